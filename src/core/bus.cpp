@@ -29,6 +29,7 @@
 #include "common/log.h"
 #include "common/memmap.h"
 
+#include <array>
 #include <cstdio>
 #include <tuple>
 #include <utility>
@@ -137,8 +138,6 @@ static std::vector<std::pair<u8*, size_t>> s_fastmem_ram_views;
 
 static u8** s_fastmem_lut = nullptr;
 
-static void SetRAMSize(bool enable_8mb_ram);
-
 static std::tuple<TickCount, TickCount, TickCount> CalculateMemoryTiming(MEMDELAY mem_delay, COMDELAY common_delay);
 static void RecalculateMemoryTimings();
 
@@ -147,6 +146,10 @@ static u8* GetLUTFastmemPointer(u32 address, u8* ram_ptr);
 static void SetRAMPageWritable(u32 page_index, bool writable);
 
 static void SetHandlers();
+static void UpdateRAMHandlers();
+
+template<MemoryAccessType type, MemoryAccessSize size, typename RT>
+static RT GetConstantAddressHandler(VirtualMemoryAddress address);
 
 template<typename FP>
 static FP* OffsetHandlerArray(void** handlers, MemoryAccessSize size, MemoryAccessType type);
@@ -307,6 +310,8 @@ void Bus::SetRAMSize(bool enable_8mb_ram)
 {
   g_ram_size = enable_8mb_ram ? RAM_8MB_SIZE : RAM_2MB_SIZE;
   g_ram_mask = enable_8mb_ram ? RAM_8MB_MASK : RAM_2MB_MASK;
+  if (g_memory_handlers)
+    UpdateRAMHandlers();
 
 #ifndef __ANDROID__
   Exports::RAM_SIZE = g_ram_size;
@@ -855,8 +860,9 @@ template<MemoryAccessSize size> static void IgnoreWriteHandler(VirtualMemoryAddr
 template<MemoryAccessSize size> static u32 UnmappedReadHandler(VirtualMemoryAddress address);
 template<MemoryAccessSize size> static void UnmappedWriteHandler(VirtualMemoryAddress address, u32 value);
 
-template<MemoryAccessSize size> static u32 RAMReadHandler(VirtualMemoryAddress address);
-template<MemoryAccessSize size> static void RAMWriteHandler(VirtualMemoryAddress address, u32 value);
+template<u32 ram_mask> static void SetRAMHandlers();
+template<MemoryAccessSize size, u32 ram_mask> static u32 RAMReadHandler(VirtualMemoryAddress address);
+template<MemoryAccessSize size, u32 ram_mask> static void RAMWriteHandler(VirtualMemoryAddress address, u32 value);
 
 template<MemoryAccessSize size> static u32 BIOSReadHandler(VirtualMemoryAddress address);
 
@@ -920,12 +926,12 @@ void Bus::UnmappedWriteHandler(VirtualMemoryAddress address, u32 value)
   UnknownWriteHandler<size>(address, value);
 }
 
-template<MemoryAccessSize size>
+template<MemoryAccessSize size, u32 ram_mask>
 u32 Bus::RAMReadHandler(VirtualMemoryAddress address)
 {
   BUS_CYCLES(RAM_READ_TICKS);
 
-  const u32 offset = address & g_ram_mask;
+  const u32 offset = address & ram_mask;
   if constexpr (size == MemoryAccessSize::Byte)
   {
     return ZeroExtend32(g_ram[offset]);
@@ -944,10 +950,33 @@ u32 Bus::RAMReadHandler(VirtualMemoryAddress address)
   }
 }
 
-template<MemoryAccessSize size>
+template<MemoryAccessSize size, u32 ram_mask>
 void Bus::RAMWriteHandler(VirtualMemoryAddress address, u32 value)
 {
-  const u32 offset = address & g_ram_mask;
+  const u32 offset = address & ram_mask;
+
+  // Pages with code are write protected. Writing around the protection keeps them that way, and only the blocks which
+  // were actually written to get invalidated.
+  if (g_ram_code_bits[offset / HOST_PAGE_SIZE]) [[unlikely]]
+  {
+    u8* const ptr = &g_unprotected_ram[offset];
+    if constexpr (size == MemoryAccessSize::Byte)
+    {
+      *ptr = Truncate8(value);
+    }
+    else if constexpr (size == MemoryAccessSize::HalfWord)
+    {
+      const u16 temp = Truncate16(value);
+      std::memcpy(ptr, &temp, sizeof(u16));
+    }
+    else if constexpr (size == MemoryAccessSize::Word)
+    {
+      std::memcpy(ptr, &value, sizeof(u32));
+    }
+
+    CPU::CodeCache::InvalidateBlocksWithRAMWrite(offset, 1u << static_cast<u32>(size));
+    return;
+  }
 
   if constexpr (size == MemoryAccessSize::Byte)
   {
@@ -1653,7 +1682,6 @@ void Bus::SetHandlers()
 
   // KUSEG - Cached
   // Cache isolated appears to affect KUSEG+KSEG0.
-  SET(g_memory_handlers, KUSEG | RAM_BASE, RAM_MIRROR_SIZE, RAMReadHandler, RAMWriteHandler);
   SET(g_memory_handlers, KUSEG | CPU::SCRATCHPAD_ADDR, 0x1000, ScratchpadReadHandler, ScratchpadWriteHandler);
   SET(g_memory_handlers, KUSEG | BIOS_BASE, BIOS_SIZE, BIOSReadHandler, IgnoreWriteHandler);
   SET(g_memory_handlers, KUSEG | EXP1_BASE, EXP1_SIZE, EXP1ReadHandler, EXP1WriteHandler);
@@ -1663,7 +1691,6 @@ void Bus::SetHandlers()
   SET(g_memory_handlers_isc, KUSEG, 0x80000000, ICacheReadHandler, ICacheWriteHandler);
 
   // KSEG0 - Cached
-  SET(g_memory_handlers, KSEG0 | RAM_BASE, RAM_MIRROR_SIZE, RAMReadHandler, RAMWriteHandler);
   SET(g_memory_handlers, KSEG0 | CPU::SCRATCHPAD_ADDR, 0x1000, ScratchpadReadHandler, ScratchpadWriteHandler);
   SET(g_memory_handlers, KSEG0 | BIOS_BASE, BIOS_SIZE, BIOSReadHandler, IgnoreWriteHandler);
   SET(g_memory_handlers, KSEG0 | EXP1_BASE, EXP1_SIZE, EXP1ReadHandler, EXP1WriteHandler);
@@ -1673,7 +1700,6 @@ void Bus::SetHandlers()
   SET(g_memory_handlers_isc, KSEG0, 0x20000000, ICacheReadHandler, ICacheWriteHandler);
 
   // KSEG1 - Uncached
-  SETUC(KSEG1 | RAM_BASE, RAM_MIRROR_SIZE, RAMReadHandler, RAMWriteHandler);
   SETUC(KSEG1 | BIOS_BASE, BIOS_SIZE, BIOSReadHandler, IgnoreWriteHandler);
   SETUC(KSEG1 | EXP1_BASE, EXP1_SIZE, EXP1ReadHandler, EXP1WriteHandler);
   SETUC(KSEG1 | HW_BASE, HW_SIZE, HardwareReadHandler, HardwareWriteHandler);
@@ -1685,6 +1711,41 @@ void Bus::SetHandlers()
 
 #undef SET
 #undef SETUC
+
+  UpdateRAMHandlers();
+}
+
+void Bus::UpdateRAMHandlers()
+{
+  // The RAM size is baked into the handlers, so the mask doesn't have to be loaded on every access.
+  if (g_ram_mask == RAM_8MB_MASK)
+    SetRAMHandlers<RAM_8MB_MASK>();
+  else
+    SetRAMHandlers<RAM_2MB_MASK>();
+}
+
+template<u32 ram_mask>
+void Bus::SetRAMHandlers()
+{
+#define SET(table, start)                                                                                              \
+  SetHandlerForRegion(table, start, RAM_MIRROR_SIZE, RAMReadHandler<MemoryAccessSize::Byte, ram_mask>,                 \
+                      RAMReadHandler<MemoryAccessSize::HalfWord, ram_mask>,                                            \
+                      RAMReadHandler<MemoryAccessSize::Word, ram_mask>,                                                \
+                      RAMWriteHandler<MemoryAccessSize::Byte, ram_mask>,                                               \
+                      RAMWriteHandler<MemoryAccessSize::HalfWord, ram_mask>,                                           \
+                      RAMWriteHandler<MemoryAccessSize::Word, ram_mask>)
+
+  static constexpr u32 KUSEG = 0;
+  static constexpr u32 KSEG0 = 0x80000000U;
+  static constexpr u32 KSEG1 = 0xA0000000U;
+
+  // Cache isolation goes to the icache for KUSEG/KSEG0, so only KSEG1 is in both tables.
+  SET(g_memory_handlers, KUSEG | RAM_BASE);
+  SET(g_memory_handlers, KSEG0 | RAM_BASE);
+  SET(g_memory_handlers, KSEG1 | RAM_BASE);
+  SET(g_memory_handlers_isc, KSEG1 | RAM_BASE);
+
+#undef SET
 }
 
 void Bus::ClearHandlers(void** handlers)
@@ -1772,3 +1833,51 @@ void** Bus::GetMemoryHandlers(bool isolate_cache, bool swap_caches)
 
   return g_memory_handlers_isc;
 }
+
+template<MemoryAccessType type, MemoryAccessSize size, typename RT>
+static RT Bus::GetConstantAddressHandler(VirtualMemoryAddress address)
+{
+  const RT handler = OffsetHandlerArray<RT>(g_memory_handlers, size, type)[address >> MEMORY_LUT_PAGE_SHIFT];
+  if constexpr (type == MemoryAccessType::Read)
+  {
+    if (handler != HardwareReadHandler<size>)
+      return handler;
+  }
+  else
+  {
+    if (handler != HardwareWriteHandler<size>)
+      return handler;
+  }
+
+  static constexpr const auto table = HWHandlers::GetHardwareRegisterHandlerTable<type, size>();
+  return table[(address >> 4) & 0xFFu];
+}
+
+Bus::MemoryReadHandler Bus::GetConstantAddressReadHandler(VirtualMemoryAddress address, MemoryAccessSize size)
+{
+  switch (size)
+  {
+    case MemoryAccessSize::Byte:
+      return GetConstantAddressHandler<MemoryAccessType::Read, MemoryAccessSize::Byte, MemoryReadHandler>(address);
+    case MemoryAccessSize::HalfWord:
+      return GetConstantAddressHandler<MemoryAccessType::Read, MemoryAccessSize::HalfWord, MemoryReadHandler>(address);
+    case MemoryAccessSize::Word:
+    default:
+      return GetConstantAddressHandler<MemoryAccessType::Read, MemoryAccessSize::Word, MemoryReadHandler>(address);
+  }
+}
+
+Bus::MemoryWriteHandler Bus::GetConstantAddressWriteHandler(VirtualMemoryAddress address, MemoryAccessSize size)
+{
+  switch (size)
+  {
+    case MemoryAccessSize::Byte:
+      return GetConstantAddressHandler<MemoryAccessType::Write, MemoryAccessSize::Byte, MemoryWriteHandler>(address);
+    case MemoryAccessSize::HalfWord:
+      return GetConstantAddressHandler<MemoryAccessType::Write, MemoryAccessSize::HalfWord, MemoryWriteHandler>(
+        address);
+    case MemoryAccessSize::Word:
+    default:
+      return GetConstantAddressHandler<MemoryAccessType::Write, MemoryAccessSize::Word, MemoryWriteHandler>(address);
+  }
+}
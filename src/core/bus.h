@@ -117,11 +117,19 @@ void Shutdown();
 void Reset();
 bool DoState(StateWrapper& sw);
 
+/// Switches the active RAM size and its access handlers. CPU memory pointers must be updated afterwards.
+void SetRAMSize(bool enable_8mb_ram);
+
 using MemoryReadHandler = u32 (*)(VirtualMemoryAddress address);
 using MemoryWriteHandler = void (*)(VirtualMemoryAddress, u32);
 
 void** GetMemoryHandlers(bool isolate_cache, bool swap_caches);
 
+/// Returns the handler for an address known ahead of time, without cache isolation. Hardware registers resolve to
+/// the owning device's handler, instead of the dispatcher which looks the device up on every access.
+MemoryReadHandler GetConstantAddressReadHandler(VirtualMemoryAddress address, MemoryAccessSize size);
+MemoryWriteHandler GetConstantAddressWriteHandler(VirtualMemoryAddress address, MemoryAccessSize size);
+
 template<typename FP>
 ALWAYS_INLINE_RELEASE static FP* OffsetHandlerArray(void** handlers, MemoryAccessSize size, MemoryAccessType type)
 {
@@ -11,6 +11,7 @@
 #include "spu.h"
 #include "system.h"
 
+#include "util/audio_perf_counters.h"
 #include "util/cd_image.h"
 #include "util/cd_xa.h"
 #include "util/imgui_manager.h"
@@ -2931,7 +2932,7 @@ ALWAYS_INLINE_RELEASE void CDROM::ProcessDataSector(const u8* raw_sector, const
   SetAsyncInterrupt(Interrupt::DataReady);
 }
 
-static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
+static constexpr std::array<std::array<s16, 29>, 7> s_zigzag_table = {
   {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
     0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
     0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
@@ -2954,7 +2955,102 @@ static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
     0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
     0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
 
-static s16 ZigZagInterpolate(const s16* ringbuf, const s16* table, u8 p)
+// The zigzag tables reversed and padded to a whole number of vectors, so that each output is a dot product with the
+// ring buffer rotated to start at the oldest sample which contributes to it.
+static constexpr u32 ZIGZAG_WINDOW_SIZE = 32;
+alignas(VECTOR_ALIGNMENT) static constexpr std::array<std::array<s16, ZIGZAG_WINDOW_SIZE>, 7> s_zigzag_window_table =
+  []() {
+    std::array<std::array<s16, ZIGZAG_WINDOW_SIZE>, 7> table = {};
+    for (u32 i = 0; i < 7; i++)
+    {
+      for (u32 j = 0; j < 29; j++)
+        table[i][28 - j] = s_zigzag_table[i][j];
+    }
+    return table;
+  }();
+
+/// Copies the ring buffer into a window, with the sample that is multiplied by the last tap at the start.
+static void GetZigZagWindow(const s16* ringbuf, u8 p, s16* window)
+{
+  static_assert(ZIGZAG_WINDOW_SIZE == 32);
+  const u32 start = (p - 28u) & 0x1F;
+  std::memcpy(window, &ringbuf[start], sizeof(s16) * (ZIGZAG_WINDOW_SIZE - start));
+  std::memcpy(&window[ZIGZAG_WINDOW_SIZE - start], ringbuf, sizeof(s16) * start);
+}
+
+/// Interpolates one output frame from both channels' windows. Each product is divided (rounding towards zero) before
+/// it's accumulated, matching the hardware.
+template<bool STEREO>
+static void ZigZagInterpolate(const s16* left_window, const s16* right_window, const s16* table, s16* left_out,
+                              s16* right_out)
+{
+  s32 left_sum, right_sum;
+
+#if defined(CPU_ARCH_SSE)
+  const auto divide = [](__m128i product) {
+    return _mm_srai_epi32(_mm_add_epi32(product, _mm_and_si128(_mm_srai_epi32(product, 31), _mm_set1_epi32(0x7FFF))),
+                          15);
+  };
+  const auto accumulate = [&divide](__m128i sum, __m128i samples, __m128i coefficients) {
+    const __m128i lo = _mm_mullo_epi16(samples, coefficients);
+    const __m128i hi = _mm_mulhi_epi16(samples, coefficients);
+    sum = _mm_add_epi32(sum, divide(_mm_unpacklo_epi16(lo, hi)));
+    return _mm_add_epi32(sum, divide(_mm_unpackhi_epi16(lo, hi)));
+  };
+
+  __m128i left = _mm_setzero_si128();
+  __m128i right = _mm_setzero_si128();
+  for (u32 i = 0; i < ZIGZAG_WINDOW_SIZE; i += 8)
+  {
+    const __m128i coefficients = _mm_load_si128(reinterpret_cast<const __m128i*>(&table[i]));
+    left = accumulate(left, _mm_load_si128(reinterpret_cast<const __m128i*>(&left_window[i])), coefficients);
+    if constexpr (STEREO)
+      right = accumulate(right, _mm_load_si128(reinterpret_cast<const __m128i*>(&right_window[i])), coefficients);
+  }
+
+  // [L0+L2, R0+R2, L1+L3, R1+R3], then fold the top half down.
+  const __m128i pairs = _mm_add_epi32(_mm_unpacklo_epi32(left, right), _mm_unpackhi_epi32(left, right));
+  const __m128i sums = _mm_add_epi32(pairs, _mm_srli_si128(pairs, 8));
+  left_sum = _mm_cvtsi128_si32(sums);
+  right_sum = _mm_cvtsi128_si32(_mm_srli_si128(sums, 4));
+#elif defined(CPU_ARCH_NEON)
+  const auto divide = [](int32x4_t product) {
+    return vshrq_n_s32(vaddq_s32(product, vandq_s32(vshrq_n_s32(product, 31), vdupq_n_s32(0x7FFF))), 15);
+  };
+  const auto accumulate = [&divide](int32x4_t sum, int16x8_t samples, int16x8_t coefficients) {
+    sum = vaddq_s32(sum, divide(vmull_s16(vget_low_s16(samples), vget_low_s16(coefficients))));
+    return vaddq_s32(sum, divide(vmull_s16(vget_high_s16(samples), vget_high_s16(coefficients))));
+  };
+
+  int32x4_t left = vdupq_n_s32(0);
+  int32x4_t right = vdupq_n_s32(0);
+  for (u32 i = 0; i < ZIGZAG_WINDOW_SIZE; i += 8)
+  {
+    const int16x8_t coefficients = vld1q_s16(&table[i]);
+    left = accumulate(left, vld1q_s16(&left_window[i]), coefficients);
+    if constexpr (STEREO)
+      right = accumulate(right, vld1q_s16(&right_window[i]), coefficients);
+  }
+
+  left_sum = vaddvq_s32(left);
+  right_sum = vaddvq_s32(right);
+#else
+  left_sum = 0;
+  right_sum = 0;
+  for (u32 i = 0; i < ZIGZAG_WINDOW_SIZE; i++)
+  {
+    left_sum += (s32(left_window[i]) * s32(table[i])) / 0x8000;
+    if constexpr (STEREO)
+      right_sum += (s32(right_window[i]) * s32(table[i])) / 0x8000;
+  }
+#endif
+
+  *left_out = static_cast<s16>(std::clamp<s32>(left_sum, -0x8000, 0x7FFF));
+  *right_out = STEREO ? static_cast<s16>(std::clamp<s32>(right_sum, -0x8000, 0x7FFF)) : *left_out;
+}
+
+/// Reference version of the interpolation, working directly on the ring buffer with the tables in hardware order.
+static s16 ZigZagInterpolateRingBuffer(const s16* ringbuf, const s16* table, u8 p)
 {
   s32 sum = 0;
   for (u8 i = 0; i < 29; i++)
@@ -2963,6 +3059,31 @@ static s16 ZigZagInterpolate(const s16* ringbuf, const s16* table, u8 p)
   return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
 }
 
+void CDROM::ZigZagInterpolateForTest(const s16* left_ringbuf, const s16* right_ringbuf, u8 p, s16* left_out,
+                                     s16* right_out, bool vectorized)
+{
+  if (!vectorized)
+  {
+    for (u32 j = 0; j < 7; j++)
+    {
+      left_out[j] = ZigZagInterpolateRingBuffer(left_ringbuf, s_zigzag_table[j].data(), p);
+      right_out[j] = ZigZagInterpolateRingBuffer(right_ringbuf, s_zigzag_table[j].data(), p);
+    }
+
+    return;
+  }
+
+  alignas(VECTOR_ALIGNMENT) std::array<s16, ZIGZAG_WINDOW_SIZE> left_window;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, ZIGZAG_WINDOW_SIZE> right_window;
+  GetZigZagWindow(left_ringbuf, p, left_window.data());
+  GetZigZagWindow(right_ringbuf, p, right_window.data());
+  for (u32 j = 0; j < 7; j++)
+  {
+    ZigZagInterpolate<true>(left_window.data(), right_window.data(), s_zigzag_window_table[j].data(), &left_out[j],
+                            &right_out[j]);
+  }
+}
+
 std::tuple<s16, s16> CDROM::GetAudioFrame()
 {
   const u32 frame = s_audio_fifo.IsEmpty() ? 0u : s_audio_fifo.Pop();
@@ -2993,6 +3114,9 @@ s16 CDROM::SaturateVolume(s32 volume)
 template<bool STEREO, bool SAMPLE_RATE>
 void CDROM::ResampleXAADPCM(const s16* frames_in, u32 num_frames_in)
 {
+  AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::XAADPCMResample);
+  AudioPerfCounters::AddBufferLevel(AudioPerfCounters::Buffer::CDAudioFIFO, s_audio_fifo.GetSize(), AUDIO_FIFO_SIZE);
+
   // Since the disc reads and SPU are running at different speeds, we might be _slightly_ behind, which is fine, since
   // the SPU will over-read in the next batch to catch up.
   if (s_audio_fifo.GetSize() > AUDIO_FIFO_LOW_WATERMARK)
@@ -3027,10 +3151,18 @@ void CDROM::ResampleXAADPCM(const s16* frames_in, u32 num_frames_in)
       if (sixstep == 0)
       {
         sixstep = 6;
+
+        alignas(VECTOR_ALIGNMENT) std::array<s16, ZIGZAG_WINDOW_SIZE> left_window;
+        alignas(VECTOR_ALIGNMENT) std::array<s16, ZIGZAG_WINDOW_SIZE> right_window;
+        GetZigZagWindow(left_ringbuf, p, left_window.data());
+        if constexpr (STEREO)
+          GetZigZagWindow(right_ringbuf, p, right_window.data());
+
         for (u32 j = 0; j < 7; j++)
         {
-          const s16 left_interp = ZigZagInterpolate(left_ringbuf, s_zigzag_table[j].data(), p);
-          const s16 right_interp = STEREO ? ZigZagInterpolate(right_ringbuf, s_zigzag_table[j].data(), p) : left_interp;
+          s16 left_interp, right_interp;
+          ZigZagInterpolate<STEREO>(left_window.data(), right_window.data(), s_zigzag_window_table[j].data(),
+                                    &left_interp, &right_interp);
           AddCDAudioFrame(left_interp, right_interp);
         }
       }
@@ -3107,7 +3239,11 @@ ALWAYS_INLINE_RELEASE void CDROM::ProcessXAADPCMSector(const u8* raw_sector, con
     ResetCurrentXAFile();
 
   std::array<s16, CDXA::XA_ADPCM_SAMPLES_PER_SECTOR_4BIT> sample_buffer;
-  CDXA::DecodeADPCMSector(raw_sector, sample_buffer.data(), s_xa_last_samples.data());
+  {
+    // Only the decode, catching up the SPU below is counted against it.
+    AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::XAADPCMDecode);
+    CDXA::DecodeADPCMSector(raw_sector, sample_buffer.data(), s_xa_last_samples.data());
+  }
 
   // Only send to SPU if we're not muted.
   if (s_muted || s_adpcm_muted || g_settings.cdrom_mute_cd_audio)
@@ -3238,6 +3374,7 @@ ALWAYS_INLINE_RELEASE void CDROM::ProcessCDDASector(const u8* raw_sector, const
 
   constexpr bool is_stereo = true;
   constexpr u32 num_samples = CDImage::RAW_SECTOR_SIZE / sizeof(s16) / (is_stereo ? 2 : 1);
+  AudioPerfCounters::AddBufferLevel(AudioPerfCounters::Buffer::CDAudioFIFO, s_audio_fifo.GetSize(), AUDIO_FIFO_SIZE);
   const u32 remaining_space = s_audio_fifo.GetSpace();
   if (remaining_space < num_samples)
   {
@@ -44,4 +44,9 @@ void SetReadaheadSectors(u32 readahead_sectors);
 /// Reads a frame from the audio FIFO, used by the SPU.
 std::tuple<s16, s16> GetAudioFrame();
 
+/// Interpolates the seven XA-ADPCM output frames for position p in the 32-sample resampling ring buffers. The scalar
+/// version applies the tables to the ring buffer directly, which the windowed, vectorized version has to match.
+void ZigZagInterpolateForTest(const s16* left_ringbuf, const s16* right_ringbuf, u8 p, s16* left_out,
+                              s16* right_out, bool vectorized);
+
 } // namespace CDROM
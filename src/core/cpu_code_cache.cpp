@@ -12,6 +12,7 @@
 #include "system.h"
 #include "timing_event.h"
 
+#include "common/align.h"
 #include "common/assert.h"
 #include "common/error.h"
 #include "common/intrin.h"
@@ -28,7 +29,7 @@ Log_SetChannel(CPU::CodeCache);
 #include "cpu_newrec_compiler.h"
 #endif
 
-#include <map>
+#include <algorithm>
 #include <unordered_set>
 #include <zlib.h>
 
@@ -48,6 +49,21 @@ static constexpr u32 RECOMPILE_FRAMES_FOR_INTERPRETER_FALLBACK = 15;
 static constexpr u32 INVALIDATE_COUNT_FOR_MANUAL_PROTECTION = 4;
 static constexpr u32 INVALIDATE_FRAMES_FOR_MANUAL_PROTECTION = 60;
 
+// Fastmem stores which fault on a page without touching any of its code (i.e. data placed next to code) are moved to
+// the slow path, which writes around the protection. Other writers (e.g. DMA) still unprotect the page, but the blocks
+// only need to be revalidated, not recompiled. So many more of those are allowed before manual protection.
+static constexpr u32 DATA_WRITE_COUNT_FOR_MANUAL_PROTECTION = 64;
+
+// Blocks are carved out of large chunks, and only given back when the whole cache is cleared. Storage is rounded up
+// to a power of two number of instructions, so a recompiled block can usually stay where it is, and blocks which
+// have to move go on a free list for their size class to be picked up by the next block of that size.
+static constexpr u32 BLOCK_ARENA_CHUNK_SIZE = 1024 * 1024;
+static constexpr u32 BLOCK_ARENA_ALIGNMENT = 64;
+static constexpr u32 NUM_BLOCK_SIZE_CLASSES = 32;
+
+// Anything longer is unlikely to be a polling loop, and isn't worth the analysis.
+static constexpr u32 MAX_IDLE_LOOP_INSTRUCTIONS = 16;
+
 static CodeLUT DecodeCodeLUTPointer(u32 slot, CodeLUT ptr);
 static CodeLUT EncodeCodeLUTPointer(u32 slot, CodeLUT ptr);
 static CodeLUT OffsetCodeLUTPointer(CodeLUT fake_ptr, u32 pc);
@@ -60,6 +76,9 @@ static void InvalidateBlock(Block* block, BlockState new_state);
 static void ClearBlocks();
 
 static Block* LookupBlock(u32 pc);
+static Block* AllocateBlock(u32 size);
+static void FreeBlock(Block* block);
+static void FreeAllBlocks();
 static Block* CreateBlock(u32 pc, const BlockInstructionList& instructions, const BlockMetadata& metadata);
 static bool IsBlockCodeCurrent(const Block* block);
 static bool RevalidateBlock(Block* block);
@@ -69,11 +88,21 @@ static bool ReadBlockInstructions(u32 start_pc, BlockInstructionList* instructio
 static void FillBlockRegInfo(Block* block);
 static void CopyRegInfo(InstructionInfo* dst, const InstructionInfo* src);
 static void SetRegAccess(InstructionInfo* inst, Reg reg, bool write);
+static bool IsIdleLoop(u32 start_pc, const BlockInstructionList& instructions);
+static bool AnalyzeIdleLoop(const Instruction* instructions, u32 count, const Registers* regs);
+static bool IsIdleLoopLoadAddress(VirtualMemoryAddress address);
+static void SkipIdleLoop(Block* block);
 static void AddBlockToPageList(Block* block);
 static void RemoveBlockFromPageList(Block* block);
+static u64 GetCodeGranuleMask(u32 offset, u32 size);
+static u64 GetBlockCodeGranuleMask(const Block* block);
+static BlockState CountPageInvalidation(u32 index, bool code_written);
+static void InvalidatePageBlocks(u32 index, BlockState new_block_state);
+static void InvalidateBlocksWithWriteFault(PhysicalMemoryAddress address);
 
 static Common::PageFaultHandler::HandlerResult ExceptionHandler(void* exception_pc, void* fault_address, bool is_write);
 
+template<PGXPMode pgxp_mode>
 static Block* CreateCachedInterpreterBlock(u32 pc);
 [[noreturn]] static void ExecuteCachedInterpreter();
 template<PGXPMode pgxp_mode>
@@ -87,10 +116,16 @@ static std::unique_ptr<const void*[]> s_lut_code_pointers;
 static std::unique_ptr<Block*[]> s_lut_block_pointers;
 static PageProtectionArray s_page_protection = {};
 static std::vector<Block*> s_blocks;
+static std::vector<void*> s_block_arena_chunks;
+static u8* s_block_arena_ptr = nullptr;
+static u8* s_block_arena_end = nullptr;
+static std::array<Block*, NUM_BLOCK_SIZE_CLASSES> s_free_blocks = {};
 
 // for compiling - reuse to avoid allocations
 static BlockInstructionList s_block_instructions;
 
+static u64 s_idle_loop_skipped_ticks = 0;
+
 #ifdef ENABLE_RECOMPILER_SUPPORT
 
 static void BacklinkBlocks(u32 pc, const void* dst);
@@ -104,8 +139,17 @@ static Common::PageFaultHandler::HandlerResult HandleFastmemException(void* exce
 static void BackpatchLoadStore(void* host_pc, const LoadstoreBackpatchInfo& info);
 static void RemoveBackpatchInfoForRange(const void* host_code, u32 size);
 
+static LoadstoreBackpatchInfo* FindBackpatchInfo(const void* code_address);
+static bool IsFastmemDataWrite(const void* exception_pc, PhysicalMemoryAddress address);
+static void InsertBackpatchInfo(void* code_address, const LoadstoreBackpatchInfo& info);
+static void CompactBackpatchInfo();
+
 static BlockLinkMap s_block_links;
-static std::map<const void*, LoadstoreBackpatchInfo> s_fastmem_backpatch_info;
+
+// Sorted by host address. Code is emitted linearly, so new entries almost always go on the end. Removed entries are
+// only marked with a zero code size, and swept out once they outnumber the live entries.
+static std::vector<std::pair<const void*, LoadstoreBackpatchInfo>> s_fastmem_backpatch_info;
+static size_t s_fastmem_backpatch_removed_count = 0;
 static std::unordered_set<u32> s_fastmem_faulting_pcs;
 
 NORETURN_FUNCTION_POINTER void (*g_enter_recompiler)();
@@ -447,27 +491,23 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
     recompile_frame = block->compile_frame;
     recompile_count = block->compile_count;
 
-    // if it has the same number of instructions, we can reuse it
-    if (block->size != size)
+    // exits should have been unlinked before recompiling
+    DebugAssert(block->num_exit_links == 0);
+
+    // if the instructions still fit, we can reuse it
+    if (size > (1u << block->size_class))
     {
       // this sucks.. hopefully won't happen very often
-      // TODO: allocate max size, allow shrink but not grow
       auto it = std::find(s_blocks.begin(), s_blocks.end(), block);
       Assert(it != s_blocks.end());
-      s_blocks.erase(it);
-
-      block->~Block();
-      std::free(block);
-      block = nullptr;
+      FreeBlock(block);
+      block = AllocateBlock(size);
+      *it = block;
     }
   }
-
-  if (!block)
+  else
   {
-    block =
-      static_cast<Block*>(std::malloc(sizeof(Block) + (sizeof(Instruction) * size) + (sizeof(InstructionInfo) * size)));
-    Assert(block);
-    new (block) Block();
+    block = AllocateBlock(size);
     s_blocks.push_back(block);
   }
 
@@ -532,6 +572,59 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
   return block;
 }
 
+CPU::CodeCache::Block* CPU::CodeCache::AllocateBlock(u32 size)
+{
+  const u32 size_class = CountTrailingZeros(Common::NextPow2(std::max(size, 1u)));
+  DebugAssert(size_class < NUM_BLOCK_SIZE_CLASSES);
+
+  Block* block = s_free_blocks[size_class];
+  if (block)
+  {
+    s_free_blocks[size_class] = block->next_block_in_page;
+  }
+  else
+  {
+    const size_t alloc_size = Common::AlignUpPow2(
+      sizeof(Block) +
+        ((sizeof(Instruction) + sizeof(InstructionInfo) + sizeof(CachedInterpreterHandler)) << size_class),
+      BLOCK_ARENA_ALIGNMENT);
+    if (static_cast<size_t>(s_block_arena_end - s_block_arena_ptr) < alloc_size)
+    {
+      const size_t chunk_size = std::max<size_t>(alloc_size, BLOCK_ARENA_CHUNK_SIZE);
+      void* chunk = Common::AlignedMalloc(chunk_size, BLOCK_ARENA_ALIGNMENT);
+      Assert(chunk);
+      s_block_arena_chunks.push_back(chunk);
+      s_block_arena_ptr = static_cast<u8*>(chunk);
+      s_block_arena_end = s_block_arena_ptr + chunk_size;
+    }
+
+    block = reinterpret_cast<Block*>(s_block_arena_ptr);
+    s_block_arena_ptr += alloc_size;
+  }
+
+  new (block) Block();
+  block->size_class = static_cast<u8>(size_class);
+  return block;
+}
+
+void CPU::CodeCache::FreeBlock(Block* block)
+{
+  // free blocks are chained through the page list pointer, since they can't be in a page
+  block->next_block_in_page = s_free_blocks[block->size_class];
+  s_free_blocks[block->size_class] = block;
+}
+
+void CPU::CodeCache::FreeAllBlocks()
+{
+  for (void* chunk : s_block_arena_chunks)
+    Common::AlignedFree(chunk);
+  s_block_arena_chunks.clear();
+  s_block_arena_ptr = nullptr;
+  s_block_arena_end = nullptr;
+  s_free_blocks = {};
+  s_blocks.clear();
+}
+
 bool CPU::CodeCache::IsBlockCodeCurrent(const Block* block)
 {
   // blocks shouldn't be wrapping..
@@ -575,6 +668,7 @@ void CPU::CodeCache::AddBlockToPageList(Block* block)
   const u32 page_idx = block->StartPageIndex();
   PageProtectionInfo& entry = s_page_protection[page_idx];
   Bus::SetRAMCodePage(page_idx);
+  entry.code_granule_mask |= GetBlockCodeGranuleMask(block);
 
   if (entry.last_block_in_page)
   {
@@ -621,31 +715,55 @@ void CPU::CodeCache::RemoveBlockFromPageList(Block* block)
   }
 }
 
-void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
+u64 CPU::CodeCache::GetCodeGranuleMask(u32 offset, u32 size)
 {
-  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT);
-  Bus::ClearRAMCodePage(index);
+  DebugAssert(offset < HOST_PAGE_SIZE && size > 0);
+  const u32 first = offset / CODE_GRANULE_SIZE;
+  const u32 last = std::min(offset + size - 1, HOST_PAGE_MASK) / CODE_GRANULE_SIZE;
+  return (UINT64_C(0xFFFFFFFFFFFFFFFF) >> (63 - last)) & (UINT64_C(0xFFFFFFFFFFFFFFFF) << first);
+}
+
+u64 CPU::CodeCache::GetBlockCodeGranuleMask(const Block* block)
+{
+  // write protected blocks can't cross pages, anything past the end of the page is clamped
+  return GetCodeGranuleMask(VirtualAddressToPhysical(block->pc) & HOST_PAGE_MASK, block->size * sizeof(Instruction));
+}
 
-  BlockState new_block_state = BlockState::Invalidated;
+CPU::CodeCache::BlockState CPU::CodeCache::CountPageInvalidation(u32 index, bool code_written)
+{
   PageProtectionInfo& ppi = s_page_protection[index];
 
   const u32 frame_number = System::GetFrameNumber();
   const u32 frame_delta = frame_number - ppi.invalidate_frame;
-  ppi.invalidate_count++;
+  if (code_written)
+    ppi.invalidate_count++;
+  else
+    ppi.data_write_count++;
 
   if (frame_delta >= INVALIDATE_FRAMES_FOR_MANUAL_PROTECTION)
   {
-    ppi.invalidate_count = 1;
+    ppi.invalidate_count = code_written ? 1 : 0;
+    ppi.data_write_count = code_written ? 0 : 1;
     ppi.invalidate_frame = frame_number;
   }
-  else if (ppi.invalidate_count > INVALIDATE_COUNT_FOR_MANUAL_PROTECTION)
+  else if (ppi.invalidate_count > INVALIDATE_COUNT_FOR_MANUAL_PROTECTION ||
+           ppi.data_write_count > DATA_WRITE_COUNT_FOR_MANUAL_PROTECTION)
   {
-    Log_DevFmt("{} invalidations in {} frames to page {} [0x{:08X} -> 0x{:08X}], switching to manual protection",
-               ppi.invalidate_count, frame_delta, index, (index * HOST_PAGE_SIZE), ((index + 1) * HOST_PAGE_SIZE));
+    Log_DevFmt("{} invalidations and {} data writes in {} frames to page {} [0x{:08X} -> 0x{:08X}], switching to "
+               "manual protection",
+               ppi.invalidate_count, ppi.data_write_count, frame_delta, index, (index * HOST_PAGE_SIZE),
+               ((index + 1) * HOST_PAGE_SIZE));
     ppi.mode = PageProtectionMode::ManualCheck;
-    new_block_state = BlockState::NeedsRecompile;
+    return BlockState::NeedsRecompile;
   }
 
+  return BlockState::Invalidated;
+}
+
+void CPU::CodeCache::InvalidatePageBlocks(u32 index, BlockState new_block_state)
+{
+  PageProtectionInfo& ppi = s_page_protection[index];
+  ppi.code_granule_mask = 0;
   if (!ppi.first_block_in_page)
     return;
 
@@ -664,6 +782,78 @@ void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
   MemMap::EndCodeWrite();
 }
 
+void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
+{
+  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT);
+  Bus::ClearRAMCodePage(index);
+  InvalidatePageBlocks(index, CountPageInvalidation(index, true));
+}
+
+void CPU::CodeCache::InvalidateBlocksWithWriteFault(PhysicalMemoryAddress address)
+{
+  // The page has to be unprotected for the write to go through, so every block in it needs revalidating. But if the
+  // write missed all the code, there's no point in counting it like self-modifying code. Stores are at most a word.
+  const u32 index = Bus::GetRAMCodePageIndex(address);
+  const u64 write_mask = GetCodeGranuleMask(address & HOST_PAGE_MASK & ~3u, sizeof(u32));
+  const bool code_written = ((s_page_protection[index].code_granule_mask & write_mask) != 0);
+  Bus::ClearRAMCodePage(index);
+  InvalidatePageBlocks(index, CountPageInvalidation(index, code_written));
+}
+
+void CPU::CodeCache::InvalidateBlocksWithRAMWrite(PhysicalMemoryAddress address, u32 size)
+{
+  const u32 index = Bus::GetRAMCodePageIndex(address);
+  const u32 offset = address & HOST_PAGE_MASK;
+  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT && (offset + size) <= HOST_PAGE_SIZE);
+
+  PageProtectionInfo& ppi = s_page_protection[index];
+  const u64 write_mask = GetCodeGranuleMask(offset, size);
+  if ((ppi.code_granule_mask & write_mask) == 0)
+    return;
+
+  const BlockState new_block_state = CountPageInvalidation(index, true);
+  if (new_block_state != BlockState::Invalidated)
+  {
+    Bus::ClearRAMCodePage(index);
+    InvalidatePageBlocks(index, new_block_state);
+    return;
+  }
+
+  // The page is still protected, so only the blocks which were written to need to go.
+  MemMap::BeginCodeWrite();
+
+  Block* prev_block = nullptr;
+  Block* block = ppi.first_block_in_page;
+  ppi.code_granule_mask = 0;
+  while (block)
+  {
+    Block* next_block = block->next_block_in_page;
+    const u32 block_offset = VirtualAddressToPhysical(block->pc) & HOST_PAGE_MASK;
+    if (block_offset < (offset + size) && offset < (block_offset + block->size * sizeof(Instruction)))
+    {
+      InvalidateBlock(block, BlockState::Invalidated);
+      block->next_block_in_page = nullptr;
+      if (prev_block)
+        prev_block->next_block_in_page = next_block;
+      else
+        ppi.first_block_in_page = next_block;
+    }
+    else
+    {
+      ppi.code_granule_mask |= GetBlockCodeGranuleMask(block);
+      prev_block = block;
+    }
+
+    block = next_block;
+  }
+
+  ppi.last_block_in_page = prev_block;
+  if (!ppi.first_block_in_page)
+    Bus::ClearRAMCodePage(index);
+
+  MemMap::EndCodeWrite();
+}
+
 CPU::CodeCache::PageProtectionMode CPU::CodeCache::GetProtectionModeForPC(u32 pc)
 {
   if (!AddressInRAM(pc))
@@ -714,6 +904,7 @@ void CPU::CodeCache::InvalidateAllRAMBlocks()
   {
     ppi.first_block_in_page = nullptr;
     ppi.last_block_in_page = nullptr;
+    ppi.code_granule_mask = 0;
   }
 
   MemMap::EndCodeWrite();
@@ -733,16 +924,12 @@ void CPU::CodeCache::ClearBlocks()
 
 #ifdef ENABLE_RECOMPILER_SUPPORT
   s_fastmem_backpatch_info.clear();
+  s_fastmem_backpatch_removed_count = 0;
   s_fastmem_faulting_pcs.clear();
   s_block_links.clear();
 #endif
 
-  for (Block* block : s_blocks)
-  {
-    block->~Block();
-    std::free(block);
-  }
-  s_blocks.clear();
+  FreeAllBlocks();
 
   std::memset(s_lut_block_pointers.get(), 0, sizeof(Block*) * GetLUTSlotCount(false));
 }
@@ -757,9 +944,16 @@ Common::PageFaultHandler::HandlerResult CPU::CodeCache::ExceptionHandler(void* e
     DebugAssert(is_write);
     const u32 guest_address = static_cast<u32>(static_cast<const u8*>(fault_address) - Bus::g_ram);
     const u32 page_index = Bus::GetRAMCodePageIndex(guest_address);
+
+#ifdef ENABLE_RECOMPILER_SUPPORT
+    // LUT fastmem stores write to RAM directly, so they fault here instead.
+    if (g_settings.cpu_fastmem_mode == CPUFastmemMode::LUT && IsFastmemDataWrite(exception_pc, guest_address))
+      return HandleFastmemException(exception_pc, fault_address, is_write);
+#endif
+
     Log_DevFmt("Page fault on protected RAM @ 0x{:08X} (page #{}), invalidating code cache.", guest_address,
                page_index);
-    InvalidateBlocksWithPageIndex(page_index);
+    InvalidateBlocksWithWriteFault(guest_address);
     return Common::PageFaultHandler::HandlerResult::ContinueExecution;
   }
 
@@ -774,11 +968,15 @@ Common::PageFaultHandler::HandlerResult CPU::CodeCache::ExceptionHandler(void* e
 // MARK: - Cached Interpreter
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template<PGXPMode pgxp_mode>
 CPU::CodeCache::Block* CPU::CodeCache::CreateCachedInterpreterBlock(u32 pc)
 {
   BlockMetadata metadata = {};
   ReadBlockInstructions(pc, &s_block_instructions, &metadata);
-  return CreateBlock(pc, s_block_instructions, metadata);
+
+  Block* block = CreateBlock(pc, s_block_instructions, metadata);
+  DecodeCachedInterpreterBlock<pgxp_mode>(block);
+  return block;
 }
 
 template<PGXPMode pgxp_mode>
@@ -819,7 +1017,7 @@ template<PGXPMode pgxp_mode>
     reexecute_block:
       if (!block)
       {
-        if ((block = CreateCachedInterpreterBlock(pc))->size == 0) [[unlikely]]
+        if ((block = CreateCachedInterpreterBlock<pgxp_mode>(pc))->size == 0) [[unlikely]]
           goto interpret_block;
       }
       else
@@ -830,7 +1028,7 @@ template<PGXPMode pgxp_mode>
         if ((block->state != BlockState::Valid && !RevalidateBlock(block)) ||
             (block->protection == PageProtectionMode::ManualCheck && !IsBlockCodeCurrent(block)))
         {
-          if ((block = CreateCachedInterpreterBlock(pc))->size == 0) [[unlikely]]
+          if ((block = CreateCachedInterpreterBlock<pgxp_mode>(pc))->size == 0) [[unlikely]]
             goto interpret_block;
         }
       }
@@ -841,6 +1039,9 @@ template<PGXPMode pgxp_mode>
 
       InterpretCachedBlock<pgxp_mode>(block);
 
+      if (g_state.pc == block->pc && block->HasFlag(BlockFlags::IdleLoop))
+        SkipIdleLoop(block);
+
       CHECK_DOWNCOUNT();
 
       // Handle self-looping blocks
@@ -1030,6 +1231,12 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
 
   instructions->back().second.is_last_instruction = true;
 
+  if (g_settings.cpu_idle_loop_skipping && IsIdleLoop(start_pc, *instructions))
+  {
+    Log_DevFmt("Block 0x{:08X} is an idle loop", start_pc);
+    metadata->flags |= BlockFlags::IdleLoop;
+  }
+
 #ifdef _DEBUG
   SmallString disasm;
   Log_DebugPrintf("Block at 0x%08X", start_pc);
@@ -1044,6 +1251,250 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
   return true;
 }
 
+bool CPU::CodeCache::IsIdleLoop(u32 start_pc, const BlockInstructionList& instructions)
+{
+  // Has to be a loop back to the start of the block, with no other branches inside it.
+  const u32 count = static_cast<u32>(instructions.size());
+  if (count < 2 || count > MAX_IDLE_LOOP_INSTRUCTIONS)
+    return false;
+
+  const BlockInstructionInfoPair& branch = instructions[count - 2];
+  if (!branch.second.is_direct_branch_instruction ||
+      GetDirectBranchTarget(branch.first, branch.second.pc) != start_pc)
+  {
+    return false;
+  }
+
+  std::array<Instruction, MAX_IDLE_LOOP_INSTRUCTIONS> loop_instructions;
+  for (u32 i = 0; i < count; i++)
+  {
+    if (i != (count - 2) && instructions[i].second.is_branch_instruction)
+      return false;
+
+    loop_instructions[i].bits = instructions[i].first.bits;
+  }
+
+  return AnalyzeIdleLoop(loop_instructions.data(), count, nullptr);
+}
+
+bool CPU::CodeCache::AnalyzeIdleLoop(const Instruction* instructions, u32 count, const Registers* regs)
+{
+  // Bitmasks of Reg, only the instructions which can't have side effects are accepted.
+  const auto get_reg_access = [](const Instruction inst, u64* reads, u64* writes, bool* is_load) {
+    const auto bit = [](Reg reg) { return (reg == Reg::zero) ? u64(0) : (u64(1) << static_cast<u8>(reg)); };
+    *reads = 0;
+    *writes = 0;
+    *is_load = false;
+
+    switch (inst.op)
+    {
+      case InstructionOp::funct:
+      {
+        switch (inst.r.funct)
+        {
+          case InstructionFunct::sll:
+          case InstructionFunct::srl:
+          case InstructionFunct::sra:
+            *reads = bit(inst.r.rt);
+            *writes = bit(inst.r.rd);
+            return true;
+
+          case InstructionFunct::sllv:
+          case InstructionFunct::srlv:
+          case InstructionFunct::srav:
+          case InstructionFunct::addu:
+          case InstructionFunct::subu:
+          case InstructionFunct::and_:
+          case InstructionFunct::or_:
+          case InstructionFunct::xor_:
+          case InstructionFunct::nor:
+          case InstructionFunct::slt:
+          case InstructionFunct::sltu:
+            *reads = bit(inst.r.rs) | bit(inst.r.rt);
+            *writes = bit(inst.r.rd);
+            return true;
+
+          case InstructionFunct::mfhi:
+            *reads = bit(Reg::hi);
+            *writes = bit(inst.r.rd);
+            return true;
+
+          case InstructionFunct::mflo:
+            *reads = bit(Reg::lo);
+            *writes = bit(inst.r.rd);
+            return true;
+
+          default:
+            return false;
+        }
+      }
+
+      case InstructionOp::b:
+      {
+        // bltzal/bgezal write ra.
+        if ((static_cast<u8>(inst.i.rt.GetValue()) & u8(0x1E)) == u8(0x10))
+          return false;
+
+        *reads = bit(inst.i.rs);
+        return true;
+      }
+
+      case InstructionOp::j:
+        return true;
+
+      case InstructionOp::beq:
+      case InstructionOp::bne:
+        *reads = bit(inst.i.rs) | bit(inst.i.rt);
+        return true;
+
+      case InstructionOp::blez:
+      case InstructionOp::bgtz:
+        *reads = bit(inst.i.rs);
+        return true;
+
+      case InstructionOp::addiu:
+      case InstructionOp::slti:
+      case InstructionOp::sltiu:
+      case InstructionOp::andi:
+      case InstructionOp::ori:
+      case InstructionOp::xori:
+        *reads = bit(inst.i.rs);
+        *writes = bit(inst.i.rt);
+        return true;
+
+      case InstructionOp::lui:
+        *writes = bit(inst.i.rt);
+        return true;
+
+      case InstructionOp::lb:
+      case InstructionOp::lbu:
+      case InstructionOp::lh:
+      case InstructionOp::lhu:
+      case InstructionOp::lw:
+        *reads = bit(inst.i.rs);
+        *writes = bit(inst.i.rt);
+        *is_load = true;
+        return true;
+
+      default:
+        return false;
+    }
+  };
+
+  u64 reads, writes;
+  bool is_load;
+  u64 loop_writes = 0;
+  for (u32 i = 0; i < count; i++)
+  {
+    if (!get_reg_access(instructions[i], &reads, &writes, &is_load))
+      return false;
+    loop_writes |= writes;
+  }
+
+  // Registers which are built from immediates in the loop, typically the upper half of an address.
+  std::array<u32, 32> constant_values;
+  u64 constant_regs = 1;
+  constant_values[0] = 0;
+
+  u64 written = 0;
+  u64 load_delay_writes = 0;
+  for (u32 i = 0; i < count; i++)
+  {
+    const Instruction inst = instructions[i];
+    get_reg_access(inst, &reads, &writes, &is_load);
+
+    // Reading something before the loop writes it means it depends on the last iteration, e.g. a counter. Reading a
+    // load in its delay slot gets the old value, which is the same thing.
+    if ((reads & ((loop_writes & ~written) | load_delay_writes)) != 0)
+      return false;
+
+    if (is_load)
+    {
+      const u8 base = static_cast<u8>(inst.i.rs.GetValue());
+      const u64 base_bit = u64(1) << base;
+      if (constant_regs & base_bit)
+      {
+        if (!IsIdleLoopLoadAddress(constant_values[base] + inst.i.imm_sext32()))
+          return false;
+      }
+      else if (loop_writes & base_bit)
+      {
+        return false;
+      }
+      else if (regs && !IsIdleLoopLoadAddress(regs->r[base] + inst.i.imm_sext32()))
+      {
+        // Base doesn't change in the loop, so it has the same value now as every iteration.
+        return false;
+      }
+    }
+
+    const u8 rt = static_cast<u8>(inst.i.rt.GetValue());
+    const u8 rs = static_cast<u8>(inst.i.rs.GetValue());
+    const bool rs_constant = (constant_regs & (u64(1) << rs)) != 0;
+    constant_regs &= ~writes;
+    if (inst.op == InstructionOp::lui)
+    {
+      constant_values[rt] = inst.i.imm_zext32() << 16;
+      constant_regs |= writes;
+    }
+    else if (rs_constant && inst.op == InstructionOp::addiu)
+    {
+      constant_values[rt] = constant_values[rs] + inst.i.imm_sext32();
+      constant_regs |= writes;
+    }
+    else if (rs_constant && inst.op == InstructionOp::ori)
+    {
+      constant_values[rt] = constant_values[rs] | inst.i.imm_zext32();
+      constant_regs |= writes;
+    }
+
+    written |= writes;
+    load_delay_writes = is_load ? writes : 0;
+  }
+
+  // A load in the delay slot would still be in flight when the loop goes around.
+  return (load_delay_writes == 0);
+}
+
+bool CPU::CodeCache::IsIdleLoopLoadAddress(VirtualMemoryAddress address)
+{
+  // Only memory which is changed by the CPU, DMA or interrupts can be polled, since those all happen in events. Timers
+  // and GPUSTAT move on their own, so skipping ahead would change what the loop sees.
+  if (GetSegmentForAddress(address) == Segment::KSEG2)
+    return false;
+
+  const PhysicalMemoryAddress paddr = VirtualAddressToPhysical(address);
+  return (Bus::IsRAMAddress(paddr) || (address & SCRATCHPAD_ADDR_MASK) == SCRATCHPAD_ADDR ||
+          (paddr - Bus::INTC_BASE) < 8);
+}
+
+void CPU::CodeCache::SkipIdleLoop(Block* block)
+{
+  // Isolated cache loads go to the icache, not what was checked. Not worth handling.
+  if (g_state.cop0_regs.sr.Isc)
+    return;
+
+  if (!AnalyzeIdleLoop(block->Instructions(), block->size, &g_state.regs))
+  {
+    // Polling something which changes without an event, don't bother checking again.
+    Log_DevFmt("Idle loop at 0x{:08X} reads memory which can change outside of events", block->pc);
+    block->flags &= ~BlockFlags::IdleLoop;
+    return;
+  }
+
+  // Nothing will change until the next event runs, so there's no point executing the loop until then.
+  if (g_state.pending_ticks < g_state.downcount)
+  {
+    s_idle_loop_skipped_ticks += static_cast<u64>(g_state.downcount - g_state.pending_ticks);
+    g_state.pending_ticks = g_state.downcount;
+  }
+}
+
+u64 CPU::CodeCache::GetIdleLoopSkippedTicks()
+{
+  return s_idle_loop_skipped_ticks;
+}
+
 void CPU::CodeCache::CopyRegInfo(InstructionInfo* dst, const InstructionInfo* src)
 {
   std::memcpy(dst->reg_flags, src->reg_flags, sizeof(dst->reg_flags));
@@ -1389,6 +1840,13 @@ void CPU::CodeCache::DiscardAndRecompileBlock(u32 start_pc)
   MemMap::EndCodeWrite();
 }
 
+void CPU::CodeCache::SkipIdleLoop()
+{
+  Block* block = LookupBlock(g_state.pc);
+  if (block && block->HasFlag(BlockFlags::IdleLoop))
+    SkipIdleLoop(block);
+}
+
 const void* CPU::CodeCache::CreateBlockLink(Block* block, void* code, u32 newpc)
 {
   // self-linking should be handled by the caller
@@ -1411,9 +1869,15 @@ const void* CPU::CodeCache::CreateBlockLink(Block* block, void* code, u32 newpc)
       dst = g_compile_or_revalidate_block;
     }
 
-    BlockLinkMap::iterator iter = s_block_links.emplace(newpc, code);
     DebugAssert(block->num_exit_links < MAX_BLOCK_EXIT_LINKS);
-    block->exit_links[block->num_exit_links++] = iter;
+    BlockLink& link = block->exit_links[block->num_exit_links++];
+    BlockLink*& head = s_block_links[newpc];
+    link.code = code;
+    link.next = head;
+    link.prev_next = &head;
+    if (head)
+      head->prev_next = &link.next;
+    head = &link;
   }
 
   Log_DebugPrintf("Linking %p with dst pc %08X to %p%s", code, newpc, dst,
@@ -1426,12 +1890,15 @@ void CPU::CodeCache::BacklinkBlocks(u32 pc, const void* dst)
   if (!g_settings.cpu_recompiler_block_linking)
     return;
 
-  const auto link_range = s_block_links.equal_range(pc);
-  for (auto it = link_range.first; it != link_range.second; ++it)
+  const auto iter = s_block_links.find(pc);
+  if (iter == s_block_links.end())
+    return;
+
+  for (const BlockLink* link = iter->second; link; link = link->next)
   {
-    Log_DebugPrintf("Backlinking %p with dst pc %08X to %p%s", it->second, pc, dst,
+    Log_DebugPrintf("Backlinking %p with dst pc %08X to %p%s", link->code, pc, dst,
                     (dst == g_compile_or_revalidate_block) ? "[compiler]" : "");
-    EmitJump(it->second, dst, true);
+    EmitJump(link->code, dst, true);
   }
 }
 
@@ -1439,7 +1906,12 @@ void CPU::CodeCache::UnlinkBlockExits(Block* block)
 {
   const u32 num_exit_links = block->num_exit_links;
   for (u32 i = 0; i < num_exit_links; i++)
-    s_block_links.erase(block->exit_links[i]);
+  {
+    const BlockLink& link = block->exit_links[i];
+    *link.prev_next = link.next;
+    if (link.next)
+      link.next->prev_next = link.prev_next;
+  }
   block->num_exit_links = 0;
 }
 
@@ -1493,6 +1965,18 @@ void CPU::CodeCache::CompileASMFunctions()
   MemMap::EndCodeWrite();
 }
 
+CPU::CodeCache::GTETestFunction CPU::CodeCache::CompileGTECommandForTest(u32 inst_bits)
+{
+#ifdef ENABLE_NEWREC
+  MemMap::BeginCodeWrite();
+  const void* code = NewRec::g_compiler->CompileGTECommandForTest(inst_bits);
+  MemMap::EndCodeWrite();
+  return code ? reinterpret_cast<GTETestFunction>(const_cast<void*>(code)) : nullptr;
+#else
+  return nullptr;
+#endif
+}
+
 bool CPU::CodeCache::CompileBlock(Block* block)
 {
   const void* host_code = nullptr;
@@ -1553,31 +2037,23 @@ bool CPU::CodeCache::CompileBlock(Block* block)
 
 void CPU::CodeCache::AddLoadStoreInfo(void* code_address, u32 code_size, u32 guest_pc, const void* thunk_address)
 {
-  DebugAssert(code_size < std::numeric_limits<u8>::max());
-
-  auto iter = s_fastmem_backpatch_info.find(code_address);
-  if (iter != s_fastmem_backpatch_info.end())
-    s_fastmem_backpatch_info.erase(iter);
+  DebugAssert(code_size > 0 && code_size < std::numeric_limits<u8>::max());
 
   LoadstoreBackpatchInfo info;
   info.thunk_address = thunk_address;
   info.guest_pc = guest_pc;
   info.guest_block = 0;
   info.code_size = static_cast<u8>(code_size);
-  s_fastmem_backpatch_info.emplace(code_address, info);
+  InsertBackpatchInfo(code_address, info);
 }
 
 void CPU::CodeCache::AddLoadStoreInfo(void* code_address, u32 code_size, u32 guest_pc, u32 guest_block,
                                       TickCount cycles, u32 gpr_bitmask, u8 address_register, u8 data_register,
                                       MemoryAccessSize size, bool is_signed, bool is_load)
 {
-  DebugAssert(code_size < std::numeric_limits<u8>::max());
+  DebugAssert(code_size > 0 && code_size < std::numeric_limits<u8>::max());
   DebugAssert(cycles >= 0 && cycles < std::numeric_limits<u16>::max());
 
-  auto iter = s_fastmem_backpatch_info.find(code_address);
-  if (iter != s_fastmem_backpatch_info.end())
-    s_fastmem_backpatch_info.erase(iter);
-
   LoadstoreBackpatchInfo info;
   info.thunk_address = nullptr;
   info.guest_pc = guest_pc;
@@ -1590,7 +2066,7 @@ void CPU::CodeCache::AddLoadStoreInfo(void* code_address, u32 code_size, u32 gue
   info.is_signed = is_signed;
   info.is_load = is_load;
   info.code_size = static_cast<u8>(code_size);
-  s_fastmem_backpatch_info.emplace(code_address, info);
+  InsertBackpatchInfo(code_address, info);
 }
 
 Common::PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(void* exception_pc, void* fault_address,
@@ -1614,10 +2090,12 @@ Common::PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(v
 
     // if we're writing to ram, let it go through a few times, and use manual block protection to sort it out
     // TODO: path for manual protection to return back to read-only pages
-    if (is_write && !g_state.cop0_regs.sr.Isc && AddressInRAM(guest_address))
+    // Stores which miss the code in the page are backpatched below, so the page stays protected.
+    if (is_write && !g_state.cop0_regs.sr.Isc && AddressInRAM(guest_address) &&
+        !IsFastmemDataWrite(exception_pc, guest_address))
     {
       Log_DevFmt("Ignoring fault due to RAM write @ 0x{:08X}", guest_address);
-      InvalidateBlocksWithPageIndex(Bus::GetRAMCodePageIndex(guest_address));
+      InvalidateBlocksWithWriteFault(guest_address);
       return Common::PageFaultHandler::HandlerResult::ContinueExecution;
     }
   }
@@ -1631,14 +2109,14 @@ Common::PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(v
   Log_DevFmt("Page fault handler invoked at PC={} Address={} {}, fastmem offset {:08X}", exception_pc, fault_address,
              is_write ? "(write)" : "(read)", guest_address);
 
-  auto iter = s_fastmem_backpatch_info.find(exception_pc);
-  if (iter == s_fastmem_backpatch_info.end())
+  LoadstoreBackpatchInfo* const info_ptr = FindBackpatchInfo(exception_pc);
+  if (!info_ptr)
   {
     Log_ErrorFmt("No backpatch info found for {}", exception_pc);
     return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
   }
 
-  LoadstoreBackpatchInfo& info = iter->second;
+  LoadstoreBackpatchInfo& info = *info_ptr;
   Log_DevFmt("Backpatching {} at {}[{}] (pc {:08X} addr {:08X}): Bitmask {:08X} Addr {} Data {} Size {} Signed {:02X}",
              info.is_load ? "load" : "store", exception_pc, info.code_size, info.guest_pc, guest_address,
              info.gpr_bitmask, static_cast<unsigned>(info.address_register), static_cast<unsigned>(info.data_register),
@@ -1669,10 +2147,23 @@ Common::PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(v
 
   // and store the pc in the faulting list, so that we don't emit another fastmem loadstore
   s_fastmem_faulting_pcs.insert(info.guest_pc);
-  s_fastmem_backpatch_info.erase(iter);
+  info.code_size = 0;
+  s_fastmem_backpatch_removed_count++;
   return Common::PageFaultHandler::HandlerResult::ContinueExecution;
 }
 
+bool CPU::CodeCache::IsFastmemDataWrite(const void* exception_pc, PhysicalMemoryAddress address)
+{
+  // Only stores which have backpatch info can be moved to the slow path. The RAM write handler goes around the page
+  // protection, and only invalidates the blocks it hits. Stores are at most a word, and granules are larger than that.
+  if (!FindBackpatchInfo(exception_pc))
+    return false;
+
+  const u32 index = Bus::GetRAMCodePageIndex(address);
+  const u64 write_mask = GetCodeGranuleMask(address & HOST_PAGE_MASK & ~3u, sizeof(u32));
+  return ((s_page_protection[index].code_granule_mask & write_mask) == 0);
+}
+
 bool CPU::CodeCache::HasPreviouslyFaultedOnPC(u32 guest_pc)
 {
   return (s_fastmem_faulting_pcs.find(guest_pc) != s_fastmem_faulting_pcs.end());
@@ -1690,28 +2181,66 @@ void CPU::CodeCache::BackpatchLoadStore(void* host_pc, const LoadstoreBackpatchI
 #endif
 }
 
-void CPU::CodeCache::RemoveBackpatchInfoForRange(const void* host_code, u32 size)
+CPU::CodeCache::LoadstoreBackpatchInfo* CPU::CodeCache::FindBackpatchInfo(const void* code_address)
 {
-  const u8* start = static_cast<const u8*>(host_code);
-  const u8* end = start + size;
+  const auto iter =
+    std::lower_bound(s_fastmem_backpatch_info.begin(), s_fastmem_backpatch_info.end(), code_address,
+                     [](const auto& it, const void* address) { return it.first < address; });
+  if (iter == s_fastmem_backpatch_info.end() || iter->first != code_address || iter->second.code_size == 0)
+    return nullptr;
 
-  auto start_iter = s_fastmem_backpatch_info.lower_bound(start);
-  if (start_iter == s_fastmem_backpatch_info.end())
+  return &iter->second;
+}
+
+void CPU::CodeCache::InsertBackpatchInfo(void* code_address, const LoadstoreBackpatchInfo& info)
+{
+  if (s_fastmem_backpatch_info.empty() || s_fastmem_backpatch_info.back().first < code_address) [[likely]]
+  {
+    s_fastmem_backpatch_info.emplace_back(code_address, info);
     return;
+  }
+
+  const auto iter =
+    std::lower_bound(s_fastmem_backpatch_info.begin(), s_fastmem_backpatch_info.end(), code_address,
+                     [](const auto& it, const void* address) { return it.first < address; });
+  if (iter != s_fastmem_backpatch_info.end() && iter->first == code_address)
+  {
+    if (iter->second.code_size == 0)
+      s_fastmem_backpatch_removed_count--;
 
-  // this might point to another block, so bail out in that case
-  if (start_iter->first >= end)
+    iter->second = info;
     return;
+  }
 
-  // find the end point, or last instruction in the range
-  auto end_iter = start_iter;
-  do
+  s_fastmem_backpatch_info.emplace(iter, code_address, info);
+}
+
+void CPU::CodeCache::RemoveBackpatchInfoForRange(const void* host_code, u32 size)
+{
+  const u8* start = static_cast<const u8*>(host_code);
+  const u8* end = start + size;
+
+  auto iter = std::lower_bound(s_fastmem_backpatch_info.begin(), s_fastmem_backpatch_info.end(), start,
+                               [](const auto& it, const u8* address) { return it.first < address; });
+  for (; iter != s_fastmem_backpatch_info.end() && iter->first < end; ++iter)
   {
-    ++end_iter;
-  } while (end_iter != s_fastmem_backpatch_info.end() && end_iter->first < end);
+    if (iter->second.code_size != 0)
+    {
+      iter->second.code_size = 0;
+      s_fastmem_backpatch_removed_count++;
+    }
+  }
+
+  if (s_fastmem_backpatch_removed_count > (s_fastmem_backpatch_info.size() / 2))
+    CompactBackpatchInfo();
+}
 
-  // erase the whole range at once
-  s_fastmem_backpatch_info.erase(start_iter, end_iter);
+void CPU::CodeCache::CompactBackpatchInfo()
+{
+  const auto new_end = std::remove_if(s_fastmem_backpatch_info.begin(), s_fastmem_backpatch_info.end(),
+                                      [](const auto& it) { return (it.second.code_size == 0); });
+  s_fastmem_backpatch_info.erase(new_end, s_fastmem_backpatch_info.end());
+  s_fastmem_backpatch_removed_count = 0;
 }
 
 #endif // ENABLE_RECOMPILER_SUPPORT
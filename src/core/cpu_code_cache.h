@@ -35,7 +35,19 @@ void Reset();
 /// Invalidates all blocks which are in the range of the specified code page.
 void InvalidateBlocksWithPageIndex(u32 page_index);
 
+/// Invalidates the blocks overlapping a RAM write which went around the write protection, e.g. from the debugger or
+/// cheats. The rest of the page stays protected, so writes to data next to code don't touch any blocks.
+void InvalidateBlocksWithRAMWrite(PhysicalMemoryAddress address, u32 size);
+
 /// Invalidates all blocks in the cache.
 void InvalidateAllRAMBlocks();
 
+/// Returns the number of cycles which have been skipped in idle loops since startup.
+u64 GetIdleLoopSkippedTicks();
+
+/// Compiles a function which runs a single GTE command with the new recompiler, for checking the generated code
+/// against the interpreter. Returns nullptr if the new recompiler isn't available on this host.
+using GTETestFunction = void (*)();
+GTETestFunction CompileGTECommandForTest(u32 inst_bits);
+
 } // namespace CPU::CodeCache
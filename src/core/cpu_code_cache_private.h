@@ -14,7 +14,6 @@
 #include "util/page_fault_handler.h"
 
 #include <array>
-#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -32,7 +31,6 @@ enum : u32
 
 using CodeLUT = const void**;
 using CodeLUTArray = std::array<CodeLUT, LUT_TABLE_COUNT>;
-using BlockLinkMap = std::unordered_multimap<u32, void*>; // TODO: try ordered?
 
 enum RegInfoFlags : u8
 {
@@ -96,6 +94,7 @@ enum class BlockFlags : u8
   ContainsLoadStoreInstructions = (1 << 0),
   SpansPages = (1 << 1),
   BranchDelaySpansPages = (1 << 2),
+  IdleLoop = (1 << 3),
 };
 IMPLEMENT_ENUM_CLASS_BITWISE_OPERATORS(BlockFlags);
 
@@ -106,6 +105,9 @@ enum class PageProtectionMode : u8
   Unprotected,
 };
 
+/// Instruction handler with the opcode already decoded, filled in by the cached interpreter.
+using CachedInterpreterHandler = void (*)();
+
 struct BlockMetadata
 {
   TickCount uncached_fetch_ticks;
@@ -113,6 +115,17 @@ struct BlockMetadata
   BlockFlags flags;
 };
 
+/// Jump in a block's host code to another guest PC. Links to the same PC form a list, which is walked when the
+/// destination is compiled or invalidated. The nodes live in the source block, so unlinking doesn't need a lookup.
+struct BlockLink
+{
+  void* code;
+  BlockLink* next;
+  BlockLink** prev_next;
+};
+
+using BlockLinkMap = std::unordered_map<u32, BlockLink*>;
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4324) // C4324: 'CPU::CodeCache::Block': structure was padded due to alignment specifier)
@@ -120,29 +133,30 @@ struct BlockMetadata
 
 struct alignas(16) Block
 {
+  // Everything needed for lookup, dispatch and invalidation comes first, so it shares a cache line.
   u32 pc;
   u32 size; // in guest instructions
   const void* host_code;
 
-  // links to previous/next block within page
-  Block* next_block_in_page;
-
-  BlockLinkMap::iterator exit_links[MAX_BLOCK_EXIT_LINKS];
-  u8 num_exit_links;
-
-  // TODO: Move up so it's part of the same cache line
   BlockState state;
   BlockFlags flags;
   PageProtectionMode protection;
+  u8 num_exit_links;
 
   TickCount uncached_fetch_ticks;
   u32 icache_line_count;
 
+  // links to previous/next block within page
+  Block* next_block_in_page;
+
   u32 host_code_size;
   u32 compile_frame;
   u8 compile_count;
+  u8 size_class; // storage is allocated for (1 << size_class) instructions
+
+  BlockLink exit_links[MAX_BLOCK_EXIT_LINKS];
 
-  // followed by Instruction * size, InstructionRegInfo * size
+  // followed by Instruction * size, InstructionRegInfo * size, CachedInterpreterHandler * size
   ALWAYS_INLINE const Instruction* Instructions() const { return reinterpret_cast<const Instruction*>(this + 1); }
   ALWAYS_INLINE Instruction* Instructions() { return reinterpret_cast<Instruction*>(this + 1); }
 
@@ -155,6 +169,15 @@ struct alignas(16) Block
     return reinterpret_cast<InstructionInfo*>(Instructions() + size);
   }
 
+  ALWAYS_INLINE const CachedInterpreterHandler* CachedInterpreterHandlers() const
+  {
+    return reinterpret_cast<const CachedInterpreterHandler*>(InstructionsInfo() + size);
+  }
+  ALWAYS_INLINE CachedInterpreterHandler* CachedInterpreterHandlers()
+  {
+    return reinterpret_cast<CachedInterpreterHandler*>(InstructionsInfo() + size);
+  }
+
   // returns true if the block has a given flag
   ALWAYS_INLINE bool HasFlag(BlockFlags flag) const { return ((flags & flag) != BlockFlags::None); }
 
@@ -172,6 +195,10 @@ struct alignas(16) Block
 #pragma warning(pop)
 #endif
 
+static_assert(((sizeof(Instruction) + sizeof(InstructionInfo)) % alignof(CachedInterpreterHandler)) == 0,
+              "Cached interpreter handlers are aligned");
+static_assert((offsetof(Block, next_block_in_page) + sizeof(Block*)) <= 64, "Hot block fields fit in a cache line");
+
 using BlockLUTArray = std::array<Block**, LUT_TABLE_COUNT>;
 
 struct LoadstoreBackpatchInfo
@@ -210,16 +237,26 @@ static inline bool AddressInRAM(VirtualMemoryAddress pc)
   return VirtualAddressToPhysical(pc) < Bus::g_ram_size;
 }
 
+/// Code in a page is tracked in 64 granules, so writes can be matched against the blocks they actually hit.
+static constexpr u32 CODE_GRANULE_SIZE = HOST_PAGE_SIZE / 64;
+
 struct PageProtectionInfo
 {
   Block* first_block_in_page;
   Block* last_block_in_page;
 
-  PageProtectionMode mode;
-  u16 invalidate_count;
+  // Granules covered by blocks in the list. Only grows until the list is cleared, so it may be a superset.
+  u64 code_granule_mask;
+
   u32 invalidate_frame;
+  u16 invalidate_count;
+  u16 data_write_count;
+  PageProtectionMode mode;
 };
-static_assert(sizeof(PageProtectionInfo) == (sizeof(Block*) * 2 + 8));
+static_assert(sizeof(PageProtectionInfo) <= (sizeof(Block*) * 2 + 24));
+
+template<PGXPMode pgxp_mode>
+void DecodeCachedInterpreterBlock(Block* block);
 
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const Block* block);
@@ -249,6 +286,9 @@ void CompileOrRevalidateBlock(u32 start_pc);
 void DiscardAndRecompileBlock(u32 start_pc);
 const void* CreateBlockLink(Block* from_block, void* code, u32 newpc);
 
+/// Called when an idle loop block is about to branch back to itself, fast-forwards to the next event.
+void SkipIdleLoop();
+
 void AddLoadStoreInfo(void* code_address, u32 code_size, u32 guest_pc, const void* thunk_address);
 void AddLoadStoreInfo(void* code_address, u32 code_size, u32 guest_pc, u32 guest_block, TickCount cycles,
                       u32 gpr_bitmask, u8 address_register, u8 data_register, MemoryAccessSize size, bool is_signed,
@@ -22,7 +22,9 @@
 #include "common/file_system.h"
 #include "common/log.h"
 
+#include <array>
 #include <cstdio>
+#include <utility>
 
 Log_SetChannel(CPU::Core);
 
@@ -68,7 +70,13 @@ static void HandlePutcSyscall();
 static void HandlePutsSyscall();
 static void ExecuteDebug();
 
-template<PGXPMode pgxp_mode, bool debug>
+// The cached interpreter decodes instructions when blocks are created, and passes the opcode as a template parameter
+// so the dispatch switch folds away. Primary opcodes are 0-63, SPECIAL instructions are 64 + funct.
+static constexpr u32 DECODED_FUNCT_OFFSET = 64;
+static constexpr u32 NUM_DECODED_OPS = 128;
+static constexpr u32 UNDECODED_OP = NUM_DECODED_OPS;
+
+template<PGXPMode pgxp_mode, bool debug, u32 decoded_op = UNDECODED_OP>
 static void ExecuteInstruction();
 
 template<PGXPMode pgxp_mode, bool debug>
@@ -939,7 +947,7 @@ void CPU::DisassembleAndPrint(u32 addr, u32 instructions_before /* = 0 */, u32 i
   }
 }
 
-template<PGXPMode pgxp_mode, bool debug>
+template<PGXPMode pgxp_mode, bool debug, u32 decoded_op>
 ALWAYS_INLINE_RELEASE void CPU::ExecuteInstruction()
 {
 restart_instruction:
@@ -962,11 +970,17 @@ restart_instruction:
   if (inst.bits == 0)
     return;
 
-  switch (inst.op)
+  const InstructionOp op = (decoded_op == UNDECODED_OP) ? inst.op.GetValue() :
+                           (decoded_op >= DECODED_FUNCT_OFFSET) ? InstructionOp::funct :
+                                                                  static_cast<InstructionOp>(decoded_op);
+  switch (op)
   {
     case InstructionOp::funct:
     {
-      switch (inst.r.funct)
+      const InstructionFunct funct = (decoded_op == UNDECODED_OP) ?
+                                       inst.r.funct.GetValue() :
+                                       static_cast<InstructionFunct>(decoded_op - DECODED_FUNCT_OFFSET);
+      switch (funct)
       {
         case InstructionFunct::sll:
         {
@@ -1940,6 +1954,11 @@ restart_instruction:
         Log_ErrorPrintf("Stale icache at 0x%08X - ICache: %08X RAM: %08X", g_state.current_instruction_pc,
                         g_state.current_instruction.bits, ram_value);
         g_state.current_instruction.bits = ram_value;
+
+        // Decoded instructions have to go back through the opcode switch.
+        if constexpr (decoded_op != UNDECODED_OP)
+          return ExecuteInstruction<pgxp_mode, debug>();
+
         goto restart_instruction;
       }
 
@@ -2429,6 +2448,38 @@ void CPU::SetSingleStepFlag()
     System::InterruptExecution();
 }
 
+namespace CPU {
+template<PGXPMode pgxp_mode, u32... ops>
+static constexpr std::array<CodeCache::CachedInterpreterHandler, sizeof...(ops)>
+MakeCachedInterpreterHandlers(std::integer_sequence<u32, ops...>)
+{
+  return {{&ExecuteInstruction<pgxp_mode, false, ops>...}};
+}
+
+template<PGXPMode pgxp_mode>
+static constexpr std::array<CodeCache::CachedInterpreterHandler, NUM_DECODED_OPS> s_cached_interpreter_handlers =
+  MakeCachedInterpreterHandlers<pgxp_mode>(std::make_integer_sequence<u32, NUM_DECODED_OPS>());
+} // namespace CPU
+
+template<PGXPMode pgxp_mode>
+void CPU::CodeCache::DecodeCachedInterpreterBlock(Block* block)
+{
+  const Instruction* instruction = block->Instructions();
+  CachedInterpreterHandler* handler = block->CachedInterpreterHandlers();
+  for (u32 i = 0; i < block->size; i++, instruction++, handler++)
+  {
+    const u32 op = static_cast<u32>(instruction->op.GetValue());
+    const u32 decoded_op = (op == static_cast<u32>(InstructionOp::funct)) ?
+                             (DECODED_FUNCT_OFFSET + static_cast<u32>(instruction->r.funct.GetValue())) :
+                             op;
+    *handler = s_cached_interpreter_handlers<pgxp_mode>[decoded_op];
+  }
+}
+
+template void CPU::CodeCache::DecodeCachedInterpreterBlock<PGXPMode::Disabled>(Block* block);
+template void CPU::CodeCache::DecodeCachedInterpreterBlock<PGXPMode::Memory>(Block* block);
+template void CPU::CodeCache::DecodeCachedInterpreterBlock<PGXPMode::CPU>(Block* block);
+
 template<PGXPMode pgxp_mode>
 void CPU::CodeCache::InterpretCachedBlock(const Block* block)
 {
@@ -2439,6 +2490,7 @@ void CPU::CodeCache::InterpretCachedBlock(const Block* block)
   const Instruction* instruction = block->Instructions();
   const Instruction* end_instruction = instruction + block->size;
   const CodeCache::InstructionInfo* info = block->InstructionsInfo();
+  const CachedInterpreterHandler* handler = block->CachedInterpreterHandlers();
 
   do
   {
@@ -2456,8 +2508,8 @@ void CPU::CodeCache::InterpretCachedBlock(const Block* block)
     g_state.pc = g_state.npc;
     g_state.npc += 4;
 
-    // execute the instruction we previously fetched
-    ExecuteInstruction<pgxp_mode, false>();
+    // execute the instruction we previously fetched, the opcode was decoded when the block was created
+    (*handler)();
 
     // next load delay
     UpdateLoadDelay();
@@ -2467,6 +2519,7 @@ void CPU::CodeCache::InterpretCachedBlock(const Block* block)
 
     instruction++;
     info++;
+    handler++;
   } while (instruction != end_instruction);
 
   // cleanup so the interpreter can kick in if needed
@@ -2843,72 +2896,55 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
 {
   using namespace Bus;
 
-  switch (address >> 29)
+  // Only the first 512MB of KUSEG, KSEG0 and KSEG1 map to physical memory, everything else raises an exception.
+  // Testing the segment against a bitmask avoids a jump table on every access.
+  static constexpr u32 PHYSICAL_SEGMENTS = (1u << 0x00) | (1u << 0x04) | (1u << 0x05);
+  if (!((PHYSICAL_SEGMENTS >> (address >> 29)) & 1u)) [[unlikely]]
+    return false;
+
+  // The scratchpad mask includes bit 29, so KSEG1 addresses never match it.
+  if ((address & SCRATCHPAD_ADDR_MASK) == SCRATCHPAD_ADDR)
   {
-    case 0x00: // KUSEG 0M-512M
-    case 0x04: // KSEG0 - physical memory cached
+    const u32 offset = address & SCRATCHPAD_OFFSET_MASK;
+
+    if constexpr (type == MemoryAccessType::Read)
     {
-      if ((address & SCRATCHPAD_ADDR_MASK) == SCRATCHPAD_ADDR)
+      if constexpr (size == MemoryAccessSize::Byte)
       {
-        const u32 offset = address & SCRATCHPAD_OFFSET_MASK;
-
-        if constexpr (type == MemoryAccessType::Read)
-        {
-          if constexpr (size == MemoryAccessSize::Byte)
-          {
-            value = CPU::g_state.scratchpad[offset];
-          }
-          else if constexpr (size == MemoryAccessSize::HalfWord)
-          {
-            u16 temp;
-            std::memcpy(&temp, &CPU::g_state.scratchpad[offset], sizeof(u16));
-            value = ZeroExtend32(temp);
-          }
-          else if constexpr (size == MemoryAccessSize::Word)
-          {
-            std::memcpy(&value, &CPU::g_state.scratchpad[offset], sizeof(u32));
-          }
-        }
-        else
-        {
-          if constexpr (size == MemoryAccessSize::Byte)
-          {
-            CPU::g_state.scratchpad[offset] = Truncate8(value);
-          }
-          else if constexpr (size == MemoryAccessSize::HalfWord)
-          {
-            std::memcpy(&CPU::g_state.scratchpad[offset], &value, sizeof(u16));
-          }
-          else if constexpr (size == MemoryAccessSize::Word)
-          {
-            std::memcpy(&CPU::g_state.scratchpad[offset], &value, sizeof(u32));
-          }
-        }
-
-        return true;
+        value = CPU::g_state.scratchpad[offset];
+      }
+      else if constexpr (size == MemoryAccessSize::HalfWord)
+      {
+        u16 temp;
+        std::memcpy(&temp, &CPU::g_state.scratchpad[offset], sizeof(u16));
+        value = ZeroExtend32(temp);
+      }
+      else if constexpr (size == MemoryAccessSize::Word)
+      {
+        std::memcpy(&value, &CPU::g_state.scratchpad[offset], sizeof(u32));
       }
-
-      address &= PHYSICAL_MEMORY_ADDRESS_MASK;
     }
-    break;
-
-    case 0x01: // KUSEG 512M-1024M
-    case 0x02: // KUSEG 1024M-1536M
-    case 0x03: // KUSEG 1536M-2048M
-    case 0x06: // KSEG2
-    case 0x07: // KSEG2
+    else
     {
-      // Above 512mb raises an exception.
-      return false;
+      if constexpr (size == MemoryAccessSize::Byte)
+      {
+        CPU::g_state.scratchpad[offset] = Truncate8(value);
+      }
+      else if constexpr (size == MemoryAccessSize::HalfWord)
+      {
+        std::memcpy(&CPU::g_state.scratchpad[offset], &value, sizeof(u16));
+      }
+      else if constexpr (size == MemoryAccessSize::Word)
+      {
+        std::memcpy(&CPU::g_state.scratchpad[offset], &value, sizeof(u32));
+      }
     }
 
-    case 0x05: // KSEG1 - physical memory uncached
-    {
-      address &= PHYSICAL_MEMORY_ADDRESS_MASK;
-    }
-    break;
+    return true;
   }
 
+  address &= PHYSICAL_MEMORY_ADDRESS_MASK;
+
   if (address < RAM_MIRROR_END)
   {
     const u32 offset = address & g_ram_mask;
@@ -2939,7 +2975,7 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         {
           g_unprotected_ram[offset] = Truncate8(value);
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksWithRAMWrite(offset, sizeof(u8));
         }
       }
       else if constexpr (size == MemoryAccessSize::HalfWord)
@@ -2951,7 +2987,7 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         {
           std::memcpy(&g_unprotected_ram[offset], &new_value, sizeof(u16));
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksWithRAMWrite(offset, sizeof(u16));
         }
       }
       else if constexpr (size == MemoryAccessSize::Word)
@@ -2962,7 +2998,7 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         {
           std::memcpy(&g_unprotected_ram[offset], &value, sizeof(u32));
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksWithRAMWrite(offset, sizeof(u32));
         }
       }
     }
@@ -147,6 +147,48 @@ const void* CPU::NewRec::Compiler::CompileBlock(CodeCache::Block* block, u32* ho
   return code;
 }
 
+const void* CPU::NewRec::Compiler::CompileGTECommandForTest(u32 inst_bits)
+{
+  // Only the PC is used from the block.
+  CodeCache::Block block = {};
+  Instruction instruction;
+  instruction.bits = (static_cast<u32>(InstructionOp::cop2) << 26) | (1u << 25) |
+                     (inst_bits & GTE::Instruction::REQUIRED_BITS_MASK);
+
+  JitCodeBuffer& buffer = CodeCache::GetCodeBuffer();
+  Reset(&block, buffer.GetFreeCodePointer(), buffer.GetFreeCodeSpace(), buffer.GetFreeFarCodePointer(),
+        buffer.GetFreeFarCodeSpace());
+
+  u32 code_size, far_code_size;
+  if (!GenerateTestFunctionPrologue())
+  {
+    EndCompile(&code_size, &far_code_size);
+    return nullptr;
+  }
+
+  inst = &instruction;
+  Compile_cop2(CompileFlags{});
+  inst = nullptr;
+  GenerateTestFunctionEpilogue();
+
+  for (u32 i = 0; i < NUM_HOST_REGS; i++)
+    DebugAssert(!IsHostRegAllocated(i));
+
+  const void* code = EndCompile(&code_size, &far_code_size);
+  buffer.CommitCode(code_size);
+  buffer.CommitFarCode(far_code_size);
+  return code;
+}
+
+bool CPU::NewRec::Compiler::GenerateTestFunctionPrologue()
+{
+  return false;
+}
+
+void CPU::NewRec::Compiler::GenerateTestFunctionEpilogue()
+{
+}
+
 void CPU::NewRec::Compiler::SetConstantReg(Reg r, u32 v)
 {
   DebugAssert(r < Reg::count && r != Reg::zero);
@@ -1231,10 +1273,10 @@ void CPU::NewRec::Compiler::CompileInstruction()
         case InstructionFunct::multu: CompileTemplate(&Compiler::Compile_multu_const, &Compiler::Compile_multu, PGXPFN(CPU_MULTU), TF_READS_S | TF_READS_T | TF_WRITES_LO | TF_WRITES_HI | TF_COMMUTATIVE); SpecExec_multu(); break;
         case InstructionFunct::div: CompileTemplate(&Compiler::Compile_div_const, &Compiler::Compile_div, PGXPFN(CPU_DIV), TF_READS_S | TF_READS_T | TF_WRITES_LO | TF_WRITES_HI); SpecExec_div(); break;
         case InstructionFunct::divu: CompileTemplate(&Compiler::Compile_divu_const, &Compiler::Compile_divu, PGXPFN(CPU_DIVU), TF_READS_S | TF_READS_T | TF_WRITES_LO | TF_WRITES_HI); SpecExec_divu(); break;
-        case InstructionFunct::add: CompileTemplate(&Compiler::Compile_add_const, &Compiler::Compile_add, PGXPFN(CPU_ADD), TF_WRITES_D | TF_READS_S | TF_READS_T | TF_COMMUTATIVE | TF_CAN_OVERFLOW | TF_RENAME_WITH_ZERO_T); SpecExec_add(); break;
-        case InstructionFunct::addu: CompileTemplate(&Compiler::Compile_addu_const, &Compiler::Compile_addu, PGXPFN(CPU_ADD), TF_WRITES_D | TF_READS_S | TF_READS_T | TF_COMMUTATIVE | TF_RENAME_WITH_ZERO_T); SpecExec_addu(); break;
-        case InstructionFunct::sub: CompileTemplate(&Compiler::Compile_sub_const, &Compiler::Compile_sub, PGXPFN(CPU_SUB), TF_WRITES_D | TF_READS_S | TF_READS_T | TF_CAN_OVERFLOW | TF_RENAME_WITH_ZERO_T); SpecExec_sub(); break;
-        case InstructionFunct::subu: CompileTemplate(&Compiler::Compile_subu_const, &Compiler::Compile_subu, PGXPFN(CPU_SUB), TF_WRITES_D | TF_READS_S | TF_READS_T | TF_RENAME_WITH_ZERO_T); SpecExec_subu(); break;
+        case InstructionFunct::add: CompileTemplate(&Compiler::Compile_add_const, &Compiler::Compile_add, PGXPFN(CPU_ADD), TF_PGXP_ADD_SUB | TF_WRITES_D | TF_READS_S | TF_READS_T | TF_COMMUTATIVE | TF_CAN_OVERFLOW | TF_RENAME_WITH_ZERO_T); SpecExec_add(); break;
+        case InstructionFunct::addu: CompileTemplate(&Compiler::Compile_addu_const, &Compiler::Compile_addu, PGXPFN(CPU_ADD), TF_PGXP_ADD_SUB | TF_WRITES_D | TF_READS_S | TF_READS_T | TF_COMMUTATIVE | TF_RENAME_WITH_ZERO_T); SpecExec_addu(); break;
+        case InstructionFunct::sub: CompileTemplate(&Compiler::Compile_sub_const, &Compiler::Compile_sub, PGXPFN(CPU_SUB), TF_PGXP_ADD_SUB | TF_WRITES_D | TF_READS_S | TF_READS_T | TF_CAN_OVERFLOW | TF_RENAME_WITH_ZERO_T); SpecExec_sub(); break;
+        case InstructionFunct::subu: CompileTemplate(&Compiler::Compile_subu_const, &Compiler::Compile_subu, PGXPFN(CPU_SUB), TF_PGXP_ADD_SUB | TF_WRITES_D | TF_READS_S | TF_READS_T | TF_RENAME_WITH_ZERO_T); SpecExec_subu(); break;
         case InstructionFunct::and_: CompileTemplate(&Compiler::Compile_and_const, &Compiler::Compile_and, PGXPFN(CPU_AND_), TF_WRITES_D | TF_READS_S | TF_READS_T | TF_COMMUTATIVE); SpecExec_and(); break;
         case InstructionFunct::or_: CompileTemplate(&Compiler::Compile_or_const, &Compiler::Compile_or, PGXPFN(CPU_OR_), TF_WRITES_D | TF_READS_S | TF_READS_T | TF_COMMUTATIVE | TF_RENAME_WITH_ZERO_T); SpecExec_or(); break;
         case InstructionFunct::xor_: CompileTemplate(&Compiler::Compile_xor_const, &Compiler::Compile_xor, PGXPFN(CPU_XOR_), TF_WRITES_D | TF_READS_S | TF_READS_T | TF_COMMUTATIVE | TF_RENAME_WITH_ZERO_T); SpecExec_xor(); break;
@@ -1255,8 +1297,8 @@ void CPU::NewRec::Compiler::CompileInstruction()
     case InstructionOp::beq: CompileTemplate(&Compiler::Compile_beq_const, &Compiler::Compile_beq, nullptr, TF_READS_S | TF_READS_T | TF_COMMUTATIVE | TF_CAN_SWAP_DELAY_SLOT); break;
     case InstructionOp::bne: CompileTemplate(&Compiler::Compile_bne_const, &Compiler::Compile_bne, nullptr, TF_READS_S | TF_READS_T | TF_COMMUTATIVE | TF_CAN_SWAP_DELAY_SLOT); break;
 
-    case InstructionOp::addi: CompileTemplate(&Compiler::Compile_addi_const, &Compiler::Compile_addi, PGXPFN(CPU_ADDI), TF_WRITES_T | TF_READS_S | TF_COMMUTATIVE | TF_CAN_OVERFLOW | TF_RENAME_WITH_ZERO_IMM); SpecExec_addi(); break;
-    case InstructionOp::addiu: CompileTemplate(&Compiler::Compile_addiu_const, &Compiler::Compile_addiu, PGXPFN(CPU_ADDI), TF_WRITES_T | TF_READS_S | TF_COMMUTATIVE | TF_RENAME_WITH_ZERO_IMM); SpecExec_addiu(); break;
+    case InstructionOp::addi: CompileTemplate(&Compiler::Compile_addi_const, &Compiler::Compile_addi, PGXPFN(CPU_ADDI), TF_PGXP_ADD_SUB | TF_WRITES_T | TF_READS_S | TF_COMMUTATIVE | TF_CAN_OVERFLOW | TF_RENAME_WITH_ZERO_IMM); SpecExec_addi(); break;
+    case InstructionOp::addiu: CompileTemplate(&Compiler::Compile_addiu_const, &Compiler::Compile_addiu, PGXPFN(CPU_ADDI), TF_PGXP_ADD_SUB | TF_WRITES_T | TF_READS_S | TF_COMMUTATIVE | TF_RENAME_WITH_ZERO_IMM); SpecExec_addiu(); break;
     case InstructionOp::slti: CompileTemplate(&Compiler::Compile_slti_const, &Compiler::Compile_slti, PGXPFN(CPU_SLTI), TF_WRITES_T | TF_READS_S); SpecExec_slti(); break;
     case InstructionOp::sltiu: CompileTemplate(&Compiler::Compile_sltiu_const, &Compiler::Compile_sltiu, PGXPFN(CPU_SLTIU), TF_WRITES_T | TF_READS_S); SpecExec_sltiu(); break;
     case InstructionOp::andi: CompileTemplate(&Compiler::Compile_andi_const, &Compiler::Compile_andi, PGXPFN(CPU_ANDI), TF_WRITES_T | TF_READS_S | TF_COMMUTATIVE); SpecExec_andi(); break;
@@ -1422,7 +1464,15 @@ void CPU::NewRec::Compiler::CompileTemplate(void (Compiler::*const_func)(Compile
     return;
   }
 
-  if (pgxp_cpu_func && g_settings.gpu_pgxp_enable && ((tflags & TF_PGXP_WITHOUT_CPU) || g_settings.UsingPGXPCPUMode()))
+  if (pgxp_cpu_func && g_settings.gpu_pgxp_enable && (tflags & TF_PGXP_ADD_SUB) && g_settings.UsingPGXPCPUMode())
+  {
+    if (tflags & TF_WRITES_T)
+      GeneratePGXPAddImmediate(rt, rs, inst->i.imm_sext32());
+    else
+      GeneratePGXPAddSub(rd, rs, rt, inst->r.funct == InstructionFunct::sub || inst->r.funct == InstructionFunct::subu);
+  }
+  else if (pgxp_cpu_func && g_settings.gpu_pgxp_enable &&
+           ((tflags & TF_PGXP_WITHOUT_CPU) || g_settings.UsingPGXPCPUMode()))
   {
     std::array<Reg, 2> reg_args = {{Reg::count, Reg::count}};
     u32 num_reg_args = 0;
@@ -1728,6 +1778,40 @@ void CPU::NewRec::Compiler::FlushForLoadStore(const std::optional<VirtualMemoryA
   Flush(FLUSH_FOR_C_CALL | FLUSH_FOR_LOADSTORE);
 }
 
+std::optional<CPU::NewRec::Compiler::ConstantMemoryAccess>
+CPU::NewRec::Compiler::GetConstantMemoryAccess(const std::optional<VirtualMemoryAddress>& address,
+                                               MemoryAccessSize size, bool store)
+{
+  // Checked accesses need the thunk to raise the exception.
+  if (!address.has_value() || g_settings.cpu_recompiler_memory_exceptions)
+    return std::nullopt;
+
+  const VirtualMemoryAddress addr = address.value();
+  if ((addr & ((1u << static_cast<u32>(size)) - 1u)) != 0)
+    return std::nullopt;
+
+  ConstantMemoryAccess ret;
+  const Segment seg = GetSegmentForAddress(addr);
+  ret.check_isc = (seg == Segment::KUSEG || seg == Segment::KSEG0);
+  ret.scratchpad_offset = 0;
+
+  if ((addr & SCRATCHPAD_ADDR_MASK) == SCRATCHPAD_ADDR)
+  {
+    ret.handler = nullptr;
+    ret.scratchpad_offset = addr & SCRATCHPAD_OFFSET_MASK;
+    return ret;
+  }
+
+  // Handlers only change with SR.Isc, which check_isc covers, and the RAM size, which resets the code cache. Hardware
+  // registers call the device's handler directly, e.g. GPUSTAT goes straight to GPU::ReadRegister().
+  if (store)
+    ret.handler = reinterpret_cast<const void*>(Bus::GetConstantAddressWriteHandler(addr, size));
+  else
+    ret.handler = reinterpret_cast<const void*>(Bus::GetConstantAddressReadHandler(addr, size));
+
+  return ret;
+}
+
 void CPU::NewRec::Compiler::CompileMoveRegTemplate(Reg dst, Reg src, bool pgxp_move)
 {
   if (dst == src || dst == Reg::zero)
@@ -1753,11 +1837,42 @@ void CPU::NewRec::Compiler::CompileMoveRegTemplate(Reg dst, Reg src, bool pgxp_m
   if (g_settings.gpu_pgxp_enable && pgxp_move)
   {
     // might've been renamed, so use dst here
-    GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_MOVE_Packed), PGXP::PackMoveArgs(dst, src),
-                                 dst);
+    GeneratePGXPMove(dst, src);
   }
 }
 
+void CPU::NewRec::Compiler::GenerateIdleLoopSkip(const std::optional<u32>& newpc)
+{
+  if (newpc != m_block->pc || !m_block->HasFlag(CodeCache::BlockFlags::IdleLoop))
+    return;
+
+  Flush(FLUSH_CYCLES | FLUSH_GTE_DONE_CYCLE);
+  GenerateCall(reinterpret_cast<const void*>(&CodeCache::SkipIdleLoop));
+}
+
+void CPU::NewRec::Compiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_MOVE_Packed), PGXP::PackMoveArgs(dst, src),
+                               dst);
+}
+
+void CPU::NewRec::Compiler::GeneratePGXPLoadUpper(Reg rt, u16 imm)
+{
+  GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_LUI), inst->bits);
+}
+
+void CPU::NewRec::Compiler::GeneratePGXPAddSub(Reg rd, Reg rs, Reg rt, bool sub)
+{
+  GeneratePGXPCallWithMIPSRegs(sub ? reinterpret_cast<const void*>(&PGXP::CPU_SUB) :
+                                     reinterpret_cast<const void*>(&PGXP::CPU_ADD),
+                               inst->bits, rs, rt);
+}
+
+void CPU::NewRec::Compiler::GeneratePGXPAddImmediate(Reg rt, Reg rs, u32 imm)
+{
+  GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_ADDI), inst->bits, rs);
+}
+
 void CPU::NewRec::Compiler::Compile_j()
 {
   const u32 newpc = (m_compiler_pc & UINT32_C(0xF0000000)) | (inst->j.target << 2);
@@ -2158,7 +2273,7 @@ void CPU::NewRec::Compiler::Compile_lui()
   SetConstantReg(inst->i.rt, inst->i.imm_zext32() << 16);
 
   if (g_settings.UsingPGXPCPUMode())
-    GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_LUI), inst->bits);
+    GeneratePGXPLoadUpper(inst->i.rt, inst->i.imm);
 }
 
 static constexpr const std::array<std::pair<u32*, u32>, 16> s_cop0_table = {
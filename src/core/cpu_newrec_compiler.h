@@ -41,6 +41,10 @@ public:
 
   const void* CompileBlock(CodeCache::Block* block, u32* host_code_size, u32* host_far_code_size);
 
+  /// Compiles a function which runs a single GTE command the same way a block would, callable from C. Used to check
+  /// the generated code against the interpreter. Returns nullptr if the backend can't generate standalone functions.
+  const void* CompileGTECommandForTest(u32 inst_bits);
+
 protected:
   enum FlushFlags : u32
   {
@@ -134,6 +138,7 @@ protected:
     TF_RENAME_WITH_ZERO_IMM = (1 << 17),
 
     TF_PGXP_WITHOUT_CPU = (1 << 18),
+    TF_PGXP_ADD_SUB = (1 << 19), // the PGXP function is CPU_ADD/CPU_SUB/CPU_ADDI, which backends can generate inline
   };
 
   enum HostRegFlags : u8
@@ -201,6 +206,10 @@ protected:
   void SetCompilerPC(u32 newpc);
   void TruncateBlock();
 
+  /// Fast-forwards to the next event when an idle loop branches back to itself. Cycles must be committed first, since
+  /// the skip is based on pending_ticks.
+  void GenerateIdleLoopSkip(const std::optional<u32>& newpc);
+
   virtual const void* GetCurrentCodePointer() = 0;
 
   virtual void Reset(CodeCache::Block* block, u8* code_buffer, u32 code_buffer_space, u8* far_code_buffer,
@@ -213,6 +222,10 @@ protected:
   virtual void EndBlockWithException(Exception excode) = 0;
   virtual const void* EndCompile(u32* code_size, u32* far_code_size) = 0;
 
+  /// Entry/exit for standalone test functions, which need the same host state a block is entered with.
+  virtual bool GenerateTestFunctionPrologue();
+  virtual void GenerateTestFunctionEpilogue();
+
   ALWAYS_INLINE bool IsHostRegAllocated(u32 r) const { return (m_host_regs[r].flags & HR_ALLOCATED) != 0; }
   static const char* GetReadWriteModeString(u32 flags);
   virtual const char* GetHostRegName(u32 reg) const = 0;
@@ -273,11 +286,27 @@ protected:
                                                        const std::optional<VirtualMemoryAddress>&),
                                 MemoryAccessSize size, bool store, bool sign, u32 tflags);
   void FlushForLoadStore(const std::optional<VirtualMemoryAddress>& address, bool store, bool use_fastmem);
+
+  /// Slowmem access to an address known at compile time, which can skip the thunk and handler lookup.
+  struct ConstantMemoryAccess
+  {
+    const void* handler;   // nullptr for scratchpad, which is accessed inline
+    u32 scratchpad_offset; // offset into g_state.scratchpad
+    bool check_isc;        // KUSEG/KSEG0 go to the icache instead while SR.Isc is set
+  };
+  static std::optional<ConstantMemoryAccess> GetConstantMemoryAccess(const std::optional<VirtualMemoryAddress>& address,
+                                                                     MemoryAccessSize size, bool store);
   void CompileMoveRegTemplate(Reg dst, Reg src, bool pgxp_move);
 
   virtual void GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1val, Reg arg2reg = Reg::count,
                                             Reg arg3reg = Reg::count) = 0;
 
+  // Backends can override these to update the PGXP registers inline, instead of calling the C implementations.
+  virtual void GeneratePGXPMove(Reg dst, Reg src);
+  virtual void GeneratePGXPLoadUpper(Reg rt, u16 imm);
+  virtual void GeneratePGXPAddSub(Reg rd, Reg rs, Reg rt, bool sub);
+  virtual void GeneratePGXPAddImmediate(Reg rt, Reg rs, u32 imm);
+
   virtual void Compile_Fallback() = 0;
 
   void Compile_j();
@@ -370,6 +370,7 @@ void CPU::NewRec::AArch32Compiler::EndBlock(const std::optional<u32>& newpc, boo
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+  GenerateIdleLoopSkip(newpc);
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
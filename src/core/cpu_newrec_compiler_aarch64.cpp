@@ -13,6 +13,7 @@
 #include "gte.h"
 #include "settings.h"
 #include "timing_event.h"
+#include <climits>
 #include <limits>
 
 #ifdef CPU_ARCH_ARM64
@@ -46,6 +47,34 @@ CPU::NewRec::AArch64Compiler::AArch64Compiler()
 
 CPU::NewRec::AArch64Compiler::~AArch64Compiler() = default;
 
+bool CPU::NewRec::AArch64Compiler::GenerateTestFunctionPrologue()
+{
+  // Any callee-saved register can be allocated, including the frame pointer, so they all need saving.
+  armAsm->stp(x29, x30, MemOperand(sp, -96, PreIndex));
+  armAsm->stp(x19, x20, MemOperand(sp, 16));
+  armAsm->stp(x21, x22, MemOperand(sp, 32));
+  armAsm->stp(x23, x24, MemOperand(sp, 48));
+  armAsm->stp(x25, x26, MemOperand(sp, 64));
+  armAsm->stp(x27, x28, MemOperand(sp, 80));
+
+  armMoveAddressToReg(armAsm, RSTATE, &g_state);
+  if (CodeCache::IsUsingFastmem())
+    armAsm->ldr(RMEMBASE, PTR(&g_state.fastmem_base));
+
+  return true;
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateTestFunctionEpilogue()
+{
+  armAsm->ldp(x27, x28, MemOperand(sp, 80));
+  armAsm->ldp(x25, x26, MemOperand(sp, 64));
+  armAsm->ldp(x23, x24, MemOperand(sp, 48));
+  armAsm->ldp(x21, x22, MemOperand(sp, 32));
+  armAsm->ldp(x19, x20, MemOperand(sp, 16));
+  armAsm->ldp(x29, x30, MemOperand(sp, 96, PostIndex));
+  armAsm->ret();
+}
+
 const void* CPU::NewRec::AArch64Compiler::GetCurrentCodePointer()
 {
   return armAsm->GetCursorAddress<const void*>();
@@ -342,6 +371,7 @@ void CPU::NewRec::AArch64Compiler::EndBlock(const std::optional<u32>& newpc, boo
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+  GenerateIdleLoopSkip(newpc);
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
@@ -597,6 +627,335 @@ void CPU::NewRec::AArch64Compiler::GeneratePGXPCallWithMIPSRegs(const void* func
   EmitCall(func);
 }
 
+void CPU::NewRec::AArch64Compiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  // Same as PGXP::CPU_MOVE(). Doesn't need any flushing, the ARG registers are never allocated.
+  PGXP_value* const dst_ptr = &g_state.pgxp_gpr[static_cast<u8>(dst)];
+  PGXP_value* const src_ptr = &g_state.pgxp_gpr[static_cast<u8>(src)];
+  Label validated;
+  MoveMIPSRegToReg(RWARG1, dst);
+  armAsm->ldr(RWARG2, PTR(&src_ptr->value));
+  armAsm->cmp(RWARG2, RWARG1);
+  armAsm->ldr(RWARG2, PTR(&src_ptr->flags));
+  armAsm->b(&validated, eq);
+  armAsm->and_(RWARG2, RWARG2, armCheckLogicalConstant(~PGXP::FLAGS_VALID_ALL));
+  armAsm->str(RWARG2, PTR(&src_ptr->flags));
+  armAsm->bind(&validated);
+
+  if (dst != src)
+  {
+    armAsm->str(RWARG2, PTR(&dst_ptr->flags));
+    for (u32 i = 0; i < offsetof(PGXP_value, flags); i += sizeof(u32))
+    {
+      armAsm->ldr(RWARG2, PTR(reinterpret_cast<u8*>(src_ptr) + i));
+      armAsm->str(RWARG2, PTR(reinterpret_cast<u8*>(dst_ptr) + i));
+    }
+  }
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPLoadUpper(Reg rt, u16 imm)
+{
+  // Same as PGXP::CPU_LUI(), everything is known at compile time.
+  PGXP_value* const ptr = &g_state.pgxp_gpr[static_cast<u8>(rt)];
+  armAsm->str(wzr, PTR(&ptr->x));
+  EmitMov(RWARG1, std::bit_cast<u32>(static_cast<float>(static_cast<s32>(SignExtend32(imm)))));
+  armAsm->str(RWARG1, PTR(&ptr->y));
+  armAsm->str(wzr, PTR(&ptr->z));
+  EmitMov(RWARG1, static_cast<u32>(imm) << 16);
+  armAsm->str(RWARG1, PTR(&ptr->value));
+  EmitMov(RWARG1, PGXP::FLAGS_VALID_XY);
+  armAsm->str(RWARG1, PTR(&ptr->flags));
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPValidate(PGXP_value* ptr, const vixl::aarch64::WRegister& value)
+{
+  // Same as PGXP::Validate().
+  DebugAssert(value.GetCode() != RWARG1.GetCode());
+  Label validated;
+  armAsm->ldr(RWARG1, PTR(&ptr->value));
+  armAsm->cmp(RWARG1, value);
+  armAsm->b(&validated, eq);
+  armAsm->ldr(RWARG1, PTR(&ptr->flags));
+  armAsm->and_(RWARG1, RWARG1, armCheckLogicalConstant(~PGXP::FLAGS_VALID_ALL));
+  armAsm->str(RWARG1, PTR(&ptr->flags));
+  armAsm->bind(&validated);
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPAddHalves(bool sub)
+{
+  // The float part of PGXP::CPU_ADD()/CPU_SUB()/CPU_ADDI(). Takes the x halves in s0/s1 and the y halves in s2/s3,
+  // and returns x in s0 and y in s2. The comparisons are done with selects, so there's no branches. Only RWSCRATCH
+  // is used from the integer registers.
+
+  // f16Unsign(), in double precision like the C version.
+  EmitMov(RWSCRATCH, USHRT_MAX + 1);
+  armAsm->scvtf(d5, RWSCRATCH);
+  for (u32 i = 0; i < 2; i++)
+  {
+    const VRegister sreg = i ? s1 : s0;
+    const VRegister dreg = i ? d1 : d0;
+    armAsm->fcvt(dreg, sreg);
+    armAsm->fadd(d4, dreg, d5);
+    armAsm->fcmp(dreg, 0.0);
+    armAsm->fcsel(dreg, dreg, d4, ge);
+    armAsm->fcvt(sreg, dreg);
+  }
+  sub ? armAsm->fsub(s0, s0, s1) : armAsm->fadd(s0, s0, s1);
+
+  // of = (x > USHRT_MAX) ? 1 : (x < 0) ? -1 : 0
+  armAsm->fmov(s1, wzr);
+  armAsm->fmov(s4, -1.0f);
+  armAsm->fcmp(s0, 0.0);
+  armAsm->fcsel(s1, s4, s1, mi);
+  armAsm->fmov(s4, 1.0f);
+  EmitMov(RWSCRATCH, USHRT_MAX);
+  armAsm->scvtf(s5, RWSCRATCH);
+  armAsm->fcmp(s0, s5);
+  armAsm->fcsel(s1, s4, s1, gt);
+
+  // f16Sign(), the fixed point conversions do the scaling by 65536.
+  armAsm->fcvt(d0, s0);
+  armAsm->fcvtzs(RXSCRATCH, d0, 16);
+  armAsm->scvtf(d0, RWSCRATCH, 16);
+  armAsm->fcvt(s0, d0);
+
+  // y += ty + of, or y -= ty - of
+  sub ? armAsm->fsub(s3, s3, s1) : armAsm->fadd(s3, s3, s1);
+  sub ? armAsm->fsub(s2, s2, s3) : armAsm->fadd(s2, s2, s3);
+
+  // y += (y > SHRT_MAX) ? -(USHRT_MAX + 1) : (y < SHRT_MIN) ? USHRT_MAX + 1 : 0
+  armAsm->fmov(s1, wzr);
+  EmitMov(RWSCRATCH, USHRT_MAX + 1);
+  armAsm->scvtf(s4, RWSCRATCH);
+  EmitMov(RWSCRATCH, static_cast<u32>(SHRT_MIN));
+  armAsm->scvtf(s5, RWSCRATCH);
+  armAsm->fcmp(s2, s5);
+  armAsm->fcsel(s1, s4, s1, mi);
+  armAsm->fneg(s4, s4);
+  EmitMov(RWSCRATCH, SHRT_MAX);
+  armAsm->scvtf(s5, RWSCRATCH);
+  armAsm->fcmp(s2, s5);
+  armAsm->fcsel(s1, s4, s1, gt);
+  armAsm->fadd(s2, s2, s1);
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPAddSub(Reg rd, Reg rs, Reg rt, bool sub)
+{
+  // Same as PGXP::CPU_ADD()/CPU_SUB(). When only one operand is valid, the other has to be rebuilt from its integer
+  // value, so that's left to the C version. Invalid operands should be rare, so the flush isn't worth avoiding.
+  Flush(FLUSH_FOR_C_CALL);
+
+  PGXP_value* const d_ptr = &g_state.pgxp_gpr[static_cast<u8>(rd)];
+  PGXP_value* const s_ptr = &g_state.pgxp_gpr[static_cast<u8>(rs)];
+  PGXP_value* const t_ptr = &g_state.pgxp_gpr[static_cast<u8>(rt)];
+  Label copy_s, copy_t, calculated, z_merged, slow, done;
+  MoveMIPSRegToReg(RWARG2, rs);
+  MoveMIPSRegToReg(RWARG3, rt);
+  GeneratePGXPValidate(s_ptr, RWARG2);
+  GeneratePGXPValidate(t_ptr, RWARG3);
+
+  // Adding zero is a copy of the other operand, whether it's valid or not.
+  if (!sub)
+  {
+    armAsm->cbz(RWARG3, &copy_s);
+    armAsm->cbz(RWARG2, &copy_t);
+  }
+
+  armAsm->ldr(RWARG1, PTR(&s_ptr->flags));
+  armAsm->ldr(RWSCRATCH, PTR(&t_ptr->flags));
+  armAsm->and_(RWARG1, RWARG1, RWSCRATCH);
+  EmitMov(RWSCRATCH, PGXP::FLAGS_VALID_XY);
+  armAsm->bics(wzr, RWSCRATCH, RWARG1);
+  armAsm->b(&slow, ne);
+
+  armAsm->ldr(s0, PTR(&s_ptr->x));
+  armAsm->ldr(s1, PTR(&t_ptr->x));
+  armAsm->ldr(s2, PTR(&s_ptr->y));
+  armAsm->ldr(s3, PTR(&t_ptr->y));
+  GeneratePGXPAddHalves(sub);
+
+  // ret.halfFlags[0] &= t.halfFlags[0]
+  armAsm->ldr(s1, PTR(&s_ptr->z));
+  armAsm->ldr(RWARG1, PTR(&t_ptr->flags));
+  armAsm->orr(RWARG1, RWARG1, armCheckLogicalConstant(0xFFFF0000u));
+  armAsm->ldr(RWSCRATCH, PTR(&s_ptr->flags));
+  armAsm->and_(RWARG1, RWARG1, RWSCRATCH);
+
+  if (!sub)
+  {
+    armAsm->b(&calculated);
+    armAsm->bind(&copy_t);
+    armAsm->ldr(s0, PTR(&t_ptr->x));
+    armAsm->ldr(s2, PTR(&t_ptr->y));
+    armAsm->ldr(s1, PTR(&t_ptr->z));
+    armAsm->ldr(RWARG1, PTR(&t_ptr->flags));
+    armAsm->b(&calculated);
+    armAsm->bind(&copy_s);
+    armAsm->ldr(s0, PTR(&s_ptr->x));
+    armAsm->ldr(s2, PTR(&s_ptr->y));
+    armAsm->ldr(s1, PTR(&s_ptr->z));
+    armAsm->ldr(RWARG1, PTR(&s_ptr->flags));
+  }
+
+  // Take z from the other operand if the result doesn't have one.
+  armAsm->bind(&calculated);
+  armAsm->tbnz(RWARG1, std::countr_zero(static_cast<u32>(PGXP::FLAGS_VALID_Z)), &z_merged);
+  armAsm->ldr(RWSCRATCH, PTR(&t_ptr->flags));
+  armAsm->tbz(RWSCRATCH, std::countr_zero(static_cast<u32>(PGXP::FLAGS_VALID_Z)), &z_merged);
+  armAsm->ldr(s1, PTR(&t_ptr->z));
+  armAsm->orr(RWARG1, RWARG1, armCheckLogicalConstant(PGXP::FLAGS_VALID_Z));
+  armAsm->bind(&z_merged);
+
+  armAsm->str(s0, PTR(&d_ptr->x));
+  armAsm->str(s2, PTR(&d_ptr->y));
+  armAsm->str(s1, PTR(&d_ptr->z));
+  armAsm->str(RWARG1, PTR(&d_ptr->flags));
+  sub ? armAsm->sub(RWARG2, RWARG2, RWARG3) : armAsm->add(RWARG2, RWARG2, RWARG3);
+  armAsm->str(RWARG2, PTR(&d_ptr->value));
+  armAsm->b(&done);
+
+  armAsm->bind(&slow);
+  EmitMov(RWARG1, inst->bits);
+  EmitCall(sub ? reinterpret_cast<const void*>(&PGXP::CPU_SUB) : reinterpret_cast<const void*>(&PGXP::CPU_ADD));
+  armAsm->bind(&done);
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPAddImmediate(Reg rt, Reg rs, u32 imm)
+{
+  // Same as PGXP::CPU_ADDI(). The operand is used whether it's valid or not, so this never needs to call out to C.
+  PGXP_value* const d_ptr = &g_state.pgxp_gpr[static_cast<u8>(rt)];
+  PGXP_value* const s_ptr = &g_state.pgxp_gpr[static_cast<u8>(rs)];
+  MoveMIPSRegToReg(RWARG2, rs);
+  GeneratePGXPValidate(s_ptr, RWARG2);
+
+  armAsm->ldr(s0, PTR(&s_ptr->x));
+  armAsm->ldr(s2, PTR(&s_ptr->y));
+  if (imm != 0)
+  {
+    EmitMov(RWSCRATCH, std::bit_cast<u32>(static_cast<float>(static_cast<u16>(imm))));
+    armAsm->fmov(s1, RWSCRATCH);
+    EmitMov(RWSCRATCH, std::bit_cast<u32>(static_cast<float>(static_cast<::s16>(imm >> 16))));
+    armAsm->fmov(s3, RWSCRATCH);
+    GeneratePGXPAddHalves(false);
+  }
+
+  armAsm->ldr(s1, PTR(&s_ptr->z));
+  armAsm->ldr(RWARG1, PTR(&s_ptr->flags));
+  armAsm->str(s0, PTR(&d_ptr->x));
+  armAsm->str(s2, PTR(&d_ptr->y));
+  armAsm->str(s1, PTR(&d_ptr->z));
+  armAsm->str(RWARG1, PTR(&d_ptr->flags));
+  EmitMov(RWSCRATCH, imm);
+  armAsm->add(RWARG2, RWARG2, RWSCRATCH);
+  armAsm->str(RWARG2, PTR(&d_ptr->value));
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPMemoryPointer(const vixl::aarch64::WRegister& addr,
+                                                             const vixl::aarch64::XRegister& ptr,
+                                                             const vixl::aarch64::XRegister& temp1,
+                                                             const vixl::aarch64::XRegister& temp2,
+                                                             vixl::aarch64::Label* unmapped,
+                                                             vixl::aarch64::Label* unallocated)
+{
+  // Same as PGXP::GetMemIndex(), plus the page lookup. The low bits of the address are ignored, like the C version.
+  // Constants can end up in RWSCRATCH, so that's only used as a temporary once they're done.
+  const WRegister index = WRegister(temp1.GetCode());
+  Label not_scratchpad, have_index;
+  armAsm->and_(index, addr, armCheckLogicalConstant(SCRATCHPAD_ADDR_MASK));
+  armAsm->cmp(index, armCheckCompareConstant(static_cast<s32>(SCRATCHPAD_ADDR)));
+  armAsm->b(&not_scratchpad, ne);
+  armAsm->ubfx(index, addr, 2, 8);
+  armAsm->add(index, index, armCheckAddSubConstant(PGXP::MEM_SCRATCH_OFFSET));
+  armAsm->b(&have_index);
+
+  armAsm->bind(&not_scratchpad);
+  armAsm->and_(index, addr, armCheckLogicalConstant(PHYSICAL_MEMORY_ADDRESS_MASK));
+  armAsm->cmp(index, armCheckCompareConstant(static_cast<s32>(Bus::RAM_MIRROR_END)));
+  armAsm->b(unmapped, hs);
+  armAsm->and_(index, index, armCheckLogicalConstant(Bus::g_ram_mask));
+  armAsm->lsr(index, index, 2);
+
+  armAsm->bind(&have_index);
+  armMoveAddressToReg(armAsm, ptr, PGXP::GetMemoryPageTable());
+  armAsm->lsr(temp2.W(), index, PGXP::MEM_PAGE_SHIFT);
+  armAsm->ldr(ptr, MemOperand(ptr, temp2, LSL, 3));
+  armAsm->cbz(ptr, unallocated);
+
+  // ptr += (index & MASK) * sizeof(PGXP_value)
+  armAsm->and_(index, index, PGXP::MEM_PAGE_MASK);
+  armAsm->add(index, index, vixl::aarch64::Operand(index, LSL, 2));
+  armAsm->add(ptr, ptr, vixl::aarch64::Operand(temp1, LSL, 2));
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPLoadWord(const vixl::aarch64::WRegister& addr,
+                                                        const vixl::aarch64::WRegister& value, PGXP_value* dst)
+{
+  // Same as PGXP::CPU_LW(). Unallocated pages are all invalid, so nothing here needs to call out to C.
+  // The value can be in RWRET, which is also RWARG1, so that's left alone.
+  DebugAssert(value.GetCode() != RWARG2.GetCode() && value.GetCode() != RWARG3.GetCode() &&
+              value.GetCode() != RWSCRATCH.GetCode());
+  DebugAssert(addr.GetCode() != RWARG2.GetCode() && addr.GetCode() != RWARG3.GetCode() &&
+              addr.GetCode() != RWSCRATCH.GetCode());
+
+  Label invalid, validated, done;
+  GeneratePGXPMemoryPointer(addr, RXARG3, RXARG2, RXSCRATCH, &invalid, &invalid);
+  armAsm->ldr(RWARG2, MemOperand(RXARG3, offsetof(PGXP_value, value)));
+  armAsm->cmp(RWARG2, value);
+  armAsm->ldr(RWARG2, MemOperand(RXARG3, offsetof(PGXP_value, flags)));
+  armAsm->b(&validated, eq);
+  armAsm->and_(RWARG2, RWARG2, armCheckLogicalConstant(~PGXP::FLAGS_VALID_ALL));
+  armAsm->str(RWARG2, MemOperand(RXARG3, offsetof(PGXP_value, flags)));
+  armAsm->bind(&validated);
+  armAsm->str(RWARG2, PTR(&dst->flags));
+  for (u32 i = 0; i < offsetof(PGXP_value, flags); i += sizeof(u32))
+  {
+    armAsm->ldr(RWARG2, MemOperand(RXARG3, i));
+    armAsm->str(RWARG2, PTR(reinterpret_cast<u8*>(dst) + i));
+  }
+  armAsm->b(&done);
+
+  armAsm->bind(&invalid);
+  for (u32 i = 0; i < sizeof(PGXP_value); i += sizeof(u32))
+    armAsm->str(wzr, PTR(reinterpret_cast<u8*>(dst) + i));
+  armAsm->bind(&done);
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPStoreWord(const vixl::aarch64::WRegister& addr,
+                                                         const vixl::aarch64::WRegister& value, PGXP_value* src,
+                                                         const void* slow_func)
+{
+  // Same as PGXP::CPU_SW(). The C version is only called when the page needs to be allocated, so the caller has to
+  // have flushed for a C call already.
+  DebugAssert(value.GetCode() != RWARG2.GetCode() && value.GetCode() != RWARG3.GetCode() &&
+              value.GetCode() != RWSCRATCH.GetCode());
+  DebugAssert(addr.GetCode() != RWARG1.GetCode() && addr.GetCode() != RWARG2.GetCode() &&
+              addr.GetCode() != RWARG3.GetCode() && addr.GetCode() != RWSCRATCH.GetCode());
+
+  Label validated, unallocated, done;
+  armAsm->ldr(RWARG2, PTR(&src->value));
+  armAsm->cmp(RWARG2, value);
+  armAsm->b(&validated, eq);
+  armAsm->ldr(RWARG2, PTR(&src->flags));
+  armAsm->and_(RWARG2, RWARG2, armCheckLogicalConstant(~PGXP::FLAGS_VALID_ALL));
+  armAsm->str(RWARG2, PTR(&src->flags));
+  armAsm->bind(&validated);
+
+  GeneratePGXPMemoryPointer(addr, RXARG3, RXARG2, RXSCRATCH, &done, &unallocated);
+  for (u32 i = 0; i < sizeof(PGXP_value); i += sizeof(u32))
+  {
+    armAsm->ldr(RWARG2, PTR(reinterpret_cast<u8*>(src) + i));
+    armAsm->str(RWARG2, MemOperand(RXARG3, i));
+  }
+  armAsm->b(&done);
+
+  armAsm->bind(&unallocated);
+  armAsm->mov(RWARG3, value);
+  armAsm->mov(RWARG2, addr);
+  EmitMov(RWARG1, inst->bits);
+  EmitCall(slow_func);
+  armAsm->bind(&done);
+}
+
 void CPU::NewRec::AArch64Compiler::Flush(u32 flags)
 {
   Compiler::Flush(flags);
@@ -1321,7 +1680,8 @@ CPU::NewRec::AArch64Compiler::ComputeLoadStoreAddressArg(CompileFlags cf,
 template<typename RegAllocFn>
 vixl::aarch64::WRegister CPU::NewRec::AArch64Compiler::GenerateLoad(const vixl::aarch64::WRegister& addr_reg,
                                                                     MemoryAccessSize size, bool sign, bool use_fastmem,
-                                                                    const RegAllocFn& dst_reg_alloc)
+                                                                    const RegAllocFn& dst_reg_alloc,
+                                                                    const std::optional<VirtualMemoryAddress>& address)
 {
   if (use_fastmem)
   {
@@ -1358,30 +1718,80 @@ vixl::aarch64::WRegister CPU::NewRec::AArch64Compiler::GenerateLoad(const vixl::
     return dst;
   }
 
-  if (addr_reg.GetCode() != RWARG1.GetCode())
-    armAsm->mov(RWARG1, addr_reg);
-
   const bool checked = g_settings.cpu_recompiler_memory_exceptions;
-  switch (size)
+  const auto emit_thunk_call = [this, &addr_reg, size, checked]() {
+    if (addr_reg.GetCode() != RWARG1.GetCode())
+      armAsm->mov(RWARG1, addr_reg);
+
+    switch (size)
+    {
+      case MemoryAccessSize::Byte:
+      {
+        EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryByte) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryByte));
+      }
+      break;
+      case MemoryAccessSize::HalfWord:
+      {
+        EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryHalfWord) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryHalfWord));
+      }
+      break;
+      case MemoryAccessSize::Word:
+      {
+        EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryWord) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryWord));
+      }
+      break;
+    }
+  };
+
+  if (const std::optional<ConstantMemoryAccess> cma = GetConstantMemoryAccess(address, size, false); cma.has_value())
   {
-    case MemoryAccessSize::Byte:
+    // Isolated cache redirects to the icache, which is left to the thunk in far code.
+    if (cma->check_isc)
     {
-      EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryByte) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryByte));
+      armAsm->ldr(RWSCRATCH, PTR(&g_state.cop0_regs.sr.bits));
+      SwitchToFarCodeIfBitSet(RWSCRATCH, 16);
+      SwitchToNearCode(false);
     }
-    break;
-    case MemoryAccessSize::HalfWord:
+
+    if (!cma->handler)
     {
-      EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryHalfWord) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryHalfWord));
+      // Scratchpad is past the immediate offset range.
+      EmitMov(RWSCRATCH, static_cast<u32>(reinterpret_cast<const u8*>(&g_state.scratchpad[cma->scratchpad_offset]) -
+                                          reinterpret_cast<const u8*>(&g_state)));
+      const MemOperand mem = MemOperand(RSTATE, RXSCRATCH);
+      switch (size)
+      {
+        case MemoryAccessSize::Byte:
+          armAsm->ldrb(RWRET, mem);
+          break;
+        case MemoryAccessSize::HalfWord:
+          armAsm->ldrh(RWRET, mem);
+          break;
+        case MemoryAccessSize::Word:
+          armAsm->ldr(RWRET, mem);
+          break;
+      }
     }
-    break;
-    case MemoryAccessSize::Word:
+    else
     {
-      EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryWord) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryWord));
+      if (addr_reg.GetCode() != RWARG1.GetCode())
+        armAsm->mov(RWARG1, addr_reg);
+      EmitCall(cma->handler);
+    }
+
+    if (cma->check_isc)
+    {
+      SwitchToFarCode(false);
+      emit_thunk_call();
+      SwitchToNearCode(true);
     }
-    break;
+  }
+  else
+  {
+    emit_thunk_call();
   }
 
   // TODO: turn this into an asm function instead
@@ -1436,7 +1846,8 @@ vixl::aarch64::WRegister CPU::NewRec::AArch64Compiler::GenerateLoad(const vixl::
 
 void CPU::NewRec::AArch64Compiler::GenerateStore(const vixl::aarch64::WRegister& addr_reg,
                                                  const vixl::aarch64::WRegister& value_reg, MemoryAccessSize size,
-                                                 bool use_fastmem)
+                                                 bool use_fastmem,
+                                                 const std::optional<VirtualMemoryAddress>& address)
 {
   if (use_fastmem)
   {
@@ -1474,26 +1885,74 @@ void CPU::NewRec::AArch64Compiler::GenerateStore(const vixl::aarch64::WRegister&
     armAsm->mov(RWARG2, value_reg);
 
   const bool checked = g_settings.cpu_recompiler_memory_exceptions;
-  switch (size)
+  const auto emit_thunk_call = [this, size, checked]() {
+    switch (size)
+    {
+      case MemoryAccessSize::Byte:
+      {
+        EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryByte) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryByte));
+      }
+      break;
+      case MemoryAccessSize::HalfWord:
+      {
+        EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryHalfWord) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryHalfWord));
+      }
+      break;
+      case MemoryAccessSize::Word:
+      {
+        EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryWord) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryWord));
+      }
+      break;
+    }
+  };
+
+  if (const std::optional<ConstantMemoryAccess> cma = GetConstantMemoryAccess(address, size, true); cma.has_value())
   {
-    case MemoryAccessSize::Byte:
+    // Isolated cache redirects to the icache, which is left to the thunk in far code.
+    if (cma->check_isc)
     {
-      EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryByte) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryByte));
+      armAsm->ldr(RWSCRATCH, PTR(&g_state.cop0_regs.sr.bits));
+      SwitchToFarCodeIfBitSet(RWSCRATCH, 16);
+      SwitchToNearCode(false);
     }
-    break;
-    case MemoryAccessSize::HalfWord:
+
+    if (!cma->handler)
     {
-      EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryHalfWord) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryHalfWord));
+      // Scratchpad is past the immediate offset range.
+      EmitMov(RWSCRATCH, static_cast<u32>(reinterpret_cast<const u8*>(&g_state.scratchpad[cma->scratchpad_offset]) -
+                                          reinterpret_cast<const u8*>(&g_state)));
+      const MemOperand mem = MemOperand(RSTATE, RXSCRATCH);
+      switch (size)
+      {
+        case MemoryAccessSize::Byte:
+          armAsm->strb(RWARG2, mem);
+          break;
+        case MemoryAccessSize::HalfWord:
+          armAsm->strh(RWARG2, mem);
+          break;
+        case MemoryAccessSize::Word:
+          armAsm->str(RWARG2, mem);
+          break;
+      }
     }
-    break;
-    case MemoryAccessSize::Word:
+    else
     {
-      EmitCall(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryWord) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryWord));
+      EmitCall(cma->handler);
     }
-    break;
+
+    if (cma->check_isc)
+    {
+      SwitchToFarCode(false);
+      emit_thunk_call();
+      SwitchToNearCode(true);
+    }
+  }
+  else
+  {
+    emit_thunk_call();
   }
 
   // TODO: turn this into an asm function instead
@@ -1537,16 +1996,24 @@ void CPU::NewRec::AArch64Compiler::Compile_lxx(CompileFlags cf, MemoryAccessSize
     return WRegister(AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
                                      EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG,
                                      cf.MipsT()));
-  });
+  }, address);
 
   if (g_settings.gpu_pgxp_enable)
   {
-    Flush(FLUSH_FOR_C_CALL);
+    if (size == MemoryAccessSize::Word)
+    {
+      GeneratePGXPLoadWord(addr, data, &g_state.pgxp_gpr[static_cast<u8>(cf.MipsT())]);
+    }
+    else
+    {
+      Flush(FLUSH_FOR_C_CALL);
+
+      EmitMov(RWARG1, inst->bits);
+      armAsm->mov(RWARG2, addr);
+      armAsm->mov(RWARG3, data);
+      EmitCall(s_pgxp_mem_load_functions[static_cast<u32>(size)][static_cast<u32>(sign)]);
+    }
 
-    EmitMov(RWARG1, inst->bits);
-    armAsm->mov(RWARG2, addr);
-    armAsm->mov(RWARG3, data);
-    EmitCall(s_pgxp_mem_load_functions[static_cast<u32>(size)][static_cast<u32>(sign)]);
     FreeHostReg(addr_reg.value().GetCode());
   }
 }
@@ -1636,13 +2103,7 @@ void CPU::NewRec::AArch64Compiler::Compile_lwx(CompileFlags cf, MemoryAccessSize
   FreeHostReg(addr.GetCode());
 
   if (g_settings.gpu_pgxp_enable)
-  {
-    Flush(FLUSH_FOR_C_CALL);
-    armAsm->mov(RWARG3, value);
-    armAsm->and_(RWARG2, addr, armCheckLogicalConstant(~0x3u));
-    EmitMov(RWARG1, inst->bits);
-    EmitCall(reinterpret_cast<const void*>(&PGXP::CPU_LW));
-  }
+    GeneratePGXPLoadWord(addr, value, &g_state.pgxp_gpr[static_cast<u8>(inst->r.rt.GetValue())]);
 }
 
 void CPU::NewRec::AArch64Compiler::Compile_lwc2(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
@@ -1746,15 +2207,24 @@ void CPU::NewRec::AArch64Compiler::Compile_sxx(CompileFlags cf, MemoryAccessSize
   if (!cf.valid_host_t)
     MoveTToReg(RWARG2, cf);
 
-  GenerateStore(addr, data, size, use_fastmem);
+  GenerateStore(addr, data, size, use_fastmem, address);
 
   if (g_settings.gpu_pgxp_enable)
   {
     Flush(FLUSH_FOR_C_CALL);
-    MoveMIPSRegToReg(RWARG3, cf.MipsT());
-    armAsm->mov(RWARG2, addr);
-    EmitMov(RWARG1, inst->bits);
-    EmitCall(s_pgxp_mem_store_functions[static_cast<u32>(size)]);
+    if (size == MemoryAccessSize::Word)
+    {
+      MoveMIPSRegToReg(RWARG1, cf.MipsT());
+      GeneratePGXPStoreWord(addr, RWARG1, &g_state.pgxp_gpr[static_cast<u8>(cf.MipsT())],
+                            s_pgxp_mem_store_functions[static_cast<u32>(size)]);
+    }
+    else
+    {
+      MoveMIPSRegToReg(RWARG3, cf.MipsT());
+      armAsm->mov(RWARG2, addr);
+      EmitMov(RWARG1, inst->bits);
+      EmitCall(s_pgxp_mem_store_functions[static_cast<u32>(size)]);
+    }
     FreeHostReg(addr_reg.value().GetCode());
   }
 }
@@ -1824,12 +2294,10 @@ void CPU::NewRec::AArch64Compiler::Compile_swx(CompileFlags cf, MemoryAccessSize
     GenerateStore(addr, value, MemoryAccessSize::Word, use_fastmem);
 
     Flush(FLUSH_FOR_C_CALL);
-    armAsm->mov(RWARG3, value);
+    GeneratePGXPStoreWord(addr, value, &g_state.pgxp_gpr[static_cast<u8>(inst->r.rt.GetValue())],
+                          reinterpret_cast<const void*>(&PGXP::CPU_SW));
     FreeHostReg(value.GetCode());
-    armAsm->mov(RWARG2, addr);
     FreeHostReg(addr.GetCode());
-    EmitMov(RWARG1, inst->bits);
-    EmitCall(reinterpret_cast<const void*>(&PGXP::CPU_SW));
   }
 }
 
@@ -1878,14 +2346,10 @@ void CPU::NewRec::AArch64Compiler::Compile_swc2(CompileFlags cf, MemoryAccessSiz
   }
   else
   {
-    // TODO: This can be simplified because we don't need to validate in PGXP..
     Flush(FLUSH_FOR_C_CALL);
-    armAsm->mov(RWARG3, data);
+    GeneratePGXPStoreWord(addr, data, &g_state.pgxp_gte[index], reinterpret_cast<const void*>(&PGXP::CPU_SWC2));
     FreeHostReg(data.GetCode());
-    armAsm->mov(RWARG2, addr);
     FreeHostReg(addr.GetCode());
-    EmitMov(RWARG1, inst->bits);
-    EmitCall(reinterpret_cast<const void*>(&PGXP::CPU_SWC2));
   }
 }
 
@@ -2127,11 +2591,509 @@ void CPU::NewRec::AArch64Compiler::Compile_mtc2(CompileFlags cf)
   }
 }
 
+void CPU::NewRec::AArch64Compiler::GenerateGTESetMAC0()
+{
+  // Same as TruncateAndSetMAC<0>() with FLAG cleared. The result is in RXRET, and the new FLAG value is left in RWARG3
+  // with the error bit already set.
+  Label done;
+  armAsm->str(RWRET, PTR(&g_state.gte_regs.MAC0));
+  armAsm->mov(RWARG3, wzr);
+  armAsm->cmp(RXRET, Operand(RWRET, SXTW));
+  armAsm->b(&done, eq);
+  EmitMov(RWARG3, (1u << 31) | (1u << 16)); // error | mac0_overflow
+  EmitMov(RWARG2, (1u << 31) | (1u << 15)); // error | mac0_underflow
+  armAsm->cmp(RXRET, 0);
+  armAsm->csel(RWARG3, RWARG2, RWARG3, lt);
+  armAsm->bind(&done);
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTENormalClip()
+{
+  // Same as GTE::Execute_NCLIP(), with the sum regrouped as SX0*(SY1-SY2) + SX1*(SY2-SY0) + SX2*(SY0-SY1).
+  GTE::Regs& regs = g_state.gte_regs;
+  armAsm->ldrsh(RXARG2, PTR(&regs.SXY1[1]));
+  armAsm->ldrsh(RXARG3, PTR(&regs.SXY2[1]));
+  armAsm->sub(RXARG2, RXARG2, RXARG3);
+  armAsm->ldrsh(RXRET, PTR(&regs.SXY0[0]));
+  armAsm->mul(RXRET, RXRET, RXARG2);
+
+  armAsm->ldrsh(RXARG2, PTR(&regs.SXY0[1]));
+  armAsm->sub(RXARG3, RXARG3, RXARG2);
+  armAsm->ldrsh(RXSCRATCH, PTR(&regs.SXY1[0]));
+  armAsm->madd(RXRET, RXSCRATCH, RXARG3, RXRET);
+
+  armAsm->ldrsh(RXARG3, PTR(&regs.SXY1[1]));
+  armAsm->sub(RXARG2, RXARG2, RXARG3);
+  armAsm->ldrsh(RXSCRATCH, PTR(&regs.SXY2[0]));
+  armAsm->madd(RXRET, RXSCRATCH, RXARG2, RXRET);
+
+  GenerateGTESetMAC0();
+  armAsm->str(RWARG3, PTR(&regs.FLAG.bits));
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTEAverageZ(bool four)
+{
+  // Same as GTE::Execute_AVSZ3()/Execute_AVSZ4(). The sum fits in 18 bits, only the multiply needs to be 64-bit.
+  GTE::Regs& regs = g_state.gte_regs;
+  armAsm->ldrh(RWARG2, PTR(&regs.SZ1));
+  armAsm->ldrh(RWARG3, PTR(&regs.SZ2));
+  armAsm->add(RWARG2, RWARG2, RWARG3);
+  armAsm->ldrh(RWARG3, PTR(&regs.SZ3));
+  armAsm->add(RWARG2, RWARG2, RWARG3);
+  if (four)
+  {
+    armAsm->ldrh(RWARG3, PTR(&regs.SZ0));
+    armAsm->add(RWARG2, RWARG2, RWARG3);
+  }
+  armAsm->ldrsh(RWARG3, PTR(four ? &regs.ZSF4 : &regs.ZSF3));
+  armAsm->smull(RXRET, RWARG2, RWARG3);
+
+  GenerateGTESetMAC0();
+
+  // OTZ = clamp(MAC0 SAR 12, 0, FFFFh)
+  Label otz_done;
+  armAsm->asr(RXARG2, RXRET, 12);
+  armAsm->cmp(RXARG2, Operand(RWARG2, UXTH));
+  armAsm->b(&otz_done, eq);
+  EmitMov(RWSCRATCH, (1u << 31) | (1u << 18)); // error | sz1_otz_saturated
+  armAsm->orr(RWARG3, RWARG3, RWSCRATCH);
+  armAsm->cmp(RXARG2, 0);
+  EmitMov(RWSCRATCH, 0xFFFF);
+  armAsm->csel(RWARG2, wzr, RWSCRATCH, lt);
+  armAsm->bind(&otz_done);
+  armAsm->str(RWARG2, PTR(&regs.dr32[7]));
+  armAsm->str(RWARG3, PTR(&regs.FLAG.bits));
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTECheckMAC(const vixl::aarch64::XRegister& value,
+                                                       const vixl::aarch64::XRegister& extended,
+                                                       const vixl::aarch64::WRegister& flags, u32 bits,
+                                                       u32 overflow_flag, u32 underflow_flag)
+{
+  // Same as CheckMACOverflow(). The value sign-extended from the MAC width is left in extended, RWSCRATCH is clobbered.
+  Label done, set_flags;
+  armAsm->sbfx(extended, value, 0, bits);
+  armAsm->cmp(extended, value);
+  armAsm->b(&done, eq);
+  armAsm->cmp(value, 0);
+  EmitMov(RWSCRATCH, (1u << 31) | overflow_flag);
+  armAsm->b(&set_flags, ge);
+  EmitMov(RWSCRATCH, (1u << 31) | underflow_flag);
+  armAsm->bind(&set_flags);
+  armAsm->orr(flags, flags, RWSCRATCH);
+  armAsm->bind(&done);
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTEClamp(const vixl::aarch64::WRegister& value,
+                                                    const vixl::aarch64::WRegister& flags, s32 min_value,
+                                                    s32 max_value, u32 saturated_flags)
+{
+  // Same as TruncateAndSetIR()/PushSXY()/PushSZ(). The flags are only set if saturated_flags is non-zero, and should
+  // include the error bit when the flag feeds into it. RWARG2, RWARG3 and RWSCRATCH are clobbered.
+  DebugAssert(value.GetCode() != RWARG2.GetCode() && value.GetCode() != RWARG3.GetCode());
+  EmitMov(RWARG2, static_cast<u32>(max_value));
+  EmitMov(RWARG3, static_cast<u32>(min_value));
+  armAsm->cmp(value, RWARG2);
+  armAsm->csel(RWSCRATCH, RWARG2, value, gt);
+  armAsm->cmp(RWSCRATCH, RWARG3);
+  armAsm->csel(RWSCRATCH, RWARG3, RWSCRATCH, lt);
+  if (saturated_flags != 0)
+  {
+    Label done;
+    armAsm->cmp(RWSCRATCH, value);
+    armAsm->b(&done, eq);
+    EmitMov(RWARG2, saturated_flags);
+    armAsm->orr(flags, flags, RWARG2);
+    armAsm->bind(&done);
+  }
+  armAsm->mov(value, RWSCRATCH);
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTEPerspectiveTransform(const ::s16* V, u8 shift, bool lm, bool last,
+                                                                   const vixl::aarch64::WRegister& flags,
+                                                                   const vixl::aarch64::XRegister& temp1,
+                                                                   const vixl::aarch64::XRegister& temp2)
+{
+  // Same as GTE::RTPS() without PGXP, with FLAG accumulated in flags.
+  GTE::Regs& regs = g_state.gte_regs;
+  const XRegister acc = temp1;
+  const WRegister temp2w = WRegister(temp2.GetCode());
+
+  // MACn = (TRn*1000h + RTn1*VX + RTn2*VY + RTn3*VZ) SAR (sf*12), the first two sums are sign-extended from 44 bits.
+  for (u32 i = 0; i < 3; i++)
+  {
+    const u32 overflow_flag = 1u << (30 - i);
+    const u32 underflow_flag = 1u << (27 - i);
+
+    armAsm->ldrsw(acc, PTR(&regs.TR[i]));
+    armAsm->lsl(acc, acc, 12);
+    for (u32 j = 0; j < 3; j++)
+    {
+      armAsm->ldrsh(RXRET, PTR(&regs.RT[i][j]));
+      armAsm->ldrsh(RXARG2, PTR(&V[j]));
+      armAsm->madd(acc, RXRET, RXARG2, acc);
+      GenerateGTECheckMAC(acc, RXRET, flags, 44, overflow_flag, underflow_flag);
+      if (j < 2)
+        armAsm->mov(acc, RXRET);
+    }
+
+    if (shift != 0)
+      armAsm->asr(RXRET, acc, shift);
+    else
+      armAsm->mov(RXRET, acc);
+    armAsm->str(RWRET, PTR(&regs.dr32[25 + i]));
+
+    if (i < 2)
+    {
+      GenerateGTEClamp(RWRET, flags, lm ? 0 : -0x8000, 0x7FFF, (1u << 31) | (1u << (24 - i)));
+      armAsm->str(RWRET, PTR(&regs.dr32[9 + i]));
+      continue;
+    }
+
+    // IR3 is saturated from MAC3, but the flag comes from MAC3 SAR 12 regardless of sf.
+    GenerateGTEClamp(RWRET, flags, lm ? 0 : -0x8000, 0x7FFF, 0);
+    armAsm->str(RWRET, PTR(&regs.dr32[11]));
+    armAsm->asr(RXRET, acc, 12);
+    armAsm->mov(temp2w, RWRET);
+    GenerateGTEClamp(temp2w, flags, -0x8000, 0x7FFF, 1u << 22);
+
+    // SZ3 = MAC3 SAR 12, pushed to the FIFO.
+    GenerateGTEClamp(RWRET, flags, 0, 0xFFFF, (1u << 31) | (1u << 18));
+    armAsm->ldr(RWARG2, PTR(&regs.dr32[17]));
+    armAsm->str(RWARG2, PTR(&regs.dr32[16]));
+    armAsm->ldr(RWARG2, PTR(&regs.dr32[18]));
+    armAsm->str(RWARG2, PTR(&regs.dr32[17]));
+    armAsm->ldr(RWARG2, PTR(&regs.dr32[19]));
+    armAsm->str(RWARG2, PTR(&regs.dr32[18]));
+    armAsm->str(RWRET, PTR(&regs.dr32[19]));
+  }
+
+  // Same as GTE::UNRDivide(H, SZ3), SZ3 is in RWRET. SZ3 can't be zero past the overflow check.
+  Label divide_done, divide;
+  const WRegister lhs = temp2w;
+  armAsm->ldrh(lhs, PTR(&regs.H));
+  armAsm->add(RWARG2, RWRET, RWRET);
+  armAsm->cmp(RWARG2, lhs);
+  armAsm->b(&divide, hi);
+  EmitMov(RWARG2, (1u << 31) | (1u << 17)); // error | divide_overflow
+  armAsm->orr(flags, flags, RWARG2);
+  EmitMov(RWRET, 0x1FFFF);
+  armAsm->b(&divide_done);
+  armAsm->bind(&divide);
+  armAsm->clz(RWARG2, RWRET);
+  armAsm->sub(RWARG2, RWARG2, 16);
+  armAsm->lslv(lhs, lhs, RWARG2);
+  armAsm->lslv(RWRET, RWRET, RWARG2);
+  armAsm->and_(RWARG2, RWRET, 0x7FFF);
+  armAsm->add(RWARG2, RWARG2, 0x40);
+  armAsm->lsr(RWARG2, RWARG2, 7);
+  armMoveAddressToReg(armAsm, RXSCRATCH, GTE::GetUNRTable());
+  armAsm->ldrb(RWARG2, MemOperand(RXSCRATCH, RXARG2));
+  armAsm->add(RWARG2, RWARG2, 0x101);
+  armAsm->mul(RWARG3, RWRET, RWARG2);
+  armAsm->neg(RWARG3, RWARG3);
+  armAsm->add(RWARG3, RWARG3, 0x80);
+  armAsm->asr(RWARG3, RWARG3, 8);
+  armAsm->add(RWARG3, RWARG3, 0x20000);
+  armAsm->mul(RWARG3, RWARG3, RWARG2);
+  armAsm->add(RWARG3, RWARG3, 0x80);
+  armAsm->asr(RWARG3, RWARG3, 8);
+  armAsm->umull(RXRET, lhs, RWARG3);
+  armAsm->add(RXRET, RXRET, 0x8000);
+  armAsm->lsr(RXRET, RXRET, 16);
+  EmitMov(RWARG2, 0x1FFFF);
+  armAsm->cmp(RWRET, RWARG2);
+  armAsm->csel(RWRET, RWARG2, RWRET, hi);
+  armAsm->bind(&divide_done);
+
+  // The quotient is kept in temp1 for the rest of the command, zero-extended.
+  const XRegister quotient = temp1;
+  armAsm->mov(WRegister(quotient.GetCode()), RWRET);
+
+  // SX2 = (quotient * IR1 * scale + OFX) SAR 16, SY2 = (quotient * IR2 + OFY) SAR 16
+  Label no_scale;
+  armAsm->ldrsh(RXRET, PTR(&regs.IR1));
+  armAsm->mul(RXRET, RXRET, quotient);
+  armMoveAddressToReg(armAsm, RXSCRATCH, GTE::GetProjectionScalePtr());
+  armAsm->ldrsw(RXARG2, MemOperand(RXSCRATCH, offsetof(GTE::ProjectionScale, numerator)));
+  armAsm->ldrsw(RXARG3, MemOperand(RXSCRATCH, offsetof(GTE::ProjectionScale, denominator)));
+  armAsm->cmp(RXARG2, RXARG3);
+  armAsm->b(&no_scale, eq);
+  armAsm->mul(RXRET, RXRET, RXARG2);
+  armAsm->sdiv(RXRET, RXRET, RXARG3);
+  armAsm->bind(&no_scale);
+  armAsm->ldrsw(RXARG2, PTR(&regs.OFX));
+  armAsm->add(RXRET, RXRET, RXARG2);
+  GenerateGTECheckMAC(RXRET, RXARG2, flags, 32, 1u << 16, 1u << 15);
+  armAsm->asr(RXRET, RXRET, 16);
+  GenerateGTEClamp(RWRET, flags, -1024, 1023, (1u << 31) | (1u << 14));
+  armAsm->and_(temp2w, RWRET, 0xFFFF);
+
+  armAsm->ldrsh(RXRET, PTR(&regs.IR2));
+  armAsm->mul(RXRET, RXRET, quotient);
+  armAsm->ldrsw(RXARG2, PTR(&regs.OFY));
+  armAsm->add(RXRET, RXRET, RXARG2);
+  GenerateGTECheckMAC(RXRET, RXARG2, flags, 32, 1u << 16, 1u << 15);
+  armAsm->asr(RXRET, RXRET, 16);
+  GenerateGTEClamp(RWRET, flags, -1024, 1023, (1u << 31) | (1u << 13));
+  armAsm->orr(temp2w, temp2w, Operand(RWRET, LSL, 16));
+
+  armAsm->ldr(RWARG2, PTR(&regs.dr32[13]));
+  armAsm->str(RWARG2, PTR(&regs.dr32[12]));
+  armAsm->ldr(RWARG2, PTR(&regs.dr32[14]));
+  armAsm->str(RWARG2, PTR(&regs.dr32[13]));
+  armAsm->str(temp2w, PTR(&regs.dr32[14]));
+
+  if (last)
+  {
+    // MAC0 = quotient * DQA + DQB, IR0 = MAC0 SAR 12
+    armAsm->ldrsh(RXRET, PTR(&regs.DQA));
+    armAsm->mul(RXRET, RXRET, quotient);
+    armAsm->ldrsw(RXARG2, PTR(&regs.DQB));
+    armAsm->add(RXRET, RXRET, RXARG2);
+    GenerateGTECheckMAC(RXRET, RXARG2, flags, 32, 1u << 16, 1u << 15);
+    armAsm->str(RWRET, PTR(&regs.MAC0));
+    armAsm->asr(RXRET, RXRET, 12);
+    GenerateGTEClamp(RWRET, flags, 0, 0x1000, 1u << 12);
+    armAsm->str(RWRET, PTR(&regs.dr32[8]));
+  }
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTERotateTranslatePerspective(bool triple, u8 shift, bool lm)
+{
+  const WRegister flags = WRegister(AllocateTempHostReg());
+  const XRegister temp1 = XRegister(AllocateTempHostReg());
+  const XRegister temp2 = XRegister(AllocateTempHostReg());
+
+  GTE::Regs& regs = g_state.gte_regs;
+  armAsm->mov(flags, wzr);
+  if (triple)
+  {
+    GenerateGTEPerspectiveTransform(regs.V0, shift, lm, false, flags, temp1, temp2);
+    GenerateGTEPerspectiveTransform(regs.V1, shift, lm, false, flags, temp1, temp2);
+    GenerateGTEPerspectiveTransform(regs.V2, shift, lm, true, flags, temp1, temp2);
+  }
+  else
+  {
+    GenerateGTEPerspectiveTransform(regs.V0, shift, lm, true, flags, temp1, temp2);
+  }
+  armAsm->str(flags, PTR(&regs.FLAG.bits));
+
+  FreeHostReg(temp2.GetCode());
+  FreeHostReg(temp1.GetCode());
+  FreeHostReg(flags.GetCode());
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTEMultiplyMatrixVector(const ::s16* M, const s32* T,
+                                                                   const ::s16* const V[3], u8 shift, bool lm,
+                                                                   const vixl::aarch64::WRegister& flags,
+                                                                   const vixl::aarch64::XRegister& temp)
+{
+  // Same as GTE::MulMatVec(), T is null for no translation. V can be the IR vector, so all of the MACs are computed
+  // before any IR is written.
+  GTE::Regs& regs = g_state.gte_regs;
+  const XRegister acc = temp;
+  for (u32 i = 0; i < 3; i++)
+  {
+    const u32 overflow_flag = 1u << (30 - i);
+    const u32 underflow_flag = 1u << (27 - i);
+
+    if (T)
+    {
+      armAsm->ldrsw(acc, PTR(&T[i]));
+      armAsm->lsl(acc, acc, 12);
+    }
+    else
+    {
+      armAsm->mov(acc, xzr);
+    }
+
+    for (u32 j = 0; j < 3; j++)
+    {
+      armAsm->ldrsh(RXRET, PTR(&M[i * 3 + j]));
+      armAsm->ldrsh(RXARG2, PTR(V[j]));
+      armAsm->madd(acc, RXRET, RXARG2, acc);
+      GenerateGTECheckMAC(acc, RXRET, flags, 44, overflow_flag, underflow_flag);
+      if (j < 2)
+        armAsm->mov(acc, RXRET);
+    }
+
+    if (shift != 0)
+      armAsm->asr(RXRET, acc, shift);
+    else
+      armAsm->mov(RXRET, acc);
+    armAsm->str(RWRET, PTR(&regs.dr32[25 + i]));
+  }
+
+  for (u32 i = 0; i < 3; i++)
+  {
+    armAsm->ldr(RWRET, PTR(&regs.dr32[25 + i]));
+    GenerateGTEClamp(RWRET, flags, lm ? 0 : -0x8000, 0x7FFF, (1u << 31) | (1u << (24 - i)));
+    armAsm->str(RWRET, PTR(&regs.dr32[9 + i]));
+  }
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTEMVMVA(u8 matrix, u8 vector, u8 translation, u8 shift, bool lm)
+{
+  // Same as GTE::Execute_MVMVA(), without the garbage matrix or the FC translation bug.
+  DebugAssert(matrix < 3 && translation != 2);
+  GTE::Regs& regs = g_state.gte_regs;
+  const ::s16* const M_lookup[3] = {&regs.RT[0][0], &regs.LLM[0][0], &regs.LCM[0][0]};
+  const ::s16* const V_lookup[4][3] = {
+    {&regs.V0[0], &regs.V0[1], &regs.V0[2]},
+    {&regs.V1[0], &regs.V1[1], &regs.V1[2]},
+    {&regs.V2[0], &regs.V2[1], &regs.V2[2]},
+    {&regs.IR1, &regs.IR2, &regs.IR3},
+  };
+  const s32* const T_lookup[4] = {regs.TR, regs.BK, nullptr, nullptr};
+
+  const WRegister flags = WRegister(AllocateTempHostReg());
+  const XRegister temp = XRegister(AllocateTempHostReg());
+  armAsm->mov(flags, wzr);
+  GenerateGTEMultiplyMatrixVector(M_lookup[matrix], T_lookup[translation], V_lookup[vector], shift, lm, flags, temp);
+  armAsm->str(flags, PTR(&regs.FLAG.bits));
+  FreeHostReg(temp.GetCode());
+  FreeHostReg(flags.GetCode());
+}
+
+void CPU::NewRec::AArch64Compiler::GenerateGTENormalColorDepthCue(u8 shift, bool lm)
+{
+  // Same as GTE::NCDS().
+  GTE::Regs& regs = g_state.gte_regs;
+  const ::s16* const V0[3] = {&regs.V0[0], &regs.V0[1], &regs.V0[2]};
+  const ::s16* const IR[3] = {&regs.IR1, &regs.IR2, &regs.IR3};
+
+  const WRegister flags = WRegister(AllocateTempHostReg());
+  const XRegister temp1 = XRegister(AllocateTempHostReg());
+  const XRegister temp2 = XRegister(AllocateTempHostReg());
+  const WRegister temp2w = WRegister(temp2.GetCode());
+  armAsm->mov(flags, wzr);
+
+  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
+  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
+  GenerateGTEMultiplyMatrixVector(&regs.LLM[0][0], nullptr, V0, shift, lm, flags, temp1);
+  GenerateGTEMultiplyMatrixVector(&regs.LCM[0][0], regs.BK, IR, shift, lm, flags, temp1);
+
+  for (u32 i = 0; i < 3; i++)
+  {
+    const u32 overflow_flag = 1u << (30 - i);
+    const u32 underflow_flag = 1u << (27 - i);
+    const u32 ir_flag = (1u << 31) | (1u << (24 - i));
+
+    // in_MAC = [R,G,B] * IR SHL 4, kept in temp2
+    armAsm->ldrb(RWRET, PTR(&regs.RGBC[i]));
+    armAsm->ldrsh(RWARG2, PTR(IR[i]));
+    armAsm->mul(RWRET, RWRET, RWARG2);
+    armAsm->lsl(RWRET, RWRET, 4);
+    armAsm->sxtw(temp2, RWRET);
+
+    // IR = ((FC SHL 12) - in_MAC) SAR (sf*12), saturated without lm
+    armAsm->ldrsw(temp1, PTR(&regs.FC[i]));
+    armAsm->lsl(temp1, temp1, 12);
+    armAsm->sub(temp1, temp1, temp2);
+    GenerateGTECheckMAC(temp1, RXRET, flags, 44, overflow_flag, underflow_flag);
+    if (shift != 0)
+      armAsm->asr(RXRET, temp1, shift);
+    else
+      armAsm->mov(RXRET, temp1);
+    GenerateGTEClamp(RWRET, flags, -0x8000, 0x7FFF, ir_flag);
+
+    // [MAC,IR] = (IR * IR0 + in_MAC) SAR (sf*12), which can't overflow
+    armAsm->ldrsh(RWARG2, PTR(&regs.IR0));
+    armAsm->mul(RWRET, RWRET, RWARG2);
+    armAsm->sxtw(RXRET, RWRET);
+    armAsm->add(RXRET, RXRET, temp2);
+    if (shift != 0)
+      armAsm->asr(RXRET, RXRET, shift);
+    armAsm->str(RWRET, PTR(&regs.dr32[25 + i]));
+    GenerateGTEClamp(RWRET, flags, lm ? 0 : -0x8000, 0x7FFF, ir_flag);
+    armAsm->str(RWRET, PTR(&regs.dr32[9 + i]));
+  }
+
+  // Color FIFO = [MAC1 SAR 4, MAC2 SAR 4, MAC3 SAR 4, CODE]
+  armAsm->ldrb(temp2w, PTR(&regs.RGBC[3]));
+  armAsm->lsl(temp2w, temp2w, 24);
+  for (u32 i = 0; i < 3; i++)
+  {
+    armAsm->ldr(RWRET, PTR(&regs.dr32[25 + i]));
+    armAsm->asr(RWRET, RWRET, 4);
+    GenerateGTEClamp(RWRET, flags, 0, 0xFF, 1u << (21 - i));
+    armAsm->orr(temp2w, temp2w, Operand(RWRET, LSL, i * 8));
+  }
+  armAsm->ldr(RWARG2, PTR(&regs.dr32[21]));
+  armAsm->str(RWARG2, PTR(&regs.dr32[20]));
+  armAsm->ldr(RWARG2, PTR(&regs.dr32[22]));
+  armAsm->str(RWARG2, PTR(&regs.dr32[21]));
+  armAsm->str(temp2w, PTR(&regs.dr32[22]));
+
+  armAsm->str(flags, PTR(&regs.FLAG.bits));
+  FreeHostReg(temp2.GetCode());
+  FreeHostReg(temp1.GetCode());
+  FreeHostReg(flags.GetCode());
+}
+
 void CPU::NewRec::AArch64Compiler::Compile_cop2(CompileFlags cf)
 {
   TickCount func_ticks;
   GTE::InstructionImpl func = GTE::GetInstructionImpl(inst->bits, &func_ticks);
 
+  // The simplest commands only touch the GTE registers, so they can be generated inline without flushing.
+  const GTE::Instruction gte_inst{inst->bits};
+  switch (gte_inst.command)
+  {
+    case 0x06: // NCLIP
+    {
+      if (g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling)
+        break;
+
+      GenerateGTENormalClip();
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    case 0x2D: // AVSZ3
+    case 0x2E: // AVSZ4
+    {
+      GenerateGTEAverageZ(gte_inst.command == 0x2E);
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    case 0x01: // RTPS
+    case 0x30: // RTPT
+    {
+      // PGXP needs the unrounded projection, so leave that to the C version.
+      if (g_settings.gpu_pgxp_enable)
+        break;
+
+      GenerateGTERotateTranslatePerspective(gte_inst.command == 0x30, gte_inst.GetShift(), gte_inst.lm);
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    case 0x12: // MVMVA
+    {
+      // The garbage matrix and the buggy FC translation are rare, so they're left to the C version.
+      if (gte_inst.mvmva_multiply_matrix == 3 || gte_inst.mvmva_translation_vector == 2)
+        break;
+
+      GenerateGTEMVMVA(gte_inst.mvmva_multiply_matrix, gte_inst.mvmva_multiply_vector,
+                       gte_inst.mvmva_translation_vector, gte_inst.GetShift(), gte_inst.lm);
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    case 0x13: // NCDS
+    {
+      GenerateGTENormalColorDepthCue(gte_inst.GetShift(), gte_inst.lm);
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    default:
+      break;
+  }
+
   Flush(FLUSH_FOR_C_CALL);
   EmitMov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
   EmitCall(reinterpret_cast<const void*>(func));
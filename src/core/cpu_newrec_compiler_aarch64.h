@@ -38,6 +38,8 @@ protected:
   void EndBlockWithException(Exception excode) override;
   void EndAndLinkBlock(const std::optional<u32>& newpc, bool do_event_test, bool force_run_events);
   const void* EndCompile(u32* code_size, u32* far_code_size) override;
+  bool GenerateTestFunctionPrologue() override;
+  void GenerateTestFunctionEpilogue() override;
 
   void Flush(u32 flags) override;
 
@@ -100,9 +102,11 @@ protected:
                              const std::optional<const vixl::aarch64::WRegister>& reg = std::nullopt);
   template<typename RegAllocFn>
   vixl::aarch64::WRegister GenerateLoad(const vixl::aarch64::WRegister& addr_reg, MemoryAccessSize size, bool sign,
-                                        bool use_fastmem, const RegAllocFn& dst_reg_alloc);
+                                        bool use_fastmem, const RegAllocFn& dst_reg_alloc,
+                                        const std::optional<VirtualMemoryAddress>& address = std::nullopt);
   void GenerateStore(const vixl::aarch64::WRegister& addr_reg, const vixl::aarch64::WRegister& value_reg,
-                     MemoryAccessSize size, bool use_fastmem);
+                     MemoryAccessSize size, bool use_fastmem,
+                     const std::optional<VirtualMemoryAddress>& address = std::nullopt);
   void Compile_lxx(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
                    const std::optional<VirtualMemoryAddress>& address) override;
   void Compile_lwx(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
@@ -126,6 +130,10 @@ protected:
 
   void GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1val, Reg arg2reg = Reg::count,
                                     Reg arg3reg = Reg::count) override;
+  void GeneratePGXPMove(Reg dst, Reg src) override;
+  void GeneratePGXPLoadUpper(Reg rt, u16 imm) override;
+  void GeneratePGXPAddSub(Reg rd, Reg rs, Reg rt, bool sub) override;
+  void GeneratePGXPAddImmediate(Reg rt, Reg rs, u32 imm) override;
 
 private:
   void EmitMov(const vixl::aarch64::WRegister& dst, u32 val);
@@ -154,6 +162,32 @@ private:
   void MoveTToReg(const vixl::aarch64::WRegister& dst, CompileFlags cf);
   void MoveMIPSRegToReg(const vixl::aarch64::WRegister& dst, Reg reg);
 
+  void GeneratePGXPMemoryPointer(const vixl::aarch64::WRegister& addr, const vixl::aarch64::XRegister& ptr,
+                                 const vixl::aarch64::XRegister& temp1, const vixl::aarch64::XRegister& temp2,
+                                 vixl::aarch64::Label* unmapped, vixl::aarch64::Label* unallocated);
+  void GeneratePGXPLoadWord(const vixl::aarch64::WRegister& addr, const vixl::aarch64::WRegister& value,
+                            PGXP_value* dst);
+  void GeneratePGXPStoreWord(const vixl::aarch64::WRegister& addr, const vixl::aarch64::WRegister& value,
+                             PGXP_value* src, const void* slow_func);
+  void GeneratePGXPValidate(PGXP_value* ptr, const vixl::aarch64::WRegister& value);
+  void GeneratePGXPAddHalves(bool sub);
+
+  void GenerateGTESetMAC0();
+  void GenerateGTENormalClip();
+  void GenerateGTEAverageZ(bool four);
+  void GenerateGTECheckMAC(const vixl::aarch64::XRegister& value, const vixl::aarch64::XRegister& extended,
+                           const vixl::aarch64::WRegister& flags, u32 bits, u32 overflow_flag, u32 underflow_flag);
+  void GenerateGTEClamp(const vixl::aarch64::WRegister& value, const vixl::aarch64::WRegister& flags, s32 min_value,
+                        s32 max_value, u32 saturated_flags);
+  void GenerateGTEPerspectiveTransform(const s16* V, u8 shift, bool lm, bool last,
+                                       const vixl::aarch64::WRegister& flags, const vixl::aarch64::XRegister& temp1,
+                                       const vixl::aarch64::XRegister& temp2);
+  void GenerateGTERotateTranslatePerspective(bool triple, u8 shift, bool lm);
+  void GenerateGTEMultiplyMatrixVector(const s16* M, const s32* T, const s16* const V[3], u8 shift, bool lm,
+                                       const vixl::aarch64::WRegister& flags, const vixl::aarch64::XRegister& temp);
+  void GenerateGTEMVMVA(u8 matrix, u8 vector, u8 translation, u8 shift, bool lm);
+  void GenerateGTENormalColorDepthCue(u8 shift, bool lm);
+
   vixl::aarch64::Assembler m_emitter;
   vixl::aarch64::Assembler m_far_emitter;
   vixl::aarch64::Assembler* armAsm;
@@ -14,6 +14,7 @@
 #include "gte.h"
 #include "settings.h"
 #include "timing_event.h"
+#include <climits>
 #include <limits>
 
 #ifdef CPU_ARCH_X64
@@ -232,6 +233,7 @@ void CPU::NewRec::X64Compiler::EndBlock(const std::optional<u32>& newpc, bool do
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+  GenerateIdleLoopSkip(newpc);
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
@@ -334,6 +336,49 @@ const void* CPU::NewRec::X64Compiler::EndCompile(u32* code_size, u32* far_code_s
   return code;
 }
 
+bool CPU::NewRec::X64Compiler::GenerateTestFunctionPrologue()
+{
+  // Any callee-saved register can be allocated, so they all need saving. The stack ends up aligned the same as in the
+  // dispatcher, for C calls.
+  cg->push(cg->rbx);
+  cg->push(cg->rbp);
+  cg->push(cg->r12);
+  cg->push(cg->r13);
+  cg->push(cg->r14);
+  cg->push(cg->r15);
+#ifdef _WIN32
+  cg->push(cg->rdi);
+  cg->push(cg->rsi);
+  cg->sub(cg->rsp, 32 + 8);
+#else
+  cg->sub(cg->rsp, 8);
+#endif
+
+  cg->lea(RSTATE, cg->qword[cg->rip + &g_state]);
+  if (CodeCache::IsUsingFastmem())
+    cg->mov(RMEMBASE, cg->qword[PTR(&g_state.fastmem_base)]);
+
+  return true;
+}
+
+void CPU::NewRec::X64Compiler::GenerateTestFunctionEpilogue()
+{
+#ifdef _WIN32
+  cg->add(cg->rsp, 32 + 8);
+  cg->pop(cg->rsi);
+  cg->pop(cg->rdi);
+#else
+  cg->add(cg->rsp, 8);
+#endif
+  cg->pop(cg->r15);
+  cg->pop(cg->r14);
+  cg->pop(cg->r13);
+  cg->pop(cg->r12);
+  cg->pop(cg->rbp);
+  cg->pop(cg->rbx);
+  cg->ret();
+}
+
 const void* CPU::NewRec::X64Compiler::GetCurrentCodePointer()
 {
   return cg->getCurr();
@@ -525,6 +570,329 @@ void CPU::NewRec::X64Compiler::GeneratePGXPCallWithMIPSRegs(const void* func, u3
   cg->call(func);
 }
 
+void CPU::NewRec::X64Compiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  // Same as PGXP::CPU_MOVE(). Doesn't need any flushing, the ARG registers are never allocated.
+  PGXP_value* const dst_ptr = &g_state.pgxp_gpr[static_cast<u8>(dst)];
+  PGXP_value* const src_ptr = &g_state.pgxp_gpr[static_cast<u8>(src)];
+  Label validated;
+  MoveMIPSRegToReg(RWARG1, dst);
+  cg->cmp(cg->dword[PTR(&src_ptr->value)], RWARG1);
+  cg->je(validated, CodeGenerator::T_SHORT);
+  cg->and_(cg->dword[PTR(&src_ptr->flags)], ~PGXP::FLAGS_VALID_ALL);
+  cg->L(validated);
+
+  if (dst != src)
+  {
+    cg->movups(cg->xmm0, cg->xword[PTR(src_ptr)]);
+    cg->mov(RWARG1, cg->dword[PTR(&src_ptr->flags)]);
+    cg->movups(cg->xword[PTR(dst_ptr)], cg->xmm0);
+    cg->mov(cg->dword[PTR(&dst_ptr->flags)], RWARG1);
+  }
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPLoadUpper(Reg rt, u16 imm)
+{
+  // Same as PGXP::CPU_LUI(), everything is known at compile time.
+  PGXP_value* const ptr = &g_state.pgxp_gpr[static_cast<u8>(rt)];
+  cg->mov(cg->dword[PTR(&ptr->x)], 0);
+  cg->mov(cg->dword[PTR(&ptr->y)], std::bit_cast<u32>(static_cast<float>(static_cast<s16>(imm))));
+  cg->mov(cg->dword[PTR(&ptr->z)], 0);
+  cg->mov(cg->dword[PTR(&ptr->value)], static_cast<u32>(imm) << 16);
+  cg->mov(cg->dword[PTR(&ptr->flags)], PGXP::FLAGS_VALID_XY);
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPValidate(PGXP_value* ptr, const Xbyak::Reg32& value)
+{
+  // Same as PGXP::Validate().
+  Label validated;
+  cg->cmp(cg->dword[PTR(&ptr->value)], value);
+  cg->je(validated, CodeGenerator::T_SHORT);
+  cg->and_(cg->dword[PTR(&ptr->flags)], ~PGXP::FLAGS_VALID_ALL);
+  cg->L(validated);
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPAddHalves(bool sub)
+{
+  // The float part of PGXP::CPU_ADD()/CPU_SUB()/CPU_ADDI(). Takes the x halves in xmm0/xmm1 and the y halves in
+  // xmm2/xmm3, and returns x in xmm0 and y in xmm2. The comparisons are turned into masks, so there's no branches.
+  const Xbyak::Xmm& sx = cg->xmm0;
+  const Xbyak::Xmm& tx = cg->xmm1;
+  const Xbyak::Xmm& sy = cg->xmm2;
+  const Xbyak::Xmm& ty = cg->xmm3;
+  const Xbyak::Xmm& temp1 = cg->xmm4;
+  const Xbyak::Xmm& temp2 = cg->xmm5;
+
+  // f16Unsign(), in double precision like the C version. -0 comes out as +0, but the sum is truncated to a whole
+  // 1/65536 below, so the sign of a zero doesn't make it to the result.
+  cg->mov(RXRET, std::bit_cast<u64>(static_cast<double>(USHRT_MAX + 1)));
+  cg->movq(temp2, RXRET);
+  for (const Xbyak::Xmm& reg : {sx, tx})
+  {
+    cg->cvtss2sd(reg, reg);
+    cg->xorps(temp1, temp1);
+    cg->cmpnlesd(temp1, reg);
+    cg->andpd(temp1, temp2);
+    cg->addsd(reg, temp1);
+    cg->cvtsd2ss(reg, reg);
+  }
+  sub ? cg->subss(sx, tx) : cg->addss(sx, tx);
+
+  // of = (x > USHRT_MAX) ? 1 : (x < 0) ? -1 : 0
+  const Xbyak::Xmm& of = tx;
+  cg->mov(RWRET, std::bit_cast<u32>(static_cast<float>(USHRT_MAX)));
+  cg->movd(of, RWRET);
+  cg->cmpltss(of, sx);
+  cg->mov(RWRET, std::bit_cast<u32>(1.0f));
+  cg->movd(temp1, RWRET);
+  cg->andps(of, temp1);
+  cg->movaps(temp1, sx);
+  cg->xorps(temp2, temp2);
+  cg->cmpltss(temp1, temp2);
+  cg->mov(RWRET, std::bit_cast<u32>(-1.0f));
+  cg->movd(temp2, RWRET);
+  cg->andps(temp1, temp2);
+  cg->orps(of, temp1);
+
+  // f16Sign()
+  cg->cvtss2sd(sx, sx);
+  cg->mov(RXRET, std::bit_cast<u64>(static_cast<double>(USHRT_MAX + 1)));
+  cg->movq(temp2, RXRET);
+  cg->mulsd(sx, temp2);
+  cg->cvttsd2si(RXRET, sx);
+  cg->cvtsi2sd(sx, RWRET);
+  cg->mov(RXRET, std::bit_cast<u64>(1.0 / static_cast<double>(USHRT_MAX + 1)));
+  cg->movq(temp2, RXRET);
+  cg->mulsd(sx, temp2);
+  cg->cvtsd2ss(sx, sx);
+
+  // y += ty + of, or y -= ty - of
+  sub ? cg->subss(ty, of) : cg->addss(ty, of);
+  sub ? cg->subss(sy, ty) : cg->addss(sy, ty);
+
+  // y += (y > SHRT_MAX) ? -(USHRT_MAX + 1) : (y < SHRT_MIN) ? USHRT_MAX + 1 : 0
+  cg->mov(RWRET, std::bit_cast<u32>(static_cast<float>(SHRT_MAX)));
+  cg->movd(temp1, RWRET);
+  cg->cmpltss(temp1, sy);
+  cg->mov(RWRET, std::bit_cast<u32>(static_cast<float>(-(USHRT_MAX + 1))));
+  cg->movd(temp2, RWRET);
+  cg->andps(temp1, temp2);
+  cg->movaps(ty, sy);
+  cg->mov(RWRET, std::bit_cast<u32>(static_cast<float>(SHRT_MIN)));
+  cg->movd(temp2, RWRET);
+  cg->cmpltss(ty, temp2);
+  cg->mov(RWRET, std::bit_cast<u32>(static_cast<float>(USHRT_MAX + 1)));
+  cg->movd(temp2, RWRET);
+  cg->andps(ty, temp2);
+  cg->orps(temp1, ty);
+  cg->addss(sy, temp1);
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPAddSub(Reg rd, Reg rs, Reg rt, bool sub)
+{
+  // Same as PGXP::CPU_ADD()/CPU_SUB(). When only one operand is valid, the other has to be rebuilt from its integer
+  // value, so that's left to the C version. Invalid operands should be rare, so the flush isn't worth avoiding.
+  Flush(FLUSH_FOR_C_CALL);
+
+  PGXP_value* const d_ptr = &g_state.pgxp_gpr[static_cast<u8>(rd)];
+  PGXP_value* const s_ptr = &g_state.pgxp_gpr[static_cast<u8>(rs)];
+  PGXP_value* const t_ptr = &g_state.pgxp_gpr[static_cast<u8>(rt)];
+  Label copy_s, copy_t, calculated, z_merged, slow, done;
+  MoveMIPSRegToReg(RWARG2, rs);
+  MoveMIPSRegToReg(RWARG3, rt);
+  GeneratePGXPValidate(s_ptr, RWARG2);
+  GeneratePGXPValidate(t_ptr, RWARG3);
+
+  // Adding zero is a copy of the other operand, whether it's valid or not.
+  if (!sub)
+  {
+    cg->test(RWARG3, RWARG3);
+    cg->jz(copy_s, CodeGenerator::T_NEAR);
+    cg->test(RWARG2, RWARG2);
+    cg->jz(copy_t, CodeGenerator::T_NEAR);
+  }
+
+  cg->mov(RWRET, cg->dword[PTR(&s_ptr->flags)]);
+  cg->and_(RWRET, cg->dword[PTR(&t_ptr->flags)]);
+  cg->and_(RWRET, PGXP::FLAGS_VALID_XY);
+  cg->cmp(RWRET, PGXP::FLAGS_VALID_XY);
+  cg->jne(slow, CodeGenerator::T_NEAR);
+
+  cg->movss(cg->xmm0, cg->dword[PTR(&s_ptr->x)]);
+  cg->movss(cg->xmm1, cg->dword[PTR(&t_ptr->x)]);
+  cg->movss(cg->xmm2, cg->dword[PTR(&s_ptr->y)]);
+  cg->movss(cg->xmm3, cg->dword[PTR(&t_ptr->y)]);
+  GeneratePGXPAddHalves(sub);
+
+  // ret.halfFlags[0] &= t.halfFlags[0]
+  cg->movss(cg->xmm1, cg->dword[PTR(&s_ptr->z)]);
+  cg->mov(RWRET, cg->dword[PTR(&t_ptr->flags)]);
+  cg->or_(RWRET, 0xFFFF0000u);
+  cg->and_(RWRET, cg->dword[PTR(&s_ptr->flags)]);
+
+  if (!sub)
+  {
+    cg->jmp(calculated, CodeGenerator::T_SHORT);
+    cg->L(copy_t);
+    cg->movss(cg->xmm0, cg->dword[PTR(&t_ptr->x)]);
+    cg->movss(cg->xmm2, cg->dword[PTR(&t_ptr->y)]);
+    cg->movss(cg->xmm1, cg->dword[PTR(&t_ptr->z)]);
+    cg->mov(RWRET, cg->dword[PTR(&t_ptr->flags)]);
+    cg->jmp(calculated, CodeGenerator::T_SHORT);
+    cg->L(copy_s);
+    cg->movss(cg->xmm0, cg->dword[PTR(&s_ptr->x)]);
+    cg->movss(cg->xmm2, cg->dword[PTR(&s_ptr->y)]);
+    cg->movss(cg->xmm1, cg->dword[PTR(&s_ptr->z)]);
+    cg->mov(RWRET, cg->dword[PTR(&s_ptr->flags)]);
+  }
+
+  // Take z from the other operand if the result doesn't have one.
+  cg->L(calculated);
+  cg->test(RWRET, PGXP::FLAGS_VALID_Z);
+  cg->jnz(z_merged, CodeGenerator::T_SHORT);
+  cg->test(cg->dword[PTR(&t_ptr->flags)], PGXP::FLAGS_VALID_Z);
+  cg->jz(z_merged, CodeGenerator::T_SHORT);
+  cg->movss(cg->xmm1, cg->dword[PTR(&t_ptr->z)]);
+  cg->or_(RWRET, PGXP::FLAGS_VALID_Z);
+  cg->L(z_merged);
+
+  cg->movss(cg->dword[PTR(&d_ptr->x)], cg->xmm0);
+  cg->movss(cg->dword[PTR(&d_ptr->y)], cg->xmm2);
+  cg->movss(cg->dword[PTR(&d_ptr->z)], cg->xmm1);
+  cg->mov(cg->dword[PTR(&d_ptr->flags)], RWRET);
+  sub ? cg->sub(RWARG2, RWARG3) : cg->add(RWARG2, RWARG3);
+  cg->mov(cg->dword[PTR(&d_ptr->value)], RWARG2);
+  cg->jmp(done, CodeGenerator::T_NEAR);
+
+  cg->L(slow);
+  cg->mov(RWARG1, inst->bits);
+  cg->call(sub ? reinterpret_cast<const void*>(&PGXP::CPU_SUB) : reinterpret_cast<const void*>(&PGXP::CPU_ADD));
+  cg->L(done);
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPAddImmediate(Reg rt, Reg rs, u32 imm)
+{
+  // Same as PGXP::CPU_ADDI(). The operand is used whether it's valid or not, so this never needs to call out to C.
+  PGXP_value* const d_ptr = &g_state.pgxp_gpr[static_cast<u8>(rt)];
+  PGXP_value* const s_ptr = &g_state.pgxp_gpr[static_cast<u8>(rs)];
+  MoveMIPSRegToReg(RWARG2, rs);
+  GeneratePGXPValidate(s_ptr, RWARG2);
+
+  cg->movss(cg->xmm0, cg->dword[PTR(&s_ptr->x)]);
+  cg->movss(cg->xmm2, cg->dword[PTR(&s_ptr->y)]);
+  if (imm != 0)
+  {
+    cg->mov(RWRET, std::bit_cast<u32>(static_cast<float>(static_cast<u16>(imm))));
+    cg->movd(cg->xmm1, RWRET);
+    cg->mov(RWRET, std::bit_cast<u32>(static_cast<float>(static_cast<s16>(imm >> 16))));
+    cg->movd(cg->xmm3, RWRET);
+    GeneratePGXPAddHalves(false);
+  }
+
+  cg->movss(cg->xmm1, cg->dword[PTR(&s_ptr->z)]);
+  cg->mov(RWRET, cg->dword[PTR(&s_ptr->flags)]);
+  cg->movss(cg->dword[PTR(&d_ptr->x)], cg->xmm0);
+  cg->movss(cg->dword[PTR(&d_ptr->y)], cg->xmm2);
+  cg->movss(cg->dword[PTR(&d_ptr->z)], cg->xmm1);
+  cg->mov(cg->dword[PTR(&d_ptr->flags)], RWRET);
+  cg->add(RWARG2, imm);
+  cg->mov(cg->dword[PTR(&d_ptr->value)], RWARG2);
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPMemoryPointer(const Xbyak::Reg32& addr, const Xbyak::Reg64& ptr,
+                                                         const Xbyak::Reg64& temp1, const Xbyak::Reg64& temp2,
+                                                         Xbyak::Label& unmapped, Xbyak::Label& unallocated)
+{
+  // Same as PGXP::GetMemIndex(), plus the page lookup. The low bits of the address are ignored, like the C version.
+  const Reg32 index = temp1.cvt32();
+  Label not_scratchpad, have_index;
+  cg->mov(index, addr);
+  cg->and_(index, SCRATCHPAD_ADDR_MASK);
+  cg->cmp(index, SCRATCHPAD_ADDR);
+  cg->jne(not_scratchpad, CodeGenerator::T_SHORT);
+  cg->mov(index, addr);
+  cg->and_(index, SCRATCHPAD_OFFSET_MASK);
+  cg->shr(index, 2);
+  cg->add(index, PGXP::MEM_SCRATCH_OFFSET);
+  cg->jmp(have_index, CodeGenerator::T_SHORT);
+
+  cg->L(not_scratchpad);
+  cg->mov(index, addr);
+  cg->and_(index, PHYSICAL_MEMORY_ADDRESS_MASK);
+  cg->cmp(index, Bus::RAM_MIRROR_END);
+  cg->jae(unmapped, CodeGenerator::T_NEAR);
+  cg->and_(index, Bus::g_ram_mask);
+  cg->shr(index, 2);
+
+  cg->L(have_index);
+  cg->mov(temp2.cvt32(), index);
+  cg->shr(temp2.cvt32(), PGXP::MEM_PAGE_SHIFT);
+  cg->mov(ptr, reinterpret_cast<size_t>(PGXP::GetMemoryPageTable()));
+  cg->mov(ptr, cg->qword[ptr + temp2 * 8]);
+  cg->test(ptr, ptr);
+  cg->jz(unallocated, CodeGenerator::T_NEAR);
+
+  // ptr += (index & MASK) * sizeof(PGXP_value)
+  cg->and_(index, PGXP::MEM_PAGE_MASK);
+  cg->lea(temp1, cg->qword[temp1 + temp1 * 4]);
+  cg->lea(ptr, cg->qword[ptr + temp1 * 4]);
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPLoadWord(const Xbyak::Reg32& addr, const Xbyak::Reg32& value,
+                                                    PGXP_value* dst)
+{
+  // Same as PGXP::CPU_LW(). Unallocated pages are all invalid, so nothing here needs to call out to C.
+  DebugAssert(value != RWARG1 && value != RWARG2 && value != RWARG3);
+  DebugAssert(addr != RWARG1 && addr != RWARG2 && addr != RWARG3);
+
+  Label invalid, validated, done;
+  GeneratePGXPMemoryPointer(addr, RXARG3, RXARG1, RXARG2, invalid, invalid);
+  cg->cmp(cg->dword[RXARG3 + offsetof(PGXP_value, value)], value);
+  cg->je(validated, CodeGenerator::T_SHORT);
+  cg->and_(cg->dword[RXARG3 + offsetof(PGXP_value, flags)], ~PGXP::FLAGS_VALID_ALL);
+  cg->L(validated);
+  cg->movups(cg->xmm0, cg->xword[RXARG3]);
+  cg->mov(RWARG1, cg->dword[RXARG3 + offsetof(PGXP_value, flags)]);
+  cg->movups(cg->xword[PTR(dst)], cg->xmm0);
+  cg->mov(cg->dword[PTR(&dst->flags)], RWARG1);
+  cg->jmp(done, CodeGenerator::T_SHORT);
+
+  cg->L(invalid);
+  cg->xorps(cg->xmm0, cg->xmm0);
+  cg->movups(cg->xword[PTR(dst)], cg->xmm0);
+  cg->mov(cg->dword[PTR(&dst->flags)], 0);
+  cg->L(done);
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPStoreWord(const Xbyak::Reg32& addr, const Xbyak::Reg32& value,
+                                                     PGXP_value* src, const void* slow_func)
+{
+  // Same as PGXP::CPU_SW(). The C version is only called when the page needs to be allocated, so the caller has to
+  // have flushed for a C call already.
+  DebugAssert(value != RWARG1 && value != RWARG2 && value != RWARG3);
+  DebugAssert(addr != RWARG1 && addr != RWARG2 && addr != RWARG3);
+
+  Label validated, unallocated, done;
+  cg->cmp(cg->dword[PTR(&src->value)], value);
+  cg->je(validated, CodeGenerator::T_SHORT);
+  cg->and_(cg->dword[PTR(&src->flags)], ~PGXP::FLAGS_VALID_ALL);
+  cg->L(validated);
+
+  GeneratePGXPMemoryPointer(addr, RXARG3, RXARG1, RXARG2, done, unallocated);
+  cg->movups(cg->xmm0, cg->xword[PTR(src)]);
+  cg->mov(RWARG1, cg->dword[PTR(&src->flags)]);
+  cg->movups(cg->xword[RXARG3], cg->xmm0);
+  cg->mov(cg->dword[RXARG3 + offsetof(PGXP_value, flags)], RWARG1);
+  cg->jmp(done, CodeGenerator::T_NEAR);
+
+  cg->L(unallocated);
+  cg->mov(RWARG3, value);
+  cg->mov(RWARG2, addr);
+  cg->mov(RWARG1, inst->bits);
+  cg->call(slow_func);
+  cg->L(done);
+}
+
 void CPU::NewRec::X64Compiler::Flush(u32 flags)
 {
   Compiler::Flush(flags);
@@ -1255,7 +1623,8 @@ CPU::NewRec::X64Compiler::ComputeLoadStoreAddressArg(CompileFlags cf,
 
 template<typename RegAllocFn>
 Xbyak::Reg32 CPU::NewRec::X64Compiler::GenerateLoad(const Xbyak::Reg32& addr_reg, MemoryAccessSize size, bool sign,
-                                                    bool use_fastmem, const RegAllocFn& dst_reg_alloc)
+                                                    bool use_fastmem, const RegAllocFn& dst_reg_alloc,
+                                                    const std::optional<VirtualMemoryAddress>& address)
 {
   if (use_fastmem)
   {
@@ -1308,30 +1677,77 @@ Xbyak::Reg32 CPU::NewRec::X64Compiler::GenerateLoad(const Xbyak::Reg32& addr_reg
     return dst;
   }
 
-  if (addr_reg != RWARG1)
-    cg->mov(RWARG1, addr_reg);
-
   const bool checked = g_settings.cpu_recompiler_memory_exceptions;
-  switch (size)
+  const auto emit_thunk_call = [this, &addr_reg, size, checked]() {
+    if (addr_reg != RWARG1)
+      cg->mov(RWARG1, addr_reg);
+
+    switch (size)
+    {
+      case MemoryAccessSize::Byte:
+      {
+        cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryByte) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryByte));
+      }
+      break;
+      case MemoryAccessSize::HalfWord:
+      {
+        cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryHalfWord) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryHalfWord));
+      }
+      break;
+      case MemoryAccessSize::Word:
+      {
+        cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryWord) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryWord));
+      }
+      break;
+    }
+  };
+
+  if (const std::optional<ConstantMemoryAccess> cma = GetConstantMemoryAccess(address, size, false); cma.has_value())
   {
-    case MemoryAccessSize::Byte:
+    // Isolated cache redirects to the icache, which is left to the thunk in far code.
+    if (cma->check_isc)
     {
-      cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryByte) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryByte));
+      cg->test(cg->dword[PTR(&g_state.cop0_regs.sr.bits)], 1u << 16);
+      SwitchToFarCode(true, &CodeGenerator::jnz);
+      SwitchToNearCode(false);
     }
-    break;
-    case MemoryAccessSize::HalfWord:
+
+    if (!cma->handler)
     {
-      cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryHalfWord) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryHalfWord));
+      const Xbyak::RegExp mem = PTR(&g_state.scratchpad[cma->scratchpad_offset]);
+      switch (size)
+      {
+        case MemoryAccessSize::Byte:
+          cg->movzx(RWRET, cg->byte[mem]);
+          break;
+        case MemoryAccessSize::HalfWord:
+          cg->movzx(RWRET, cg->word[mem]);
+          break;
+        case MemoryAccessSize::Word:
+          cg->mov(RWRET, cg->dword[mem]);
+          break;
+      }
     }
-    break;
-    case MemoryAccessSize::Word:
+    else
     {
-      cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::ReadMemoryWord) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedReadMemoryWord));
+      if (addr_reg != RWARG1)
+        cg->mov(RWARG1, addr_reg);
+      cg->call(cma->handler);
+    }
+
+    if (cma->check_isc)
+    {
+      SwitchToFarCode(false);
+      emit_thunk_call();
+      SwitchToNearCode(true);
     }
-    break;
+  }
+  else
+  {
+    emit_thunk_call();
   }
 
   // TODO: turn this into an asm function instead
@@ -1386,7 +1802,8 @@ Xbyak::Reg32 CPU::NewRec::X64Compiler::GenerateLoad(const Xbyak::Reg32& addr_reg
 }
 
 void CPU::NewRec::X64Compiler::GenerateStore(const Xbyak::Reg32& addr_reg, const Xbyak::Reg32& value_reg,
-                                             MemoryAccessSize size, bool use_fastmem)
+                                             MemoryAccessSize size, bool use_fastmem,
+                                             const std::optional<VirtualMemoryAddress>& address)
 {
   if (use_fastmem)
   {
@@ -1433,26 +1850,71 @@ void CPU::NewRec::X64Compiler::GenerateStore(const Xbyak::Reg32& addr_reg, const
     cg->mov(RWARG2, value_reg);
 
   const bool checked = g_settings.cpu_recompiler_memory_exceptions;
-  switch (size)
+  const auto emit_thunk_call = [this, size, checked]() {
+    switch (size)
+    {
+      case MemoryAccessSize::Byte:
+      {
+        cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryByte) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryByte));
+      }
+      break;
+      case MemoryAccessSize::HalfWord:
+      {
+        cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryHalfWord) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryHalfWord));
+      }
+      break;
+      case MemoryAccessSize::Word:
+      {
+        cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryWord) :
+                           reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryWord));
+      }
+      break;
+    }
+  };
+
+  if (const std::optional<ConstantMemoryAccess> cma = GetConstantMemoryAccess(address, size, true); cma.has_value())
   {
-    case MemoryAccessSize::Byte:
+    // Isolated cache redirects to the icache, which is left to the thunk in far code.
+    if (cma->check_isc)
     {
-      cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryByte) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryByte));
+      cg->test(cg->dword[PTR(&g_state.cop0_regs.sr.bits)], 1u << 16);
+      SwitchToFarCode(true, &CodeGenerator::jnz);
+      SwitchToNearCode(false);
     }
-    break;
-    case MemoryAccessSize::HalfWord:
+
+    if (!cma->handler)
     {
-      cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryHalfWord) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryHalfWord));
+      const Xbyak::RegExp mem = PTR(&g_state.scratchpad[cma->scratchpad_offset]);
+      switch (size)
+      {
+        case MemoryAccessSize::Byte:
+          cg->mov(cg->byte[mem], RWARG2.cvt8());
+          break;
+        case MemoryAccessSize::HalfWord:
+          cg->mov(cg->word[mem], RWARG2.cvt16());
+          break;
+        case MemoryAccessSize::Word:
+          cg->mov(cg->dword[mem], RWARG2);
+          break;
+      }
     }
-    break;
-    case MemoryAccessSize::Word:
+    else
     {
-      cg->call(checked ? reinterpret_cast<const void*>(&Recompiler::Thunks::WriteMemoryWord) :
-                         reinterpret_cast<const void*>(&Recompiler::Thunks::UncheckedWriteMemoryWord));
+      cg->call(cma->handler);
+    }
+
+    if (cma->check_isc)
+    {
+      SwitchToFarCode(false);
+      emit_thunk_call();
+      SwitchToNearCode(true);
     }
-    break;
+  }
+  else
+  {
+    emit_thunk_call();
   }
 
   // TODO: turn this into an asm function instead
@@ -1497,16 +1959,24 @@ void CPU::NewRec::X64Compiler::Compile_lxx(CompileFlags cf, MemoryAccessSize siz
 
     return Reg32(AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
                                  EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, cf.MipsT()));
-  });
+  }, address);
 
   if (g_settings.gpu_pgxp_enable)
   {
-    Flush(FLUSH_FOR_C_CALL);
+    if (size == MemoryAccessSize::Word)
+    {
+      GeneratePGXPLoadWord(addr, data, &g_state.pgxp_gpr[static_cast<u8>(cf.MipsT())]);
+    }
+    else
+    {
+      Flush(FLUSH_FOR_C_CALL);
+
+      cg->mov(RWARG1, inst->bits);
+      cg->mov(RWARG2, addr);
+      cg->mov(RWARG3, data);
+      cg->call(s_pgxp_mem_load_functions[static_cast<u32>(size)][static_cast<u32>(sign)]);
+    }
 
-    cg->mov(RWARG1, inst->bits);
-    cg->mov(RWARG2, addr);
-    cg->mov(RWARG3, data);
-    cg->call(s_pgxp_mem_load_functions[static_cast<u32>(size)][static_cast<u32>(sign)]);
     FreeHostReg(addr_reg.value().getIdx());
   }
 }
@@ -1603,14 +2073,7 @@ void CPU::NewRec::X64Compiler::Compile_lwx(CompileFlags cf, MemoryAccessSize siz
   FreeHostReg(addr.getIdx());
 
   if (g_settings.gpu_pgxp_enable)
-  {
-    DebugAssert(value != RWARG3);
-    cg->mov(RWARG3, value);
-    cg->mov(RWARG2, addr);
-    cg->and_(RWARG2, ~0x3u);
-    cg->mov(RWARG1, inst->bits);
-    cg->call(reinterpret_cast<const void*>(&PGXP::CPU_LW));
-  }
+    GeneratePGXPLoadWord(addr, value, &g_state.pgxp_gpr[static_cast<u8>(inst->r.rt.GetValue())]);
 }
 
 void CPU::NewRec::X64Compiler::Compile_lwc2(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
@@ -1711,15 +2174,24 @@ void CPU::NewRec::X64Compiler::Compile_sxx(CompileFlags cf, MemoryAccessSize siz
   if (!cf.valid_host_t)
     MoveTToReg(RWARG2, cf);
 
-  GenerateStore(addr, data, size, use_fastmem);
+  GenerateStore(addr, data, size, use_fastmem, address);
 
   if (g_settings.gpu_pgxp_enable)
   {
     Flush(FLUSH_FOR_C_CALL);
-    MoveMIPSRegToReg(RWARG3, cf.MipsT());
-    cg->mov(RWARG2, addr);
-    cg->mov(RWARG1, inst->bits);
-    cg->call(s_pgxp_mem_store_functions[static_cast<u32>(size)]);
+    if (size == MemoryAccessSize::Word)
+    {
+      MoveMIPSRegToReg(RWRET, cf.MipsT());
+      GeneratePGXPStoreWord(addr, RWRET, &g_state.pgxp_gpr[static_cast<u8>(cf.MipsT())],
+                            s_pgxp_mem_store_functions[static_cast<u32>(size)]);
+    }
+    else
+    {
+      MoveMIPSRegToReg(RWARG3, cf.MipsT());
+      cg->mov(RWARG2, addr);
+      cg->mov(RWARG1, inst->bits);
+      cg->call(s_pgxp_mem_store_functions[static_cast<u32>(size)]);
+    }
     FreeHostReg(addr_reg.value().getIdx());
   }
 }
@@ -1795,12 +2267,10 @@ void CPU::NewRec::X64Compiler::Compile_swx(CompileFlags cf, MemoryAccessSize siz
     GenerateStore(addr, value, MemoryAccessSize::Word, use_fastmem);
 
     Flush(FLUSH_FOR_C_CALL);
-    cg->mov(RWARG3, value);
+    GeneratePGXPStoreWord(addr, value, &g_state.pgxp_gpr[static_cast<u8>(inst->r.rt.GetValue())],
+                          reinterpret_cast<const void*>(&PGXP::CPU_SW));
     FreeHostReg(value.getIdx());
-    cg->mov(RWARG2, addr);
     FreeHostReg(addr.getIdx());
-    cg->mov(RWARG1, inst->bits);
-    cg->call(reinterpret_cast<const void*>(&PGXP::CPU_SW));
   }
 }
 
@@ -1852,10 +2322,8 @@ void CPU::NewRec::X64Compiler::Compile_swc2(CompileFlags cf, MemoryAccessSize si
   GenerateStore(addr_reg, RWARG2, size, use_fastmem);
 
   Flush(FLUSH_FOR_C_CALL);
-  cg->mov(RWARG3, data_backup);
-  cg->mov(RWARG2, addr_reg);
-  cg->mov(RWARG1, inst->bits);
-  cg->call(reinterpret_cast<const void*>(&PGXP::CPU_SWC2));
+  GeneratePGXPStoreWord(addr_reg, data_backup, &g_state.pgxp_gte[index],
+                        reinterpret_cast<const void*>(&PGXP::CPU_SWC2));
   FreeHostReg(addr_reg.getIdx());
   FreeHostReg(data_backup.getIdx());
 }
@@ -2122,11 +2590,528 @@ void CPU::NewRec::X64Compiler::Compile_mtc2(CompileFlags cf)
   }
 }
 
+void CPU::NewRec::X64Compiler::GenerateGTESetMAC0()
+{
+  // Same as TruncateAndSetMAC<0>() with FLAG cleared. The result is in RXRET, and the new FLAG value is left in RWARG3
+  // with the error bit already set.
+  Label done;
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.MAC0)], RWRET);
+  cg->movsxd(RXARG2, RWRET);
+  cg->xor_(RWARG3, RWARG3);
+  cg->cmp(RXARG2, RXRET);
+  cg->je(done, CodeGenerator::T_SHORT);
+  cg->mov(RWARG3, (1u << 31) | (1u << 16)); // error | mac0_overflow
+  cg->test(RXRET, RXRET);
+  cg->jns(done, CodeGenerator::T_SHORT);
+  cg->mov(RWARG3, (1u << 31) | (1u << 15)); // error | mac0_underflow
+  cg->L(done);
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTENormalClip()
+{
+  // Same as GTE::Execute_NCLIP(), with the sum regrouped as SX0*(SY1-SY2) + SX1*(SY2-SY0) + SX2*(SY0-SY1).
+  GTE::Regs& regs = g_state.gte_regs;
+  cg->movsx(RXARG1, cg->word[PTR(&regs.SXY1[1])]);
+  cg->movsx(RXARG2, cg->word[PTR(&regs.SXY2[1])]);
+  cg->sub(RXARG1, RXARG2);
+  cg->movsx(RXRET, cg->word[PTR(&regs.SXY0[0])]);
+  cg->imul(RXRET, RXARG1);
+
+  cg->movsx(RXARG1, cg->word[PTR(&regs.SXY0[1])]);
+  cg->sub(RXARG2, RXARG1);
+  cg->movsx(RXARG3, cg->word[PTR(&regs.SXY1[0])]);
+  cg->imul(RXARG3, RXARG2);
+  cg->add(RXRET, RXARG3);
+
+  cg->movsx(RXARG2, cg->word[PTR(&regs.SXY1[1])]);
+  cg->sub(RXARG1, RXARG2);
+  cg->movsx(RXARG3, cg->word[PTR(&regs.SXY2[0])]);
+  cg->imul(RXARG3, RXARG1);
+  cg->add(RXRET, RXARG3);
+
+  GenerateGTESetMAC0();
+  cg->mov(cg->dword[PTR(&regs.FLAG.bits)], RWARG3);
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTEAverageZ(bool four)
+{
+  // Same as GTE::Execute_AVSZ3()/Execute_AVSZ4(). The sum fits in 18 bits, only the multiply needs to be 64-bit.
+  GTE::Regs& regs = g_state.gte_regs;
+  cg->movzx(RWRET, cg->word[PTR(&regs.SZ1)]);
+  cg->movzx(RWARG1, cg->word[PTR(&regs.SZ2)]);
+  cg->add(RWRET, RWARG1);
+  cg->movzx(RWARG1, cg->word[PTR(&regs.SZ3)]);
+  cg->add(RWRET, RWARG1);
+  if (four)
+  {
+    cg->movzx(RWARG1, cg->word[PTR(&regs.SZ0)]);
+    cg->add(RWRET, RWARG1);
+  }
+  cg->movsx(RXARG1, cg->word[PTR(four ? &regs.ZSF4 : &regs.ZSF3)]);
+  cg->imul(RXRET, RXARG1);
+
+  GenerateGTESetMAC0();
+
+  // OTZ = clamp(MAC0 SAR 12, 0, FFFFh), the unsigned compare catches negative values too.
+  Label otz_done;
+  cg->sar(RXRET, 12);
+  cg->cmp(RXRET, 0xFFFF);
+  cg->jbe(otz_done, CodeGenerator::T_SHORT);
+  cg->or_(RWARG3, (1u << 31) | (1u << 18)); // error | sz1_otz_saturated
+  cg->xor_(RWARG1, RWARG1);
+  cg->test(RXRET, RXRET);
+  cg->mov(RWRET, 0xFFFF);
+  cg->cmovs(RWRET, RWARG1);
+  cg->L(otz_done);
+  cg->mov(cg->dword[PTR(&regs.dr32[7])], RWRET);
+  cg->mov(cg->dword[PTR(&regs.FLAG.bits)], RWARG3);
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTECheckMAC(const Xbyak::Reg64& value, const Xbyak::Reg64& extended,
+                                                   const Xbyak::Reg32& flags, u32 bits, u32 overflow_flag,
+                                                   u32 underflow_flag)
+{
+  // Same as CheckMACOverflow(). The value sign-extended from the MAC width is left in extended.
+  Label done, underflow;
+  if (bits == 32)
+  {
+    cg->movsxd(extended, value.cvt32());
+  }
+  else
+  {
+    cg->mov(extended, value);
+    cg->shl(extended, 64 - bits);
+    cg->sar(extended, 64 - bits);
+  }
+  cg->cmp(extended, value);
+  cg->je(done, CodeGenerator::T_SHORT);
+  cg->test(value, value);
+  cg->js(underflow, CodeGenerator::T_SHORT);
+  cg->or_(flags, (1u << 31) | overflow_flag);
+  cg->jmp(done, CodeGenerator::T_SHORT);
+  cg->L(underflow);
+  cg->or_(flags, (1u << 31) | underflow_flag);
+  cg->L(done);
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTEClamp(const Xbyak::Reg32& value, const Xbyak::Reg32& flags, s32 min_value,
+                                                s32 max_value, u32 saturated_flags)
+{
+  // Same as TruncateAndSetIR()/PushSXY()/PushSZ(). The flags are only set if saturated_flags is non-zero, and should
+  // include the error bit when the flag feeds into it.
+  Label done, below;
+  cg->cmp(value, max_value);
+  cg->jle(below, CodeGenerator::T_SHORT);
+  cg->mov(value, max_value);
+  if (saturated_flags != 0)
+    cg->or_(flags, saturated_flags);
+  cg->jmp(done, CodeGenerator::T_SHORT);
+  cg->L(below);
+  cg->cmp(value, min_value);
+  cg->jge(done, CodeGenerator::T_SHORT);
+  cg->mov(value, min_value);
+  if (saturated_flags != 0)
+    cg->or_(flags, saturated_flags);
+  cg->L(done);
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTEPerspectiveTransform(const s16* V, u8 shift, bool lm, bool last,
+                                                               const Xbyak::Reg32& flags, const Xbyak::Reg64& temp1,
+                                                               const Xbyak::Reg64& temp2)
+{
+  // Same as GTE::RTPS() without PGXP, with FLAG accumulated in flags. RAX, RCX and RDX are always free, RCX is needed
+  // for variable shifts and RAX/RDX for the widescreen division.
+  GTE::Regs& regs = g_state.gte_regs;
+  const Reg64 rax = cg->rax, rcx = cg->rcx, rdx = cg->rdx;
+  const Reg32 eax = cg->eax, ecx = cg->ecx, edx = cg->edx;
+  const Reg64 acc = temp1;
+
+  // MACn = (TRn*1000h + RTn1*VX + RTn2*VY + RTn3*VZ) SAR (sf*12), the first two sums are sign-extended from 44 bits.
+  for (u32 i = 0; i < 3; i++)
+  {
+    const u32 overflow_flag = 1u << (30 - i);
+    const u32 underflow_flag = 1u << (27 - i);
+
+    cg->movsxd(acc, cg->dword[PTR(&regs.TR[i])]);
+    cg->shl(acc, 12);
+    for (u32 j = 0; j < 3; j++)
+    {
+      cg->movsx(rax, cg->word[PTR(&regs.RT[i][j])]);
+      cg->movsx(rdx, cg->word[PTR(&V[j])]);
+      cg->imul(rax, rdx);
+      cg->add(acc, rax);
+      GenerateGTECheckMAC(acc, rax, flags, 44, overflow_flag, underflow_flag);
+      if (j < 2)
+        cg->mov(acc, rax);
+    }
+
+    cg->mov(rax, acc);
+    if (shift != 0)
+      cg->sar(rax, shift);
+    cg->mov(cg->dword[PTR(&regs.dr32[25 + i])], eax);
+
+    if (i < 2)
+    {
+      GenerateGTEClamp(eax, flags, lm ? 0 : -0x8000, 0x7FFF, (1u << 31) | (1u << (24 - i)));
+      cg->mov(cg->dword[PTR(&regs.dr32[9 + i])], eax);
+      continue;
+    }
+
+    // IR3 is saturated from MAC3, but the flag comes from MAC3 SAR 12 regardless of sf.
+    GenerateGTEClamp(eax, flags, lm ? 0 : -0x8000, 0x7FFF, 0);
+    cg->mov(cg->dword[PTR(&regs.dr32[11])], eax);
+    cg->mov(rax, acc);
+    cg->sar(rax, 12);
+    cg->mov(edx, eax);
+    GenerateGTEClamp(edx, flags, -0x8000, 0x7FFF, 1u << 22);
+
+    // SZ3 = MAC3 SAR 12, pushed to the FIFO.
+    GenerateGTEClamp(eax, flags, 0, 0xFFFF, (1u << 31) | (1u << 18));
+    cg->mov(edx, cg->dword[PTR(&regs.dr32[17])]);
+    cg->mov(cg->dword[PTR(&regs.dr32[16])], edx);
+    cg->mov(edx, cg->dword[PTR(&regs.dr32[18])]);
+    cg->mov(cg->dword[PTR(&regs.dr32[17])], edx);
+    cg->mov(edx, cg->dword[PTR(&regs.dr32[19])]);
+    cg->mov(cg->dword[PTR(&regs.dr32[18])], edx);
+    cg->mov(cg->dword[PTR(&regs.dr32[19])], eax);
+  }
+
+  // Same as GTE::UNRDivide(H, SZ3), SZ3 is in EAX. SZ3 can't be zero past the overflow check.
+  Label divide_done, divide;
+  const Reg32 lhs = temp2.cvt32();
+  cg->movzx(lhs, cg->word[PTR(&regs.H)]);
+  cg->lea(edx, cg->ptr[rax + rax]);
+  cg->cmp(edx, lhs);
+  cg->ja(divide, CodeGenerator::T_SHORT);
+  cg->or_(flags, (1u << 31) | (1u << 17)); // error | divide_overflow
+  cg->mov(eax, 0x1FFFF);
+  cg->jmp(divide_done, CodeGenerator::T_NEAR);
+  cg->L(divide);
+  cg->bsr(ecx, eax);
+  cg->neg(ecx);
+  cg->add(ecx, 15);
+  cg->shl(lhs, cg->cl);
+  cg->shl(eax, cg->cl);
+  cg->mov(edx, eax);
+  cg->and_(edx, 0x7FFF);
+  cg->add(edx, 0x40);
+  cg->shr(edx, 7);
+  cg->mov(rcx, static_cast<size_t>(reinterpret_cast<uintptr_t>(GTE::GetUNRTable())));
+  cg->movzx(edx, cg->byte[rcx + rdx]);
+  cg->add(edx, 0x101);
+  cg->mov(ecx, eax);
+  cg->imul(ecx, edx);
+  cg->neg(ecx);
+  cg->add(ecx, 0x80);
+  cg->sar(ecx, 8);
+  cg->add(ecx, 0x20000);
+  cg->imul(ecx, edx);
+  cg->add(ecx, 0x80);
+  cg->sar(ecx, 8);
+  cg->imul(temp2, rcx);
+  cg->add(temp2, 0x8000);
+  cg->shr(temp2, 16);
+  cg->mov(eax, lhs);
+  cg->mov(edx, 0x1FFFF);
+  cg->cmp(eax, edx);
+  cg->cmova(eax, edx);
+  cg->L(divide_done);
+
+  // The quotient is kept in temp1 for the rest of the command, both upper halves are zero.
+  const Reg64 quotient = temp1;
+  cg->mov(quotient.cvt32(), eax);
+
+  // SX2 = (quotient * IR1 * scale + OFX) SAR 16, SY2 = (quotient * IR2 + OFY) SAR 16
+  Label no_scale;
+  cg->movsx(rax, cg->word[PTR(&regs.IR1)]);
+  cg->imul(rax, quotient);
+  cg->mov(rcx, static_cast<size_t>(reinterpret_cast<uintptr_t>(GTE::GetProjectionScalePtr())));
+  cg->mov(edx, cg->dword[rcx + offsetof(GTE::ProjectionScale, numerator)]);
+  cg->cmp(edx, cg->dword[rcx + offsetof(GTE::ProjectionScale, denominator)]);
+  cg->je(no_scale, CodeGenerator::T_SHORT);
+  cg->movsxd(rdx, edx);
+  cg->imul(rax, rdx);
+  cg->movsxd(rcx, cg->dword[rcx + offsetof(GTE::ProjectionScale, denominator)]);
+  cg->cqo();
+  cg->idiv(rcx);
+  cg->L(no_scale);
+  cg->movsxd(rdx, cg->dword[PTR(&regs.OFX)]);
+  cg->add(rax, rdx);
+  GenerateGTECheckMAC(rax, rdx, flags, 32, 1u << 16, 1u << 15);
+  cg->sar(rax, 16);
+  GenerateGTEClamp(eax, flags, -1024, 1023, (1u << 31) | (1u << 14));
+  cg->movzx(temp2.cvt32(), cg->ax);
+
+  cg->movsx(rax, cg->word[PTR(&regs.IR2)]);
+  cg->imul(rax, quotient);
+  cg->movsxd(rdx, cg->dword[PTR(&regs.OFY)]);
+  cg->add(rax, rdx);
+  GenerateGTECheckMAC(rax, rdx, flags, 32, 1u << 16, 1u << 15);
+  cg->sar(rax, 16);
+  GenerateGTEClamp(eax, flags, -1024, 1023, (1u << 31) | (1u << 13));
+  cg->shl(eax, 16);
+  cg->or_(temp2.cvt32(), eax);
+
+  cg->mov(edx, cg->dword[PTR(&regs.dr32[13])]);
+  cg->mov(cg->dword[PTR(&regs.dr32[12])], edx);
+  cg->mov(edx, cg->dword[PTR(&regs.dr32[14])]);
+  cg->mov(cg->dword[PTR(&regs.dr32[13])], edx);
+  cg->mov(cg->dword[PTR(&regs.dr32[14])], temp2.cvt32());
+
+  if (last)
+  {
+    // MAC0 = quotient * DQA + DQB, IR0 = MAC0 SAR 12
+    cg->movsx(rax, cg->word[PTR(&regs.DQA)]);
+    cg->imul(rax, quotient);
+    cg->movsxd(rdx, cg->dword[PTR(&regs.DQB)]);
+    cg->add(rax, rdx);
+    GenerateGTECheckMAC(rax, rdx, flags, 32, 1u << 16, 1u << 15);
+    cg->mov(cg->dword[PTR(&regs.MAC0)], eax);
+    cg->sar(rax, 12);
+    GenerateGTEClamp(eax, flags, 0, 0x1000, 1u << 12);
+    cg->mov(cg->dword[PTR(&regs.dr32[8])], eax);
+  }
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTERotateTranslatePerspective(bool triple, u8 shift, bool lm)
+{
+  const Reg32 flags = Reg32(AllocateTempHostReg());
+  const Reg64 temp1 = Reg64(AllocateTempHostReg());
+  const Reg64 temp2 = Reg64(AllocateTempHostReg());
+
+  GTE::Regs& regs = g_state.gte_regs;
+  cg->xor_(flags, flags);
+  if (triple)
+  {
+    GenerateGTEPerspectiveTransform(regs.V0, shift, lm, false, flags, temp1, temp2);
+    GenerateGTEPerspectiveTransform(regs.V1, shift, lm, false, flags, temp1, temp2);
+    GenerateGTEPerspectiveTransform(regs.V2, shift, lm, true, flags, temp1, temp2);
+  }
+  else
+  {
+    GenerateGTEPerspectiveTransform(regs.V0, shift, lm, true, flags, temp1, temp2);
+  }
+  cg->mov(cg->dword[PTR(&regs.FLAG.bits)], flags);
+
+  FreeHostReg(temp2.getIdx());
+  FreeHostReg(temp1.getIdx());
+  FreeHostReg(flags.getIdx());
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTEMultiplyMatrixVector(const s16* M, const s32* T, const s16* const V[3],
+                                                               u8 shift, bool lm, const Xbyak::Reg32& flags,
+                                                               const Xbyak::Reg64& temp)
+{
+  // Same as GTE::MulMatVec(), T is null for no translation. V can be the IR vector, so all of the MACs are computed
+  // before any IR is written.
+  GTE::Regs& regs = g_state.gte_regs;
+  const Reg64 rax = cg->rax, rdx = cg->rdx;
+  const Reg32 eax = cg->eax;
+  const Reg64 acc = temp;
+  for (u32 i = 0; i < 3; i++)
+  {
+    const u32 overflow_flag = 1u << (30 - i);
+    const u32 underflow_flag = 1u << (27 - i);
+
+    if (T)
+    {
+      cg->movsxd(acc, cg->dword[PTR(&T[i])]);
+      cg->shl(acc, 12);
+    }
+    else
+    {
+      cg->xor_(acc.cvt32(), acc.cvt32());
+    }
+
+    for (u32 j = 0; j < 3; j++)
+    {
+      cg->movsx(rax, cg->word[PTR(&M[i * 3 + j])]);
+      cg->movsx(rdx, cg->word[PTR(V[j])]);
+      cg->imul(rax, rdx);
+      cg->add(acc, rax);
+      GenerateGTECheckMAC(acc, rax, flags, 44, overflow_flag, underflow_flag);
+      if (j < 2)
+        cg->mov(acc, rax);
+    }
+
+    cg->mov(rax, acc);
+    if (shift != 0)
+      cg->sar(rax, shift);
+    cg->mov(cg->dword[PTR(&regs.dr32[25 + i])], eax);
+  }
+
+  for (u32 i = 0; i < 3; i++)
+  {
+    cg->mov(eax, cg->dword[PTR(&regs.dr32[25 + i])]);
+    GenerateGTEClamp(eax, flags, lm ? 0 : -0x8000, 0x7FFF, (1u << 31) | (1u << (24 - i)));
+    cg->mov(cg->dword[PTR(&regs.dr32[9 + i])], eax);
+  }
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTEMVMVA(u8 matrix, u8 vector, u8 translation, u8 shift, bool lm)
+{
+  // Same as GTE::Execute_MVMVA(), without the garbage matrix or the FC translation bug.
+  DebugAssert(matrix < 3 && translation != 2);
+  GTE::Regs& regs = g_state.gte_regs;
+  const s16* const M_lookup[3] = {&regs.RT[0][0], &regs.LLM[0][0], &regs.LCM[0][0]};
+  const s16* const V_lookup[4][3] = {
+    {&regs.V0[0], &regs.V0[1], &regs.V0[2]},
+    {&regs.V1[0], &regs.V1[1], &regs.V1[2]},
+    {&regs.V2[0], &regs.V2[1], &regs.V2[2]},
+    {&regs.IR1, &regs.IR2, &regs.IR3},
+  };
+  const s32* const T_lookup[4] = {regs.TR, regs.BK, nullptr, nullptr};
+
+  const Reg32 flags = Reg32(AllocateTempHostReg());
+  const Reg64 temp = Reg64(AllocateTempHostReg());
+  cg->xor_(flags, flags);
+  GenerateGTEMultiplyMatrixVector(M_lookup[matrix], T_lookup[translation], V_lookup[vector], shift, lm, flags, temp);
+  cg->mov(cg->dword[PTR(&regs.FLAG.bits)], flags);
+  FreeHostReg(temp.getIdx());
+  FreeHostReg(flags.getIdx());
+}
+
+void CPU::NewRec::X64Compiler::GenerateGTENormalColorDepthCue(u8 shift, bool lm)
+{
+  // Same as GTE::NCDS().
+  GTE::Regs& regs = g_state.gte_regs;
+  const Reg64 rax = cg->rax;
+  const Reg32 eax = cg->eax, edx = cg->edx;
+  const s16* const V0[3] = {&regs.V0[0], &regs.V0[1], &regs.V0[2]};
+  const s16* const IR[3] = {&regs.IR1, &regs.IR2, &regs.IR3};
+
+  const Reg32 flags = Reg32(AllocateTempHostReg());
+  const Reg64 temp1 = Reg64(AllocateTempHostReg());
+  const Reg64 temp2 = Reg64(AllocateTempHostReg());
+  cg->xor_(flags, flags);
+
+  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
+  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
+  GenerateGTEMultiplyMatrixVector(&regs.LLM[0][0], nullptr, V0, shift, lm, flags, temp1);
+  GenerateGTEMultiplyMatrixVector(&regs.LCM[0][0], regs.BK, IR, shift, lm, flags, temp1);
+
+  for (u32 i = 0; i < 3; i++)
+  {
+    const u32 overflow_flag = 1u << (30 - i);
+    const u32 underflow_flag = 1u << (27 - i);
+    const u32 ir_flag = (1u << 31) | (1u << (24 - i));
+
+    // in_MAC = [R,G,B] * IR SHL 4, kept in temp2
+    cg->movzx(eax, cg->byte[PTR(&regs.RGBC[i])]);
+    cg->movsx(edx, cg->word[PTR(IR[i])]);
+    cg->imul(eax, edx);
+    cg->shl(eax, 4);
+    cg->movsxd(temp2, eax);
+
+    // IR = ((FC SHL 12) - in_MAC) SAR (sf*12), saturated without lm
+    cg->movsxd(temp1, cg->dword[PTR(&regs.FC[i])]);
+    cg->shl(temp1, 12);
+    cg->sub(temp1, temp2);
+    GenerateGTECheckMAC(temp1, rax, flags, 44, overflow_flag, underflow_flag);
+    cg->mov(rax, temp1);
+    if (shift != 0)
+      cg->sar(rax, shift);
+    GenerateGTEClamp(eax, flags, -0x8000, 0x7FFF, ir_flag);
+
+    // [MAC,IR] = (IR * IR0 + in_MAC) SAR (sf*12), which can't overflow
+    cg->movsx(edx, cg->word[PTR(&regs.IR0)]);
+    cg->imul(eax, edx);
+    cg->movsxd(rax, eax);
+    cg->add(rax, temp2);
+    if (shift != 0)
+      cg->sar(rax, shift);
+    cg->mov(cg->dword[PTR(&regs.dr32[25 + i])], eax);
+    GenerateGTEClamp(eax, flags, lm ? 0 : -0x8000, 0x7FFF, ir_flag);
+    cg->mov(cg->dword[PTR(&regs.dr32[9 + i])], eax);
+  }
+
+  // Color FIFO = [MAC1 SAR 4, MAC2 SAR 4, MAC3 SAR 4, CODE]
+  const Reg32 rgb = temp2.cvt32();
+  cg->movzx(rgb, cg->byte[PTR(&regs.RGBC[3])]);
+  cg->shl(rgb, 24);
+  for (u32 i = 0; i < 3; i++)
+  {
+    cg->mov(eax, cg->dword[PTR(&regs.dr32[25 + i])]);
+    cg->sar(eax, 4);
+    GenerateGTEClamp(eax, flags, 0, 0xFF, 1u << (21 - i));
+    if (i > 0)
+      cg->shl(eax, i * 8);
+    cg->or_(rgb, eax);
+  }
+  cg->mov(edx, cg->dword[PTR(&regs.dr32[21])]);
+  cg->mov(cg->dword[PTR(&regs.dr32[20])], edx);
+  cg->mov(edx, cg->dword[PTR(&regs.dr32[22])]);
+  cg->mov(cg->dword[PTR(&regs.dr32[21])], edx);
+  cg->mov(cg->dword[PTR(&regs.dr32[22])], rgb);
+
+  cg->mov(cg->dword[PTR(&regs.FLAG.bits)], flags);
+  FreeHostReg(temp2.getIdx());
+  FreeHostReg(temp1.getIdx());
+  FreeHostReg(flags.getIdx());
+}
+
 void CPU::NewRec::X64Compiler::Compile_cop2(CompileFlags cf)
 {
   TickCount func_ticks;
   GTE::InstructionImpl func = GTE::GetInstructionImpl(inst->bits, &func_ticks);
 
+  // The simplest commands only touch the GTE registers, so they can be generated inline without flushing.
+  const GTE::Instruction gte_inst{inst->bits};
+  switch (gte_inst.command)
+  {
+    case 0x06: // NCLIP
+    {
+      if (g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling)
+        break;
+
+      GenerateGTENormalClip();
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    case 0x2D: // AVSZ3
+    case 0x2E: // AVSZ4
+    {
+      GenerateGTEAverageZ(gte_inst.command == 0x2E);
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    case 0x01: // RTPS
+    case 0x30: // RTPT
+    {
+      // PGXP needs the unrounded projection, so leave that to the C version.
+      if (g_settings.gpu_pgxp_enable)
+        break;
+
+      GenerateGTERotateTranslatePerspective(gte_inst.command == 0x30, gte_inst.GetShift(), gte_inst.lm);
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    case 0x12: // MVMVA
+    {
+      // The garbage matrix and the buggy FC translation are rare, so they're left to the C version.
+      if (gte_inst.mvmva_multiply_matrix == 3 || gte_inst.mvmva_translation_vector == 2)
+        break;
+
+      GenerateGTEMVMVA(gte_inst.mvmva_multiply_matrix, gte_inst.mvmva_multiply_vector,
+                       gte_inst.mvmva_translation_vector, gte_inst.GetShift(), gte_inst.lm);
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    case 0x13: // NCDS
+    {
+      GenerateGTENormalColorDepthCue(gte_inst.GetShift(), gte_inst.lm);
+      AddGTETicks(func_ticks);
+      return;
+    }
+
+    default:
+      break;
+  }
+
   Flush(FLUSH_FOR_C_CALL);
   cg->mov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
   cg->call(reinterpret_cast<const void*>(func));
@@ -36,6 +36,8 @@ protected:
   void EndBlockWithException(Exception excode) override;
   void EndAndLinkBlock(const std::optional<u32>& newpc, bool do_event_test, bool force_run_events);
   const void* EndCompile(u32* code_size, u32* far_code_size) override;
+  bool GenerateTestFunctionPrologue() override;
+  void GenerateTestFunctionEpilogue() override;
 
   void Flush(u32 flags) override;
 
@@ -89,9 +91,10 @@ protected:
                                           const std::optional<const Xbyak::Reg32>& reg = std::nullopt);
   template<typename RegAllocFn>
   Xbyak::Reg32 GenerateLoad(const Xbyak::Reg32& addr_reg, MemoryAccessSize size, bool sign, bool use_fastmem,
-                            const RegAllocFn& dst_reg_alloc);
+                            const RegAllocFn& dst_reg_alloc,
+                            const std::optional<VirtualMemoryAddress>& address = std::nullopt);
   void GenerateStore(const Xbyak::Reg32& addr_reg, const Xbyak::Reg32& value_reg, MemoryAccessSize size,
-                     bool use_fastmem);
+                     bool use_fastmem, const std::optional<VirtualMemoryAddress>& address = std::nullopt);
   void Compile_lxx(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
                    const std::optional<VirtualMemoryAddress>& address) override;
   void Compile_lwx(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
@@ -115,6 +118,10 @@ protected:
 
   void GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1val, Reg arg2reg = Reg::count,
                                     Reg arg3reg = Reg::count) override;
+  void GeneratePGXPMove(Reg dst, Reg src) override;
+  void GeneratePGXPLoadUpper(Reg rt, u16 imm) override;
+  void GeneratePGXPAddSub(Reg rd, Reg rs, Reg rt, bool sub) override;
+  void GeneratePGXPAddImmediate(Reg rt, Reg rs, u32 imm) override;
 
 private:
   void SwitchToFarCode(bool emit_jump, void (Xbyak::CodeGenerator::*jump_op)(const void*) = nullptr);
@@ -134,6 +141,29 @@ private:
   void MoveTToReg(const Xbyak::Reg32& dst, CompileFlags cf);
   void MoveMIPSRegToReg(const Xbyak::Reg32& dst, Reg reg);
 
+  void GeneratePGXPMemoryPointer(const Xbyak::Reg32& addr, const Xbyak::Reg64& ptr, const Xbyak::Reg64& temp1,
+                                 const Xbyak::Reg64& temp2, Xbyak::Label& unmapped, Xbyak::Label& unallocated);
+  void GeneratePGXPLoadWord(const Xbyak::Reg32& addr, const Xbyak::Reg32& value, PGXP_value* dst);
+  void GeneratePGXPStoreWord(const Xbyak::Reg32& addr, const Xbyak::Reg32& value, PGXP_value* src,
+                             const void* slow_func);
+  void GeneratePGXPValidate(PGXP_value* ptr, const Xbyak::Reg32& value);
+  void GeneratePGXPAddHalves(bool sub);
+
+  void GenerateGTESetMAC0();
+  void GenerateGTENormalClip();
+  void GenerateGTEAverageZ(bool four);
+  void GenerateGTECheckMAC(const Xbyak::Reg64& value, const Xbyak::Reg64& extended, const Xbyak::Reg32& flags,
+                           u32 bits, u32 overflow_flag, u32 underflow_flag);
+  void GenerateGTEClamp(const Xbyak::Reg32& value, const Xbyak::Reg32& flags, s32 min_value, s32 max_value,
+                        u32 saturated_flags);
+  void GenerateGTEPerspectiveTransform(const s16* V, u8 shift, bool lm, bool last, const Xbyak::Reg32& flags,
+                                       const Xbyak::Reg64& temp1, const Xbyak::Reg64& temp2);
+  void GenerateGTERotateTranslatePerspective(bool triple, u8 shift, bool lm);
+  void GenerateGTEMultiplyMatrixVector(const s16* M, const s32* T, const s16* const V[3], u8 shift, bool lm,
+                                       const Xbyak::Reg32& flags, const Xbyak::Reg64& temp);
+  void GenerateGTEMVMVA(u8 matrix, u8 vector, u8 translation, u8 shift, bool lm);
+  void GenerateGTENormalColorDepthCue(u8 shift, bool lm);
+
   std::unique_ptr<Xbyak::CodeGenerator> m_emitter;
   std::unique_ptr<Xbyak::CodeGenerator> m_far_emitter;
   Xbyak::CodeGenerator* cg;
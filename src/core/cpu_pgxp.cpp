@@ -9,8 +9,12 @@
 #include "common/assert.h"
 #include "common/log.h"
 
+#include <array>
 #include <climits>
 #include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
 
 Log_SetChannel(CPU::PGXP);
 
@@ -21,9 +25,15 @@ enum : u32
 {
   VERTEX_CACHE_WIDTH = 0x800 * 2,
   VERTEX_CACHE_HEIGHT = 0x800 * 2,
-  VERTEX_CACHE_SIZE = VERTEX_CACHE_WIDTH * VERTEX_CACHE_HEIGHT,
+  VERTEX_CACHE_TILE_SHIFT = 5,
+  VERTEX_CACHE_TILE_SIZE = 1 << VERTEX_CACHE_TILE_SHIFT,
+  VERTEX_CACHE_TILE_MASK = VERTEX_CACHE_TILE_SIZE - 1,
+  VERTEX_CACHE_TILES_X = VERTEX_CACHE_WIDTH / VERTEX_CACHE_TILE_SIZE,
+  VERTEX_CACHE_TILE_COUNT = VERTEX_CACHE_TILES_X * (VERTEX_CACHE_HEIGHT / VERTEX_CACHE_TILE_SIZE),
+
   PGXP_MEM_SIZE = (static_cast<u32>(Bus::RAM_8MB_SIZE) + static_cast<u32>(CPU::SCRATCHPAD_SIZE)) / 4,
-  PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4
+  PGXP_MEM_PAGE_COUNT = (PGXP_MEM_SIZE + MEM_PAGE_SIZE - 1) / MEM_PAGE_SIZE,
+  INVALID_MEM_INDEX = 0xFFFFFFFFu,
 };
 
 #define NONE 0
@@ -38,6 +48,11 @@ enum : u32
 #define VALID_ALL (VALID_0 | VALID_1 | VALID_2 | VALID_3)
 #define INV_VALID_ALL (ALL ^ VALID_ALL)
 
+static_assert(MEM_SCRATCH_OFFSET == (Bus::RAM_8MB_SIZE / 4));
+static_assert(FLAGS_VALID_XY == VALID_01 && FLAGS_VALID_Z == VALID_2 && FLAGS_VALID_ALL == VALID_ALL);
+static_assert(sizeof(PGXP_value) == 20 && offsetof(PGXP_value, value) == 12 && offsetof(PGXP_value, flags) == 16,
+              "Recompilers depend on the PGXP_value layout");
+
 union psx_value
 {
   u32 d;
@@ -51,10 +66,62 @@ union psx_value
     s16 l, h;
   } sw;
 };
+
+// The vertex cache is only ever looked up by screen position, so the value isn't needed.
+struct CachedVertex
+{
+  float x;
+  float y;
+  float z;
+  u32 flags;
+};
+
+/// Two-level table, where pages are only allocated when they're first written to. Allocated pages are tracked, so
+/// clearing the table only has to visit the pages which were actually used.
+template<typename T, u32 EntriesPerPage, u32 NumPages>
+class SparseTable
+{
+public:
+  SparseTable() = default;
+  ~SparseTable() { Clear(); }
+
+  SparseTable(const SparseTable&) = delete;
+  SparseTable& operator=(const SparseTable&) = delete;
+
+  ALWAYS_INLINE T* GetPage(u32 page) const { return m_pages[page]; }
+  ALWAYS_INLINE T* const* GetPageTable() const { return m_pages.data(); }
+  ALWAYS_INLINE size_t GetAllocatedPageCount() const { return m_allocated_pages.size(); }
+
+  T* AllocatePage(u32 page)
+  {
+    DebugAssert(!m_pages[page]);
+    T* ptr = static_cast<T*>(std::calloc(EntriesPerPage, sizeof(T)));
+    if (!ptr)
+      return nullptr;
+
+    m_pages[page] = ptr;
+    m_allocated_pages.push_back(page);
+    return ptr;
+  }
+
+  void Clear()
+  {
+    for (const u32 page : m_allocated_pages)
+    {
+      std::free(m_pages[page]);
+      m_pages[page] = nullptr;
+    }
+    m_allocated_pages.clear();
+  }
+
+private:
+  std::array<T*, NumPages> m_pages = {};
+  std::vector<u32> m_allocated_pages;
+};
 } // namespace
 
 static void CacheVertex(s16 sx, s16 sy, const PGXP_value& vertex);
-static PGXP_value* GetCachedVertex(short sx, short sy);
+static const CachedVertex* GetCachedVertex(short sx, short sy);
 
 static float TruncateVertexPosition(float p);
 static bool IsWithinTolerance(float precise_x, float precise_y, int int_x, int int_y);
@@ -68,7 +135,9 @@ static double f16Sign(double in);
 static double f16Unsign(double in);
 static double f16Overflow(double in);
 
+static u32 GetMemIndex(u32 addr);
 static PGXP_value* GetPtr(u32 addr);
+static PGXP_value* GetWritePtr(u32 addr);
 
 static void ValidateAndCopyMem(PGXP_value* dest, u32 addr, u32 value);
 static void ValidateAndCopyMem16(PGXP_value* dest, u32 addr, u32 value, bool sign);
@@ -78,12 +147,17 @@ static void CPU_BITWISE(u32 instr, u32 rdVal, u32 rsVal, u32 rtVal);
 
 static void WriteMem(const PGXP_value* value, u32 addr);
 static void WriteMem16(const PGXP_value* src, u32 addr);
+static void InvalidateMem(u32 addr);
 
 static const PGXP_value PGXP_value_invalid = {0.f, 0.f, 0.f, 0, {0}};
 static const PGXP_value PGXP_value_zero = {0.f, 0.f, 0.f, 0, {VALID_ALL}};
 
-static PGXP_value* s_mem = nullptr;
-static PGXP_value* s_vertex_cache = nullptr;
+static SparseTable<PGXP_value, MEM_PAGE_SIZE, PGXP_MEM_PAGE_COUNT> s_mem;
+static SparseTable<CachedVertex, VERTEX_CACHE_TILE_SIZE * VERTEX_CACHE_TILE_SIZE, VERTEX_CACHE_TILE_COUNT>
+  s_vertex_cache;
+
+// Stands in for memory in pages which haven't been written yet. Readers only ever clear flags, so it stays zeroed.
+static PGXP_value s_untouched_value = {};
 } // namespace CPU::PGXP
 
 void CPU::PGXP::Initialize()
@@ -92,25 +166,8 @@ void CPU::PGXP::Initialize()
   std::memset(g_state.pgxp_cop0, 0, sizeof(g_state.pgxp_cop0));
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
 
-  if (!s_mem)
-  {
-    s_mem = static_cast<PGXP_value*>(std::calloc(PGXP_MEM_SIZE, sizeof(PGXP_value)));
-    if (!s_mem)
-      Panic("Failed to allocate PGXP memory");
-  }
-
-  if (g_settings.gpu_pgxp_vertex_cache && !s_vertex_cache)
-  {
-    s_vertex_cache = static_cast<PGXP_value*>(std::calloc(VERTEX_CACHE_SIZE, sizeof(PGXP_value)));
-    if (!s_vertex_cache)
-    {
-      Log_ErrorPrint("Failed to allocate memory for vertex cache, disabling.");
-      g_settings.gpu_pgxp_vertex_cache = false;
-    }
-  }
-
-  if (s_vertex_cache)
-    std::memset(s_vertex_cache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
+  // Memory and vertex cache pages are allocated on first write.
+  s_vertex_cache.Clear();
 }
 
 void CPU::PGXP::Reset()
@@ -119,31 +176,27 @@ void CPU::PGXP::Reset()
   std::memset(g_state.pgxp_cop0, 0, sizeof(g_state.pgxp_cop0));
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
 
-  if (s_mem)
-    std::memset(s_mem, 0, sizeof(PGXP_value) * PGXP_MEM_SIZE);
-
-  if (s_vertex_cache)
-    std::memset(s_vertex_cache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
+  s_mem.Clear();
+  s_vertex_cache.Clear();
 }
 
 void CPU::PGXP::Shutdown()
 {
-  if (s_vertex_cache)
-  {
-    std::free(s_vertex_cache);
-    s_vertex_cache = nullptr;
-  }
-  if (s_mem)
-  {
-    std::free(s_mem);
-    s_mem = nullptr;
-  }
+  Log_DevFmt("Releasing {} memory pages and {} vertex cache tiles", s_mem.GetAllocatedPageCount(),
+             s_vertex_cache.GetAllocatedPageCount());
+  s_mem.Clear();
+  s_vertex_cache.Clear();
 
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
   std::memset(g_state.pgxp_gpr, 0, sizeof(g_state.pgxp_gpr));
   std::memset(g_state.pgxp_cop0, 0, sizeof(g_state.pgxp_cop0));
 }
 
+CPU::PGXP_value* const* CPU::PGXP::GetMemoryPageTable()
+{
+  return s_mem.GetPageTable();
+}
+
 // Instruction register decoding
 #define op(_instr) (_instr >> 26)          // The op part of the instruction register
 #define func(_instr) ((_instr)&0x3F)       // The funct part of the instruction register
@@ -205,16 +258,44 @@ ALWAYS_INLINE_RELEASE double CPU::PGXP::f16Overflow(double in)
   return out;
 }
 
-ALWAYS_INLINE_RELEASE CPU::PGXP_value* CPU::PGXP::GetPtr(u32 addr)
+ALWAYS_INLINE_RELEASE u32 CPU::PGXP::GetMemIndex(u32 addr)
 {
   if ((addr & SCRATCHPAD_ADDR_MASK) == SCRATCHPAD_ADDR)
-    return &s_mem[PGXP_MEM_SCRATCH_OFFSET + ((addr & SCRATCHPAD_OFFSET_MASK) >> 2)];
+    return MEM_SCRATCH_OFFSET + ((addr & SCRATCHPAD_OFFSET_MASK) >> 2);
 
   const u32 paddr = (addr & PHYSICAL_MEMORY_ADDRESS_MASK);
   if (paddr < Bus::RAM_MIRROR_END)
-    return &s_mem[(paddr & Bus::g_ram_mask) >> 2];
+    return (paddr & Bus::g_ram_mask) >> 2;
   else
+    return INVALID_MEM_INDEX;
+}
+
+ALWAYS_INLINE_RELEASE CPU::PGXP_value* CPU::PGXP::GetPtr(u32 addr)
+{
+  const u32 index = GetMemIndex(addr);
+  if (index == INVALID_MEM_INDEX)
     return nullptr;
+
+  PGXP_value* page = s_mem.GetPage(index >> MEM_PAGE_SHIFT);
+  return page ? &page[index & MEM_PAGE_MASK] : &s_untouched_value;
+}
+
+ALWAYS_INLINE_RELEASE CPU::PGXP_value* CPU::PGXP::GetWritePtr(u32 addr)
+{
+  const u32 index = GetMemIndex(addr);
+  if (index == INVALID_MEM_INDEX)
+    return nullptr;
+
+  const u32 page_index = index >> MEM_PAGE_SHIFT;
+  PGXP_value* page = s_mem.GetPage(page_index);
+  if (!page) [[unlikely]]
+  {
+    page = s_mem.AllocatePage(page_index);
+    if (!page)
+      Panic("Failed to allocate PGXP memory");
+  }
+
+  return &page[index & MEM_PAGE_MASK];
 }
 
 ALWAYS_INLINE_RELEASE void CPU::PGXP::ValidateAndCopyMem(PGXP_value* dest, u32 addr, u32 value)
@@ -285,15 +366,27 @@ ALWAYS_INLINE_RELEASE void CPU::PGXP::ValidateAndCopyMem16(PGXP_value* dest, u32
 
 ALWAYS_INLINE_RELEASE void CPU::PGXP::WriteMem(const PGXP_value* value, u32 addr)
 {
-  PGXP_value* pMem = GetPtr(addr);
+  PGXP_value* pMem = GetWritePtr(addr);
 
   if (pMem)
     *pMem = *value;
 }
 
+ALWAYS_INLINE_RELEASE void CPU::PGXP::InvalidateMem(u32 addr)
+{
+  // Untouched memory is already invalid, so there's no need to allocate a page for it.
+  const u32 index = GetMemIndex(addr);
+  if (index == INVALID_MEM_INDEX)
+    return;
+
+  PGXP_value* page = s_mem.GetPage(index >> MEM_PAGE_SHIFT);
+  if (page)
+    page[index & MEM_PAGE_MASK] = PGXP_value_invalid;
+}
+
 ALWAYS_INLINE_RELEASE void CPU::PGXP::WriteMem16(const PGXP_value* src, u32 addr)
 {
-  PGXP_value* dest = GetPtr(addr);
+  PGXP_value* dest = GetWritePtr(addr);
   if (!dest)
     return;
 
@@ -438,17 +531,36 @@ ALWAYS_INLINE_RELEASE void CPU::PGXP::CacheVertex(s16 sx, s16 sy, const PGXP_val
 {
   if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
   {
+    const u32 x = static_cast<u32>(sx + 0x800);
+    const u32 y = static_cast<u32>(sy + 0x800);
+    const u32 tile_index = (y >> VERTEX_CACHE_TILE_SHIFT) * VERTEX_CACHE_TILES_X + (x >> VERTEX_CACHE_TILE_SHIFT);
+    CachedVertex* tile = s_vertex_cache.GetPage(tile_index);
+    if (!tile) [[unlikely]]
+    {
+      // Not worth stopping over, the vertex just won't be cached.
+      tile = s_vertex_cache.AllocatePage(tile_index);
+      if (!tile)
+        return;
+    }
+
     // Write vertex into cache
-    s_vertex_cache[(sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800)] = vertex;
+    tile[((y & VERTEX_CACHE_TILE_MASK) << VERTEX_CACHE_TILE_SHIFT) | (x & VERTEX_CACHE_TILE_MASK)] =
+      CachedVertex{vertex.x, vertex.y, vertex.z, vertex.flags};
   }
 }
 
-ALWAYS_INLINE_RELEASE CPU::PGXP_value* CPU::PGXP::GetCachedVertex(short sx, short sy)
+ALWAYS_INLINE_RELEASE const CPU::PGXP::CachedVertex* CPU::PGXP::GetCachedVertex(short sx, short sy)
 {
   if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
   {
-    // Return pointer to cache entry
-    return &s_vertex_cache[(sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800)];
+    const u32 x = static_cast<u32>(sx + 0x800);
+    const u32 y = static_cast<u32>(sy + 0x800);
+    const CachedVertex* tile =
+      s_vertex_cache.GetPage((y >> VERTEX_CACHE_TILE_SHIFT) * VERTEX_CACHE_TILES_X + (x >> VERTEX_CACHE_TILE_SHIFT));
+
+    // Return pointer to cache entry, tiles which haven't been written don't have any valid vertices
+    return tile ? &tile[((y & VERTEX_CACHE_TILE_MASK) << VERTEX_CACHE_TILE_SHIFT) | (x & VERTEX_CACHE_TILE_MASK)] :
+                  nullptr;
   }
 
   return nullptr;
@@ -495,12 +607,12 @@ bool CPU::PGXP::GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, i
     const short psx_y = (short)(value >> 16);
 
     // Look in cache for valid vertex
-    vert = GetCachedVertex(psx_x, psx_y);
-    if (vert && (vert->flags & VALID_01) == VALID_01)
+    const CachedVertex* cached = GetCachedVertex(psx_x, psx_y);
+    if (cached && (cached->flags & VALID_01) == VALID_01)
     {
-      *out_x = TruncateVertexPosition(vert->x) + static_cast<float>(xOffs);
-      *out_y = TruncateVertexPosition(vert->y) + static_cast<float>(yOffs);
-      *out_w = vert->z / 32768.0f;
+      *out_x = TruncateVertexPosition(cached->x) + static_cast<float>(xOffs);
+      *out_y = TruncateVertexPosition(cached->y) + static_cast<float>(yOffs);
+      *out_w = cached->z / 32768.0f;
 
       if (IsWithinTolerance(*out_x, *out_y, x, y))
         return false;
@@ -550,7 +662,7 @@ void CPU::PGXP::CPU_LHU(u32 instr, u32 addr, u32 rtVal)
 
 void CPU::PGXP::CPU_SB(u32 instr, u32 addr, u32 rtVal)
 {
-  WriteMem(&PGXP_value_invalid, addr);
+  InvalidateMem(addr);
 }
 
 void CPU::PGXP::CPU_SH(u32 instr, u32 addr, u32 rtVal)
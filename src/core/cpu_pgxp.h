@@ -6,10 +6,26 @@
 
 namespace CPU::PGXP {
 
+// Shadow memory layout, which the recompilers access directly for word loads and stores. Each page holds the values
+// for 4KB of guest memory. Pages are allocated on the first write, so entries in the page table can be null.
+enum : u32
+{
+  MEM_PAGE_SHIFT = 10,
+  MEM_PAGE_SIZE = 1u << MEM_PAGE_SHIFT,
+  MEM_PAGE_MASK = MEM_PAGE_SIZE - 1,
+  MEM_SCRATCH_OFFSET = 0x800000 / 4,
+
+  FLAGS_VALID_XY = 0x00000101u,
+  FLAGS_VALID_Z = 0x00010000u,
+  FLAGS_VALID_ALL = 0x01010101u,
+};
+
 void Initialize();
 void Reset();
 void Shutdown();
 
+PGXP_value* const* GetMemoryPageTable();
+
 // -- GTE functions
 // Transforms
 void GTE_PushSXYZ2f(float x, float y, float z, u32 v);
@@ -2436,6 +2436,18 @@ bool CodeGenerator::Compile_Branch(Instruction instruction, const CodeCache::Ins
       EmitLoadCPUStructField(pending_ticks.GetHostRegister(), RegSize_32, offsetof(State, pending_ticks));
       EmitLoadCPUStructField(downcount.GetHostRegister(), RegSize_32, offsetof(State, downcount));
 
+      // idle loops skip to the next event before looping, which moves pending_ticks
+      const auto skip_idle_loop = [this, &pending_ticks](const Value& target) {
+        if (static_cast<u32>(target.constant_value) != m_block->pc ||
+            !m_block->HasFlag(CodeCache::BlockFlags::IdleLoop))
+        {
+          return;
+        }
+
+        EmitFunctionCall(nullptr, &CodeCache::SkipIdleLoop);
+        EmitLoadCPUStructField(pending_ticks.GetHostRegister(), RegSize_32, offsetof(State, pending_ticks));
+      };
+
       // pending < downcount
       LabelType return_to_dispatcher;
 
@@ -2445,6 +2457,7 @@ bool CodeGenerator::Compile_Branch(Instruction instruction, const CodeCache::Ins
         m_register_cache.PushState();
         {
           WriteNewPC(branch_target, false);
+          skip_idle_loop(branch_target);
           EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
                                 &return_to_dispatcher);
 
@@ -2479,6 +2492,7 @@ bool CodeGenerator::Compile_Branch(Instruction instruction, const CodeCache::Ins
       else
       {
         WriteNewPC(branch_target, true);
+        skip_idle_loop(branch_target);
       }
 
       EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
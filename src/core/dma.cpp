@@ -47,6 +47,7 @@ static constexpr PhysicalMemoryAddress LINKED_LIST_TERMINATOR = UINT32_C(0x00FFF
 
 static constexpr TickCount LINKED_LIST_HEADER_READ_TICKS = 10;
 static constexpr TickCount LINKED_LIST_BLOCK_SETUP_TICKS = 5;
+static constexpr u32 MAX_LINKED_LIST_WALK_PACKETS = 64;
 static constexpr TickCount SLICE_SIZE_WHEN_TRANSMITTING_PAD = 10;
 
 struct ChannelState
@@ -196,9 +197,13 @@ static TickCount TransferMemoryToDevice(u32 address, u32 increment, u32 word_cou
 
 static TickCount GetMaxSliceTicks();
 
+static bool TransferGPULinkedList(ChannelState& cs, PhysicalMemoryAddress* current_address,
+                                  TickCount* remaining_ticks);
+
 // configuration
 static TickCount s_max_slice_ticks = 1000;
 static TickCount s_halt_ticks = 100;
+static bool s_linked_list_fast_path = true;
 
 static std::vector<u32> s_transfer_buffer;
 static std::unique_ptr<TimingEvent> s_unhalt_event;
@@ -236,6 +241,7 @@ void DMA::Initialize()
 {
   s_max_slice_ticks = g_settings.dma_max_slice_ticks;
   s_halt_ticks = g_settings.dma_halt_ticks;
+  s_linked_list_fast_path = g_settings.dma_linked_list_fast_path;
 
   s_unhalt_event =
     TimingEvents::CreateTimingEvent("DMA Transfer Unhalt", 1, s_max_slice_ticks, &DMA::UnhaltTransfer, nullptr, false);
@@ -479,6 +485,11 @@ void DMA::SetHaltTicks(TickCount ticks)
   s_halt_ticks = ticks;
 }
 
+void DMA::SetLinkedListFastPath(bool enabled)
+{
+  s_linked_list_fast_path = enabled;
+}
+
 ALWAYS_INLINE_RELEASE bool DMA::CanTransferChannel(Channel channel, bool ignore_halt)
 {
   if (!s_DPCR.GetMasterEnable(channel))
@@ -605,6 +616,16 @@ bool DMA::TransferChannel()
 
       const TickCount slice_ticks = GetMaxSliceTicks();
       TickCount remaining_ticks = slice_ticks;
+      if constexpr (channel == Channel::GPU)
+      {
+        if (s_linked_list_fast_path && TransferGPULinkedList(cs, &current_address, &remaining_ticks))
+        {
+          cs.base_address = LINKED_LIST_TERMINATOR;
+          CompleteTransfer(channel, cs);
+          return true;
+        }
+      }
+
       while (cs.request && remaining_ticks > 0)
       {
         u32 header;
@@ -741,6 +762,94 @@ bool DMA::TransferChannel()
   UnreachableCode();
 }
 
+bool DMA::TransferGPULinkedList(ChannelState& cs, PhysicalMemoryAddress* current_address, TickCount* remaining_ticks)
+{
+  // Walks ahead in the list and hands every packet found to the GPU in one go. Ticks are charged once the GPU has
+  // consumed the packets, rather than before each one, which is why it can be disabled for timing-sensitive games.
+  // Returns true if the end of the list was reached. Nodes which need the regular path (bus errors, or packets
+  // wrapping around the end of RAM) stop the walk and are left to the caller.
+  const u8* const ram_ptr = Bus::g_ram;
+  const u32 mask = Bus::g_ram_mask;
+
+  std::array<GPU::DMAPacket, MAX_LINKED_LIST_WALK_PACKETS> packets;
+  std::array<PhysicalMemoryAddress, MAX_LINKED_LIST_WALK_PACKETS> packet_next_address;
+  std::array<TickCount, MAX_LINKED_LIST_WALK_PACKETS> packet_end_ticks;
+
+  while (cs.request && *remaining_ticks > 0)
+  {
+    PhysicalMemoryAddress walk_address = *current_address;
+    TickCount walk_ticks = 0;
+    u32 num_packets = 0;
+    bool reached_end = false;
+    bool needs_regular_path = false;
+    while (num_packets < MAX_LINKED_LIST_WALK_PACKETS && walk_ticks < *remaining_ticks)
+    {
+      if ((walk_address + sizeof(u32)) > Bus::RAM_8MB_SIZE) [[unlikely]]
+      {
+        needs_regular_path = true;
+        break;
+      }
+
+      u32 header;
+      const PhysicalMemoryAddress transfer_addr = walk_address & TRANSFER_ADDRESS_MASK;
+      std::memcpy(&header, &ram_ptr[transfer_addr & mask], sizeof(header));
+      const u32 word_count = header >> 24;
+      const u32 next_address = header & 0x00FFFFFFu;
+      if (word_count > 0)
+      {
+        const u32 data_address = (transfer_addr + sizeof(header)) & mask;
+        if (((data_address + (word_count * sizeof(u32))) & mask) <= data_address) [[unlikely]]
+        {
+          needs_regular_path = true;
+          break;
+        }
+
+        walk_ticks +=
+          LINKED_LIST_HEADER_READ_TICKS + LINKED_LIST_BLOCK_SETUP_TICKS + Bus::GetDMARAMTickCount(word_count);
+        packets[num_packets] = {data_address, word_count, reinterpret_cast<const u32*>(&ram_ptr[data_address])};
+        packet_next_address[num_packets] = next_address;
+        packet_end_ticks[num_packets] = walk_ticks;
+        num_packets++;
+      }
+      else
+      {
+        walk_ticks += LINKED_LIST_HEADER_READ_TICKS;
+      }
+
+      walk_address = next_address;
+      if (IsLinkedListTerminator(walk_address))
+      {
+        reached_end = true;
+        break;
+      }
+    }
+
+    // Same as TransferMemoryToDevice(), the packets are still read and the ticks charged when the GPU isn't in
+    // CPU->GP0 mode, but the data is dropped rather than decoded as commands.
+    u32 packets_written = num_packets;
+    if (num_packets > 0 && g_gpu->BeginDMAWrite())
+      packets_written = g_gpu->DMAWritePackets(packets.data(), num_packets);
+    if (packets_written < num_packets)
+    {
+      // GPU stopped accepting data, pick up after the last packet it took once the request is raised again.
+      *current_address = packet_next_address[packets_written - 1];
+      CPU::AddPendingTicks(packet_end_ticks[packets_written - 1]);
+      *remaining_ticks -= packet_end_ticks[packets_written - 1];
+      continue;
+    }
+
+    *current_address = walk_address;
+    CPU::AddPendingTicks(walk_ticks);
+    *remaining_ticks -= walk_ticks;
+    if (reached_end)
+      return true;
+    else if (needs_regular_path)
+      return false;
+  }
+
+  return false;
+}
+
 void DMA::HaltTransfer(TickCount duration)
 {
   s_halt_ticks_remaining += duration;
@@ -807,7 +916,14 @@ TickCount DMA::TransferMemoryToDevice(u32 address, u32 increment, u32 word_count
   {
     case Channel::GPU:
     {
-      if (g_gpu->BeginDMAWrite()) [[likely]]
+      if (!g_gpu->BeginDMAWrite()) [[unlikely]]
+        break;
+
+      if (increment == sizeof(u32) && ((address + (increment * word_count)) & mask) > address) [[likely]]
+      {
+        g_gpu->DMAWriteBlock(address, src_pointer, word_count);
+      }
+      else
       {
         u8* ram_pointer = Bus::g_ram;
         for (u32 i = 0; i < word_count; i++)
@@ -37,6 +37,7 @@ void SetRequest(Channel channel, bool request);
 // changing interfaces
 void SetMaxSliceTicks(TickCount ticks);
 void SetHaltTicks(TickCount ticks);
+void SetLinkedListFastPath(bool enabled);
 
 void DrawDebugStateWindow();
 
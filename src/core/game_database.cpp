@@ -33,7 +33,7 @@ namespace GameDatabase {
 enum : u32
 {
   GAME_DATABASE_CACHE_SIGNATURE = 0x45434C48,
-  GAME_DATABASE_CACHE_VERSION = 7,
+  GAME_DATABASE_CACHE_VERSION = 8,
 };
 
 static Entry* GetMutableEntry(const std::string_view& serial);
@@ -82,6 +82,7 @@ static constexpr const std::array<const char*, static_cast<u32>(GameDatabase::Tr
   "ForceRecompilerMemoryExceptions",
   "ForceRecompilerICache",
   "ForceRecompilerLUTFastmem",
+  "DisableDMALinkedListFastPath",
   "IsLibCryptProtected",
 }};
 
@@ -619,6 +620,12 @@ void GameDatabase::Entry::ApplySettings(Settings& settings, bool display_osd_mes
     settings.cpu_fastmem_mode = CPUFastmemMode::LUT;
   }
 
+  if (HasTrait(Trait::DisableDMALinkedListFastPath))
+  {
+    Log_WarningPrint("DMA linked list fast path disabled by compatibility settings.");
+    settings.dma_linked_list_fast_path = false;
+  }
+
 #define BIT_FOR(ctype) (static_cast<u16>(1) << static_cast<u32>(ctype))
 
   if (supported_controllers != 0 && supported_controllers != static_cast<u16>(-1))
@@ -49,6 +49,7 @@ enum class Trait : u32
   ForceRecompilerMemoryExceptions,
   ForceRecompilerICache,
   ForceRecompilerLUTFastmem,
+  DisableDMALinkedListFastPath,
   IsLibCryptProtected,
 
   Count
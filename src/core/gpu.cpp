@@ -19,6 +19,7 @@
 #include "util/state_wrapper.h"
 
 #include "common/align.h"
+#include "common/error.h"
 #include "common/file_system.h"
 #include "common/heap_array.h"
 #include "common/log.h"
@@ -55,6 +56,7 @@ GPU::GPU()
 
 GPU::~GPU()
 {
+  StopRecordingGPUDump();
   JoinScreenshotThreads();
   DestroyDeinterlaceTextures();
   g_gpu_device->RecycleTexture(std::move(m_chroma_smoothing_texture));
@@ -225,6 +227,13 @@ bool GPU::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_displ
 
   if (sw.IsReading())
   {
+    // the recorded stream would no longer follow on from the dump's initial state
+    if (m_dump_recorder)
+    {
+      Log_WarningPrint("Stopping GPU dump recording due to state load.");
+      StopRecordingGPUDump();
+    }
+
     // perform a reset to discard all pending draws/fb state
     Reset(host_texture == nullptr);
   }
@@ -468,10 +477,14 @@ void GPU::WriteRegister(u32 offset, u32 value)
   {
     case 0x00:
       m_fifo.Push(value);
+      if (m_dump_recorder) [[unlikely]]
+        m_dump_recorder->WriteGP0(value);
       ExecuteCommands();
       return;
 
     case 0x04:
+      if (m_dump_recorder) [[unlikely]]
+        m_dump_recorder->WriteGP1(value);
       WriteGP1(value);
       return;
 
@@ -499,6 +512,122 @@ void GPU::EndDMAWrite()
   ExecuteCommands();
 }
 
+bool GPU::WriteDMAWords(u32 address, const u32* words, u32 word_count)
+{
+  if (m_dump_recorder) [[unlikely]]
+  {
+    for (u32 i = 0; i < word_count; i++)
+      m_dump_recorder->WriteGP0(words[i]);
+  }
+
+  // Linked list packets are usually complete drawing commands, so skip pushing them through the FIFO.
+  u32 words_consumed = 0;
+  if (m_fifo.IsEmpty() && m_blitter_state == BlitterState::Idle)
+    words_consumed = ExecuteCommandBatch(address, words, word_count);
+
+  for (u32 i = words_consumed; i < word_count; i++)
+    m_fifo.Push((ZeroExtend64(address + (i * sizeof(u32))) << 32) | ZeroExtend64(words[i]));
+
+  return (words_consumed == word_count);
+}
+
+void GPU::DMAWriteBlock(u32 address, const u32* words, u32 word_count)
+{
+  WriteDMAWords(address, words, word_count);
+  ExecuteCommands();
+}
+
+u32 GPU::DMAWritePackets(const DMAPacket* packets, u32 num_packets)
+{
+  u32 packets_written = 0;
+  while (packets_written < num_packets)
+  {
+    const DMAPacket& packet = packets[packets_written++];
+    if (!WriteDMAWords(packet.address, packet.words, packet.word_count))
+      break;
+  }
+
+  ExecuteCommands();
+  return packets_written;
+}
+
+bool GPU::StartRecordingGPUDump(const char* path, u32 num_frames, Error* error)
+{
+  StopRecordingGPUDump();
+
+  m_dump_recorder = GPUDump::Recorder::Create(path, this, num_frames, error);
+  return static_cast<bool>(m_dump_recorder);
+}
+
+void GPU::StopRecordingGPUDump()
+{
+  if (!m_dump_recorder)
+    return;
+
+  Error error;
+  if (!m_dump_recorder->Close(&error))
+    Log_ErrorFmt("Failed to finish GPU dump: {}", error.GetDescription());
+
+  m_dump_recorder.reset();
+}
+
+bool GPU::ReplayGP0(const u32* words, u32 num_words, Error* error)
+{
+  while (num_words > 0)
+  {
+    const u32 prev_num_words = num_words;
+    if (m_fifo.IsEmpty() && m_blitter_state == BlitterState::Idle)
+    {
+      m_pending_command_ticks = 0;
+      const u32 words_consumed = ExecuteCommandBatch(0, words, num_words);
+      words += words_consumed;
+      num_words -= words_consumed;
+      if (words_consumed > 0)
+        continue;
+    }
+
+    const u32 words_to_push = std::min(num_words, m_fifo.GetSpace());
+    for (u32 i = 0; i < words_to_push; i++)
+      m_fifo.Push(ZeroExtend64(words[i]));
+    words += words_to_push;
+    num_words -= words_to_push;
+
+    // Run everything that's queued, there's no CPU to overlap with. Stops when the remaining words are an incomplete
+    // command, which will be completed by the next packet.
+    for (;;)
+    {
+      const u32 prev_fifo_size = m_fifo.GetSize();
+      const BlitterState prev_blitter_state = m_blitter_state;
+
+      m_pending_command_ticks = 0;
+      TryExecuteCommands();
+
+      // Nobody's reading the data back, so just drain it.
+      while (m_blitter_state == BlitterState::ReadingVRAM)
+        ReadGPUREAD();
+
+      if (m_fifo.IsEmpty() || (m_fifo.GetSize() == prev_fifo_size && m_blitter_state == prev_blitter_state))
+        break;
+    }
+
+    // A full FIFO which can't execute anything will never accept the rest of the packet.
+    if (num_words == prev_num_words && m_fifo.GetSpace() == 0)
+    {
+      Error::SetStringFmt(error, "GP0 FIFO is stuck with {} words pending, the dump is malformed or truncated.",
+                          num_words);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void GPU::ReplayVSync()
+{
+  FlushRender();
+  UpdateDisplay();
+}
+
 /**
  * NTSC GPU clock 53.693175 MHz
  * PAL GPU clock 53.203425 MHz
@@ -971,6 +1100,13 @@ void GPU::CRTCTickEvent(TickCount ticks)
         UpdateDisplay();
         TimingEvents::SetFrameDone();
 
+        if (m_dump_recorder) [[unlikely]]
+        {
+          m_dump_recorder->WriteVSync();
+          if (m_dump_recorder->IsComplete())
+            StopRecordingGPUDump();
+        }
+
         // switch fields early. this is needed so we draw to the correct one.
         if (m_GPUSTAT.InInterleaved480iMode())
           m_crtc_state.interlaced_display_field = m_crtc_state.interlaced_field ^ 1u;
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #pragma once
+#include "gpu_dump.h"
 #include "gpu_types.h"
 #include "timers.h"
 #include "types.h"
@@ -21,6 +22,7 @@
 #include <tuple>
 #include <vector>
 
+class Error;
 class SmallStringBase;
 
 class StateWrapper;
@@ -121,9 +123,34 @@ public:
   ALWAYS_INLINE void DMAWrite(u32 address, u32 value)
   {
     m_fifo.Push((ZeroExtend64(address) << 32) | ZeroExtend64(value));
+    if (m_dump_recorder) [[unlikely]]
+      m_dump_recorder->WriteGP0(value);
   }
   void EndDMAWrite();
 
+  /// Writes a contiguous block of words from RAM, and ends the DMA write.
+  void DMAWriteBlock(u32 address, const u32* words, u32 word_count);
+
+  /// Writes a sequence of linked list packets. Stops after any packet which leaves data in the FIFO, so the DMA
+  /// request can be re-checked, and returns the number of packets consumed.
+  struct DMAPacket
+  {
+    u32 address;
+    u32 word_count;
+    const u32* words;
+  };
+  u32 DMAWritePackets(const DMAPacket* packets, u32 num_packets);
+
+  // GPU dump recording. num_frames of zero records until stopped.
+  ALWAYS_INLINE bool IsRecordingGPUDump() const { return static_cast<bool>(m_dump_recorder); }
+  bool StartRecordingGPUDump(const char* path, u32 num_frames, Error* error);
+  void StopRecordingGPUDump();
+
+  // GPU dump replay. Commands are executed immediately, ignoring command timing.
+  bool ReplayGP0(const u32* words, u32 num_words, Error* error);
+  void ReplayVSync();
+  ALWAYS_INLINE u32 GetPrimitiveCounter() const { return m_counters.num_primitives; }
+
   /// Returns true if no data is being sent from VRAM to the DAC or that no portion of VRAM would be visible on screen.
   ALWAYS_INLINE bool IsDisplayDisabled() const
   {
@@ -308,6 +335,8 @@ protected:
   void EndCommand();
   void ExecuteCommands();
   void TryExecuteCommands();
+  u32 ExecuteCommandBatch(u32 address, const u32* words, u32 word_count);
+  bool WriteDMAWords(u32 address, const u32* words, u32 word_count);
   void HandleGetGPUInfoCommand(u32 value);
 
   // Rendering in the backend
@@ -560,9 +589,40 @@ protected:
   u32 m_blit_remaining_words;
   GPURenderCommand m_render_command{};
 
-  ALWAYS_INLINE u32 FifoPop() { return Truncate32(m_fifo.Pop()); }
-  ALWAYS_INLINE u32 FifoPeek() { return Truncate32(m_fifo.Peek()); }
-  ALWAYS_INLINE u32 FifoPeek(u32 i) { return Truncate32(m_fifo.Peek(i)); }
+  // Command words are read from the batch source instead of the FIFO while ExecuteCommandBatch() is running.
+  const u32* m_batch_ptr = nullptr;
+  const u32* m_batch_end = nullptr;
+  u32 m_batch_address = 0;
+
+  ALWAYS_INLINE u64 FifoPopWithAddress()
+  {
+    if (m_batch_ptr)
+    {
+      const u64 value = (ZeroExtend64(m_batch_address) << 32) | ZeroExtend64(*(m_batch_ptr++));
+      m_batch_address += sizeof(u32);
+      return value;
+    }
+
+    return m_fifo.Pop();
+  }
+  ALWAYS_INLINE u32 FifoPop() { return Truncate32(FifoPopWithAddress()); }
+  ALWAYS_INLINE u32 FifoPeek() { return FifoPeek(0); }
+  ALWAYS_INLINE u32 FifoPeek(u32 i) { return m_batch_ptr ? m_batch_ptr[i] : Truncate32(m_fifo.Peek(i)); }
+  ALWAYS_INLINE void FifoRemoveOne()
+  {
+    if (m_batch_ptr)
+    {
+      m_batch_ptr++;
+      m_batch_address += sizeof(u32);
+      return;
+    }
+
+    m_fifo.RemoveOne();
+  }
+  ALWAYS_INLINE u32 FifoSize() const
+  {
+    return m_batch_ptr ? static_cast<u32>(m_batch_end - m_batch_ptr) : m_fifo.GetSize();
+  }
 
   TickCount m_max_run_ahead = 128;
   u32 m_fifo_size = 128;
@@ -635,6 +695,8 @@ protected:
   Counters m_counters = {};
   Stats m_stats = {};
 
+  std::unique_ptr<GPUDump::Recorder> m_dump_recorder;
+
 private:
   bool CompileDisplayPipelines(bool display, bool deinterlace, bool chroma_smoothing);
 
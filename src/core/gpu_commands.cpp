@@ -11,7 +11,7 @@
 Log_SetChannel(GPU);
 
 #define CHECK_COMMAND_SIZE(num_words)                                                                                  \
-  if (m_fifo.GetSize() < num_words)                                                                                    \
+  if (FifoSize() < num_words)                                                                                          \
   {                                                                                                                    \
     m_command_total_words = num_words;                                                                                 \
     return false;                                                                                                      \
@@ -25,6 +25,40 @@ static constexpr u32 ReplaceZero(u32 value, u32 value_for_zero)
   return value == 0 ? value_for_zero : value;
 }
 
+// Size in words of the commands which ExecuteCommandBatch() can decode in place, zero for anything else.
+static constexpr std::array<u8, 256> GenerateBatchCommandSizeTable()
+{
+  std::array<u8, 256> table = {};
+  table[0x00] = 1;
+  for (u32 i = 0x20; i <= 0x7F; i++)
+  {
+    const u32 textured = (i >> 2) & 1u;
+    const u32 shaded = (i >> 4) & 1u;
+    switch (static_cast<GPUPrimitive>(i >> 5))
+    {
+      case GPUPrimitive::Polygon:
+        table[i] = static_cast<u8>((1 + textured + shaded) * (((i >> 3) & 1u) ? 4 : 3) + (shaded ^ 1u));
+        break;
+
+      case GPUPrimitive::Line:
+        // polylines are terminated rather than sized, so they always go through the FIFO
+        table[i] = ((i >> 3) & 1u) ? 0 : static_cast<u8>(3 + shaded);
+        break;
+
+      case GPUPrimitive::Rectangle:
+        table[i] = static_cast<u8>(2 + textured + BoolToUInt32(((i >> 3) & 3u) == 0));
+        break;
+
+      default:
+        break;
+    }
+  }
+  for (u32 i = 0xE1; i <= 0xE6; i++)
+    table[i] = 1;
+  return table;
+}
+static constexpr std::array<u8, 256> s_batch_command_sizes = GenerateBatchCommandSizeTable();
+
 void GPU::TryExecuteCommands()
 {
   while (m_pending_command_ticks <= m_max_run_ahead && !m_fifo.IsEmpty())
@@ -114,6 +148,74 @@ void GPU::ExecuteCommands()
     UpdateCommandTickEvent();
 }
 
+u32 GPU::ExecuteCommandBatch(u32 address, const u32* words, u32 word_count)
+{
+  DebugAssert(m_fifo.IsEmpty() && m_blitter_state == BlitterState::Idle);
+
+  // Decodes complete drawing and state commands straight from the source, without going through the FIFO. Anything
+  // else (transfers, polylines, or a command split across blocks) stops the batch, and is left for the FIFO path.
+  m_batch_ptr = words;
+  m_batch_end = words + word_count;
+  m_batch_address = address;
+
+  while (m_batch_ptr != m_batch_end && m_pending_command_ticks <= m_max_run_ahead)
+  {
+    const u32 command = *m_batch_ptr >> 24;
+    const u32 command_size = s_batch_command_sizes[command];
+    if (command_size == 0 || command_size > static_cast<u32>(m_batch_end - m_batch_ptr))
+      break;
+
+    switch (command >> 5)
+    {
+      case static_cast<u32>(GPUPrimitive::Polygon):
+        HandleRenderPolygonCommand();
+        break;
+
+      case static_cast<u32>(GPUPrimitive::Line):
+        HandleRenderLineCommand();
+        break;
+
+      case static_cast<u32>(GPUPrimitive::Rectangle):
+        HandleRenderRectangleCommand();
+        break;
+
+      default:
+      {
+        switch (command)
+        {
+          case 0xE1:
+            HandleSetDrawModeCommand();
+            break;
+          case 0xE2:
+            HandleSetTextureWindowCommand();
+            break;
+          case 0xE3:
+            HandleSetDrawingAreaTopLeftCommand();
+            break;
+          case 0xE4:
+            HandleSetDrawingAreaBottomRightCommand();
+            break;
+          case 0xE5:
+            HandleSetDrawingOffsetCommand();
+            break;
+          case 0xE6:
+            HandleSetMaskBitCommand();
+            break;
+          default:
+            HandleNOPCommand();
+            break;
+        }
+      }
+      break;
+    }
+  }
+
+  const u32 words_consumed = static_cast<u32>(m_batch_ptr - words);
+  m_batch_ptr = nullptr;
+  m_batch_end = nullptr;
+  return words_consumed;
+}
+
 void GPU::EndCommand()
 {
   m_blitter_state = BlitterState::Idle;
@@ -178,18 +280,18 @@ bool GPU::HandleUnknownGP0Command()
   Log_ErrorPrintf("Unimplemented GP0 command 0x%02X", command);
 
   SmallString dump;
-  for (u32 i = 0; i < m_fifo.GetSize(); i++)
+  for (u32 i = 0; i < FifoSize(); i++)
     dump.append_format("{}{:08X}", (i > 0) ? " " : "", FifoPeek(i));
   Log_ErrorPrintf("FIFO: %s", dump.c_str());
 
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
   EndCommand();
   return true;
 }
 
 bool GPU::HandleNOPCommand()
 {
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
   EndCommand();
   return true;
 }
@@ -198,7 +300,7 @@ bool GPU::HandleClearCacheCommand()
 {
   Log_DebugPrintf("GP0 clear cache");
   m_draw_mode.SetTexturePageChanged();
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
   AddCommandTicks(1);
   EndCommand();
   return true;
@@ -211,7 +313,7 @@ bool GPU::HandleInterruptRequestCommand()
   m_GPUSTAT.interrupt_request = true;
   InterruptController::SetLineState(InterruptController::IRQ::GPU, m_GPUSTAT.interrupt_request);
 
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
   AddCommandTicks(1);
   EndCommand();
   return true;
@@ -352,7 +454,7 @@ bool GPU::HandleRenderPolygonCommand()
   m_counters.num_vertices += num_vertices;
   m_counters.num_primitives++;
   m_render_command.bits = rc.bits;
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
 
   DispatchRenderCommand();
   EndCommand();
@@ -384,7 +486,7 @@ bool GPU::HandleRenderRectangleCommand()
   m_counters.num_vertices++;
   m_counters.num_primitives++;
   m_render_command.bits = rc.bits;
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
 
   DispatchRenderCommand();
   EndCommand();
@@ -406,7 +508,7 @@ bool GPU::HandleRenderLineCommand()
   m_counters.num_vertices += 2;
   m_counters.num_primitives++;
   m_render_command.bits = rc.bits;
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
 
   DispatchRenderCommand();
   EndCommand();
@@ -430,7 +532,7 @@ bool GPU::HandleRenderPolyLineCommand()
                   rc.shading_enable ? "shaded" : "monochrome", setup_ticks);
 
   m_render_command.bits = rc.bits;
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
 
   const u32 words_to_pop = min_words - 1;
   // m_blit_buffer.resize(words_to_pop);
@@ -474,7 +576,7 @@ bool GPU::HandleFillRectangleCommand()
 bool GPU::HandleCopyRectangleCPUToVRAMCommand()
 {
   CHECK_COMMAND_SIZE(3);
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
 
   const u32 dst_x = FifoPeek() & VRAM_WIDTH_MASK;
   const u32 dst_y = (FifoPop() >> 16) & VRAM_HEIGHT_MASK;
@@ -558,7 +660,7 @@ void GPU::FinishVRAMWrite()
 bool GPU::HandleCopyRectangleVRAMToCPUCommand()
 {
   CHECK_COMMAND_SIZE(3);
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
 
   m_vram_transfer.x = Truncate16(FifoPeek() & VRAM_WIDTH_MASK);
   m_vram_transfer.y = Truncate16((FifoPop() >> 16) & VRAM_HEIGHT_MASK);
@@ -592,7 +694,7 @@ bool GPU::HandleCopyRectangleVRAMToCPUCommand()
 bool GPU::HandleCopyRectangleVRAMToVRAMCommand()
 {
   CHECK_COMMAND_SIZE(4);
-  m_fifo.RemoveOne();
+  FifoRemoveOne();
 
   const u32 src_x = FifoPeek() & VRAM_WIDTH_MASK;
   const u32 src_y = (FifoPop() >> 16) & VRAM_HEIGHT_MASK;
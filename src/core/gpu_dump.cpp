@@ -0,0 +1,297 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "gpu_dump.h"
+#include "gpu.h"
+#include "save_state_version.h"
+
+#include "util/state_wrapper.h"
+
+#include "common/byte_stream.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/log.h"
+
+#include <cstring>
+
+Log_SetChannel(GPUDump);
+
+namespace GPUDump {
+
+// File layout, all little-endian u32s:
+//   magic, file version, save state version
+//   packets: header (type << 24 | payload size in words), payload
+// The first packet is always the GPU state, and the last is always End.
+static constexpr u32 FILE_MAGIC = 0x55504750; // PGPU
+static constexpr u32 FILE_VERSION = 1;
+static constexpr u32 FILE_HEADER_WORDS = 3;
+static constexpr u32 MAX_PACKET_WORDS = 0xFFFFFF;
+
+static constexpr u32 MakePacketHeader(PacketType type, u32 num_words)
+{
+  return (static_cast<u32>(type) << 24) | num_words;
+}
+
+} // namespace GPUDump
+
+GPUDump::Recorder::Recorder(std::FILE* fp, std::string path, u32 num_frames)
+  : m_fp(fp), m_path(std::move(path)), m_frames_to_record(num_frames)
+{
+  m_gp0_buffer.reserve(GP0_BUFFER_FLUSH_SIZE);
+}
+
+GPUDump::Recorder::~Recorder()
+{
+  if (m_fp)
+    Close(nullptr);
+}
+
+std::unique_ptr<GPUDump::Recorder> GPUDump::Recorder::Create(const char* path, GPU* gpu, u32 num_frames,
+                                                               Error* error)
+{
+  std::unique_ptr<GrowableMemoryByteStream> state_stream = ByteStream::CreateGrowableMemoryStream();
+  {
+    StateWrapper sw(state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    if (!gpu->DoState(sw, nullptr, false) || sw.HasError())
+    {
+      Error::SetStringView(error, "Failed to save GPU state.");
+      return {};
+    }
+  }
+
+  std::FILE* fp = FileSystem::OpenCFile(path, "wb", error);
+  if (!fp)
+    return {};
+
+  std::unique_ptr<Recorder> recorder(new Recorder(fp, path, num_frames));
+
+  const u32 header[FILE_HEADER_WORDS] = {FILE_MAGIC, FILE_VERSION, SAVE_STATE_VERSION};
+  if (std::fwrite(header, sizeof(header), 1, fp) != 1)
+  {
+    Error::SetErrno(error, "fwrite() failed: ", errno);
+    return {};
+  }
+
+  // State is stored as a byte count followed by the data, padded to a word.
+  const u32 state_size = static_cast<u32>(state_stream->GetPosition());
+  std::vector<u32> state_data(1 + ((state_size + (sizeof(u32) - 1)) / sizeof(u32)));
+  state_data[0] = state_size;
+  std::memcpy(&state_data[1], state_stream->GetMemoryPointer(), state_size);
+  recorder->WritePacket(PacketType::GPUState, state_data.data(), static_cast<u32>(state_data.size()));
+  if (recorder->m_write_error)
+  {
+    Error::SetErrno(error, "fwrite() failed: ", errno);
+    return {};
+  }
+
+  Log_InfoFmt("Recording GPU dump to '{}' ({} bytes of state).", recorder->m_path, state_size);
+  return recorder;
+}
+
+void GPUDump::Recorder::WritePacket(PacketType type, const void* data, u32 num_words)
+{
+  DebugAssert(num_words <= MAX_PACKET_WORDS);
+
+  const u32 header = MakePacketHeader(type, num_words);
+  m_write_error |= (std::fwrite(&header, sizeof(header), 1, m_fp) != 1);
+  if (num_words > 0)
+    m_write_error |= (std::fwrite(data, sizeof(u32) * num_words, 1, m_fp) != 1);
+}
+
+void GPUDump::Recorder::FlushGP0()
+{
+  if (m_gp0_buffer.empty())
+    return;
+
+  WritePacket(PacketType::GP0Data, m_gp0_buffer.data(), static_cast<u32>(m_gp0_buffer.size()));
+  m_gp0_buffer.clear();
+}
+
+void GPUDump::Recorder::WriteGP1(u32 value)
+{
+  FlushGP0();
+  WritePacket(PacketType::GP1Command, &value, 1);
+}
+
+void GPUDump::Recorder::WriteVSync()
+{
+  FlushGP0();
+  WritePacket(PacketType::VSync, nullptr, 0);
+  m_frame_count++;
+}
+
+bool GPUDump::Recorder::Close(Error* error)
+{
+  FlushGP0();
+  WritePacket(PacketType::End, nullptr, 0);
+
+  const bool result = (std::fclose(m_fp) == 0 && !m_write_error);
+  m_fp = nullptr;
+  if (!result)
+  {
+    Error::SetStringFmt(error, "Failed to write GPU dump '{}'.", m_path);
+    return false;
+  }
+
+  Log_InfoFmt("Wrote {} frames to GPU dump '{}'.", m_frame_count, m_path);
+  return true;
+}
+
+GPUDump::Player::Player(std::vector<u32> data) : m_data(std::move(data))
+{
+}
+
+GPUDump::Player::~Player() = default;
+
+std::unique_ptr<GPUDump::Player> GPUDump::Player::Open(const char* path, Error* error)
+{
+  std::optional<std::vector<u8>> bytes = FileSystem::ReadBinaryFile(path, error);
+  if (!bytes.has_value())
+    return {};
+
+  if ((bytes->size() % sizeof(u32)) != 0 || bytes->size() < (FILE_HEADER_WORDS * sizeof(u32)))
+  {
+    Error::SetStringFmt(error, "'{}' is not a GPU dump.", path);
+    return {};
+  }
+
+  std::vector<u32> data(bytes->size() / sizeof(u32));
+  std::memcpy(data.data(), bytes->data(), bytes->size());
+
+  std::unique_ptr<Player> player(new Player(std::move(data)));
+  if (!player->Parse(error))
+    return {};
+
+  return player;
+}
+
+bool GPUDump::Player::Parse(Error* error)
+{
+  if (m_data[0] != FILE_MAGIC || m_data[1] != FILE_VERSION)
+  {
+    Error::SetStringView(error, "Incorrect GPU dump header or version.");
+    return false;
+  }
+
+  m_state_version = m_data[2];
+  if (m_state_version < SAVE_STATE_MINIMUM_VERSION || m_state_version > SAVE_STATE_VERSION)
+  {
+    Error::SetStringFmt(error, "Unsupported GPU state version {}.", m_state_version);
+    return false;
+  }
+
+  // Walk the packets once to validate them and count frames.
+  u32 pos = FILE_HEADER_WORDS;
+  bool found_end = false;
+  while (pos < m_data.size() && !found_end)
+  {
+    const PacketType type = static_cast<PacketType>(m_data[pos] >> 24);
+    const u32 num_words = m_data[pos] & MAX_PACKET_WORDS;
+    const u32 payload = pos + 1;
+    if ((m_data.size() - payload) < num_words)
+      break;
+
+    switch (type)
+    {
+      case PacketType::GPUState:
+      {
+        if (num_words == 0 || m_data[payload] > ((num_words - 1) * sizeof(u32)))
+        {
+          Error::SetStringView(error, "Corrupted GPU state packet.");
+          return false;
+        }
+
+        m_state_size = m_data[payload];
+        m_state_offset = payload + 1;
+        m_first_packet_offset = payload + num_words;
+      }
+      break;
+
+      case PacketType::VSync:
+        m_frame_count++;
+        break;
+
+      case PacketType::End:
+        found_end = true;
+        break;
+
+      case PacketType::GP0Data:
+      case PacketType::GP1Command:
+        break;
+
+      default:
+      {
+        Error::SetStringFmt(error, "Unknown packet type {} at offset {}.", static_cast<u32>(type), pos);
+        return false;
+      }
+    }
+
+    pos = payload + num_words;
+  }
+
+  if (m_state_offset == 0)
+  {
+    Error::SetStringView(error, "GPU dump has no initial state.");
+    return false;
+  }
+
+  if (!found_end)
+    Log_WarningPrint("GPU dump is truncated, replaying what's there.");
+
+  return true;
+}
+
+bool GPUDump::Player::Reset(GPU* gpu, Error* error)
+{
+  ReadOnlyMemoryByteStream stream(&m_data[m_state_offset], m_state_size);
+  StateWrapper sw(&stream, StateWrapper::Mode::Read, m_state_version);
+  if (!gpu->DoState(sw, nullptr, true) || sw.HasError())
+  {
+    Error::SetStringView(error, "Failed to load GPU state.");
+    return false;
+  }
+
+  m_position = m_first_packet_offset;
+  return true;
+}
+
+GPUDump::Player::FrameResult GPUDump::Player::ProcessFrame(GPU* gpu, Error* error)
+{
+  while (m_position < m_data.size())
+  {
+    const PacketType type = static_cast<PacketType>(m_data[m_position] >> 24);
+    const u32 num_words = m_data[m_position] & MAX_PACKET_WORDS;
+    const u32 payload = m_position + 1;
+    if ((m_data.size() - payload) < num_words)
+      break;
+
+    m_position = payload + num_words;
+
+    switch (type)
+    {
+      case PacketType::GP0Data:
+      {
+        if (!gpu->ReplayGP0(&m_data[payload], num_words, error))
+          return FrameResult::Error;
+      }
+      break;
+
+      case PacketType::GP1Command:
+        gpu->WriteRegister(0x04, m_data[payload]);
+        break;
+
+      case PacketType::VSync:
+        gpu->ReplayVSync();
+        return FrameResult::Frame;
+
+      case PacketType::End:
+        m_position = static_cast<u32>(m_data.size());
+        return FrameResult::EndOfDump;
+
+      default:
+        break;
+    }
+  }
+
+  return FrameResult::EndOfDump;
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "common/types.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Error;
+
+class GPU;
+
+// GPU dumps record the GP0/GP1 word stream starting from a snapshot of the GPU state (registers and VRAM), so that
+// renderers can be benchmarked and bisected without running the rest of the system.
+namespace GPUDump {
+
+static constexpr const char* FILE_EXTENSION = "psxgpu";
+
+enum class PacketType : u8
+{
+  GPUState,
+  GP0Data,
+  GP1Command,
+  VSync,
+  End,
+};
+
+class Recorder
+{
+public:
+  ~Recorder();
+
+  /// Creates a dump file, writing the current state of the GPU as the starting point.
+  static std::unique_ptr<Recorder> Create(const char* path, GPU* gpu, u32 num_frames, Error* error);
+
+  ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
+  ALWAYS_INLINE u32 GetFrameCount() const { return m_frame_count; }
+
+  /// Returns true once the requested number of frames have been recorded.
+  ALWAYS_INLINE bool IsComplete() const { return (m_frames_to_record > 0 && m_frame_count >= m_frames_to_record); }
+
+  ALWAYS_INLINE void WriteGP0(u32 word)
+  {
+    m_gp0_buffer.push_back(word);
+    if (m_gp0_buffer.size() >= GP0_BUFFER_FLUSH_SIZE) [[unlikely]]
+      FlushGP0();
+  }
+
+  void WriteGP1(u32 value);
+  void WriteVSync();
+
+  /// Writes the end marker and closes the file.
+  bool Close(Error* error);
+
+private:
+  static constexpr u32 GP0_BUFFER_FLUSH_SIZE = 64 * 1024;
+
+  Recorder(std::FILE* fp, std::string path, u32 num_frames);
+
+  void FlushGP0();
+  void WritePacket(PacketType type, const void* data, u32 num_words);
+
+  std::FILE* m_fp;
+  std::string m_path;
+  std::vector<u32> m_gp0_buffer;
+  u32 m_frames_to_record;
+  u32 m_frame_count = 0;
+  bool m_write_error = false;
+};
+
+class Player
+{
+public:
+  ~Player();
+
+  static std::unique_ptr<Player> Open(const char* path, Error* error);
+
+  ALWAYS_INLINE u32 GetFrameCount() const { return m_frame_count; }
+
+  /// Restores the GPU state the dump was started from, and rewinds to the first packet.
+  bool Reset(GPU* gpu, Error* error);
+
+  enum class FrameResult : u8
+  {
+    Frame,
+    EndOfDump,
+    Error,
+  };
+
+  /// Feeds packets to the GPU up to and including the next vsync.
+  FrameResult ProcessFrame(GPU* gpu, Error* error);
+
+private:
+  Player(std::vector<u32> data);
+
+  bool Parse(Error* error);
+
+  std::vector<u32> m_data;
+  u32 m_state_version = 0;
+  u32 m_state_offset = 0;
+  u32 m_state_size = 0;
+  u32 m_first_packet_offset = 0;
+  u32 m_position = 0;
+  u32 m_frame_count = 0;
+};
+
+} // namespace GPUDump
@@ -15,6 +15,7 @@
 
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/intrin.h"
 #include "common/log.h"
 #include "common/scoped_guard.h"
 #include "common/string_util.h"
@@ -1735,6 +1736,41 @@ ALWAYS_INLINE_RELEASE void GPU_HW::ExpandLineTriangles(BatchVertex* vertices, u3
 
 void GPU_HW::ComputePolygonUVLimits(u32 texpage, BatchVertex* vertices, u32 num_vertices)
 {
+  const auto [min_u, min_v, max_u, max_v] = ComputePolygonUVLimits(vertices, num_vertices);
+  CheckForTexPageOverlap(texpage, min_u, min_v, max_u, max_v);
+}
+
+std::tuple<u32, u32, u32, u32> GPU_HW::ComputePolygonUVLimits(BatchVertex* vertices, u32 num_vertices)
+{
+  DebugAssert(num_vertices == 3 || num_vertices == 4);
+
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  // U and V are adjacent 16-bit fields, so reduce both at once. Triangles repeat the last vertex.
+  std::array<u32, 4> uvs;
+  for (u32 i = 0; i < 4; i++)
+    std::memcpy(&uvs[i], &vertices[std::min(i, num_vertices - 1)].u, sizeof(u32));
+
+#if defined(CPU_ARCH_SSE)
+  const __m128i uv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uvs.data()));
+  __m128i min_uv = _mm_min_epi16(uv, _mm_shuffle_epi32(uv, _MM_SHUFFLE(1, 0, 3, 2)));
+  __m128i max_uv = _mm_max_epi16(uv, _mm_shuffle_epi32(uv, _MM_SHUFFLE(1, 0, 3, 2)));
+  min_uv = _mm_min_epi16(min_uv, _mm_shuffle_epi32(min_uv, _MM_SHUFFLE(2, 3, 0, 1)));
+  max_uv = _mm_max_epi16(max_uv, _mm_shuffle_epi32(max_uv, _MM_SHUFFLE(2, 3, 0, 1)));
+  const u32 packed_min = static_cast<u32>(_mm_cvtsi128_si32(min_uv));
+  const u32 packed_max = static_cast<u32>(_mm_cvtsi128_si32(max_uv));
+#else
+  const uint16x8_t uv = vreinterpretq_u16_u32(vld1q_u32(uvs.data()));
+  uint16x4_t min_uv = vmin_u16(vget_low_u16(uv), vget_high_u16(uv));
+  uint16x4_t max_uv = vmax_u16(vget_low_u16(uv), vget_high_u16(uv));
+  min_uv = vmin_u16(min_uv, vext_u16(min_uv, min_uv, 2));
+  max_uv = vmax_u16(max_uv, vext_u16(max_uv, max_uv, 2));
+  const u32 packed_min = vget_lane_u32(vreinterpret_u32_u16(min_uv), 0);
+  const u32 packed_max = vget_lane_u32(vreinterpret_u32_u16(max_uv), 0);
+#endif
+
+  u32 min_u = packed_min & 0xFFFFu, max_u = packed_max & 0xFFFFu;
+  u32 min_v = packed_min >> 16, max_v = packed_max >> 16;
+#else
   u32 min_u = vertices[0].u, max_u = vertices[0].u, min_v = vertices[0].v, max_v = vertices[0].v;
   for (u32 i = 1; i < num_vertices; i++)
   {
@@ -1743,14 +1779,15 @@ void GPU_HW::ComputePolygonUVLimits(u32 texpage, BatchVertex* vertices, u32 num_
     min_v = std::min<u32>(min_v, vertices[i].v);
     max_v = std::max<u32>(max_v, vertices[i].v);
   }
+#endif
 
   max_u = (min_u != max_u) ? (max_u - 1) : max_u;
   max_v = (min_v != max_v) ? (max_v - 1) : max_v;
 
-  CheckForTexPageOverlap(texpage, min_u, min_v, max_u, max_v);
-
   for (u32 i = 0; i < num_vertices; i++)
     vertices[i].SetUVLimits(min_u, max_u, min_v, max_v);
+
+  return std::make_tuple(min_u, min_v, max_u, max_v);
 }
 
 void GPU_HW::SetBatchDepthBuffer(bool enabled)
@@ -1899,6 +1936,84 @@ void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1
   m_batch_index_space -= 6;
 }
 
+void GPU_HW::UnpackPolygonVertices(BatchVertex* vertices, std::array<std::array<s32, 2>, 4>& native_positions,
+                                   const std::array<u32, 4>& positions, const std::array<u32, 4>& colors,
+                                   const std::array<u32, 4>& texcoords, s32 offset_x, s32 offset_y, float depth,
+                                   u32 texpage)
+{
+  static constexpr u32 DEFAULT_UV_LIMITS = 0xFFFF0000u;
+
+#if defined(CPU_ARCH_SSE)
+  // Sign-extend the 11-bit X (bits 0-10) and Y (bits 16-26), and apply the drawing offset.
+  const __m128i pos = _mm_loadu_si128(reinterpret_cast<const __m128i*>(positions.data()));
+  const __m128i x = _mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(pos, 21), 21), _mm_set1_epi32(offset_x));
+  const __m128i y = _mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(pos, 5), 21), _mm_set1_epi32(offset_y));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&native_positions[0][0]), _mm_unpacklo_epi32(x, y));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&native_positions[2][0]), _mm_unpackhi_epi32(x, y));
+
+  // x, y, z, w
+  const __m128 fx = _mm_cvtepi32_ps(x);
+  const __m128 fy = _mm_cvtepi32_ps(y);
+  const __m128 xy01 = _mm_unpacklo_ps(fx, fy);
+  const __m128 xy23 = _mm_unpackhi_ps(fx, fy);
+  const __m128 zw = _mm_setr_ps(depth, 1.0f, depth, 1.0f);
+  _mm_storeu_ps(&vertices[0].x, _mm_movelh_ps(xy01, zw));
+  _mm_storeu_ps(&vertices[1].x, _mm_movehl_ps(zw, xy01));
+  _mm_storeu_ps(&vertices[2].x, _mm_movelh_ps(xy23, zw));
+  _mm_storeu_ps(&vertices[3].x, _mm_movehl_ps(zw, xy23));
+
+  // color, texpage, u | (v << 16), uv_limits
+  const __m128i tc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texcoords.data()));
+  const __m128i uv = _mm_or_si128(_mm_and_si128(tc, _mm_set1_epi32(0xFF)),
+                                  _mm_slli_epi32(_mm_and_si128(tc, _mm_set1_epi32(0xFF00)), 8));
+  const __m128i col = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors.data()));
+  const __m128i tp = _mm_set1_epi32(static_cast<s32>(texpage));
+  const __m128i lim = _mm_set1_epi32(static_cast<s32>(DEFAULT_UV_LIMITS));
+  const __m128i ct01 = _mm_unpacklo_epi32(col, tp);
+  const __m128i ct23 = _mm_unpackhi_epi32(col, tp);
+  const __m128i ul01 = _mm_unpacklo_epi32(uv, lim);
+  const __m128i ul23 = _mm_unpackhi_epi32(uv, lim);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&vertices[0].color), _mm_unpacklo_epi64(ct01, ul01));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&vertices[1].color), _mm_unpackhi_epi64(ct01, ul01));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&vertices[2].color), _mm_unpacklo_epi64(ct23, ul23));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&vertices[3].color), _mm_unpackhi_epi64(ct23, ul23));
+#elif defined(CPU_ARCH_NEON)
+  const int32x4_t pos = vreinterpretq_s32_u32(vld1q_u32(positions.data()));
+  const int32x4_t x = vaddq_s32(vshrq_n_s32(vshlq_n_s32(pos, 21), 21), vdupq_n_s32(offset_x));
+  const int32x4_t y = vaddq_s32(vshrq_n_s32(vshlq_n_s32(pos, 5), 21), vdupq_n_s32(offset_y));
+  const int32x4x2_t xy = vzipq_s32(x, y);
+  vst1q_s32(&native_positions[0][0], xy.val[0]);
+  vst1q_s32(&native_positions[2][0], xy.val[1]);
+
+  const float32x4x2_t fxy = vzipq_f32(vcvtq_f32_s32(x), vcvtq_f32_s32(y));
+  const float32x2_t zw = vset_lane_f32(1.0f, vdup_n_f32(depth), 1);
+  vst1q_f32(&vertices[0].x, vcombine_f32(vget_low_f32(fxy.val[0]), zw));
+  vst1q_f32(&vertices[1].x, vcombine_f32(vget_high_f32(fxy.val[0]), zw));
+  vst1q_f32(&vertices[2].x, vcombine_f32(vget_low_f32(fxy.val[1]), zw));
+  vst1q_f32(&vertices[3].x, vcombine_f32(vget_high_f32(fxy.val[1]), zw));
+
+  const uint32x4_t tc = vld1q_u32(texcoords.data());
+  const uint32x4_t uv = vorrq_u32(vandq_u32(tc, vdupq_n_u32(0xFF)), vshlq_n_u32(vandq_u32(tc, vdupq_n_u32(0xFF00)), 8));
+  const uint32x4x2_t ct = vzipq_u32(vld1q_u32(colors.data()), vdupq_n_u32(texpage));
+  const uint32x4x2_t ul = vzipq_u32(uv, vdupq_n_u32(DEFAULT_UV_LIMITS));
+  vst1q_u32(&vertices[0].color, vcombine_u32(vget_low_u32(ct.val[0]), vget_low_u32(ul.val[0])));
+  vst1q_u32(&vertices[1].color, vcombine_u32(vget_high_u32(ct.val[0]), vget_high_u32(ul.val[0])));
+  vst1q_u32(&vertices[2].color, vcombine_u32(vget_low_u32(ct.val[1]), vget_low_u32(ul.val[1])));
+  vst1q_u32(&vertices[3].color, vcombine_u32(vget_high_u32(ct.val[1]), vget_high_u32(ul.val[1])));
+#else
+  for (u32 i = 0; i < 4; i++)
+  {
+    const GPUVertexPosition vp{positions[i]};
+    const s32 native_x = offset_x + vp.x;
+    const s32 native_y = offset_y + vp.y;
+    native_positions[i][0] = native_x;
+    native_positions[i][1] = native_y;
+    vertices[i].Set(static_cast<float>(native_x), static_cast<float>(native_y), depth, 1.0f, colors[i], texpage,
+                    Truncate16(texcoords[i]), DEFAULT_UV_LIMITS);
+  }
+#endif
+}
+
 void GPU_HW::LoadVertices()
 {
   if (m_GPUSTAT.check_mask_before_draw)
@@ -1918,33 +2033,39 @@ void GPU_HW::LoadVertices()
       const bool pgxp = g_settings.gpu_pgxp_enable;
 
       const u32 num_vertices = rc.quad_polygon ? 4 : 3;
-      std::array<BatchVertex, 4> vertices;
-      std::array<std::array<s32, 2>, 4> native_vertex_positions;
-      std::array<u16, 4> native_texcoords;
-      bool valid_w = g_settings.gpu_pgxp_texture_correction;
+
+      // Pull all the command words out first, then convert every vertex at once.
+      std::array<u32, 4> positions, colors, texcoords, addresses;
       for (u32 i = 0; i < num_vertices; i++)
       {
-        const u32 color = (shaded && i > 0) ? (FifoPop() & UINT32_C(0x00FFFFFF)) : first_color;
-        const u64 maddr_and_pos = m_fifo.Pop();
-        const GPUVertexPosition vp{Truncate32(maddr_and_pos)};
-        const u16 texcoord = textured ? Truncate16(FifoPop()) : 0;
-        const s32 native_x = m_drawing_offset.x + vp.x;
-        const s32 native_y = m_drawing_offset.y + vp.y;
-        native_vertex_positions[i][0] = native_x;
-        native_vertex_positions[i][1] = native_y;
-        native_texcoords[i] = texcoord;
-        vertices[i].Set(static_cast<float>(native_x), static_cast<float>(native_y), depth, 1.0f, color, texpage,
-                        texcoord, 0xFFFF0000u);
-
-        if (pgxp)
-        {
-          valid_w &= CPU::PGXP::GetPreciseVertex(Truncate32(maddr_and_pos >> 32), vp.bits, native_x, native_y,
-                                                 m_drawing_offset.x, m_drawing_offset.y, &vertices[i].x, &vertices[i].y,
-                                                 &vertices[i].w);
-        }
+        colors[i] = (shaded && i > 0) ? (FifoPop() & UINT32_C(0x00FFFFFF)) : first_color;
+        const u64 maddr_and_pos = FifoPopWithAddress();
+        positions[i] = Truncate32(maddr_and_pos);
+        addresses[i] = Truncate32(maddr_and_pos >> 32);
+        texcoords[i] = textured ? ZeroExtend32(Truncate16(FifoPop())) : 0;
+      }
+      if (!rc.quad_polygon)
+      {
+        positions[3] = positions[2];
+        colors[3] = colors[2];
+        texcoords[3] = texcoords[2];
       }
+
+      std::array<BatchVertex, 4> vertices;
+      std::array<std::array<s32, 2>, 4> native_vertex_positions;
+      UnpackPolygonVertices(vertices.data(), native_vertex_positions, positions, colors, texcoords, m_drawing_offset.x,
+                            m_drawing_offset.y, depth, texpage);
+
       if (pgxp)
       {
+        bool valid_w = g_settings.gpu_pgxp_texture_correction;
+        for (u32 i = 0; i < num_vertices; i++)
+        {
+          valid_w &= CPU::PGXP::GetPreciseVertex(addresses[i], positions[i], native_vertex_positions[i][0],
+                                                 native_vertex_positions[i][1], m_drawing_offset.x, m_drawing_offset.y,
+                                                 &vertices[i].x, &vertices[i].y, &vertices[i].w);
+        }
+
         if (!valid_w)
         {
           SetBatchDepthBuffer(false);
@@ -2080,7 +2201,7 @@ void GPU_HW::LoadVertices()
           GPUBackendDrawPolygonCommand::Vertex* vert = &cmd->vertices[i];
           vert->x = native_vertex_positions[i][0];
           vert->y = native_vertex_positions[i][1];
-          vert->texcoord = native_texcoords[i];
+          vert->texcoord = Truncate16(texcoords[i]);
           vert->color = vertices[i].color;
         }
 
@@ -52,21 +52,6 @@ public:
 
   void UpdateDisplay() override;
 
-private:
-  enum : u32
-  {
-    MAX_BATCH_VERTEX_COUNTER_IDS = 65536 - 2,
-    MAX_VERTICES_FOR_RECTANGLE = 6 * (((MAX_PRIMITIVE_WIDTH + (TEXTURE_PAGE_WIDTH - 1)) / TEXTURE_PAGE_WIDTH) + 1u) *
-                                 (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u)
-  };
-  enum : u8
-  {
-    TEXPAGE_DIRTY_DRAWN_RECT = (1 << 0),
-    TEXPAGE_DIRTY_WRITTEN_RECT = (1 << 1),
-  };
-
-  static_assert(GPUDevice::MIN_TEXEL_BUFFER_ELEMENTS >= (VRAM_WIDTH * VRAM_HEIGHT));
-
   struct BatchVertex
   {
     float x;
@@ -84,6 +69,32 @@ private:
     static u32 PackUVLimits(u32 min_u, u32 max_u, u32 min_v, u32 max_v);
     void SetUVLimits(u32 min_u, u32 max_u, u32 min_v, u32 max_v);
   };
+  static_assert(sizeof(BatchVertex) == 32 && offsetof(BatchVertex, color) == 16 && offsetof(BatchVertex, u) == 24);
+
+  /// Converts the raw command words of a polygon to batch vertices, four at a time. Triangles should repeat the last
+  /// vertex in the fourth slot.
+  static void UnpackPolygonVertices(BatchVertex* vertices, std::array<std::array<s32, 2>, 4>& native_positions,
+                                    const std::array<u32, 4>& positions, const std::array<u32, 4>& colors,
+                                    const std::array<u32, 4>& texcoords, s32 offset_x, s32 offset_y, float depth,
+                                    u32 texpage);
+
+  /// Computes polygon U/V boundaries and stores them in the vertices. Returns min_u, min_v, max_u, max_v.
+  static std::tuple<u32, u32, u32, u32> ComputePolygonUVLimits(BatchVertex* vertices, u32 num_vertices);
+
+private:
+  enum : u32
+  {
+    MAX_BATCH_VERTEX_COUNTER_IDS = 65536 - 2,
+    MAX_VERTICES_FOR_RECTANGLE = 6 * (((MAX_PRIMITIVE_WIDTH + (TEXTURE_PAGE_WIDTH - 1)) / TEXTURE_PAGE_WIDTH) + 1u) *
+                                 (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u)
+  };
+  enum : u8
+  {
+    TEXPAGE_DIRTY_DRAWN_RECT = (1 << 0),
+    TEXPAGE_DIRTY_WRITTEN_RECT = (1 << 1),
+  };
+
+  static_assert(GPUDevice::MIN_TEXEL_BUFFER_ELEMENTS >= (VRAM_WIDTH * VRAM_HEIGHT));
 
   struct BatchConfig
   {
@@ -5,12 +5,15 @@
 #include "system.h"
 
 #include "util/gpu_device.h"
+#include "util/imgui_manager.h"
 
 #include "common/align.h"
 #include "common/assert.h"
 #include "common/intrin.h"
 #include "common/log.h"
 
+#include "imgui.h"
+
 #include <algorithm>
 
 Log_SetChannel(GPU_SW);
@@ -566,7 +569,7 @@ void GPU_SW::DispatchRenderCommand()
       {
         GPUBackendDrawPolygonCommand::Vertex* vert = &cmd->vertices[i];
         vert->color = (shaded && i > 0) ? (FifoPop() & UINT32_C(0x00FFFFFF)) : first_color;
-        const u64 maddr_and_pos = m_fifo.Pop();
+        const u64 maddr_and_pos = FifoPopWithAddress();
         const GPUVertexPosition vp{Truncate32(maddr_and_pos)};
         vert->x = m_drawing_offset.x + vp.x;
         vert->y = m_drawing_offset.y + vp.y;
@@ -849,6 +852,36 @@ void GPU_SW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
   m_backend.PushCommand(cmd);
 }
 
+void GPU_SW::DrawRendererStats()
+{
+  if (ImGui::CollapsingHeader("Renderer Statistics", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    const GPU_SW_Backend::TextureCacheStats stats = m_backend.GetTextureCacheStats();
+    const u32 lookups = stats.hits + stats.misses + stats.uncached;
+
+    ImGui::Columns(2);
+    ImGui::SetColumnWidth(0, 200.0f * Host::GetOSDScale());
+
+    ImGui::TextUnformatted("Texture Cache Hits:");
+    ImGui::NextColumn();
+    ImGui::Text("%u / %u (%.1f%%)", stats.hits, lookups,
+                (lookups > 0) ? (static_cast<float>(stats.hits) * 100.0f / static_cast<float>(lookups)) : 0.0f);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Texture Cache Decodes:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.misses);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Texture Cache Invalidations:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.invalidations);
+    ImGui::NextColumn();
+
+    ImGui::Columns(1);
+  }
+}
+
 std::unique_ptr<GPU> GPU::CreateSoftwareRenderer()
 {
   std::unique_ptr<GPU_SW> gpu(std::make_unique<GPU_SW>());
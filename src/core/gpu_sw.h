@@ -52,6 +52,7 @@ protected:
   void UpdateDisplay() override;
 
   void DispatchRenderCommand() override;
+  void DrawRendererStats() override;
 
   void FillBackendCommandParameters(GPUBackendCommand* cmd) const;
   void FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) const;
@@ -21,6 +21,187 @@ bool GPU_SW_Backend::Initialize(bool force_thread)
 void GPU_SW_Backend::Reset()
 {
   GPUBackend::Reset();
+
+  ClearTextureCache();
+  DrawingAreaChanged();
+  m_texture_cache_hits.store(0, std::memory_order_relaxed);
+  m_texture_cache_misses.store(0, std::memory_order_relaxed);
+  m_texture_cache_uncached.store(0, std::memory_order_relaxed);
+  m_texture_cache_invalidations.store(0, std::memory_order_relaxed);
+}
+
+GPU_SW_Backend::TextureCacheStats GPU_SW_Backend::GetTextureCacheStats() const
+{
+  return TextureCacheStats{m_texture_cache_hits.load(std::memory_order_relaxed),
+                           m_texture_cache_misses.load(std::memory_order_relaxed),
+                           m_texture_cache_uncached.load(std::memory_order_relaxed),
+                           m_texture_cache_invalidations.load(std::memory_order_relaxed)};
+}
+
+u32 GPU_SW_Backend::GetVRAMRegionMask(u32 x, u32 y, u32 width, u32 height)
+{
+  if (width == 0 || height == 0)
+    return 0;
+
+  const u32 first_col = (x % VRAM_WIDTH) / VRAM_REGION_WIDTH;
+  const u32 first_row = (y % VRAM_HEIGHT) / VRAM_REGION_HEIGHT;
+  const u32 num_cols = std::min((((x % VRAM_REGION_WIDTH) + width - 1) / VRAM_REGION_WIDTH) + 1, VRAM_REGIONS_X);
+  const u32 num_rows = std::min((((y % VRAM_REGION_HEIGHT) + height - 1) / VRAM_REGION_HEIGHT) + 1, VRAM_REGIONS_Y);
+
+  u32 mask = 0;
+  for (u32 row = 0; row < num_rows; row++)
+  {
+    const u32 row_base = ((first_row + row) % VRAM_REGIONS_Y) * VRAM_REGIONS_X;
+    for (u32 col = 0; col < num_cols; col++)
+      mask |= 1u << (row_base + ((first_col + col) % VRAM_REGIONS_X));
+  }
+
+  return mask;
+}
+
+void GPU_SW_Backend::InvalidateTextureCache(u32 region_mask)
+{
+  if ((m_texture_cache_region_mask & region_mask) == 0)
+    return;
+
+  u32 new_region_mask = 0;
+  for (TextureCacheEntry& entry : m_texture_cache)
+  {
+    if (entry.state == TextureCacheEntryState::Empty)
+      continue;
+
+    if (entry.region_mask & region_mask)
+    {
+      entry.state = TextureCacheEntryState::Empty;
+      m_texture_cache_invalidations.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    new_region_mask |= entry.region_mask;
+  }
+
+  m_texture_cache_region_mask = new_region_mask;
+}
+
+void GPU_SW_Backend::ClearTextureCache()
+{
+  for (TextureCacheEntry& entry : m_texture_cache)
+    entry.state = TextureCacheEntryState::Empty;
+
+  m_texture_cache_region_mask = 0;
+  m_texture_cache_counter = 0;
+  m_current_texture_page = nullptr;
+}
+
+void GPU_SW_Backend::UpdateTextureCacheForDraw(const GPUBackendDrawCommand* cmd)
+{
+  m_current_texture_page = nullptr;
+
+  // 15-bit pages are sampled straight from VRAM, there's nothing to expand.
+  const GPUDrawModeReg mode = cmd->draw_mode;
+  if (!cmd->rc.texture_enable || !mode.IsUsingPalette())
+    return;
+
+  const GPUTextureMode texture_mode = mode.texture_mode;
+  const Common::Rectangle<u32> page_rect = mode.GetTexturePageRectangle();
+  const Common::Rectangle<u32> palette_rect = cmd->palette.GetRectangle(texture_mode);
+  const u32 region_mask =
+    GetVRAMRegionMask(page_rect.left, page_rect.top, page_rect.GetWidth(), page_rect.GetHeight()) |
+    GetVRAMRegionMask(palette_rect.left, palette_rect.top, palette_rect.GetWidth(), palette_rect.GetHeight());
+
+  // Rendering into the page or palette while sampling from it has to see its own writes.
+  if (region_mask & m_drawing_area_region_mask)
+  {
+    m_texture_cache_uncached.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  const u32 key = (ZeroExtend32(cmd->palette.bits) << 16) |
+                  ZeroExtend32(mode.bits & (GPUDrawModeReg::TEXTURE_PAGE_MASK | (3u << 7)));
+  const u32 counter = ++m_texture_cache_counter;
+
+  TextureCacheEntry* victim = &m_texture_cache[0];
+  for (TextureCacheEntry& entry : m_texture_cache)
+  {
+    if (entry.state != TextureCacheEntryState::Empty && entry.key == key)
+    {
+      entry.last_used = counter;
+      if (entry.state == TextureCacheEntryState::Decoded)
+      {
+        m_texture_cache_hits.fetch_add(1, std::memory_order_relaxed);
+      }
+      else
+      {
+        // Second use, worth expanding now.
+        DecodeTexturePage(entry, mode, cmd->palette);
+        entry.state = TextureCacheEntryState::Decoded;
+        m_texture_cache_misses.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      m_current_texture_page = entry.texels.data();
+      return;
+    }
+
+    if (victim->state != TextureCacheEntryState::Empty &&
+        (entry.state == TextureCacheEntryState::Empty || entry.last_used < victim->last_used))
+    {
+      victim = &entry;
+    }
+  }
+
+  // Don't decode a page on first sight, one-off palettes would cost more to expand than to sample directly.
+  victim->key = key;
+  victim->region_mask = region_mask;
+  victim->last_used = counter;
+  victim->state = TextureCacheEntryState::Pending;
+  m_texture_cache_region_mask |= region_mask;
+  m_texture_cache_uncached.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GPU_SW_Backend::DecodeTexturePage(TextureCacheEntry& entry, GPUDrawModeReg mode, GPUTexturePaletteReg palette)
+{
+  const u32 page_x = mode.GetTexturePageBaseX();
+  const u32 page_y = mode.GetTexturePageBaseY();
+  const u32 palette_x = palette.GetXBase();
+  const u32 palette_y = palette.GetYBase();
+  u16* dst = entry.texels.data();
+
+  if (mode.texture_mode == GPUTextureMode::Palette4Bit)
+  {
+    std::array<u16, 16> clut;
+    for (u32 i = 0; i < 16; i++)
+      clut[i] = GetPixel((palette_x + i) % VRAM_WIDTH, palette_y);
+
+    for (u32 v = 0; v < TEXTURE_PAGE_HEIGHT; v++)
+    {
+      const u32 row = (page_y + v) % VRAM_HEIGHT;
+      for (u32 u = 0; u < TEXTURE_PAGE_WIDTH; u += 4)
+      {
+        const u16 palette_value = GetPixel((page_x + u / 4) % VRAM_WIDTH, row);
+        *(dst++) = clut[palette_value & 0x0Fu];
+        *(dst++) = clut[(palette_value >> 4) & 0x0Fu];
+        *(dst++) = clut[(palette_value >> 8) & 0x0Fu];
+        *(dst++) = clut[palette_value >> 12];
+      }
+    }
+  }
+  else
+  {
+    std::array<u16, 256> clut;
+    for (u32 i = 0; i < 256; i++)
+      clut[i] = GetPixel((palette_x + i) % VRAM_WIDTH, palette_y);
+
+    for (u32 v = 0; v < TEXTURE_PAGE_HEIGHT; v++)
+    {
+      const u32 row = (page_y + v) % VRAM_HEIGHT;
+      for (u32 u = 0; u < TEXTURE_PAGE_WIDTH; u += 2)
+      {
+        const u16 palette_value = GetPixel((page_x + u / 2) % VRAM_WIDTH, row);
+        *(dst++) = clut[palette_value & 0xFFu];
+        *(dst++) = clut[palette_value >> 8];
+      }
+    }
+  }
 }
 
 void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
@@ -28,6 +209,8 @@ void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
   const GPURenderCommand rc{cmd->rc.bits};
   const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
 
+  UpdateTextureCacheForDraw(cmd);
+
   const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
     rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
 
@@ -40,6 +223,8 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
 {
   const GPURenderCommand rc{cmd->rc.bits};
 
+  UpdateTextureCacheForDraw(cmd);
+
   const DrawRectangleFunction DrawFunction =
     GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
 
@@ -86,37 +271,46 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
     texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
 
     VRAMPixel texture_color;
-    switch (cmd->draw_mode.texture_mode)
+    if (m_current_texture_page)
     {
-      case GPUTextureMode::Palette4Bit:
+      texture_color.bits =
+        m_current_texture_page[ZeroExtend32(texcoord_y) * TEXTURE_PAGE_WIDTH + ZeroExtend32(texcoord_x)];
+    }
+    else
+    {
+      switch (cmd->draw_mode.texture_mode)
       {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+        case GPUTextureMode::Palette4Bit:
+        {
+          const u16 palette_value =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+          const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
 
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+          texture_color.bits =
+            GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+        }
+        break;
 
-      case GPUTextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+        case GPUTextureMode::Palette8Bit:
+        {
+          const u16 palette_value =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+          const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+          texture_color.bits =
+            GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+        }
+        break;
 
-      default:
-      {
-        texture_color.bits = GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+        default:
+        {
+          texture_color.bits =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+        }
+        break;
       }
-      break;
     }
 
     if (texture_color.bits == 0)
@@ -716,6 +910,8 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
 
 void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
 {
+  InvalidateTextureCache(GetVRAMRegionMask(x, y, width, height));
+
   const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
   if ((x + width) <= VRAM_WIDTH && !params.interlaced_rendering)
   {
@@ -761,6 +957,8 @@ void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GP
 void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data,
                                 GPUBackendCommandParameters params)
 {
+  InvalidateTextureCache(GetVRAMRegionMask(x, y, width, height));
+
   // Fast path when the copy is not oversized.
   if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && !params.IsMaskingEnabled())
   {
@@ -829,6 +1027,8 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
     return;
   }
 
+  InvalidateTextureCache(GetVRAMRegionMask(dst_x, dst_y, width, height));
+
   // This doesn't have a fast path, but do we really need one? It's not common.
   const u16 mask_and = params.GetMaskAND();
   const u16 mask_or = params.GetMaskOR();
@@ -870,7 +1070,17 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
 
 void GPU_SW_Backend::FlushRender() {}
 
-void GPU_SW_Backend::DrawingAreaChanged() {}
+void GPU_SW_Backend::DrawingAreaChanged()
+{
+  // Pages overlapping the drawing area are never cached, so anything that could be drawn over goes now.
+  // Drawing area is inclusive.
+  m_drawing_area_region_mask =
+    (m_drawing_area.right >= m_drawing_area.left && m_drawing_area.bottom >= m_drawing_area.top) ?
+      GetVRAMRegionMask(m_drawing_area.left, m_drawing_area.top, m_drawing_area.right - m_drawing_area.left + 1,
+                        m_drawing_area.bottom - m_drawing_area.top + 1) :
+      0;
+  InvalidateTextureCache(m_drawing_area_region_mask);
+}
 
 GPU_SW_Backend::DrawLineFunction GPU_SW_Backend::GetDrawLineFunction(bool shading_enable, bool transparency_enable,
                                                                      bool dithering_enable)
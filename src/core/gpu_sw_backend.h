@@ -3,7 +3,11 @@
 
 #pragma once
 #include "gpu_backend.h"
+
+#include "common/heap_array.h"
+
 #include <array>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -26,6 +30,17 @@ public:
   using DitherLUT = std::array<std::array<std::array<u8, 512>, DITHER_MATRIX_SIZE>, DITHER_MATRIX_SIZE>;
   static constexpr DitherLUT ComputeDitherLUT();
 
+  struct TextureCacheStats
+  {
+    u32 hits;
+    u32 misses;
+    u32 uncached;
+    u32 invalidations;
+  };
+
+  /// Returns the texture page cache counters since the last reset. Safe to call from the CPU thread.
+  TextureCacheStats GetTextureCacheStats() const;
+
 protected:
   union VRAMPixel
   {
@@ -112,6 +127,52 @@ protected:
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
+  //////////////////////////////////////////////////////////////////////////
+  // Texture page cache
+  //////////////////////////////////////////////////////////////////////////
+
+  // Palettized pages are expanded to 16-bit texels, keyed by page/palette/mode. Validity is tracked per 64x256
+  // region of VRAM, since that's the granularity of texture page base addresses.
+  static constexpr u32 TEXTURE_CACHE_SIZE = 16;
+  static constexpr u32 VRAM_REGION_WIDTH = 64;
+  static constexpr u32 VRAM_REGION_HEIGHT = 256;
+  static constexpr u32 VRAM_REGIONS_X = VRAM_WIDTH / VRAM_REGION_WIDTH;
+  static constexpr u32 VRAM_REGIONS_Y = VRAM_HEIGHT / VRAM_REGION_HEIGHT;
+  static_assert((VRAM_REGIONS_X * VRAM_REGIONS_Y) <= 32, "VRAM region mask fits in 32 bits");
+
+  enum class TextureCacheEntryState : u8
+  {
+    Empty,
+    Pending, // seen once, not decoded yet
+    Decoded,
+  };
+
+  struct TextureCacheEntry
+  {
+    FixedHeapArray<u16, TEXTURE_PAGE_WIDTH * TEXTURE_PAGE_HEIGHT> texels;
+    u32 key = 0;
+    u32 region_mask = 0;
+    u32 last_used = 0;
+    TextureCacheEntryState state = TextureCacheEntryState::Empty;
+  };
+
+  static u32 GetVRAMRegionMask(u32 x, u32 y, u32 width, u32 height);
+  void InvalidateTextureCache(u32 region_mask);
+  void ClearTextureCache();
+  void UpdateTextureCacheForDraw(const GPUBackendDrawCommand* cmd);
+  void DecodeTexturePage(TextureCacheEntry& entry, GPUDrawModeReg mode, GPUTexturePaletteReg palette);
+
+  std::array<TextureCacheEntry, TEXTURE_CACHE_SIZE> m_texture_cache;
+  const u16* m_current_texture_page = nullptr;
+  u32 m_texture_cache_region_mask = 0;
+  u32 m_drawing_area_region_mask = 0;
+  u32 m_texture_cache_counter = 0;
+
+  std::atomic<u32> m_texture_cache_hits{0};
+  std::atomic<u32> m_texture_cache_misses{0};
+  std::atomic<u32> m_texture_cache_uncached{0};
+  std::atomic<u32> m_texture_cache_invalidations{0};
+
   //////////////////////////////////////////////////////////////////////////
   // Polygon and line rasterization ported from Mednafen
   //////////////////////////////////////////////////////////////////////////
@@ -14,11 +14,16 @@
 
 #include "common/assert.h"
 #include "common/bitutils.h"
+#include "common/intrin.h"
+#include "common/log.h"
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <numeric>
 
+Log_SetChannel(GTE);
+
 namespace GTE {
 
 static constexpr s64 MAC0_MIN_VALUE = -(INT64_C(1) << 31);
@@ -30,10 +35,31 @@ static constexpr s32 IR0_MAX_VALUE = 0x1000;
 static constexpr s32 IR123_MIN_VALUE = -(INT64_C(1) << 15);
 static constexpr s32 IR123_MAX_VALUE = (INT64_C(1) << 15) - 1;
 
+static constexpr std::array<u8, 257> s_unr_table = {{
+  0xFF, 0xFD, 0xFB, 0xF9, 0xF7, 0xF5, 0xF3, 0xF1, 0xEF, 0xEE, 0xEC, 0xEA, 0xE8, 0xE6, 0xE4, 0xE3, //
+  0xE1, 0xDF, 0xDD, 0xDC, 0xDA, 0xD8, 0xD6, 0xD5, 0xD3, 0xD1, 0xD0, 0xCE, 0xCD, 0xCB, 0xC9, 0xC8, //  00h..3Fh
+  0xC6, 0xC5, 0xC3, 0xC1, 0xC0, 0xBE, 0xBD, 0xBB, 0xBA, 0xB8, 0xB7, 0xB5, 0xB4, 0xB2, 0xB1, 0xB0, //
+  0xAE, 0xAD, 0xAB, 0xAA, 0xA9, 0xA7, 0xA6, 0xA4, 0xA3, 0xA2, 0xA0, 0x9F, 0x9E, 0x9C, 0x9B, 0x9A, //
+  0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90, 0x8F, 0x8D, 0x8C, 0x8B, 0x8A, 0x89, 0x87, 0x86, //
+  0x85, 0x84, 0x83, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x77, 0x75, 0x74, //  40h..7Fh
+  0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x6D, 0x6C, 0x6B, 0x6A, 0x69, 0x68, 0x67, 0x66, 0x65, 0x64, //
+  0x63, 0x62, 0x61, 0x60, 0x5F, 0x5E, 0x5D, 0x5D, 0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, //
+  0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x4E, 0x4D, 0x4D, 0x4C, 0x4B, 0x4A, 0x49, 0x48, 0x48, //
+  0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3F, 0x3F, 0x3E, 0x3D, 0x3C, 0x3C, 0x3B, //  80h..BFh
+  0x3A, 0x39, 0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2F, //
+  0x2E, 0x2E, 0x2D, 0x2C, 0x2C, 0x2B, 0x2A, 0x2A, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, //
+  0x24, 0x23, 0x22, 0x22, 0x21, 0x20, 0x20, 0x1F, 0x1E, 0x1E, 0x1D, 0x1D, 0x1C, 0x1B, 0x1B, 0x1A, //
+  0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15, 0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, //  C0h..FFh
+  0x10, 0x0F, 0x0F, 0x0E, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x08, 0x08, //
+  0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, //
+  0x00 // <-- one extra table entry (for "(d-7FC0h)/80h"=100h)
+}};
+
 static DisplayAspectRatio s_aspect_ratio = DisplayAspectRatio::R4_3;
 static u32 s_custom_aspect_ratio_numerator;
 static u32 s_custom_aspect_ratio_denominator;
 static float s_custom_aspect_ratio_f;
+static ProjectionScale s_projection_scale = {1, 1};
 
 #define REGS CPU::g_state.gte_regs
 
@@ -174,11 +200,25 @@ static void MulMatVecBuggy(const s16* M_, const s32 T[3], const s16 Vx, const s1
 
 static void InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3, u8 shift, bool lm);
 static void RTPS(const s16 V[3], u8 shift, bool lm, bool last);
+static void RTPSPerspective(s64 x, s64 y, s64 z, u8 shift, bool lm, bool last);
 static void NCS(const s16 V[3], u8 shift, bool lm);
 static void NCCS(const s16 V[3], u8 shift, bool lm);
 static void NCDS(const s16 V[3], u8 shift, bool lm);
 static void DPCS(const u8 color[3], u8 shift, bool lm);
 
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+enum class LightingMode : u8
+{
+  NCS,
+  NCCS,
+  NCDS,
+};
+
+static void RTPTVector(u8 shift, bool lm);
+template<LightingMode mode>
+static void NCTVector(u8 shift, bool lm);
+#endif
+
 static void Execute_MVMVA(Instruction inst);
 static void Execute_SQR(Instruction inst);
 static void Execute_OP(Instruction inst);
@@ -224,6 +264,7 @@ bool GTE::DoState(StateWrapper& sw)
 
 void GTE::UpdateAspectRatio()
 {
+  s_projection_scale = {1, 1};
   if (!g_settings.gpu_widescreen_hack)
   {
     s_aspect_ratio = DisplayAspectRatio::R4_3;
@@ -232,6 +273,14 @@ void GTE::UpdateAspectRatio()
 
   s_aspect_ratio = g_settings.display_aspect_ratio;
 
+  // Same ratios as RTPSPerspective().
+  if (s_aspect_ratio == DisplayAspectRatio::R16_9)
+    s_projection_scale = {3, 4};
+  else if (s_aspect_ratio == DisplayAspectRatio::R19_9)
+    s_projection_scale = {12, 19};
+  else if (s_aspect_ratio == DisplayAspectRatio::R20_9)
+    s_projection_scale = {3, 5};
+
   u32 num, denom;
   switch (s_aspect_ratio)
   {
@@ -266,6 +315,8 @@ void GTE::UpdateAspectRatio()
 
   s_custom_aspect_ratio_numerator = x / gcd;
   s_custom_aspect_ratio_denominator = y / gcd;
+  s_projection_scale = {static_cast<s32>(s_custom_aspect_ratio_numerator),
+                        static_cast<s32>(s_custom_aspect_ratio_denominator)};
 
   s_custom_aspect_ratio_f = static_cast<float>((4.0 / 3.0) / (static_cast<double>(num) / static_cast<double>(denom)));
 }
@@ -397,6 +448,16 @@ u32* GTE::GetRegisterPtr(u32 index)
   return &REGS.r32[index];
 }
 
+const GTE::ProjectionScale* GTE::GetProjectionScalePtr()
+{
+  return &s_projection_scale;
+}
+
+const u8* GTE::GetUNRTable()
+{
+  return s_unr_table.data();
+}
+
 ALWAYS_INLINE void GTE::SetOTZ(s32 value)
 {
   if (value < 0)
@@ -486,28 +547,8 @@ ALWAYS_INLINE u32 GTE::UNRDivide(u32 lhs, u32 rhs)
   lhs <<= shift;
   rhs <<= shift;
 
-  static constexpr std::array<u8, 257> unr_table = {{
-    0xFF, 0xFD, 0xFB, 0xF9, 0xF7, 0xF5, 0xF3, 0xF1, 0xEF, 0xEE, 0xEC, 0xEA, 0xE8, 0xE6, 0xE4, 0xE3, //
-    0xE1, 0xDF, 0xDD, 0xDC, 0xDA, 0xD8, 0xD6, 0xD5, 0xD3, 0xD1, 0xD0, 0xCE, 0xCD, 0xCB, 0xC9, 0xC8, //  00h..3Fh
-    0xC6, 0xC5, 0xC3, 0xC1, 0xC0, 0xBE, 0xBD, 0xBB, 0xBA, 0xB8, 0xB7, 0xB5, 0xB4, 0xB2, 0xB1, 0xB0, //
-    0xAE, 0xAD, 0xAB, 0xAA, 0xA9, 0xA7, 0xA6, 0xA4, 0xA3, 0xA2, 0xA0, 0x9F, 0x9E, 0x9C, 0x9B, 0x9A, //
-    0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90, 0x8F, 0x8D, 0x8C, 0x8B, 0x8A, 0x89, 0x87, 0x86, //
-    0x85, 0x84, 0x83, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x77, 0x75, 0x74, //  40h..7Fh
-    0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x6D, 0x6C, 0x6B, 0x6A, 0x69, 0x68, 0x67, 0x66, 0x65, 0x64, //
-    0x63, 0x62, 0x61, 0x60, 0x5F, 0x5E, 0x5D, 0x5D, 0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, //
-    0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x4E, 0x4D, 0x4D, 0x4C, 0x4B, 0x4A, 0x49, 0x48, 0x48, //
-    0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3F, 0x3F, 0x3E, 0x3D, 0x3C, 0x3C, 0x3B, //  80h..BFh
-    0x3A, 0x39, 0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2F, //
-    0x2E, 0x2E, 0x2D, 0x2C, 0x2C, 0x2B, 0x2A, 0x2A, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, //
-    0x24, 0x23, 0x22, 0x22, 0x21, 0x20, 0x20, 0x1F, 0x1E, 0x1E, 0x1D, 0x1D, 0x1C, 0x1B, 0x1B, 0x1A, //
-    0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15, 0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, //  C0h..FFh
-    0x10, 0x0F, 0x0F, 0x0E, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x08, 0x08, //
-    0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, //
-    0x00 // <-- one extra table entry (for "(d-7FC0h)/80h"=100h)
-  }};
-
   const u32 divisor = rhs | 0x8000;
-  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
+  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(s_unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
   const s32 d = ((static_cast<s32>(ZeroExtend32(divisor)) * -x) + 0x80) >> 8;
   const u32 recip = static_cast<u32>(((x * (0x20000 + d)) + 0x80) >> 8);
 
@@ -574,6 +615,397 @@ void GTE::MulMatVecBuggy(const s16* M_, const s32 T[3], const s16 Vx, const s16
 #undef M
 }
 
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+
+// The triple-vertex commands run the three rows of each matrix in 32-bit vector lanes, the fourth lane is unused.
+//
+// MAC values need up to 44 bits, so they're kept as hi * 1000h + lo instead, where lo is 0..FFFh. MAC SAR 12 is then
+// hi, and the low 32 bits of MAC are (hi SHL 12) | lo. A MAC can only overflow when the translation vector is close to
+// the limits of a s32, commands with those fall back to the scalar code, so there's nothing to check for here.
+
+namespace GTE {
+
+#if defined(CPU_ARCH_SSE)
+
+using Vec = __m128i;
+
+ALWAYS_INLINE static Vec VecSet(s32 x, s32 y, s32 z)
+{
+  return _mm_setr_epi32(x, y, z, 0);
+}
+ALWAYS_INLINE static Vec VecSplat(s32 value)
+{
+  return _mm_set1_epi32(value);
+}
+ALWAYS_INLINE static Vec VecLoadVector(const s16 V[3])
+{
+  // Reads the padding after the vector too, it ends up in the unused lane.
+  const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(V));
+  return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+}
+ALWAYS_INLINE static void VecStore(s32* dst, Vec a)
+{
+  _mm_store_si128(reinterpret_cast<__m128i*>(dst), a);
+}
+ALWAYS_INLINE static void VecStore3(u32* dst, Vec a)
+{
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), a);
+  dst[2] = static_cast<u32>(_mm_cvtsi128_si32(_mm_shuffle_epi32(a, _MM_SHUFFLE(2, 2, 2, 2))));
+}
+ALWAYS_INLINE static Vec VecAdd(Vec a, Vec b)
+{
+  return _mm_add_epi32(a, b);
+}
+ALWAYS_INLINE static Vec VecSub(Vec a, Vec b)
+{
+  return _mm_sub_epi32(a, b);
+}
+ALWAYS_INLINE static Vec VecAnd(Vec a, Vec b)
+{
+  return _mm_and_si128(a, b);
+}
+ALWAYS_INLINE static Vec VecOr(Vec a, Vec b)
+{
+  return _mm_or_si128(a, b);
+}
+template<int shift>
+ALWAYS_INLINE static Vec VecShiftLeft(Vec a)
+{
+  return _mm_slli_epi32(a, shift);
+}
+template<int shift>
+ALWAYS_INLINE static Vec VecShiftRight(Vec a)
+{
+  return _mm_srai_epi32(a, shift);
+}
+ALWAYS_INLINE static Vec VecShiftRight(Vec a, u8 shift)
+{
+  return _mm_sra_epi32(a, _mm_cvtsi32_si128(shift));
+}
+ALWAYS_INLINE static Vec VecCompareGreater(Vec a, Vec b)
+{
+  return _mm_cmpgt_epi32(a, b);
+}
+ALWAYS_INLINE static Vec VecSelect(Vec mask, Vec a, Vec b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/// Multiplies lanes which are both in the range of a s16. There's no pmulld in SSE2, but pmaddwd is exact when the
+/// upper half of one side is zero.
+ALWAYS_INLINE static Vec VecMul16(Vec a, Vec b)
+{
+  return _mm_madd_epi16(a, _mm_and_si128(b, _mm_set1_epi32(0xFFFF)));
+}
+
+template<u32 lane>
+ALWAYS_INLINE static Vec VecBroadcast(Vec a)
+{
+  return _mm_shuffle_epi32(a, _MM_SHUFFLE(lane, lane, lane, lane));
+}
+
+/// Returns the sign bits of the first three lanes.
+ALWAYS_INLINE static u32 VecSignMask(Vec a)
+{
+  return static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(a))) & 7u;
+}
+
+/// Saturates each lane to 0..FFh, and packs them into the bytes of a word.
+ALWAYS_INLINE static u32 VecPackBytes(Vec a)
+{
+  const __m128i a16 = _mm_packs_epi32(a, a);
+  return static_cast<u32>(_mm_cvtsi128_si32(_mm_packus_epi16(a16, a16)));
+}
+
+#elif defined(CPU_ARCH_NEON)
+
+using Vec = int32x4_t;
+
+ALWAYS_INLINE static Vec VecSet(s32 x, s32 y, s32 z)
+{
+  const s32 values[4] = {x, y, z, 0};
+  return vld1q_s32(values);
+}
+ALWAYS_INLINE static Vec VecSplat(s32 value)
+{
+  return vdupq_n_s32(value);
+}
+ALWAYS_INLINE static Vec VecLoadVector(const s16 V[3])
+{
+  // Reads the padding after the vector too, it ends up in the unused lane.
+  return vmovl_s16(vld1_s16(V));
+}
+ALWAYS_INLINE static void VecStore(s32* dst, Vec a)
+{
+  vst1q_s32(dst, a);
+}
+ALWAYS_INLINE static void VecStore3(u32* dst, Vec a)
+{
+  vst1_u32(dst, vreinterpret_u32_s32(vget_low_s32(a)));
+  dst[2] = static_cast<u32>(vgetq_lane_s32(a, 2));
+}
+ALWAYS_INLINE static Vec VecAdd(Vec a, Vec b)
+{
+  return vaddq_s32(a, b);
+}
+ALWAYS_INLINE static Vec VecSub(Vec a, Vec b)
+{
+  return vsubq_s32(a, b);
+}
+ALWAYS_INLINE static Vec VecAnd(Vec a, Vec b)
+{
+  return vandq_s32(a, b);
+}
+ALWAYS_INLINE static Vec VecOr(Vec a, Vec b)
+{
+  return vorrq_s32(a, b);
+}
+template<int shift>
+ALWAYS_INLINE static Vec VecShiftLeft(Vec a)
+{
+  return vshlq_n_s32(a, shift);
+}
+template<int shift>
+ALWAYS_INLINE static Vec VecShiftRight(Vec a)
+{
+  return vshrq_n_s32(a, shift);
+}
+ALWAYS_INLINE static Vec VecShiftRight(Vec a, u8 shift)
+{
+  return vshlq_s32(a, vdupq_n_s32(-static_cast<s32>(shift)));
+}
+ALWAYS_INLINE static Vec VecCompareGreater(Vec a, Vec b)
+{
+  return vreinterpretq_s32_u32(vcgtq_s32(a, b));
+}
+ALWAYS_INLINE static Vec VecSelect(Vec mask, Vec a, Vec b)
+{
+  return vbslq_s32(vreinterpretq_u32_s32(mask), a, b);
+}
+
+/// Multiplies lanes which are both in the range of a s16.
+ALWAYS_INLINE static Vec VecMul16(Vec a, Vec b)
+{
+  return vmulq_s32(a, b);
+}
+
+template<u32 lane>
+ALWAYS_INLINE static Vec VecBroadcast(Vec a)
+{
+  return vdupq_laneq_s32(a, lane);
+}
+
+/// Returns the sign bits of the first three lanes.
+ALWAYS_INLINE static u32 VecSignMask(Vec a)
+{
+  static constexpr s32 shifts[4] = {0, 1, 2, 3};
+  const uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_s32(a), 31);
+  return vaddvq_u32(vshlq_u32(bits, vld1q_s32(shifts))) & 7u;
+}
+
+/// Saturates each lane to 0..FFh, and packs them into the bytes of a word.
+ALWAYS_INLINE static u32 VecPackBytes(Vec a)
+{
+  const uint16x4_t a16 = vqmovun_s32(a);
+  return vget_lane_u32(vreinterpret_u32_u8(vqmovn_u16(vcombine_u16(a16, a16))), 0);
+}
+
+#endif
+
+/// Returns true if T * 1000h plus three products can't overflow a MAC.
+ALWAYS_INLINE static bool IsTranslationInVectorRange(const s32 T[3])
+{
+  // This leaves 2^32 of headroom below the 44-bit limit, and the products are at most 2^30 each.
+  static constexpr s32 LIMIT = 0x7FF00000;
+  return (T[0] >= -LIMIT && T[0] <= LIMIT && T[1] >= -LIMIT && T[1] <= LIMIT && T[2] >= -LIMIT && T[2] <= LIMIT);
+}
+
+ALWAYS_INLINE static Vec VecLoadMatrixColumn(const s16 M[3][3], u32 column)
+{
+  return VecSet(M[0][column], M[1][column], M[2][column]);
+}
+
+/// Same as the sums in MulMatVec(), but the matrix is passed as columns.
+ALWAYS_INLINE static void VecMulMatVec(const Vec M[3], Vec T, Vec V, Vec& hi, Vec& lo)
+{
+  const Vec p0 = VecMul16(M[0], VecBroadcast<0>(V));
+  const Vec p1 = VecMul16(M[1], VecBroadcast<1>(V));
+  const Vec p2 = VecMul16(M[2], VecBroadcast<2>(V));
+
+  const Vec low_mask = VecSplat(0xFFF);
+  const Vec low_sum = VecAdd(VecAdd(VecAnd(p0, low_mask), VecAnd(p1, low_mask)), VecAnd(p2, low_mask));
+  hi = VecAdd(VecAdd(T, VecShiftRight<12>(low_sum)),
+              VecAdd(VecAdd(VecShiftRight<12>(p0), VecShiftRight<12>(p1)), VecShiftRight<12>(p2)));
+  lo = VecAnd(low_sum, low_mask);
+}
+
+/// Returns MAC1-3, i.e. the low 32 bits of (hi:lo SAR shift).
+ALWAYS_INLINE static Vec VecGetMAC(Vec hi, Vec lo, u8 shift)
+{
+  return (shift != 0) ? hi : VecOr(VecShiftLeft<12>(hi), lo);
+}
+
+/// Same as TruncateAndSetIR() for IR1-3, but returns the value. Only the sign bits of saturated are meaningful.
+ALWAYS_INLINE static Vec VecSaturateIR(Vec value, Vec min_value, Vec& saturated)
+{
+  const Vec max_value = VecSplat(IR123_MAX_VALUE);
+  const Vec below = VecCompareGreater(min_value, value);
+  const Vec above = VecCompareGreater(value, max_value);
+  saturated = VecOr(saturated, VecOr(below, above));
+  return VecSelect(below, min_value, VecSelect(above, max_value, value));
+}
+
+/// Same as PushRGBFromMAC().
+ALWAYS_INLINE static void VecPushRGB(Vec mac, Vec& saturated)
+{
+  const Vec value = VecShiftRight<4>(mac);
+  saturated = VecOr(saturated, VecOr(VecCompareGreater(VecSplat(0), value), VecCompareGreater(value, VecSplat(0xFF))));
+
+  REGS.dr32[20] = REGS.dr32[21]; // RGB0 <- RGB1
+  REGS.dr32[21] = REGS.dr32[22]; // RGB1 <- RGB2
+  REGS.dr32[22] = (VecPackBytes(value) & 0xFFFFFFu) | (ZeroExtend32(REGS.RGBC[3]) << 24);
+}
+
+ALWAYS_INLINE static void VecUpdateFlags(Vec ir_saturated, Vec color_saturated)
+{
+  // Lane 0 maps to the highest bit of each group.
+  const auto to_bits = [](Vec mask, u32 lane0_bit) {
+    const u32 bits = VecSignMask(mask);
+    return ((bits & 1u) << lane0_bit) | ((bits & 2u) << (lane0_bit - 2)) | ((bits & 4u) << (lane0_bit - 4));
+  };
+
+  REGS.FLAG.bits |= to_bits(ir_saturated, 24) | to_bits(color_saturated, 21);
+}
+
+} // namespace GTE
+
+void GTE::RTPTVector(u8 shift, bool lm)
+{
+  if (!IsTranslationInVectorRange(REGS.TR)) [[unlikely]]
+  {
+    RTPS(REGS.V0, shift, lm, false);
+    RTPS(REGS.V1, shift, lm, false);
+    RTPS(REGS.V2, shift, lm, true);
+    return;
+  }
+
+  const Vec rt[3] = {VecLoadMatrixColumn(REGS.RT, 0), VecLoadMatrixColumn(REGS.RT, 1),
+                     VecLoadMatrixColumn(REGS.RT, 2)};
+  const Vec tr = VecSet(REGS.TR[0], REGS.TR[1], REGS.TR[2]);
+  const Vec ir_min = VecSplat(lm ? 0 : IR123_MIN_VALUE);
+
+  // The IR3 saturation flag comes from MAC3 SAR 12 regardless of lm, see RTPS().
+  const Vec ir3_lane = VecSet(0, 0, -1);
+  const Vec ir_flag_min = VecSet(lm ? 0 : IR123_MIN_VALUE, lm ? 0 : IR123_MIN_VALUE, IR123_MIN_VALUE);
+
+  Vec ir_saturated = VecSplat(0);
+  const s16* const vertices[3] = {REGS.V0, REGS.V1, REGS.V2};
+  for (u32 i = 0; i < 3; i++)
+  {
+    // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (TR*1000h + RT*V) SAR (sf*12)
+    Vec hi, lo;
+    VecMulMatVec(rt, tr, VecLoadVector(vertices[i]), hi, lo);
+
+    const Vec mac = VecGetMAC(hi, lo, shift);
+    Vec ir_unused = ir_saturated;
+    const Vec ir = VecSaturateIR(mac, ir_min, ir_unused);
+    VecSaturateIR(VecSelect(ir3_lane, hi, mac), ir_flag_min, ir_saturated);
+    VecStore3(&REGS.dr32[25], mac);
+    VecStore3(&REGS.dr32[9], ir);
+
+    alignas(VECTOR_ALIGNMENT) s32 hi_values[4];
+    alignas(VECTOR_ALIGNMENT) s32 lo_values[4];
+    VecStore(hi_values, hi);
+    VecStore(lo_values, lo);
+    RTPSPerspective((s64(hi_values[0]) * 0x1000) + lo_values[0], (s64(hi_values[1]) * 0x1000) + lo_values[1],
+                    (s64(hi_values[2]) * 0x1000) + lo_values[2], shift, lm, i == 2);
+  }
+
+  VecUpdateFlags(ir_saturated, VecSplat(0));
+}
+
+template<GTE::LightingMode mode>
+void GTE::NCTVector(u8 shift, bool lm)
+{
+  if (!IsTranslationInVectorRange(REGS.BK) ||
+      (mode == LightingMode::NCDS && !IsTranslationInVectorRange(REGS.FC))) [[unlikely]]
+  {
+    const s16* const vertices[3] = {REGS.V0, REGS.V1, REGS.V2};
+    for (const s16* V : vertices)
+    {
+      if constexpr (mode == LightingMode::NCS)
+        NCS(V, shift, lm);
+      else if constexpr (mode == LightingMode::NCCS)
+        NCCS(V, shift, lm);
+      else
+        NCDS(V, shift, lm);
+    }
+
+    return;
+  }
+
+  const Vec zero = VecSplat(0);
+  const Vec llm[3] = {VecLoadMatrixColumn(REGS.LLM, 0), VecLoadMatrixColumn(REGS.LLM, 1),
+                      VecLoadMatrixColumn(REGS.LLM, 2)};
+  const Vec lcm[3] = {VecLoadMatrixColumn(REGS.LCM, 0), VecLoadMatrixColumn(REGS.LCM, 1),
+                      VecLoadMatrixColumn(REGS.LCM, 2)};
+  const Vec bk = VecSet(REGS.BK[0], REGS.BK[1], REGS.BK[2]);
+  const Vec ir_min = VecSplat(lm ? 0 : IR123_MIN_VALUE);
+
+  Vec ir_saturated = zero;
+  Vec color_saturated = zero;
+  Vec mac, ir;
+  const s16* const vertices[3] = {REGS.V0, REGS.V1, REGS.V2};
+  for (const s16* V : vertices)
+  {
+    // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
+    Vec hi, lo;
+    VecMulMatVec(llm, zero, VecLoadVector(V), hi, lo);
+    ir = VecSaturateIR(VecGetMAC(hi, lo, shift), ir_min, ir_saturated);
+
+    // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
+    VecMulMatVec(lcm, bk, ir, hi, lo);
+    mac = VecGetMAC(hi, lo, shift);
+    ir = VecSaturateIR(mac, ir_min, ir_saturated);
+
+    if constexpr (mode != LightingMode::NCS)
+    {
+      // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4
+      const Vec rgb = VecSet(REGS.RGBC[0], REGS.RGBC[1], REGS.RGBC[2]);
+      const Vec in_mac = VecShiftLeft<4>(VecMul16(rgb, ir));
+
+      if constexpr (mode == LightingMode::NCDS)
+      {
+        // [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
+        const Vec fc = VecSet(REGS.FC[0], REGS.FC[1], REGS.FC[2]);
+        const Vec diff = VecSub(zero, in_mac);
+        hi = VecAdd(fc, VecShiftRight<12>(diff));
+        lo = VecAnd(diff, VecSplat(0xFFF));
+        ir = VecSaturateIR(VecGetMAC(hi, lo, shift), VecSplat(IR123_MIN_VALUE), ir_saturated);
+
+        // [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3]) SAR (sf*12)
+        mac = VecShiftRight(VecAdd(VecMul16(ir, VecSplat(REGS.IR0)), in_mac), shift);
+      }
+      else
+      {
+        // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)
+        mac = VecShiftRight(in_mac, shift);
+      }
+
+      ir = VecSaturateIR(mac, ir_min, ir_saturated);
+    }
+
+    // Color FIFO = [MAC1/16,MAC2/16,MAC3/16,CODE], [IR1,IR2,IR3] = [MAC1,MAC2,MAC3]
+    VecPushRGB(mac, color_saturated);
+  }
+
+  VecStore3(&REGS.dr32[25], mac);
+  VecStore3(&REGS.dr32[9], ir);
+  VecUpdateFlags(ir_saturated, color_saturated);
+}
+
+#endif
+
 void GTE::Execute_MVMVA(Instruction inst)
 {
   REGS.FLAG.Clear();
@@ -686,6 +1118,11 @@ void GTE::RTPS(const s16 V[3], u8 shift, bool lm, bool last)
   REGS.dr32[11] = std::clamp(REGS.MAC3, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE);
 #undef dot3
 
+  RTPSPerspective(x, y, z, shift, lm, last);
+}
+
+void GTE::RTPSPerspective(s64 x, s64 y, s64 z, u8 shift, bool lm, bool last)
+{
   // SZ3 = MAC3 SAR ((1-sf)*12)                           ;ScreenZ FIFO 0..+FFFFh
   PushSZ(s32(z >> 12));
 
@@ -820,9 +1257,13 @@ void GTE::Execute_RTPT(Instruction inst)
   const u8 shift = inst.GetShift();
   const bool lm = inst.lm;
 
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  RTPTVector(shift, lm);
+#else
   RTPS(REGS.V0, shift, lm, false);
   RTPS(REGS.V1, shift, lm, false);
   RTPS(REGS.V2, shift, lm, true);
+#endif
 
   REGS.FLAG.UpdateError();
 }
@@ -918,9 +1359,13 @@ void GTE::Execute_NCT(Instruction inst)
   const u8 shift = inst.GetShift();
   const bool lm = inst.lm;
 
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  NCTVector<LightingMode::NCS>(shift, lm);
+#else
   NCS(REGS.V0, shift, lm);
   NCS(REGS.V1, shift, lm);
   NCS(REGS.V2, shift, lm);
+#endif
 
   REGS.FLAG.UpdateError();
 }
@@ -959,9 +1404,13 @@ void GTE::Execute_NCCT(Instruction inst)
   const u8 shift = inst.GetShift();
   const bool lm = inst.lm;
 
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  NCTVector<LightingMode::NCCS>(shift, lm);
+#else
   NCCS(REGS.V0, shift, lm);
   NCCS(REGS.V1, shift, lm);
   NCCS(REGS.V2, shift, lm);
+#endif
 
   REGS.FLAG.UpdateError();
 }
@@ -1003,9 +1452,13 @@ void GTE::Execute_NCDT(Instruction inst)
   const u8 shift = inst.GetShift();
   const bool lm = inst.lm;
 
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  NCTVector<LightingMode::NCDS>(shift, lm);
+#else
   NCDS(REGS.V0, shift, lm);
   NCDS(REGS.V1, shift, lm);
   NCDS(REGS.V2, shift, lm);
+#endif
 
   REGS.FLAG.UpdateError();
 }
@@ -1401,3 +1854,68 @@ GTE::InstructionImpl GTE::GetInstructionImpl(u32 inst_bits, TickCount* ticks)
       Panic("Missing handler");
   }
 }
+
+bool GTE::HasVectorizedTripleCommands()
+{
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void GTE::ExecuteTripleCommandForTest(TripleCommand command, u8 shift, bool lm, bool vectorized)
+{
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  if (vectorized)
+  {
+    switch (command)
+    {
+      case TripleCommand::RTPT:
+        RTPTVector(shift, lm);
+        break;
+
+      case TripleCommand::NCT:
+        NCTVector<LightingMode::NCS>(shift, lm);
+        break;
+
+      case TripleCommand::NCCT:
+        NCTVector<LightingMode::NCCS>(shift, lm);
+        break;
+
+      default:
+        NCTVector<LightingMode::NCDS>(shift, lm);
+        break;
+    }
+
+    return;
+  }
+#endif
+
+  switch (command)
+  {
+    case TripleCommand::RTPT:
+      RTPS(REGS.V0, shift, lm, false);
+      RTPS(REGS.V1, shift, lm, false);
+      RTPS(REGS.V2, shift, lm, true);
+      break;
+
+    case TripleCommand::NCT:
+      NCS(REGS.V0, shift, lm);
+      NCS(REGS.V1, shift, lm);
+      NCS(REGS.V2, shift, lm);
+      break;
+
+    case TripleCommand::NCCT:
+      NCCS(REGS.V0, shift, lm);
+      NCCS(REGS.V1, shift, lm);
+      NCCS(REGS.V2, shift, lm);
+      break;
+
+    default:
+      NCDS(REGS.V0, shift, lm);
+      NCDS(REGS.V1, shift, lm);
+      NCDS(REGS.V2, shift, lm);
+      break;
+  }
+}
@@ -20,9 +20,35 @@ void WriteRegister(u32 index, u32 value);
 // use with care, direct register access
 u32* GetRegisterPtr(u32 index);
 
+// for recompilers generating RTPS/RTPT inline
+struct ProjectionScale
+{
+  s32 numerator; // screen X is multiplied by numerator/denominator, both are 1 without the widescreen hack
+  s32 denominator;
+};
+const ProjectionScale* GetProjectionScalePtr();
+const u8* GetUNRTable();
+
 void ExecuteInstruction(u32 inst_bits);
 
 using InstructionImpl = void (*)(Instruction);
 InstructionImpl GetInstructionImpl(u32 inst_bits, TickCount* ticks);
 
+// Testing
+enum class TripleCommand : u8
+{
+  RTPT,
+  NCT,
+  NCCT,
+  NCDT,
+  Count
+};
+
+/// Returns true if the triple-vertex commands have vectorized implementations on this platform.
+bool HasVectorizedTripleCommands();
+
+/// Runs a triple-vertex command on the current registers, without touching FLAG first. The scalar version executes
+/// the single-vertex command three times, which is what the vectorized version has to match.
+void ExecuteTripleCommandForTest(TripleCommand command, u8 shift, bool lm, bool vectorized);
+
 } // namespace GTE
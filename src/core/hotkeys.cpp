@@ -122,6 +122,7 @@ static void HotkeyToggleOSD()
   g_settings.display_show_fps ^= Host::GetBoolSettingValue("Display", "ShowFPS", false);
   g_settings.display_show_speed ^= Host::GetBoolSettingValue("Display", "ShowSpeed", false);
   g_settings.display_show_gpu_stats ^= Host::GetBoolSettingValue("Display", "ShowGPUStatistics", false);
+  g_settings.display_show_audio_stats ^= Host::GetBoolSettingValue("Display", "ShowAudioStatistics", false);
   g_settings.display_show_resolution ^= Host::GetBoolSettingValue("Display", "ShowResolution", false);
   g_settings.display_show_latency_stats ^= Host::GetBoolSettingValue("Display", "ShowLatencyStatistics", false);
   g_settings.display_show_cpu_usage ^= Host::GetBoolSettingValue("Display", "ShowCPU", false);
@@ -356,6 +357,17 @@ DEFINE_HOTKEY("ToggleSoftwareRendering", TRANSLATE_NOOP("Hotkeys", "Graphics"),
                   System::ToggleSoftwareRendering();
               })
 
+DEFINE_HOTKEY("ToggleGPUDump", TRANSLATE_NOOP("Hotkeys", "Graphics"),
+              TRANSLATE_NOOP("Hotkeys", "Toggle GPU Dump Recording"), [](s32 pressed) {
+                if (!pressed && System::IsValid())
+                {
+                  if (System::IsRecordingGPUDump())
+                    System::StopRecordingGPUDump();
+                  else
+                    System::StartRecordingGPUDump();
+                }
+              })
+
 DEFINE_HOTKEY("TogglePGXP", TRANSLATE_NOOP("Hotkeys", "Graphics"), TRANSLATE_NOOP("Hotkeys", "Toggle PGXP"),
               [](s32 pressed) {
                 if (!pressed && System::IsValid())
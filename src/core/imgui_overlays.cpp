@@ -16,6 +16,7 @@
 #include "spu.h"
 #include "system.h"
 
+#include "util/audio_perf_counters.h"
 #include "util/audio_stream.h"
 #include "util/gpu_device.h"
 #include "util/imgui_animated.h"
@@ -261,7 +262,8 @@ void ImGuiManager::FormatProcessorStat(SmallStringBase& text, double usage, doub
 void ImGuiManager::DrawPerformanceOverlay()
 {
   if (!(g_settings.display_show_fps || g_settings.display_show_speed || g_settings.display_show_gpu_stats ||
-        g_settings.display_show_resolution || g_settings.display_show_cpu_usage ||
+        g_settings.display_show_audio_stats || g_settings.display_show_resolution ||
+        g_settings.display_show_cpu_usage ||
         (g_settings.display_show_status_indicators &&
          (System::IsPaused() || System::IsFastForwardEnabled() || System::IsTurboEnabled()))))
   {
@@ -338,6 +340,17 @@ void ImGuiManager::DrawPerformanceOverlay()
       DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
     }
 
+    if (g_settings.display_show_audio_stats)
+    {
+      AudioPerfCounters::FormatSectionStats(text);
+      if (!text.empty())
+        DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+      AudioPerfCounters::FormatBufferStats(text);
+      if (!text.empty())
+        DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+    }
+
     if (g_settings.display_show_resolution)
     {
       // TODO: this seems wrong?
@@ -408,6 +421,8 @@ void ImGuiManager::DrawPerformanceOverlay()
         text.assign("CPU: ");
       }
       FormatProcessorStat(text, System::GetCPUThreadUsage(), System::GetCPUThreadAverageTime());
+      if (g_settings.cpu_idle_loop_skipping && g_settings.cpu_execution_mode != CPUExecutionMode::Interpreter)
+        text.append_format(" Idle: {:.1f}%", System::GetCPUIdleSkipPercent());
       DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
 
       if (g_gpu->GetSWThread())
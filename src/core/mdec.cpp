@@ -13,12 +13,19 @@
 
 #include "common/bitfield.h"
 #include "common/fifo_queue.h"
+#include "common/intrin.h"
 #include "common/log.h"
+#include "common/threading.h"
+#include "common/timer.h"
 
 #include "imgui.h"
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 Log_SetChannel(MDEC);
 
@@ -91,6 +98,16 @@ union CommandWord
   BitField<u32, u16, 0, 16> parameter_word_count;
 };
 
+/// Everything needed to convert a decoded macroblock, captured on the CPU thread so the worker doesn't read live
+/// state which can change under it.
+struct ConversionJob
+{
+  u8 blocks_to_transform;
+  bool mono;
+  bool use_old_idct;
+  s16 addval;
+};
+
 } // namespace
 
 static bool HasPendingBlockCopyOut();
@@ -104,21 +121,31 @@ static void WriteCommandRegister(u32 value);
 static void Execute();
 
 static bool HandleDecodeMacroblockCommand();
+static bool DecodeMacroblock(const u16*& data, const u16* data_end);
 static void HandleSetQuantTableCommand();
 static void HandleSetScaleCommand();
 
-static bool DecodeMonoMacroblock();
-static bool DecodeColoredMacroblock();
+static bool DecodeMonoMacroblock(const u16*& data, const u16* data_end);
+static bool DecodeColoredMacroblock(const u16*& data, const u16* data_end);
 static void ScheduleBlockCopyOut(TickCount ticks);
 static void CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late);
 
+static void StartConversion(bool mono);
+static void WaitForConversion();
+static void RunConversion(const ConversionJob& job);
+static void TransformPendingBlocks();
+static void StartWorkerThread();
+static void StopWorkerThread();
+static void WorkerThreadEntryPoint();
+
 // from nocash spec
-static bool rl_decode_block(s16* blk, const u8* qt);
-static void IDCT(s16* blk);
+static bool rl_decode_block(const u16*& data, const u16* data_end, s16* blk, const u8* qt);
+static void IDCT(s16* blk, bool use_old_routines);
 static void IDCT_New(s16* blk);
 static void IDCT_Old(s16* blk);
+static void UpdateIDCTScaleTable();
 static void yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                       const std::array<s16, 64>& Yblk);
+                       const std::array<s16, 64>& Yblk, s16 addval);
 static void y_to_mono(const std::array<s16, 64>& Yblk);
 
 static StatusRegister s_status = {};
@@ -136,8 +163,12 @@ static std::array<u8, 64> s_iq_y{};
 
 static std::array<s16, 64> s_scale_table{};
 
+// scale table divided by 8 for IDCT_New, laid out for the vector code. Not saved, rebuilt when the table changes.
+alignas(VECTOR_ALIGNMENT) static std::array<s16, 64> s_idct_scale_table{};
+
 // blocks, for colour: 0 - Crblk, 1 - Cbblk, 2-5 - Y 1-4
-static std::array<std::array<s16, 64>, NUM_BLOCKS> s_blocks;
+alignas(VECTOR_ALIGNMENT) static std::array<std::array<s16, 64>, NUM_BLOCKS> s_blocks;
+static u8 s_untransformed_blocks = 0;  // mask of blocks which haven't been through the IDCT yet
 static u32 s_current_block = 0;        // block (0-5)
 static u32 s_current_coefficient = 64; // k (in block)
 static u16 s_current_q_scale = 0;
@@ -146,6 +177,19 @@ alignas(16) static std::array<u32, 256> s_block_rgb{};
 static std::unique_ptr<TimingEvent> s_block_copy_out_event;
 
 static u32 s_total_blocks_decoded = 0;
+
+static std::vector<u32>* s_data_recording = nullptr;
+
+// The IDCT and colour conversion of a macroblock can run on a worker thread. The copy out is scheduled well after the
+// decode, so the CPU thread rarely has to wait for it.
+static Threading::Thread s_worker_thread;
+static std::mutex s_worker_mutex;
+static std::condition_variable s_worker_wake_cv;
+static ConversionJob s_worker_job;
+static std::atomic_bool s_worker_job_pending{false};
+static std::atomic_bool s_worker_sleeping{false};
+static std::atomic_bool s_worker_shutdown{false};
+static bool s_use_worker_thread = false;
 } // namespace MDEC
 
 void MDEC::Initialize()
@@ -154,13 +198,28 @@ void MDEC::Initialize()
     TimingEvents::CreateTimingEvent("MDEC Block Copy Out", 1, 1, &MDEC::CopyOutBlock, nullptr, false);
   s_total_blocks_decoded = 0;
   Reset();
+
+  if (g_settings.mdec_use_thread)
+    StartWorkerThread();
 }
 
 void MDEC::Shutdown()
 {
+  StopWorkerThread();
   s_block_copy_out_event.reset();
 }
 
+void MDEC::SetUseThread(bool enabled)
+{
+  if (s_use_worker_thread == enabled)
+    return;
+
+  if (enabled)
+    StartWorkerThread();
+  else
+    StopWorkerThread();
+}
+
 void MDEC::Reset()
 {
   s_block_copy_out_event->Deactivate();
@@ -169,6 +228,10 @@ void MDEC::Reset()
 
 bool MDEC::DoState(StateWrapper& sw)
 {
+  // States have always had the blocks after the IDCT, and the converted output.
+  WaitForConversion();
+  TransformPendingBlocks();
+
   sw.Do(&s_status.bits);
   sw.Do(&s_enable_dma_in);
   sw.Do(&s_enable_dma_out);
@@ -179,6 +242,8 @@ bool MDEC::DoState(StateWrapper& sw)
   sw.Do(&s_iq_uv);
   sw.Do(&s_iq_y);
   sw.Do(&s_scale_table);
+  if (sw.IsReading())
+    UpdateIDCTScaleTable();
   sw.Do(&s_blocks);
   sw.Do(&s_current_block);
   sw.Do(&s_current_coefficient);
@@ -269,13 +334,29 @@ void MDEC::DMARead(u32* words, u32 word_count)
 
 void MDEC::DMAWrite(const u32* words, u32 word_count)
 {
-  if (s_data_in_fifo.GetSpace() < (word_count * 2)) [[unlikely]]
+  const u16* const data_start = reinterpret_cast<const u16*>(words);
+  const u16* const data_end = data_start + (word_count * 2);
+  const u16* data = data_start;
+
+  // If nothing is queued ahead of it, macroblock data is decoded straight from the DMA buffer instead of going
+  // through the FIFO. It would have been decoded by Execute() below anyway, so the resulting state is the same.
+  if (s_state == State::DecodingMacroblock && s_data_in_fifo.IsEmpty())
+    DecodeMacroblock(data, data_end);
+
+  const u32 halfword_count = static_cast<u32>(data_end - data);
+  if (s_data_in_fifo.GetSpace() < halfword_count) [[unlikely]]
   {
-    Log_WarningPrintf("Input FIFO overflow (writing %u, space %u)", word_count * 2, s_data_in_fifo.GetSpace());
+    Log_WarningPrintf("Input FIFO overflow (writing %u, space %u)", halfword_count, s_data_in_fifo.GetSpace());
+  }
+
+  const u32 halfwords_to_write = std::min(halfword_count, s_data_in_fifo.GetSpace() & ~u32(2));
+  s_data_in_fifo.PushRange(data, halfwords_to_write);
+  if (s_data_recording) [[unlikely]]
+  {
+    const u32 words_accepted = (static_cast<u32>(data - data_start) + halfwords_to_write) / 2;
+    s_data_recording->insert(s_data_recording->end(), words, words + words_accepted);
   }
 
-  const u32 halfwords_to_write = std::min(word_count * 2, s_data_in_fifo.GetSpace() & ~u32(2));
-  s_data_in_fifo.PushRange(reinterpret_cast<const u16*>(words), halfwords_to_write);
   Execute();
 }
 
@@ -286,6 +367,8 @@ bool MDEC::HasPendingBlockCopyOut()
 
 void MDEC::SoftReset()
 {
+  WaitForConversion();
+
   s_status.bits = 0;
   s_enable_dma_in = false;
   s_enable_dma_out = false;
@@ -359,6 +442,8 @@ void MDEC::WriteCommandRegister(u32 value)
 
   s_data_in_fifo.Push(Truncate16(value));
   s_data_in_fifo.Push(Truncate16(value >> 16));
+  if (s_data_recording) [[unlikely]]
+    s_data_recording->push_back(value);
 
   Execute();
 }
@@ -492,29 +577,45 @@ finished:
 }
 
 bool MDEC::HandleDecodeMacroblockCommand()
+{
+  // Decode from the FIFO's storage in place. It can wrap around, in which case there's a second part to decode.
+  for (;;)
+  {
+    const u16* const start = s_data_in_fifo.GetReadPointer();
+    const u16* data = start;
+    const bool result = DecodeMacroblock(data, start + s_data_in_fifo.GetContiguousSize());
+    s_data_in_fifo.Remove(static_cast<u32>(data - start));
+    if (result || data == start || s_data_in_fifo.IsEmpty())
+      return result;
+  }
+}
+
+bool MDEC::DecodeMacroblock(const u16*& data, const u16* data_end)
 {
   if (s_status.data_output_depth <= DataOutputDepth_8Bit)
-    return DecodeMonoMacroblock();
+    return DecodeMonoMacroblock(data, data_end);
   else
-    return DecodeColoredMacroblock();
+    return DecodeColoredMacroblock(data, data_end);
 }
 
-bool MDEC::DecodeMonoMacroblock()
+bool MDEC::DecodeMonoMacroblock(const u16*& data, const u16* data_end)
 {
   // TODO: This should guard the output not the input
   if (!s_data_out_fifo.IsEmpty())
     return false;
 
-  if (!rl_decode_block(s_blocks[0].data(), s_iq_y.data()))
+  // A partially decoded block mustn't be transformed if a state is saved mid-way through it.
+  s_untransformed_blocks &= ~1u;
+  if (!rl_decode_block(data, data_end, s_blocks[0].data(), s_iq_y.data()))
     return false;
 
-  IDCT(s_blocks[0].data());
+  s_untransformed_blocks |= 1u;
 
   Log_DebugPrintf("Decoded mono macroblock, %u words remaining", s_remaining_halfwords / 2);
   ResetDecoder();
   s_state = State::WritingMacroblock;
 
-  y_to_mono(s_blocks[0]);
+  StartConversion(true);
 
   ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
 
@@ -522,14 +623,18 @@ bool MDEC::DecodeMonoMacroblock()
   return true;
 }
 
-bool MDEC::DecodeColoredMacroblock()
+bool MDEC::DecodeColoredMacroblock(const u16*& data, const u16* data_end)
 {
   for (; s_current_block < NUM_BLOCKS; s_current_block++)
   {
-    if (!rl_decode_block(s_blocks[s_current_block].data(), (s_current_block >= 2) ? s_iq_y.data() : s_iq_uv.data()))
+    s_untransformed_blocks &= static_cast<u8>(~(1u << s_current_block));
+    if (!rl_decode_block(data, data_end, s_blocks[s_current_block].data(),
+                         (s_current_block >= 2) ? s_iq_y.data() : s_iq_uv.data()))
+    {
       return false;
+    }
 
-    IDCT(s_blocks[s_current_block].data());
+    s_untransformed_blocks |= static_cast<u8>(1u << s_current_block);
   }
 
   if (!s_data_out_fifo.IsEmpty())
@@ -540,10 +645,7 @@ bool MDEC::DecodeColoredMacroblock()
   ResetDecoder();
   s_state = State::WritingMacroblock;
 
-  yuv_to_rgb(0, 0, s_blocks[0], s_blocks[1], s_blocks[2]);
-  yuv_to_rgb(8, 0, s_blocks[0], s_blocks[1], s_blocks[3]);
-  yuv_to_rgb(0, 8, s_blocks[0], s_blocks[1], s_blocks[4]);
-  yuv_to_rgb(8, 8, s_blocks[0], s_blocks[1], s_blocks[5]);
+  StartConversion(false);
   s_total_blocks_decoded += 4;
 
   ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
@@ -562,6 +664,7 @@ void MDEC::CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late)
 {
   Assert(s_state == State::WritingMacroblock);
   s_block_copy_out_event->Deactivate();
+  WaitForConversion();
 
   switch (s_status.data_output_depth)
   {
@@ -599,40 +702,21 @@ void MDEC::CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late)
 
     case DataOutputDepth_24Bit:
     {
-      // pack tightly
-      u32 index = 0;
-      u32 state = 0;
-      u32 rgb = 0;
-      while (index < s_block_rgb.size())
+      // pack tightly, four pixels to three words: RGBR GBRG BRGB
+      std::array<u32, (s_block_rgb.size() * 3) / 4> packed;
+      u32* out_ptr = packed.data();
+      for (u32 i = 0; i < static_cast<u32>(s_block_rgb.size()); i += 4)
       {
-        switch (state)
-        {
-          case 0:
-            rgb = s_block_rgb[index++]; // RGB-
-            state = 1;
-            break;
-          case 1:
-            rgb |= (s_block_rgb[index] & 0xFF) << 24; // RGBR
-            s_data_out_fifo.Push(rgb);
-            rgb = s_block_rgb[index] >> 8; // GB--
-            index++;
-            state = 2;
-            break;
-          case 2:
-            rgb |= s_block_rgb[index] << 16; // GBRG
-            s_data_out_fifo.Push(rgb);
-            rgb = s_block_rgb[index] >> 16; // B---
-            index++;
-            state = 3;
-            break;
-          case 3:
-            rgb |= s_block_rgb[index] << 8; // BRGB
-            s_data_out_fifo.Push(rgb);
-            index++;
-            state = 0;
-            break;
-        }
+        const u32 p0 = s_block_rgb[i];
+        const u32 p1 = s_block_rgb[i + 1];
+        const u32 p2 = s_block_rgb[i + 2];
+        const u32 p3 = s_block_rgb[i + 3];
+        *(out_ptr++) = p0 | ((p1 & 0xFF) << 24);
+        *(out_ptr++) = (p1 >> 8) | (p2 << 16);
+        *(out_ptr++) = (p2 >> 16) | (p3 << 8);
       }
+
+      s_data_out_fifo.PushRange(packed.data(), static_cast<u32>(packed.size()));
       break;
     }
 
@@ -660,25 +744,72 @@ void MDEC::CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late)
       }
       else
       {
+        std::array<u32, s_block_rgb.size() / 2> packed;
+
+#if defined(CPU_ARCH_SSE)
+        // Eight pixels at a time, the components fit in 16 bits after masking.
+        const __m128i a = _mm_set1_epi16(static_cast<s16>(ZeroExtend16(s_status.data_output_bit15.GetValue()) << 15));
+        const __m128i mask = _mm_set1_epi32(0xFF);
+        const __m128i round = _mm_set1_epi16(4);
+        const __m128i max_value = _mm_set1_epi16(0x1F);
+        const auto E8TO5 = [&mask, &round, &max_value](__m128i lo, __m128i hi, int shift) {
+          const __m128i c = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, shift), mask),
+                                            _mm_and_si128(_mm_srli_epi32(hi, shift), mask));
+          return _mm_min_epi16(_mm_srli_epi16(_mm_add_epi16(c, round), 3), max_value);
+        };
+        for (u32 i = 0; i < static_cast<u32>(s_block_rgb.size()); i += 8)
+        {
+          const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(&s_block_rgb[i]));
+          const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(&s_block_rgb[i + 4]));
+          const __m128i r = E8TO5(lo, hi, 0);
+          const __m128i g = E8TO5(lo, hi, 8);
+          const __m128i b = E8TO5(lo, hi, 16);
+          const __m128i color15 =
+            _mm_or_si128(_mm_or_si128(r, _mm_slli_epi16(g, 5)), _mm_or_si128(_mm_slli_epi16(b, 10), a));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(&packed[i / 2]), color15);
+        }
+#elif defined(CPU_ARCH_NEON)
+        const uint16x8_t a = vdupq_n_u16(ZeroExtend16(s_status.data_output_bit15.GetValue()) << 15);
+        for (u32 i = 0; i < static_cast<u32>(s_block_rgb.size()); i += 8)
+        {
+          const uint32x4_t lo = vld1q_u32(&s_block_rgb[i]);
+          const uint32x4_t hi = vld1q_u32(&s_block_rgb[i + 4]);
+          const auto E8TO5 = [&lo, &hi](const uint32x4_t shift) {
+            const uint16x8_t c = vcombine_u16(vmovn_u32(vandq_u32(vshlq_u32(lo, vreinterpretq_s32_u32(shift)),
+                                                                  vdupq_n_u32(0xFF))),
+                                              vmovn_u32(vandq_u32(vshlq_u32(hi, vreinterpretq_s32_u32(shift)),
+                                                                  vdupq_n_u32(0xFF))));
+            return vminq_u16(vshrq_n_u16(vaddq_u16(c, vdupq_n_u16(4)), 3), vdupq_n_u16(0x1F));
+          };
+          const uint16x8_t r = E8TO5(vdupq_n_u32(0));
+          const uint16x8_t g = E8TO5(vdupq_n_u32(static_cast<u32>(-8)));
+          const uint16x8_t b = E8TO5(vdupq_n_u32(static_cast<u32>(-16)));
+          const uint16x8_t color15 = vorrq_u16(vorrq_u16(r, vshlq_n_u16(g, 5)), vorrq_u16(vshlq_n_u16(b, 10), a));
+          vst1q_u32(&packed[i / 2], vreinterpretq_u32_u16(color15));
+        }
+#else
         const u32 a = ZeroExtend32(s_status.data_output_bit15.GetValue()) << 15;
-        for (u32 i = 0; i < static_cast<u32>(s_block_rgb.size());)
+        for (u32 i = 0; i < static_cast<u32>(s_block_rgb.size()); i += 2)
         {
 #define E8TO5(color) (std::min<u32>((((color) + 4) >> 3), 0x1F))
-          u32 color = s_block_rgb[i++];
+          u32 color = s_block_rgb[i];
           u32 r = E8TO5(color & 0xFFu);
           u32 g = E8TO5((color >> 8) & 0xFFu);
           u32 b = E8TO5((color >> 16) & 0xFFu);
           const u32 color15a = r | (g << 5) | (b << 10) | a;
 
-          color = s_block_rgb[i++];
+          color = s_block_rgb[i + 1];
           r = E8TO5(color & 0xFFu);
           g = E8TO5((color >> 8) & 0xFFu);
           b = E8TO5((color >> 16) & 0xFFu);
           const u32 color15b = r | (g << 5) | (b << 10) | a;
 #undef E8TO5
 
-          s_data_out_fifo.Push(color15a | (color15b << 16));
+          packed[i / 2] = color15a | (color15b << 16);
         }
+#endif
+
+        s_data_out_fifo.PushRange(packed.data(), static_cast<u32>(packed.size()));
       }
     }
     break;
@@ -700,7 +831,7 @@ static constexpr std::array<u8, 64> zagzig = {{0,  1,  8,  16, 9,  2,  3,  10, 1
                                                35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
                                                58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63}};
 
-bool MDEC::rl_decode_block(s16* blk, const u8* qt)
+bool MDEC::rl_decode_block(const u16*& data, const u16* data_end, s16* blk, const u8* qt)
 {
   if (s_current_coefficient == 64)
   {
@@ -710,10 +841,10 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
     u16 n;
     for (;;)
     {
-      if (s_data_in_fifo.IsEmpty() || s_remaining_halfwords == 0)
+      if (data == data_end || s_remaining_halfwords == 0)
         return false;
 
-      n = s_data_in_fifo.Pop();
+      n = *(data++);
       s_remaining_halfwords--;
 
       if (n == 0xFE00)
@@ -737,9 +868,9 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
       blk[s_current_coefficient] = static_cast<s16>(val);
   }
 
-  while (!s_data_in_fifo.IsEmpty() && s_remaining_halfwords > 0)
+  while (data != data_end && s_remaining_halfwords > 0)
   {
-    u16 n = s_data_in_fifo.Pop();
+    u16 n = *(data++);
     s_remaining_halfwords--;
 
     s_current_coefficient += ((n >> 10) & 0x3F) + 1;
@@ -770,15 +901,264 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
   return false;
 }
 
-void MDEC::IDCT(s16* blk)
+void MDEC::StartConversion(bool mono)
+{
+  ConversionJob job;
+  job.blocks_to_transform = mono ? (s_untransformed_blocks & 1u) : s_untransformed_blocks;
+  job.mono = mono;
+  job.use_old_idct = g_settings.use_old_mdec_routines;
+  job.addval = s_status.data_output_signed ? 0 : 0x80;
+  s_untransformed_blocks &= ~job.blocks_to_transform;
+
+  if (!s_use_worker_thread)
+  {
+    RunConversion(job);
+    return;
+  }
+
+  DebugAssert(!s_worker_job_pending.load());
+  s_worker_job = job;
+  s_worker_job_pending.store(true, std::memory_order_release);
+
+  std::unique_lock<std::mutex> lock(s_worker_mutex);
+  if (s_worker_sleeping.load())
+    s_worker_wake_cv.notify_one();
+}
+
+void MDEC::WaitForConversion()
+{
+  if (!s_worker_job_pending.load(std::memory_order_acquire)) [[likely]]
+    return;
+
+  // It's only ever one macroblock behind.
+  while (s_worker_job_pending.load(std::memory_order_acquire))
+    Threading::Timeslice();
+}
+
+void MDEC::RunConversion(const ConversionJob& job)
+{
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+  {
+    if (job.blocks_to_transform & (1u << i))
+      IDCT(s_blocks[i].data(), job.use_old_idct);
+  }
+
+  if (job.mono)
+  {
+    y_to_mono(s_blocks[0]);
+  }
+  else
+  {
+    yuv_to_rgb(0, 0, s_blocks[0], s_blocks[1], s_blocks[2], job.addval);
+    yuv_to_rgb(8, 0, s_blocks[0], s_blocks[1], s_blocks[3], job.addval);
+    yuv_to_rgb(0, 8, s_blocks[0], s_blocks[1], s_blocks[4], job.addval);
+    yuv_to_rgb(8, 8, s_blocks[0], s_blocks[1], s_blocks[5], job.addval);
+  }
+}
+
+void MDEC::TransformPendingBlocks()
+{
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+  {
+    if (s_untransformed_blocks & (1u << i))
+      IDCT(s_blocks[i].data(), g_settings.use_old_mdec_routines);
+  }
+
+  s_untransformed_blocks = 0;
+}
+
+void MDEC::StartWorkerThread()
+{
+  // The CPU thread would just end up waiting for it to be scheduled.
+  if (std::thread::hardware_concurrency() == 1)
+  {
+    Log_InfoPrint("Only one CPU core available, not using a MDEC worker thread.");
+    return;
+  }
+
+  s_worker_shutdown.store(false);
+  if (!s_worker_thread.Start(&MDEC::WorkerThreadEntryPoint))
+  {
+    Log_ErrorPrint("Failed to start MDEC worker thread, decoding on the CPU thread.");
+    return;
+  }
+
+  s_use_worker_thread = true;
+  Log_InfoPrint("MDEC worker thread started.");
+}
+
+void MDEC::StopWorkerThread()
+{
+  if (!s_use_worker_thread)
+    return;
+
+  WaitForConversion();
+
+  {
+    std::unique_lock<std::mutex> lock(s_worker_mutex);
+    s_worker_shutdown.store(true);
+    s_worker_wake_cv.notify_one();
+  }
+
+  s_worker_thread.Join();
+  s_use_worker_thread = false;
+  Log_InfoPrint("MDEC worker thread stopped.");
+}
+
+void MDEC::WorkerThreadEntryPoint()
+{
+  // Movies decode a macroblock at a time, so keep spinning for a bit instead of sleeping between them.
+  static constexpr double SPIN_TIME_NS = 1 * 1000000;
+
+  Threading::SetNameOfCurrentThread("MDEC Worker");
+
+  Common::Timer::Value last_job_time = 0;
+  for (;;)
+  {
+    if (!s_worker_job_pending.load(std::memory_order_acquire))
+    {
+      const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+      if (!s_worker_shutdown.load() &&
+          Common::Timer::ConvertValueToNanoseconds(current_time - last_job_time) < SPIN_TIME_NS)
+      {
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(s_worker_mutex);
+      s_worker_sleeping.store(true);
+      s_worker_wake_cv.wait(lock, []() { return s_worker_shutdown.load() || s_worker_job_pending.load(); });
+      s_worker_sleeping.store(false);
+
+      if (s_worker_shutdown.load())
+        break;
+      else
+        continue;
+    }
+
+    RunConversion(s_worker_job);
+    last_job_time = Common::Timer::GetCurrentValue();
+    s_worker_job_pending.store(false, std::memory_order_release);
+  }
+}
+
+void MDEC::IDCT(s16* blk, bool use_old_routines)
 {
   // people have made texture packs using the old conversion routines.. best to just leave them be.
-  if (g_settings.use_old_mdec_routines) [[unlikely]]
+  if (use_old_routines) [[unlikely]]
     IDCT_Old(blk);
   else
     IDCT_New(blk);
 }
 
+void MDEC::UpdateIDCTScaleTable()
+{
+#if defined(CPU_ARCH_SSE)
+  // Pairs of rows are interleaved for pmaddwd, i.e. for each pair of rows z, z+1 and half of the columns:
+  // [z][x], [z+1][x], [z][x+1], [z+1][x+1], ...
+  u32 pos = 0;
+  for (u32 z = 0; z < 8; z += 2)
+  {
+    for (u32 x = 0; x < 8; x++)
+    {
+      s_idct_scale_table[pos++] = s_scale_table[x + z * 8] / 8;
+      s_idct_scale_table[pos++] = s_scale_table[x + (z + 1) * 8] / 8;
+    }
+  }
+#else
+  for (u32 i = 0; i < 64; i++)
+    s_idct_scale_table[i] = s_scale_table[i] / 8;
+#endif
+}
+
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+
+namespace MDEC {
+
+/// One pass of IDCT_New, out[y][x] = sum(in[z][y] * scale[z][x]). The rounding matches the scalar version exactly,
+/// including the division truncating towards zero. The first pass can't exceed 16 bits for inputs from
+/// rl_decode_block(), so both passes can work with 16-bit values.
+template<bool clamp_output>
+ALWAYS_INLINE static void IDCTPass(const s16* in, s16* out)
+{
+#if defined(CPU_ARCH_SSE)
+  // Transpose the input into pairs of rows, so each column can be broadcast against the interleaved scale table.
+  alignas(VECTOR_ALIGNMENT) u32 columns[4][8];
+  for (u32 p = 0; p < 4; p++)
+  {
+    const __m128i r0 = _mm_load_si128(reinterpret_cast<const __m128i*>(in + (p * 2) * 8));
+    const __m128i r1 = _mm_load_si128(reinterpret_cast<const __m128i*>(in + (p * 2 + 1) * 8));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&columns[p][0]), _mm_unpacklo_epi16(r0, r1));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&columns[p][4]), _mm_unpackhi_epi16(r0, r1));
+  }
+
+  const __m128i* table = reinterpret_cast<const __m128i*>(s_idct_scale_table.data());
+  const __m128i round = _mm_set1_epi32(0xfff);
+  const __m128i negative_bias = _mm_set1_epi32(0x1fff);
+  for (u32 y = 0; y < 8; y++)
+  {
+    __m128i sum_lo = _mm_setzero_si128();
+    __m128i sum_hi = _mm_setzero_si128();
+    for (u32 p = 0; p < 4; p++)
+    {
+      const __m128i column = _mm_set1_epi32(static_cast<s32>(columns[p][y]));
+      sum_lo = _mm_add_epi32(sum_lo, _mm_madd_epi16(column, _mm_load_si128(&table[p * 2])));
+      sum_hi = _mm_add_epi32(sum_hi, _mm_madd_epi16(column, _mm_load_si128(&table[p * 2 + 1])));
+    }
+
+    // (sum + 0xfff) / 0x2000
+    sum_lo = _mm_add_epi32(sum_lo, round);
+    sum_hi = _mm_add_epi32(sum_hi, round);
+    sum_lo = _mm_srai_epi32(_mm_add_epi32(sum_lo, _mm_and_si128(_mm_srai_epi32(sum_lo, 31), negative_bias)), 13);
+    sum_hi = _mm_srai_epi32(_mm_add_epi32(sum_hi, _mm_and_si128(_mm_srai_epi32(sum_hi, 31), negative_bias)), 13);
+
+    __m128i res = _mm_packs_epi32(sum_lo, sum_hi);
+    if constexpr (clamp_output)
+      res = _mm_max_epi16(_mm_min_epi16(res, _mm_set1_epi16(127)), _mm_set1_epi16(-128));
+    _mm_store_si128(reinterpret_cast<__m128i*>(out + y * 8), res);
+  }
+#elif defined(CPU_ARCH_NEON)
+  int16x8_t table[8];
+  for (u32 z = 0; z < 8; z++)
+    table[z] = vld1q_s16(&s_idct_scale_table[z * 8]);
+
+  const int32x4_t round = vdupq_n_s32(0xfff);
+  const int32x4_t negative_bias = vdupq_n_s32(0x1fff);
+  for (u32 y = 0; y < 8; y++)
+  {
+    int32x4_t sum_lo = vdupq_n_s32(0);
+    int32x4_t sum_hi = vdupq_n_s32(0);
+    for (u32 z = 0; z < 8; z++)
+    {
+      const s16 value = in[y + z * 8];
+      sum_lo = vmlal_n_s16(sum_lo, vget_low_s16(table[z]), value);
+      sum_hi = vmlal_n_s16(sum_hi, vget_high_s16(table[z]), value);
+    }
+
+    // (sum + 0xfff) / 0x2000
+    sum_lo = vaddq_s32(sum_lo, round);
+    sum_hi = vaddq_s32(sum_hi, round);
+    sum_lo = vshrq_n_s32(vaddq_s32(sum_lo, vandq_s32(vshrq_n_s32(sum_lo, 31), negative_bias)), 13);
+    sum_hi = vshrq_n_s32(vaddq_s32(sum_hi, vandq_s32(vshrq_n_s32(sum_hi, 31), negative_bias)), 13);
+
+    int16x8_t res = vcombine_s16(vmovn_s32(sum_lo), vmovn_s32(sum_hi));
+    if constexpr (clamp_output)
+      res = vmaxq_s16(vminq_s16(res, vdupq_n_s16(127)), vdupq_n_s16(-128));
+    vst1q_s16(out + y * 8, res);
+  }
+#endif
+}
+
+} // namespace MDEC
+
+void MDEC::IDCT_New(s16* blk)
+{
+  alignas(VECTOR_ALIGNMENT) std::array<s16, 64> temp;
+  IDCTPass<false>(blk, temp.data());
+  IDCTPass<true>(temp.data(), blk);
+}
+
+#else
+
 void MDEC::IDCT_New(s16* blk)
 {
   std::array<s32, 64> temp;
@@ -786,11 +1166,9 @@ void MDEC::IDCT_New(s16* blk)
   {
     for (u32 y = 0; y < 8; y++)
     {
-      // TODO: We could alter zigzag and invert scale_table to get these in row-major order,
-      // in which case we could do optimize this to a vector multiply.
       s32 sum = 0;
       for (u32 z = 0; z < 8; z++)
-        sum += s32(blk[y + z * 8]) * s32(s_scale_table[x + z * 8] / 8);
+        sum += s32(blk[y + z * 8]) * s32(s_idct_scale_table[x + z * 8]);
       temp[x + y * 8] = static_cast<s32>((sum + 0xfff) / 0x2000);
     }
   }
@@ -800,12 +1178,14 @@ void MDEC::IDCT_New(s16* blk)
     {
       s32 sum = 0;
       for (u32 z = 0; z < 8; z++)
-        sum += temp[y + z * 8] * s32(s_scale_table[x + z * 8] / 8);
+        sum += temp[y + z * 8] * s32(s_idct_scale_table[x + z * 8]);
       blk[x + y * 8] = static_cast<s16>(std::clamp<s32>((sum + 0xfff) / 0x2000, -128, 127));
     }
   }
 }
 
+#endif
+
 void MDEC::IDCT_Old(s16* blk)
 {
   std::array<s64, 64> temp_buffer;
@@ -834,9 +1214,79 @@ void MDEC::IDCT_Old(s16* blk)
 }
 
 void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                      const std::array<s16, 64>& Yblk)
+                      const std::array<s16, 64>& Yblk, s16 addval)
 {
-  const s16 addval = s_status.data_output_signed ? 0 : 0x80;
+#if defined(CPU_ARCH_SSE)
+  // Same float math as below, a row at a time. Chroma is half resolution, so each value covers two pixels.
+  // Multiplies and adds are kept separate so nothing gets fused, and the results are truncated like the casts.
+  const __m128 g_cb_scale = _mm_set1_ps(-0.3437f);
+  const __m128 g_cr_scale = _mm_set1_ps(-0.7143f);
+  const __m128 r_scale = _mm_set1_ps(1.402f);
+  const __m128 b_scale = _mm_set1_ps(1.772f);
+  const __m128i min_value = _mm_set1_epi16(-128);
+  const __m128i max_value = _mm_set1_epi16(127);
+  const __m128i add = _mm_set1_epi16(addval);
+  const __m128i zero = _mm_setzero_si128();
+  for (u32 y = 0; y < 8; y++)
+  {
+    const u32 chroma_offset = (xx / 2) + ((y + yy) / 2) * 8;
+    const __m128i cr16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Crblk[chroma_offset]));
+    const __m128i cb16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Cbblk[chroma_offset]));
+    const __m128 cr = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(cr16, cr16), 16));
+    const __m128 cb = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(cb16, cb16), 16));
+
+    const __m128i r = _mm_cvttps_epi32(_mm_mul_ps(r_scale, cr));
+    const __m128i g = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g_cb_scale, cb), _mm_mul_ps(g_cr_scale, cr)));
+    const __m128i b = _mm_cvttps_epi32(_mm_mul_ps(b_scale, cb));
+
+    const __m128i Y = _mm_load_si128(reinterpret_cast<const __m128i*>(&Yblk[y * 8]));
+    const auto add_luma = [&Y, &min_value, &max_value, &add](__m128i c) {
+      c = _mm_add_epi16(Y, _mm_packs_epi32(_mm_unpacklo_epi32(c, c), _mm_unpackhi_epi32(c, c)));
+      return _mm_add_epi16(_mm_max_epi16(_mm_min_epi16(c, max_value), min_value), add);
+    };
+    const __m128i R = add_luma(r);
+    const __m128i G = add_luma(g);
+    const __m128i B = add_luma(b);
+
+    // Components are combined as 16-bit values, so the sign bits of signed output overlap like they do below.
+    __m128i* out = reinterpret_cast<__m128i*>(&s_block_rgb[xx + (y + yy) * 16]);
+    _mm_store_si128(out, _mm_or_si128(_mm_or_si128(_mm_unpacklo_epi16(R, zero),
+                                                   _mm_slli_epi32(_mm_unpacklo_epi16(G, zero), 8)),
+                                      _mm_slli_epi32(_mm_unpacklo_epi16(B, zero), 16)));
+    _mm_store_si128(out + 1, _mm_or_si128(_mm_or_si128(_mm_unpackhi_epi16(R, zero),
+                                                       _mm_slli_epi32(_mm_unpackhi_epi16(G, zero), 8)),
+                                          _mm_slli_epi32(_mm_unpackhi_epi16(B, zero), 16)));
+  }
+#elif defined(CPU_ARCH_NEON)
+  const int16x8_t min_value = vdupq_n_s16(-128);
+  const int16x8_t max_value = vdupq_n_s16(127);
+  const int16x8_t add = vdupq_n_s16(addval);
+  for (u32 y = 0; y < 8; y++)
+  {
+    const u32 chroma_offset = (xx / 2) + ((y + yy) / 2) * 8;
+    const float32x4_t cr = vcvtq_f32_s32(vmovl_s16(vld1_s16(&Crblk[chroma_offset])));
+    const float32x4_t cb = vcvtq_f32_s32(vmovl_s16(vld1_s16(&Cbblk[chroma_offset])));
+
+    const int32x4_t r = vcvtq_s32_f32(vmulq_n_f32(cr, 1.402f));
+    const int32x4_t g = vcvtq_s32_f32(vaddq_f32(vmulq_n_f32(cb, -0.3437f), vmulq_n_f32(cr, -0.7143f)));
+    const int32x4_t b = vcvtq_s32_f32(vmulq_n_f32(cb, 1.772f));
+
+    const int16x8_t Y = vld1q_s16(&Yblk[y * 8]);
+    const auto add_luma = [&Y, &min_value, &max_value, &add](int32x4_t c) {
+      const int16x8_t sum = vaddq_s16(Y, vcombine_s16(vmovn_s32(vzip1q_s32(c, c)), vmovn_s32(vzip2q_s32(c, c))));
+      return vreinterpretq_u16_s16(vaddq_s16(vmaxq_s16(vminq_s16(sum, max_value), min_value), add));
+    };
+    const uint16x8_t R = add_luma(r);
+    const uint16x8_t G = add_luma(g);
+    const uint16x8_t B = add_luma(b);
+
+    u32* out = &s_block_rgb[xx + (y + yy) * 16];
+    vst1q_u32(out, vorrq_u32(vorrq_u32(vmovl_u16(vget_low_u16(R)), vshlq_n_u32(vmovl_u16(vget_low_u16(G)), 8)),
+                             vshlq_n_u32(vmovl_u16(vget_low_u16(B)), 16)));
+    vst1q_u32(out + 4, vorrq_u32(vorrq_u32(vmovl_u16(vget_high_u16(R)), vshlq_n_u32(vmovl_u16(vget_high_u16(G)), 8)),
+                                 vshlq_n_u32(vmovl_u16(vget_high_u16(B)), 16)));
+  }
+#else
   for (u32 y = 0; y < 8; y++)
   {
     for (u32 x = 0; x < 8; x++)
@@ -858,10 +1308,36 @@ void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const st
                                                 (ZeroExtend32(static_cast<u16>(B)) << 16);
     }
   }
+#endif
 }
 
 void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
 {
+#if defined(CPU_ARCH_SSE)
+  const __m128i min_value = _mm_set1_epi16(-128);
+  const __m128i max_value = _mm_set1_epi16(127);
+  const __m128i add = _mm_set1_epi16(128);
+  const __m128i mask = _mm_set1_epi16(0xFF);
+  const __m128i zero = _mm_setzero_si128();
+  for (u32 i = 0; i < 64; i += 8)
+  {
+    __m128i Y = _mm_load_si128(reinterpret_cast<const __m128i*>(&Yblk[i]));
+    Y = _mm_srai_epi16(_mm_slli_epi16(Y, 6), 6);
+    Y = _mm_and_si128(_mm_add_epi16(_mm_max_epi16(_mm_min_epi16(Y, max_value), min_value), add), mask);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&s_block_rgb[i]), _mm_unpacklo_epi16(Y, zero));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&s_block_rgb[i + 4]), _mm_unpackhi_epi16(Y, zero));
+  }
+#elif defined(CPU_ARCH_NEON)
+  for (u32 i = 0; i < 64; i += 8)
+  {
+    int16x8_t Y = vld1q_s16(&Yblk[i]);
+    Y = vshrq_n_s16(vshlq_n_s16(Y, 6), 6);
+    Y = vaddq_s16(vmaxq_s16(vminq_s16(Y, vdupq_n_s16(127)), vdupq_n_s16(-128)), vdupq_n_s16(128));
+    const uint16x8_t uY = vandq_u16(vreinterpretq_u16_s16(Y), vdupq_n_u16(0xFF));
+    vst1q_u32(&s_block_rgb[i], vmovl_u16(vget_low_u16(uY)));
+    vst1q_u32(&s_block_rgb[i + 4], vmovl_u16(vget_high_u16(uY)));
+  }
+#else
   for (u32 i = 0; i < 64; i++)
   {
     s16 Y = Yblk[i];
@@ -870,6 +1346,7 @@ void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
     Y += 128;
     s_block_rgb[i] = static_cast<u32>(Y) & 0xFF;
   }
+#endif
 }
 
 void MDEC::HandleSetQuantTableCommand()
@@ -900,6 +1377,44 @@ void MDEC::HandleSetScaleCommand()
   s_data_in_fifo.PopRange(packed_data.data(), static_cast<u32>(packed_data.size()));
   s_remaining_halfwords -= 32;
   std::memcpy(s_scale_table.data(), packed_data.data(), s_scale_table.size() * sizeof(s16));
+  UpdateIDCTScaleTable();
+}
+
+void MDEC::SetDataRecording(std::vector<u32>* words)
+{
+  s_data_recording = words;
+}
+
+u32 MDEC::DecodeDataStream(const u32* words, u32 word_count)
+{
+  SoftReset();
+
+  // Fed in blocks like games usually set up the DMA, never more than the FIFO can take.
+  static constexpr u32 DMA_BLOCK_WORDS = 32;
+
+  const u32 start_blocks_decoded = s_total_blocks_decoded;
+  u32 position = 0;
+  for (;;)
+  {
+    const u32 words_to_write = std::min({word_count - position, s_data_in_fifo.GetSpace() / 2, DMA_BLOCK_WORDS});
+    DMAWrite(words + position, words_to_write);
+    position += words_to_write;
+
+    if (s_state == State::WritingMacroblock)
+    {
+      // Don't wait for the event, the next macroblock is decoded as soon as the output is thrown away.
+      CopyOutBlock(nullptr, 0, 0);
+      s_data_out_fifo.Clear();
+      continue;
+    }
+
+    // Either the stream is done, or it's waiting on more data than is left.
+    if (words_to_write == 0)
+      break;
+  }
+
+  SoftReset();
+  return s_total_blocks_decoded - start_blocks_decoded;
 }
 
 void MDEC::DrawDebugStateWindow()
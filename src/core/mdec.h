@@ -4,6 +4,8 @@
 #pragma once
 #include "types.h"
 
+#include <vector>
+
 class StateWrapper;
 
 namespace MDEC {
@@ -13,6 +15,9 @@ void Shutdown();
 void Reset();
 bool DoState(StateWrapper& sw);
 
+/// Moves the IDCT and colour conversion of macroblocks to a worker thread, or back to the CPU thread.
+void SetUseThread(bool enabled);
+
 // I/O
 u32 ReadRegister(u32 offset);
 void WriteRegister(u32 offset, u32 value);
@@ -22,4 +27,12 @@ void DMAWrite(const u32* words, u32 word_count);
 
 void DrawDebugStateWindow();
 
+// Benchmarking
+/// Appends every word written to the data register, from the CPU or DMA, to the vector. Pass nullptr to stop.
+void SetDataRecording(std::vector<u32>* words);
+
+/// Decodes a recorded data stream as fast as possible, discarding the output. Timing and DMA are bypassed, so this
+/// should only be used when nothing else is running. Returns the number of blocks decoded.
+u32 DecodeDataStream(const u32* words, u32 word_count);
+
 } // namespace MDEC
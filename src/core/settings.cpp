@@ -170,6 +170,7 @@ void Settings::Load(SettingsInterface& si)
   cpu_recompiler_memory_exceptions = si.GetBoolValue("CPU", "RecompilerMemoryExceptions", false);
   cpu_recompiler_block_linking = si.GetBoolValue("CPU", "RecompilerBlockLinking", true);
   cpu_recompiler_icache = si.GetBoolValue("CPU", "RecompilerICache", false);
+  cpu_idle_loop_skipping = si.GetBoolValue("CPU", "IdleLoopSkipping", true);
   cpu_fastmem_mode = ParseCPUFastmemMode(
                        si.GetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(DEFAULT_CPU_FASTMEM_MODE)).c_str())
                        .value_or(DEFAULT_CPU_FASTMEM_MODE);
@@ -280,6 +281,7 @@ void Settings::Load(SettingsInterface& si)
   display_show_fps = si.GetBoolValue("Display", "ShowFPS", false);
   display_show_speed = si.GetBoolValue("Display", "ShowSpeed", false);
   display_show_gpu_stats = si.GetBoolValue("Display", "ShowGPUStatistics", false);
+  display_show_audio_stats = si.GetBoolValue("Display", "ShowAudioStatistics", false);
   display_show_resolution = si.GetBoolValue("Display", "ShowResolution", false);
   display_show_latency_stats = si.GetBoolValue("Display", "ShowLatencyStatistics", false);
   display_show_cpu_usage = si.GetBoolValue("Display", "ShowCPU", false);
@@ -326,6 +328,8 @@ void Settings::Load(SettingsInterface& si)
   dma_halt_ticks = si.GetIntValue("Hacks", "DMAHaltTicks", DEFAULT_DMA_HALT_TICKS);
   gpu_fifo_size = static_cast<u32>(si.GetIntValue("Hacks", "GPUFIFOSize", DEFAULT_GPU_FIFO_SIZE));
   gpu_max_run_ahead = si.GetIntValue("Hacks", "GPUMaxRunAhead", DEFAULT_GPU_MAX_RUN_AHEAD);
+  dma_linked_list_fast_path = si.GetBoolValue("Hacks", "DMALinkedListFastPath", true);
+  mdec_use_thread = si.GetBoolValue("Hacks", "MDECUseThread", true);
 
   bios_tty_logging = si.GetBoolValue("BIOS", "TTYLogging", false);
   bios_patch_fast_boot = si.GetBoolValue("BIOS", "PatchFastBoot", DEFAULT_FAST_BOOT_VALUE);
@@ -468,6 +472,7 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", cpu_recompiler_memory_exceptions);
   si.SetBoolValue("CPU", "RecompilerBlockLinking", cpu_recompiler_block_linking);
   si.SetBoolValue("CPU", "RecompilerICache", cpu_recompiler_icache);
+  si.SetBoolValue("CPU", "IdleLoopSkipping", cpu_idle_loop_skipping);
   si.SetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(cpu_fastmem_mode));
 
   si.SetStringValue("GPU", "Renderer", GetRendererName(gpu_renderer));
@@ -541,6 +546,7 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
     si.SetBoolValue("Display", "ShowResolution", display_show_resolution);
     si.SetBoolValue("Display", "ShowLatencyStatistics", display_show_latency_stats);
     si.SetBoolValue("Display", "ShowGPUStatistics", display_show_gpu_stats);
+    si.SetBoolValue("Display", "ShowAudioStatistics", display_show_audio_stats);
     si.SetBoolValue("Display", "ShowCPU", display_show_cpu_usage);
     si.SetBoolValue("Display", "ShowGPU", display_show_gpu_usage);
     si.SetBoolValue("Display", "ShowFrameTimes", display_show_frame_times);
@@ -578,6 +584,8 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
     si.SetIntValue("Hacks", "DMAHaltTicks", dma_halt_ticks);
     si.SetIntValue("Hacks", "GPUFIFOSize", gpu_fifo_size);
     si.SetIntValue("Hacks", "GPUMaxRunAhead", gpu_max_run_ahead);
+    si.SetBoolValue("Hacks", "DMALinkedListFastPath", dma_linked_list_fast_path);
+    si.SetBoolValue("Hacks", "MDECUseThread", mdec_use_thread);
   }
 
   si.SetBoolValue("PCDrv", "Enabled", pcdrv_enable);
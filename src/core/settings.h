@@ -70,6 +70,7 @@ struct Settings
   bool cpu_recompiler_memory_exceptions : 1 = false;
   bool cpu_recompiler_block_linking : 1 = true;
   bool cpu_recompiler_icache : 1 = false;
+  bool cpu_idle_loop_skipping : 1 = true;
   CPUFastmemMode cpu_fastmem_mode = DEFAULT_CPU_FASTMEM_MODE;
 
   float emulation_speed = 1.0f;
@@ -154,6 +155,7 @@ struct Settings
   bool display_show_fps : 1 = false;
   bool display_show_speed : 1 = false;
   bool display_show_gpu_stats : 1 = false;
+  bool display_show_audio_stats : 1 = false;
   bool display_show_resolution : 1 = false;
   bool display_show_latency_stats : 1 = false;
   bool display_show_cpu_usage : 1 = false;
@@ -198,6 +200,8 @@ struct Settings
   TickCount dma_halt_ticks = DEFAULT_DMA_HALT_TICKS;
   u32 gpu_fifo_size = DEFAULT_GPU_FIFO_SIZE;
   TickCount gpu_max_run_ahead = DEFAULT_GPU_MAX_RUN_AHEAD;
+  bool dma_linked_list_fast_path = true;
+  bool mdec_use_thread = true;
 
   // achievements
   bool achievements_enabled : 1 = false;
@@ -9,6 +9,7 @@
 #include "interrupt_controller.h"
 #include "system.h"
 
+#include "util/audio_perf_counters.h"
 #include "util/audio_stream.h"
 #include "util/imgui_manager.h"
 #include "util/state_wrapper.h"
@@ -18,6 +19,7 @@
 #include "common/bitutils.h"
 #include "common/error.h"
 #include "common/fifo_queue.h"
+#include "common/intrin.h"
 #include "common/log.h"
 #include "common/path.h"
 
@@ -53,7 +55,9 @@ enum : u32
   CAPTURE_BUFFER_SIZE_PER_CHANNEL = 0x400,
   MINIMUM_TICKS_BETWEEN_KEY_ON_OFF = 2,
   NUM_REVERB_REGS = 32,
-  FIFO_SIZE_IN_HALFWORDS = 32
+  FIFO_SIZE_IN_HALFWORDS = 32,
+  VOICE_CHUNK_FRAMES = 32,
+  MAX_VOICE_MIX_SLOTS = (NUM_VOICES > VOICE_CHUNK_FRAMES) ? NUM_VOICES : VOICE_CHUNK_FRAMES,
 };
 enum : s16
 {
@@ -265,7 +269,9 @@ struct Voice
   void ForceOff();
 
   void DecodeBlock(const ADPCMBlock& block);
-  s32 Interpolate() const;
+
+  // Fills in the four samples and gaussian coefficients for the current interpolation position.
+  void GetInterpolationTaps(s16* samples, s16* coefficients) const;
 
   // Switches to the specified phase, filling in target.
   void UpdateADSREnvelope();
@@ -331,14 +337,23 @@ static void WriteToCaptureBuffer(u32 index, s16 value);
 static void IncrementCaptureBufferPosition();
 
 static void ReadADPCMBlock(u16 address, ADPCMBlock* block);
-static std::tuple<s32, s32> SampleVoice(u32 voice_index);
+static void GatherVoiceSample(u32 voice_index, u32 slot, s16 noise_level);
+static void MixVoiceSamples(u32 count);
+static void MixVoiceSamplesScalar(u32 count);
+static void AdvanceVoice(u32 voice_index, s32 modulator_volume);
+static void SampleVoices(s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right);
+static bool CanSampleVoiceChunk(u32 frames);
+static void SampleVoiceChunk(u32 frames);
+static void SampleVoiceChunkFrames(u32 voice_index, u32 frames);
+static void MixFrames(u32 frames, s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right,
+                      const s32* capture_volume_1, const s32* capture_volume_3, s16* output_frames);
 
 static void UpdateNoise();
 
 static u32 ReverbMemoryAddress(u32 address);
 static s16 ReverbRead(u32 address, s32 offset = 0);
 static void ReverbWrite(u32 address, s16 data);
-static void ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
+static void ProcessReverb(const s32* left_in, const s32* right_in, s32* left_out, s32* right_out, u32 frames);
 
 static void Execute(void* param, TickCount ticks, TickCount ticks_late);
 static void UpdateEventInterval();
@@ -403,6 +418,38 @@ static s32 s_reverb_resample_buffer_position = 0;
 
 static std::array<Voice, NUM_VOICES> s_voices{};
 
+// Scratch for the samples being mixed, in structure-of-arrays form so that several can be processed at once. Indexed
+// by slot, which is either the position of the voice in the list of voices being sampled this frame, or the frame
+// within a chunk when a single voice is sampled for several frames.
+namespace {
+struct VoiceMixBuffers
+{
+  alignas(VECTOR_ALIGNMENT) std::array<s16, MAX_VOICE_MIX_SLOTS * 4> samples;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, MAX_VOICE_MIX_SLOTS * 4> coefficients;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MAX_VOICE_MIX_SLOTS> adsr_volume;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MAX_VOICE_MIX_SLOTS> left_level;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MAX_VOICE_MIX_SLOTS> right_level;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MAX_VOICE_MIX_SLOTS> volume;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MAX_VOICE_MIX_SLOTS> left;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MAX_VOICE_MIX_SLOTS> right;
+  std::array<u8, MAX_VOICE_MIX_SLOTS> voice_index;
+};
+
+// Per-frame results when sampling voices a chunk at a time.
+struct VoiceChunkBuffers
+{
+  std::array<s16, VOICE_CHUNK_FRAMES> noise_level;
+  std::array<std::array<s32, VOICE_CHUNK_FRAMES>, NUM_VOICES> volume;
+  std::array<s32, VOICE_CHUNK_FRAMES> left_sum;
+  std::array<s32, VOICE_CHUNK_FRAMES> right_sum;
+  std::array<s32, VOICE_CHUNK_FRAMES> reverb_in_left;
+  std::array<s32, VOICE_CHUNK_FRAMES> reverb_in_right;
+};
+} // namespace
+
+static VoiceMixBuffers s_voice_mix{};
+static VoiceChunkBuffers s_voice_chunk{};
+
 static InlineFIFOQueue<u16, FIFO_SIZE_IN_HALFWORDS> s_transfer_fifo;
 
 static std::array<u8, RAM_SIZE> s_ram{};
@@ -1838,7 +1885,7 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   current_block_flags.bits = block.flags.bits;
 }
 
-s32 SPU::Voice::Interpolate() const
+void SPU::Voice::GetInterpolationTaps(s16* samples, s16* coefficients) const
 {
   static constexpr std::array<s16, 0x200> gauss = {{
     -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
@@ -1910,11 +1957,14 @@ s32 SPU::Voice::Interpolate() const
   const u8 i = counter.interpolation_index;
   const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(counter.sample_index.GetValue());
 
-  s32 out = s32(gauss[0x0FF - i]) * s32(current_block_samples[s - 3]);
-  out += s32(gauss[0x1FF - i]) * s32(current_block_samples[s - 2]);
-  out += s32(gauss[0x100 + i]) * s32(current_block_samples[s - 1]);
-  out += s32(gauss[0x000 + i]) * s32(current_block_samples[s - 0]);
-  return out >> 15;
+  samples[0] = current_block_samples[s - 3];
+  samples[1] = current_block_samples[s - 2];
+  samples[2] = current_block_samples[s - 1];
+  samples[3] = current_block_samples[s - 0];
+  coefficients[0] = gauss[0x0FF - i];
+  coefficients[1] = gauss[0x1FF - i];
+  coefficients[2] = gauss[0x100 + i];
+  coefficients[3] = gauss[0x000 + i];
 }
 
 void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
@@ -1944,24 +1994,9 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
-ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
+ALWAYS_INLINE_RELEASE void SPU::GatherVoiceSample(u32 voice_index, u32 slot, s16 noise_level)
 {
   Voice& voice = s_voices[voice_index];
-  if (!voice.IsOn() && !s_SPUCNT.irq9_enable)
-  {
-    voice.last_volume = 0;
-
-#ifdef SPU_DUMP_ALL_VOICES
-    if (s_voice_dump_writers[voice_index])
-    {
-      const s16 dump_samples[2] = {0, 0};
-      s_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
-    }
-#endif
-
-    return {};
-  }
-
   if (!voice.has_samples)
   {
     ADPCMBlock block;
@@ -1976,26 +2011,167 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
     }
   }
 
-  // skip interpolation when the volume is muted anyway
-  s32 volume;
+  VoiceMixBuffers& mix = s_voice_mix;
+  s16* const samples = &mix.samples[slot * 4];
+  s16* const coefficients = &mix.coefficients[slot * 4];
+
+  // Skip interpolation when the volume is muted anyway, multiplying by zero discards whatever is left in the taps.
   if (voice.regs.adsr_volume != 0)
   {
-    // interpolate/sample and apply ADSR volume
-    s32 sample;
     if (IsVoiceNoiseEnabled(voice_index))
-      sample = GetVoiceNoiseLevel();
+    {
+      // Two taps of 0x4000 sum to 0x8000, so the noise level passes through interpolation unchanged.
+      samples[0] = noise_level;
+      samples[1] = noise_level;
+      samples[2] = 0;
+      samples[3] = 0;
+      coefficients[0] = 0x4000;
+      coefficients[1] = 0x4000;
+      coefficients[2] = 0;
+      coefficients[3] = 0;
+    }
     else
-      sample = voice.Interpolate();
+    {
+      voice.GetInterpolationTaps(samples, coefficients);
+    }
+  }
+
+  mix.adsr_volume[slot] = voice.regs.adsr_volume;
+  mix.left_level[slot] = voice.left_volume.current_level;
+  mix.right_level[slot] = voice.right_volume.current_level;
+  mix.voice_index[slot] = static_cast<u8>(voice_index);
+}
+
+#ifdef CPU_ARCH_SSE
 
-    volume = ApplyVolume(sample, voice.regs.adsr_volume);
+// SSE2 has no 32-bit multiply-low, but the low half of the product is the same for signed and unsigned inputs.
+ALWAYS_INLINE static __m128i MultiplyLow32(__m128i a, __m128i b)
+{
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+#endif
+
+ALWAYS_INLINE_RELEASE void SPU::MixVoiceSamples(u32 count)
+{
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  VoiceMixBuffers& mix = s_voice_mix;
+
+  // Four voices per iteration. Slots past the count hold stale data, the results for them are ignored.
+  for (u32 slot = 0; slot < count; slot += 4)
+  {
+#if defined(CPU_ARCH_SSE)
+    // madd gives the sum of each pair of taps, adding the even and odd lanes completes each voice's dot product.
+    const __m128i taps01 =
+      _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(&mix.samples[slot * 4])),
+                     _mm_load_si128(reinterpret_cast<const __m128i*>(&mix.coefficients[slot * 4])));
+    const __m128i taps23 =
+      _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(&mix.samples[slot * 4 + 8])),
+                     _mm_load_si128(reinterpret_cast<const __m128i*>(&mix.coefficients[slot * 4 + 8])));
+    const __m128 taps01f = _mm_castsi128_ps(taps01);
+    const __m128 taps23f = _mm_castsi128_ps(taps23);
+    const __m128i sample =
+      _mm_srai_epi32(_mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(taps01f, taps23f, _MM_SHUFFLE(2, 0, 2, 0))),
+                                   _mm_castps_si128(_mm_shuffle_ps(taps01f, taps23f, _MM_SHUFFLE(3, 1, 3, 1)))),
+                     15);
+
+    const __m128i volume = _mm_srai_epi32(
+      MultiplyLow32(sample, _mm_load_si128(reinterpret_cast<const __m128i*>(&mix.adsr_volume[slot]))), 15);
+    const __m128i left = _mm_srai_epi32(
+      MultiplyLow32(volume, _mm_load_si128(reinterpret_cast<const __m128i*>(&mix.left_level[slot]))), 15);
+    const __m128i right = _mm_srai_epi32(
+      MultiplyLow32(volume, _mm_load_si128(reinterpret_cast<const __m128i*>(&mix.right_level[slot]))), 15);
+
+    _mm_store_si128(reinterpret_cast<__m128i*>(&mix.volume[slot]), volume);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&mix.left[slot]), left);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&mix.right[slot]), right);
+#elif defined(CPU_ARCH_NEON)
+    const int16x8_t samples01 = vld1q_s16(&mix.samples[slot * 4]);
+    const int16x8_t samples23 = vld1q_s16(&mix.samples[slot * 4 + 8]);
+    const int16x8_t coefficients01 = vld1q_s16(&mix.coefficients[slot * 4]);
+    const int16x8_t coefficients23 = vld1q_s16(&mix.coefficients[slot * 4 + 8]);
+    const int32x4_t taps0 = vmull_s16(vget_low_s16(samples01), vget_low_s16(coefficients01));
+    const int32x4_t taps1 = vmull_s16(vget_high_s16(samples01), vget_high_s16(coefficients01));
+    const int32x4_t taps2 = vmull_s16(vget_low_s16(samples23), vget_low_s16(coefficients23));
+    const int32x4_t taps3 = vmull_s16(vget_high_s16(samples23), vget_high_s16(coefficients23));
+    const int32x4_t sample = vshrq_n_s32(vpaddq_s32(vpaddq_s32(taps0, taps1), vpaddq_s32(taps2, taps3)), 15);
+
+    const int32x4_t volume = vshrq_n_s32(vmulq_s32(sample, vld1q_s32(&mix.adsr_volume[slot])), 15);
+    vst1q_s32(&mix.volume[slot], volume);
+    vst1q_s32(&mix.left[slot], vshrq_n_s32(vmulq_s32(volume, vld1q_s32(&mix.left_level[slot])), 15));
+    vst1q_s32(&mix.right[slot], vshrq_n_s32(vmulq_s32(volume, vld1q_s32(&mix.right_level[slot])), 15));
+#endif
   }
-  else
+#else
+  MixVoiceSamplesScalar(count);
+#endif
+}
+
+void SPU::MixVoiceSamplesScalar(u32 count)
+{
+  VoiceMixBuffers& mix = s_voice_mix;
+  for (u32 slot = 0; slot < count; slot++)
+  {
+    const s16* samples = &mix.samples[slot * 4];
+    const s16* coefficients = &mix.coefficients[slot * 4];
+    s32 sample = s32(coefficients[0]) * s32(samples[0]);
+    sample += s32(coefficients[1]) * s32(samples[1]);
+    sample += s32(coefficients[2]) * s32(samples[2]);
+    sample += s32(coefficients[3]) * s32(samples[3]);
+    sample >>= 15;
+
+    const s32 volume = ApplyVolume(sample, static_cast<s16>(mix.adsr_volume[slot]));
+    mix.volume[slot] = volume;
+    mix.left[slot] = ApplyVolume(volume, static_cast<s16>(mix.left_level[slot]));
+    mix.right[slot] = ApplyVolume(volume, static_cast<s16>(mix.right_level[slot]));
+  }
+}
+
+bool SPU::HasVectorizedVoiceMixing()
+{
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SPU::MixVoicesForTest(VoiceMixTestState* voices, u32 count, bool vectorized)
+{
+  static_assert(MAX_VOICE_MIX_TEST_COUNT <= MAX_VOICE_MIX_SLOTS);
+  DebugAssert(count <= MAX_VOICE_MIX_TEST_COUNT);
+
+  VoiceMixBuffers& mix = s_voice_mix;
+  for (u32 slot = 0; slot < count; slot++)
   {
-    volume = 0;
+    const VoiceMixTestState& voice = voices[slot];
+    std::memcpy(&mix.samples[slot * 4], voice.samples.data(), sizeof(voice.samples));
+    std::memcpy(&mix.coefficients[slot * 4], voice.coefficients.data(), sizeof(voice.coefficients));
+    mix.adsr_volume[slot] = voice.adsr_volume;
+    mix.left_level[slot] = voice.left_level;
+    mix.right_level[slot] = voice.right_level;
   }
 
-  voice.last_volume = volume;
+  if (vectorized)
+    MixVoiceSamples(count);
+  else
+    MixVoiceSamplesScalar(count);
+
+  for (u32 slot = 0; slot < count; slot++)
+  {
+    VoiceMixTestState& voice = voices[slot];
+    voice.volume = mix.volume[slot];
+    voice.left = mix.left[slot];
+    voice.right = mix.right[slot];
+  }
+}
 
+ALWAYS_INLINE_RELEASE void SPU::AdvanceVoice(u32 voice_index, s32 modulator_volume)
+{
+  Voice& voice = s_voices[voice_index];
   if (voice.adsr_phase != ADSRPhase::Off)
     voice.TickADSR();
 
@@ -2003,7 +2179,7 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
   u16 step = voice.regs.adpcm_sample_rate;
   if (IsPitchModulationEnabled(voice_index))
   {
-    const s32 factor = std::clamp<s32>(s_voices[voice_index - 1].last_volume, -0x8000, 0x7FFF) + 0x8000;
+    const s32 factor = std::clamp<s32>(modulator_volume, -0x8000, 0x7FFF) + 0x8000;
     step = Truncate16(static_cast<u32>((SignExtend32(step) * factor) >> 15));
   }
   step = std::min<u16>(step, 0x3FFF);
@@ -2048,21 +2224,194 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
     }
   }
 
-  // apply per-channel volume
-  const s32 left = ApplyVolume(volume, voice.left_volume.current_level);
-  const s32 right = ApplyVolume(volume, voice.right_volume.current_level);
+  // per-channel volume was applied with the levels from before the tick
   voice.left_volume.Tick();
   voice.right_volume.Tick();
+}
+
+void SPU::SampleVoices(s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right)
+{
+  // Voices are sampled in three passes: decoding and gathering the interpolation taps, then interpolation and volume
+  // for all of the voices at once, and finally the envelope and counter updates in voice order. Nothing in the first
+  // pass depends on the state of the other voices, so the output is the same as sampling each voice in turn. Voices
+  // which are off are skipped, unless the RAM IRQ is enabled, since their ADPCM reads can still trigger it.
+  AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::SPUSampleVoices);
+  const bool sample_off_voices = s_SPUCNT.irq9_enable;
+  u32 count = 0;
+  for (u32 voice_index = 0; voice_index < NUM_VOICES; voice_index++)
+  {
+    Voice& voice = s_voices[voice_index];
+    if (!voice.IsOn() && !sample_off_voices)
+    {
+      voice.last_volume = 0;
+
+#ifdef SPU_DUMP_ALL_VOICES
+      if (s_voice_dump_writers[voice_index])
+      {
+        const s16 dump_samples[2] = {0, 0};
+        s_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
+      }
+#endif
+
+      continue;
+    }
+
+    GatherVoiceSample(voice_index, count++, GetVoiceNoiseLevel());
+  }
+
+  if (count == 0)
+    return;
+
+  MixVoiceSamples(count);
+
+  const VoiceMixBuffers& mix = s_voice_mix;
+  const u32 reverb_on_register = s_reverb_on_register;
+  for (u32 slot = 0; slot < count; slot++)
+  {
+    const u32 voice_index = mix.voice_index[slot];
+    s_voices[voice_index].last_volume = mix.volume[slot];
+    AudioPerfCounters::AddVoiceFrames(voice_index, 1);
+    AdvanceVoice(voice_index, (voice_index > 0) ? s_voices[voice_index - 1].last_volume : 0);
+
+    const s32 left = mix.left[slot];
+    const s32 right = mix.right[slot];
+    *left_sum += left;
+    *right_sum += right;
+
+    if (reverb_on_register & (1u << voice_index))
+    {
+      *reverb_in_left += left;
+      *reverb_in_right += right;
+    }
+
+#ifdef SPU_DUMP_ALL_VOICES
+    if (s_voice_dump_writers[voice_index])
+    {
+      const s16 dump_samples[2] = {static_cast<s16>(Clamp16(left)), static_cast<s16>(Clamp16(right))};
+      s_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
+    }
+#endif
+  }
+}
+
+bool SPU::CanSampleVoiceChunk(u32 frames)
+{
+  // Sampling a voice for several frames at once moves its ADPCM reads ahead of the capture buffer and reverb writes,
+  // and the other voices' reads for those frames. That's only unobservable when no voice can read from the areas being
+  // written, and the RAM IRQ can't be hit by anything in the chunk, otherwise fall back to sampling frame by frame.
+  static constexpr u32 RAM_UNITS = RAM_SIZE >> VOICE_ADDRESS_SHIFT;
+  static constexpr u32 CAPTURE_BUFFER_UNITS = (CAPTURE_BUFFER_SIZE_PER_CHANNEL * 4) >> VOICE_ADDRESS_SHIFT;
+  const bool check_irq = IsRAMIRQTriggerable();
+  if (check_irq && s_irq_address < CAPTURE_BUFFER_UNITS)
+    return false;
+
+  // Reverb addresses are in halfwords, and the work area runs to the end of RAM.
+  const bool check_reverb = s_SPUCNT.reverb_master_enable;
+  const u16 reverb_start = static_cast<u16>(s_reverb_base_address >> 2);
+  const u32 reverb_units = RAM_UNITS - reverb_start;
+
+  // Addresses are in 8-byte units, and wrap around at the end of RAM. The step is clamped to 0x3FFF, so a voice moves
+  // less than four samples per frame, plus the block which is currently loaded and a partial block at the end. Every
+  // block which is read is a continuation of the current or repeat address, since loop starts only ever set the
+  // repeat address to a block which has just been read.
+  static constexpr u32 BLOCK_UNITS = sizeof(ADPCMBlock) >> VOICE_ADDRESS_SHIFT;
+  const u32 read_units = (((frames * 4) / NUM_SAMPLES_PER_ADPCM_BLOCK) + 2) * BLOCK_UNITS;
+  const auto overlaps = [](u16 a, u32 a_units, u16 b, u32 b_units) {
+    return (static_cast<u16>(b - a) < a_units || static_cast<u16>(a - b) < b_units);
+  };
+
+  const bool sample_off_voices = s_SPUCNT.irq9_enable;
+  for (const Voice& voice : s_voices)
+  {
+    if (!voice.IsOn() && !sample_off_voices)
+      continue;
+
+    for (const u16 start : {voice.current_address, static_cast<u16>(voice.regs.adpcm_repeat_address & ~u16(1))})
+    {
+      if (overlaps(start, read_units, 0, CAPTURE_BUFFER_UNITS) ||
+          (check_reverb && overlaps(start, read_units, reverb_start, reverb_units)) ||
+          (check_irq && overlaps(start, read_units, s_irq_address, 1)))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+void SPU::SampleVoiceChunk(u32 frames)
+{
+  AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::SPUSampleVoices);
+  VoiceChunkBuffers& chunk = s_voice_chunk;
+
+  // Noise is updated once per frame, after the voices have been sampled.
+  for (u32 i = 0; i < frames; i++)
+  {
+    chunk.noise_level[i] = GetVoiceNoiseLevel();
+    UpdateNoise();
+  }
+
+  std::fill_n(chunk.left_sum.begin(), frames, 0);
+  std::fill_n(chunk.right_sum.begin(), frames, 0);
+  std::fill_n(chunk.reverb_in_left.begin(), frames, 0);
+  std::fill_n(chunk.reverb_in_right.begin(), frames, 0);
+
+  // Voices are sampled in order, so pitch modulation can use the previous voice's output for the whole chunk.
+  for (u32 voice_index = 0; voice_index < NUM_VOICES; voice_index++)
+    SampleVoiceChunkFrames(voice_index, frames);
+}
+
+ALWAYS_INLINE_RELEASE void SPU::SampleVoiceChunkFrames(u32 voice_index, u32 frames)
+{
+  Voice& voice = s_voices[voice_index];
+  VoiceChunkBuffers& chunk = s_voice_chunk;
+  s32* const volume = chunk.volume[voice_index].data();
+  const s32* const modulator_volume = chunk.volume[(voice_index > 0) ? (voice_index - 1) : 0].data();
+
+  // Voices are only keyed on between chunks, so once a voice is off, it stays off for the rest of the chunk.
+  const bool sample_off_voices = s_SPUCNT.irq9_enable;
+  u32 count = 0;
+  for (; count < frames && (voice.IsOn() || sample_off_voices); count++)
+  {
+    GatherVoiceSample(voice_index, count, chunk.noise_level[count]);
+    AdvanceVoice(voice_index, modulator_volume[count]);
+  }
+
+  const VoiceMixBuffers& mix = s_voice_mix;
+  if (count > 0)
+  {
+    AudioPerfCounters::AddVoiceFrames(voice_index, count);
+    MixVoiceSamples(count);
+
+    const bool reverb_enabled = IsVoiceReverbEnabled(voice_index);
+    for (u32 i = 0; i < count; i++)
+    {
+      volume[i] = mix.volume[i];
+      chunk.left_sum[i] += mix.left[i];
+      chunk.right_sum[i] += mix.right[i];
+      if (reverb_enabled)
+      {
+        chunk.reverb_in_left[i] += mix.left[i];
+        chunk.reverb_in_right[i] += mix.right[i];
+      }
+    }
+  }
+
+  std::fill(volume + count, volume + frames, 0);
+  voice.last_volume = volume[frames - 1];
 
 #ifdef SPU_DUMP_ALL_VOICES
   if (s_voice_dump_writers[voice_index])
   {
-    const s16 dump_samples[2] = {static_cast<s16>(Clamp16(left)), static_cast<s16>(Clamp16(right))};
-    s_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
+    for (u32 i = 0; i < frames; i++)
+    {
+      const s16 dump_samples[2] = {static_cast<s16>((i < count) ? Clamp16(mix.left[i]) : 0),
+                                   static_cast<s16>((i < count) ? Clamp16(mix.right[i]) : 0)};
+      s_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
+    }
   }
 #endif
-
-  return std::make_tuple(left, right);
 }
 
 void SPU::UpdateNoise()
@@ -2129,38 +2478,72 @@ static constexpr std::array<s16, 20> s_reverb_resample_coefficients = {
 static s16 s_last_reverb_input[2];
 static s32 s_last_reverb_output[2];
 
-ALWAYS_INLINE static s32 Reverb4422(const s16* src)
-{
-  s32 out = 0; // 32-bits is adequate(it won't overflow)
+// The same coefficients laid out for filtering a block of input in one go. Downsampling only uses every second input,
+// plus the middle tap, upsampling is padded out to a whole number of vectors.
+alignas(VECTOR_ALIGNMENT) static constexpr std::array<s16, 40> s_reverb_downsample_coefficients = []() {
+  std::array<s16, 40> coefficients = {};
   for (u32 i = 0; i < 20; i++)
-    out += s_reverb_resample_coefficients[i] * src[i * 2];
-
-  // Middle non-zero
-  out += 0x4000 * src[19];
-  out >>= 15;
-  return std::clamp<s32>(out, -32768, 32767);
-}
+    coefficients[i * 2] = s_reverb_resample_coefficients[i];
+  coefficients[19] = 0x4000;
+  return coefficients;
+}();
+alignas(VECTOR_ALIGNMENT) static constexpr std::array<s16, 24> s_reverb_upsample_coefficients = []() {
+  std::array<s16, 24> coefficients = {};
+  for (u32 i = 0; i < 20; i++)
+    coefficients[i] = s_reverb_resample_coefficients[i];
+  return coefficients;
+}();
+
+/// Applies an FIR filter to both channels, returning the unshifted sums. The sums fit in 32 bits, so the order of the
+/// additions does not change the result.
+template<u32 NUM_TAPS>
+ALWAYS_INLINE static void ReverbFilter(const s16* left_src, const s16* right_src, const s16* coefficients, s32* out)
+{
+  static_assert((NUM_TAPS % 8) == 0);
+
+#if defined(CPU_ARCH_SSE)
+  __m128i left = _mm_setzero_si128();
+  __m128i right = _mm_setzero_si128();
+  for (u32 i = 0; i < NUM_TAPS; i += 8)
+  {
+    const __m128i coefficient = _mm_load_si128(reinterpret_cast<const __m128i*>(&coefficients[i]));
+    left = _mm_add_epi32(left,
+                         _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&left_src[i])), coefficient));
+    right = _mm_add_epi32(
+      right, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&right_src[i])), coefficient));
+  }
 
-template<bool phase>
-ALWAYS_INLINE static s32 Reverb2244(const s16* src)
-{
-  s32 out; // 32-bits is adequate(it won't overflow)
-  if (phase)
-  {
-    // Middle non-zero
-    out = src[9];
+  // [L0+L2, R0+R2, L1+L3, R1+R3], then fold the top half down.
+  const __m128i pairs = _mm_add_epi32(_mm_unpacklo_epi32(left, right), _mm_unpackhi_epi32(left, right));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_add_epi32(pairs, _mm_srli_si128(pairs, 8)));
+#elif defined(CPU_ARCH_NEON)
+  int32x4_t left = vdupq_n_s32(0);
+  int32x4_t right = vdupq_n_s32(0);
+  for (u32 i = 0; i < NUM_TAPS; i += 8)
+  {
+    const int16x8_t coefficient = vld1q_s16(&coefficients[i]);
+    const int16x8_t left_samples = vld1q_s16(&left_src[i]);
+    const int16x8_t right_samples = vld1q_s16(&right_src[i]);
+    left = vmlal_s16(left, vget_low_s16(left_samples), vget_low_s16(coefficient));
+    left = vmlal_s16(left, vget_high_s16(left_samples), vget_high_s16(coefficient));
+    right = vmlal_s16(right, vget_low_s16(right_samples), vget_low_s16(coefficient));
+    right = vmlal_s16(right, vget_high_s16(right_samples), vget_high_s16(coefficient));
   }
-  else
-  {
-    out = 0;
-    for (u32 i = 0; i < 20; i++)
-      out += s_reverb_resample_coefficients[i] * src[i];
 
-    out >>= 14;
-    out = std::clamp<s32>(out, -32768, 32767);
+  out[0] = vaddvq_s32(left);
+  out[1] = vaddvq_s32(right);
+#else
+  s32 left = 0;
+  s32 right = 0;
+  for (u32 i = 0; i < NUM_TAPS; i++)
+  {
+    left += s32(coefficients[i]) * s32(left_src[i]);
+    right += s32(coefficients[i]) * s32(right_src[i]);
   }
 
-  return out;
+  out[0] = left;
+  out[1] = right;
+#endif
 }
 
 ALWAYS_INLINE static s16 ReverbSat(s32 val)
@@ -2189,101 +2572,191 @@ ALWAYS_INLINE static s32 IIASM(const s16 IIR_ALPHA, const s16 insamp)
     return insamp * (32768 - IIR_ALPHA);
 }
 
-void SPU::ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out)
+void SPU::ProcessReverb(const s32* left_in, const s32* right_in, s32* left_out, s32* right_out, u32 frames)
 {
-  s_last_reverb_input[0] = left_in;
-  s_last_reverb_input[1] = right_in;
-  s_reverb_downsample_buffer[0][s_reverb_resample_buffer_position | 0x00] = left_in;
-  s_reverb_downsample_buffer[0][s_reverb_resample_buffer_position | 0x40] = left_in;
-  s_reverb_downsample_buffer[1][s_reverb_resample_buffer_position | 0x00] = right_in;
-  s_reverb_downsample_buffer[1][s_reverb_resample_buffer_position | 0x40] = right_in;
+  AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::SPUReverb);
 
-  s32 out[2];
-  if (s_reverb_resample_buffer_position & 1u)
+  // RAM writes can alias anything as far as the compiler is concerned, take a copy of the registers so they aren't
+  // reloaded after every write.
+  const ReverbRegisters regs = s_reverb_registers;
+  const bool reverb_enabled = s_SPUCNT.reverb_master_enable;
+
+  for (u32 frame = 0; frame < frames; frame++)
   {
-    std::array<s32, 2> downsampled;
-    for (unsigned lr = 0; lr < 2; lr++)
-      downsampled[lr] = Reverb4422(&s_reverb_downsample_buffer[lr][(s_reverb_resample_buffer_position - 38) & 0x3F]);
+    const s16 left = static_cast<s16>(Clamp16(left_in[frame]));
+    const s16 right = static_cast<s16>(Clamp16(right_in[frame]));
+    s_last_reverb_input[0] = left;
+    s_last_reverb_input[1] = right;
+    s_reverb_downsample_buffer[0][s_reverb_resample_buffer_position | 0x00] = left;
+    s_reverb_downsample_buffer[0][s_reverb_resample_buffer_position | 0x40] = left;
+    s_reverb_downsample_buffer[1][s_reverb_resample_buffer_position | 0x00] = right;
+    s_reverb_downsample_buffer[1][s_reverb_resample_buffer_position | 0x40] = right;
 
-    for (unsigned lr = 0; lr < 2; lr++)
+    s32 out[2];
+    if (s_reverb_resample_buffer_position & 1u)
     {
-      if (s_SPUCNT.reverb_master_enable)
+      const u32 downsample_position = (s_reverb_resample_buffer_position - 38) & 0x3F;
+      s32 downsampled[2];
+      ReverbFilter<40>(&s_reverb_downsample_buffer[0][downsample_position],
+                       &s_reverb_downsample_buffer[1][downsample_position], s_reverb_downsample_coefficients.data(),
+                       downsampled);
+      for (unsigned lr = 0; lr < 2; lr++)
+        downsampled[lr] = std::clamp<s32>(downsampled[lr] >> 15, -32768, 32767);
+
+      for (unsigned lr = 0; lr < 2; lr++)
       {
-        const s16 IIR_INPUT_A =
-          ReverbSat((((ReverbRead(s_reverb_registers.IIR_SRC_A[lr ^ 0]) * s_reverb_registers.IIR_COEF) >> 14) +
-                     ((downsampled[lr] * s_reverb_registers.IN_COEF[lr]) >> 14)) >>
-                    1);
-        const s16 IIR_INPUT_B =
-          ReverbSat((((ReverbRead(s_reverb_registers.IIR_SRC_B[lr ^ 1]) * s_reverb_registers.IIR_COEF) >> 14) +
-                     ((downsampled[lr] * s_reverb_registers.IN_COEF[lr]) >> 14)) >>
-                    1);
-        const s16 IIR_A =
-          ReverbSat((((IIR_INPUT_A * s_reverb_registers.IIR_ALPHA) >> 14) +
-                     (IIASM(s_reverb_registers.IIR_ALPHA, ReverbRead(s_reverb_registers.IIR_DEST_A[lr], -1)) >> 14)) >>
-                    1);
-        const s16 IIR_B =
-          ReverbSat((((IIR_INPUT_B * s_reverb_registers.IIR_ALPHA) >> 14) +
-                     (IIASM(s_reverb_registers.IIR_ALPHA, ReverbRead(s_reverb_registers.IIR_DEST_B[lr], -1)) >> 14)) >>
-                    1);
-
-        ReverbWrite(s_reverb_registers.IIR_DEST_A[lr], IIR_A);
-        ReverbWrite(s_reverb_registers.IIR_DEST_B[lr], IIR_B);
-      }
+        if (reverb_enabled)
+        {
+          const s16 IIR_INPUT_A =
+            ReverbSat((((ReverbRead(regs.IIR_SRC_A[lr ^ 0]) * regs.IIR_COEF) >> 14) +
+                       ((downsampled[lr] * regs.IN_COEF[lr]) >> 14)) >>
+                      1);
+          const s16 IIR_INPUT_B =
+            ReverbSat((((ReverbRead(regs.IIR_SRC_B[lr ^ 1]) * regs.IIR_COEF) >> 14) +
+                       ((downsampled[lr] * regs.IN_COEF[lr]) >> 14)) >>
+                      1);
+          const s16 IIR_A =
+            ReverbSat((((IIR_INPUT_A * regs.IIR_ALPHA) >> 14) +
+                       (IIASM(regs.IIR_ALPHA, ReverbRead(regs.IIR_DEST_A[lr], -1)) >> 14)) >>
+                      1);
+          const s16 IIR_B =
+            ReverbSat((((IIR_INPUT_B * regs.IIR_ALPHA) >> 14) +
+                       (IIASM(regs.IIR_ALPHA, ReverbRead(regs.IIR_DEST_B[lr], -1)) >> 14)) >>
+                      1);
+
+          ReverbWrite(regs.IIR_DEST_A[lr], IIR_A);
+          ReverbWrite(regs.IIR_DEST_B[lr], IIR_B);
+        }
 
-      const s32 ACC = ((ReverbRead(s_reverb_registers.ACC_SRC_A[lr]) * s_reverb_registers.ACC_COEF_A) >> 14) +
-                      ((ReverbRead(s_reverb_registers.ACC_SRC_B[lr]) * s_reverb_registers.ACC_COEF_B) >> 14) +
-                      ((ReverbRead(s_reverb_registers.ACC_SRC_C[lr]) * s_reverb_registers.ACC_COEF_C) >> 14) +
-                      ((ReverbRead(s_reverb_registers.ACC_SRC_D[lr]) * s_reverb_registers.ACC_COEF_D) >> 14);
+        const s32 ACC = ((ReverbRead(regs.ACC_SRC_A[lr]) * regs.ACC_COEF_A) >> 14) +
+                        ((ReverbRead(regs.ACC_SRC_B[lr]) * regs.ACC_COEF_B) >> 14) +
+                        ((ReverbRead(regs.ACC_SRC_C[lr]) * regs.ACC_COEF_C) >> 14) +
+                        ((ReverbRead(regs.ACC_SRC_D[lr]) * regs.ACC_COEF_D) >> 14);
 
-      const s16 FB_A = ReverbRead(s_reverb_registers.MIX_DEST_A[lr] - s_reverb_registers.FB_SRC_A);
-      const s16 FB_B = ReverbRead(s_reverb_registers.MIX_DEST_B[lr] - s_reverb_registers.FB_SRC_B);
-      const s16 MDA = ReverbSat((ACC + ((FB_A * ReverbNeg(s_reverb_registers.FB_ALPHA)) >> 14)) >> 1);
-      const s16 MDB = ReverbSat(
-        FB_A +
-        ((((MDA * s_reverb_registers.FB_ALPHA) >> 14) + ((FB_B * ReverbNeg(s_reverb_registers.FB_X)) >> 14)) >> 1));
-      const s16 IVB = ReverbSat(FB_B + ((MDB * s_reverb_registers.FB_X) >> 15));
+        const s16 FB_A = ReverbRead(regs.MIX_DEST_A[lr] - regs.FB_SRC_A);
+        const s16 FB_B = ReverbRead(regs.MIX_DEST_B[lr] - regs.FB_SRC_B);
+        const s16 MDA = ReverbSat((ACC + ((FB_A * ReverbNeg(regs.FB_ALPHA)) >> 14)) >> 1);
+        const s16 MDB =
+          ReverbSat(FB_A + ((((MDA * regs.FB_ALPHA) >> 14) + ((FB_B * ReverbNeg(regs.FB_X)) >> 14)) >> 1));
+        const s16 IVB = ReverbSat(FB_B + ((MDB * regs.FB_X) >> 15));
 
-      if (s_SPUCNT.reverb_master_enable)
-      {
-        ReverbWrite(s_reverb_registers.MIX_DEST_A[lr], MDA);
-        ReverbWrite(s_reverb_registers.MIX_DEST_B[lr], MDB);
+        if (reverb_enabled)
+        {
+          ReverbWrite(regs.MIX_DEST_A[lr], MDA);
+          ReverbWrite(regs.MIX_DEST_B[lr], MDB);
+        }
+
+        s_reverb_upsample_buffer[lr][(s_reverb_resample_buffer_position >> 1) | 0x20] =
+          s_reverb_upsample_buffer[lr][s_reverb_resample_buffer_position >> 1] = IVB;
       }
 
-      s_reverb_upsample_buffer[lr][(s_reverb_resample_buffer_position >> 1) | 0x20] =
-        s_reverb_upsample_buffer[lr][s_reverb_resample_buffer_position >> 1] = IVB;
+      s_reverb_current_address = (s_reverb_current_address + 1) & 0x3FFFFu;
+      if (s_reverb_current_address == 0)
+        s_reverb_current_address = s_reverb_base_address;
+
+      const u32 upsample_position = ((s_reverb_resample_buffer_position >> 1) - 19) & 0x1F;
+      ReverbFilter<24>(&s_reverb_upsample_buffer[0][upsample_position], &s_reverb_upsample_buffer[1][upsample_position],
+                       s_reverb_upsample_coefficients.data(), out);
+      for (unsigned lr = 0; lr < 2; lr++)
+        out[lr] = std::clamp<s32>(out[lr] >> 14, -32768, 32767);
+    }
+    else
+    {
+      // Middle non-zero
+      const u32 upsample_position = ((s_reverb_resample_buffer_position >> 1) - 19) & 0x1F;
+      for (unsigned lr = 0; lr < 2; lr++)
+        out[lr] = s_reverb_upsample_buffer[lr][upsample_position + 9];
     }
 
-    s_reverb_current_address = (s_reverb_current_address + 1) & 0x3FFFFu;
-    if (s_reverb_current_address == 0)
-      s_reverb_current_address = s_reverb_base_address;
+    s_reverb_resample_buffer_position = (s_reverb_resample_buffer_position + 1) & 0x3F;
 
-    for (unsigned lr = 0; lr < 2; lr++)
-      out[lr] =
-        Reverb2244<false>(&s_reverb_upsample_buffer[lr][((s_reverb_resample_buffer_position >> 1) - 19) & 0x1F]);
-  }
-  else
-  {
-    for (unsigned lr = 0; lr < 2; lr++)
-      out[lr] = Reverb2244<true>(&s_reverb_upsample_buffer[lr][((s_reverb_resample_buffer_position >> 1) - 19) & 0x1F]);
+    s_last_reverb_output[0] = left_out[frame] = ApplyVolume(out[0], regs.vLOUT);
+    s_last_reverb_output[1] = right_out[frame] = ApplyVolume(out[1], regs.vROUT);
+
+#ifdef SPU_DUMP_ALL_VOICES
+    if (s_voice_dump_writers[NUM_VOICES])
+    {
+      const s16 dump_samples[2] = {static_cast<s16>(Clamp16(s_last_reverb_output[0])),
+                                   static_cast<s16>(Clamp16(s_last_reverb_output[1]))};
+      s_voice_dump_writers[NUM_VOICES]->WriteFrames(dump_samples, 1);
+    }
+#endif
   }
+}
 
-  s_reverb_resample_buffer_position = (s_reverb_resample_buffer_position + 1) & 0x3F;
+void SPU::MixFrames(u32 frames, s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right,
+                    const s32* capture_volume_1, const s32* capture_volume_3, s16* output_frames)
+{
+  DebugAssert(frames <= VOICE_CHUNK_FRAMES);
 
-  s_last_reverb_output[0] = *left_out = ApplyVolume(out[0], s_reverb_registers.vLOUT);
-  s_last_reverb_output[1] = *right_out = ApplyVolume(out[1], s_reverb_registers.vROUT);
+  // Reverb is run over the whole batch, which moves its RAM accesses ahead of the capture buffer writes. If the work
+  // area overlaps the capture buffers, that could be observed, so fall back to mixing one frame at a time.
+  static constexpr u32 CAPTURE_BUFFER_HALFWORDS = (CAPTURE_BUFFER_SIZE_PER_CHANNEL * 4) / sizeof(u16);
+  const u32 batch_size = (s_reverb_base_address >= CAPTURE_BUFFER_HALFWORDS) ? frames : 1;
 
-#ifdef SPU_DUMP_ALL_VOICES
-  if (s_voice_dump_writers[NUM_VOICES])
+  std::array<s16, VOICE_CHUNK_FRAMES> cd_audio_left;
+  std::array<s16, VOICE_CHUNK_FRAMES> cd_audio_right;
+  std::array<s32, VOICE_CHUNK_FRAMES> reverb_out_left;
+  std::array<s32, VOICE_CHUNK_FRAMES> reverb_out_right;
+  for (u32 batch_start = 0; batch_start < frames; batch_start += batch_size)
   {
-    const s16 dump_samples[2] = {static_cast<s16>(Clamp16(s_last_reverb_output[0])),
-                                 static_cast<s16>(Clamp16(s_last_reverb_output[1]))};
-    s_voice_dump_writers[NUM_VOICES]->WriteFrames(dump_samples, 1);
+    const u32 batch_end = batch_start + batch_size;
+    for (u32 i = batch_start; i < batch_end; i++)
+    {
+      if (!s_SPUCNT.mute_n)
+      {
+        left_sum[i] = 0;
+        right_sum[i] = 0;
+      }
+
+      // Mix in CD audio.
+      std::tie(cd_audio_left[i], cd_audio_right[i]) = CDROM::GetAudioFrame();
+      if (s_SPUCNT.cd_audio_enable)
+      {
+        const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left[i]), s_cd_audio_volume_left);
+        const s32 cd_audio_volume_right = ApplyVolume(s32(cd_audio_right[i]), s_cd_audio_volume_right);
+
+        left_sum[i] += cd_audio_volume_left;
+        right_sum[i] += cd_audio_volume_right;
+
+        if (s_SPUCNT.cd_audio_reverb)
+        {
+          reverb_in_left[i] += cd_audio_volume_left;
+          reverb_in_right[i] += cd_audio_volume_right;
+        }
+      }
+    }
+
+    // Compute reverb.
+    ProcessReverb(&reverb_in_left[batch_start], &reverb_in_right[batch_start], &reverb_out_left[batch_start],
+                  &reverb_out_right[batch_start], batch_size);
+
+    for (u32 i = batch_start; i < batch_end; i++)
+    {
+      // Mix in reverb.
+      const s32 left = left_sum[i] + reverb_out_left[i];
+      const s32 right = right_sum[i] + reverb_out_right[i];
+
+      // Apply main volume after clamping. A maximum volume should not overflow here because both are 16-bit values.
+      output_frames[i * 2 + 0] = static_cast<s16>(ApplyVolume(Clamp16(left), s_main_volume_left.current_level));
+      output_frames[i * 2 + 1] = static_cast<s16>(ApplyVolume(Clamp16(right), s_main_volume_right.current_level));
+      s_main_volume_left.Tick();
+      s_main_volume_right.Tick();
+
+      // Write to capture buffers.
+      WriteToCaptureBuffer(0, cd_audio_left[i]);
+      WriteToCaptureBuffer(1, cd_audio_right[i]);
+      WriteToCaptureBuffer(2, static_cast<s16>(Clamp16(capture_volume_1[i])));
+      WriteToCaptureBuffer(3, static_cast<s16>(Clamp16(capture_volume_3[i])));
+      IncrementCaptureBufferPosition();
+    }
   }
-#endif
 }
 
 void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 {
+  AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::SPUExecute);
+
   u32 remaining_frames;
   if (g_settings.cpu_overclock_active)
   {
@@ -2308,79 +2781,41 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 
     s16* output_frame = output_frame_start;
     const u32 frames_in_this_batch = std::min(remaining_frames, output_frame_space);
-    for (u32 i = 0; i < frames_in_this_batch; i++)
+    for (u32 i = 0; i < frames_in_this_batch;)
     {
-      s32 left_sum = 0;
-      s32 right_sum = 0;
-      s32 reverb_in_left = 0;
-      s32 reverb_in_right = 0;
-
-      u32 reverb_on_register = s_reverb_on_register;
-
-      for (u32 voice = 0; voice < NUM_VOICES; voice++)
+      // Voices are keyed on/off after the first frame, so it always has to be sampled on its own.
+      const bool key_on_off_pending = (i == 0 && (s_key_off_register != 0 || s_key_on_register != 0));
+      const u32 chunk_frames = key_on_off_pending ? 1 : std::min<u32>(frames_in_this_batch - i, VOICE_CHUNK_FRAMES);
+      if (chunk_frames > 1 && CanSampleVoiceChunk(chunk_frames))
       {
-        const auto [left, right] = SampleVoice(voice);
-        left_sum += left;
-        right_sum += right;
-
-        if (reverb_on_register & 1u)
-        {
-          reverb_in_left += left;
-          reverb_in_right += right;
-        }
-        reverb_on_register >>= 1;
-      }
+        SampleVoiceChunk(chunk_frames);
 
-      if (!s_SPUCNT.mute_n)
-      {
-        left_sum = 0;
-        right_sum = 0;
+        VoiceChunkBuffers& chunk = s_voice_chunk;
+        MixFrames(chunk_frames, chunk.left_sum.data(), chunk.right_sum.data(), chunk.reverb_in_left.data(),
+                  chunk.reverb_in_right.data(), chunk.volume[1].data(), chunk.volume[3].data(), output_frame);
+        output_frame += chunk_frames * 2;
       }
-
-      // Update noise once per frame.
-      UpdateNoise();
-
-      // Mix in CD audio.
-      const auto [cd_audio_left, cd_audio_right] = CDROM::GetAudioFrame();
-      if (s_SPUCNT.cd_audio_enable)
+      else
       {
-        const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left), s_cd_audio_volume_left);
-        const s32 cd_audio_volume_right = ApplyVolume(s32(cd_audio_right), s_cd_audio_volume_right);
-
-        left_sum += cd_audio_volume_left;
-        right_sum += cd_audio_volume_right;
-
-        if (s_SPUCNT.cd_audio_reverb)
+        for (u32 j = 0; j < chunk_frames; j++)
         {
-          reverb_in_left += cd_audio_volume_left;
-          reverb_in_right += cd_audio_volume_right;
+          s32 left_sum = 0;
+          s32 right_sum = 0;
+          s32 reverb_in_left = 0;
+          s32 reverb_in_right = 0;
+          SampleVoices(&left_sum, &right_sum, &reverb_in_left, &reverb_in_right);
+
+          // Update noise once per frame.
+          UpdateNoise();
+
+          MixFrames(1, &left_sum, &right_sum, &reverb_in_left, &reverb_in_right, &s_voices[1].last_volume,
+                    &s_voices[3].last_volume, output_frame);
+          output_frame += 2;
         }
       }
 
-      // Compute reverb.
-      s32 reverb_out_left, reverb_out_right;
-      ProcessReverb(static_cast<s16>(Clamp16(reverb_in_left)), static_cast<s16>(Clamp16(reverb_in_right)),
-                    &reverb_out_left, &reverb_out_right);
-
-      // Mix in reverb.
-      left_sum += reverb_out_left;
-      right_sum += reverb_out_right;
-
-      // Apply main volume after clamping. A maximum volume should not overflow here because both are 16-bit values.
-      *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_main_volume_left.current_level));
-      *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_main_volume_right.current_level));
-      s_main_volume_left.Tick();
-      s_main_volume_right.Tick();
-
-      // Write to capture buffers.
-      WriteToCaptureBuffer(0, cd_audio_left);
-      WriteToCaptureBuffer(1, cd_audio_right);
-      WriteToCaptureBuffer(2, static_cast<s16>(Clamp16(s_voices[1].last_volume)));
-      WriteToCaptureBuffer(3, static_cast<s16>(Clamp16(s_voices[3].last_volume)));
-      IncrementCaptureBufferPosition();
-
       // Key off/on voices after the first frame.
-      if (i == 0 && (s_key_off_register != 0 || s_key_on_register != 0))
+      if (key_on_off_pending)
       {
         u32 key_off_register = s_key_off_register;
         s_key_off_register = 0;
@@ -2402,6 +2837,8 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
           key_on_register >>= 1;
         }
       }
+
+      i += chunk_frames;
     }
 
     if (s_dump_writer)
@@ -57,4 +57,27 @@ void SetAudioOutputMuted(bool muted);
 AudioStream* GetOutputStream();
 void RecreateOutputStream();
 
+/// Inputs and outputs of the interpolation and volume step of voice mixing.
+struct VoiceMixTestState
+{
+  std::array<s16, 4> samples;
+  std::array<s16, 4> coefficients;
+  s16 adsr_volume;
+  s16 left_level;
+  s16 right_level;
+  s32 volume;
+  s32 left;
+  s32 right;
+};
+
+/// Maximum number of voices which can be passed to MixVoicesForTest() at once.
+static constexpr u32 MAX_VOICE_MIX_TEST_COUNT = 24;
+
+/// Returns true if voice mixing has a vectorized implementation on this platform.
+bool HasVectorizedVoiceMixing();
+
+/// Interpolates and applies the ADSR and left/right volumes to each voice, filling in the outputs. The scalar version
+/// is the reference formula that the vectorized version has to match.
+void MixVoicesForTest(VoiceMixTestState* voices, u32 count, bool vectorized);
+
 }; // namespace SPU
@@ -34,6 +34,7 @@
 #include "texture_replacements.h"
 #include "timers.h"
 
+#include "util/audio_perf_counters.h"
 #include "util/audio_stream.h"
 #include "util/cd_image.h"
 #include "util/gpu_device.h"
@@ -204,6 +205,7 @@ static float s_maximum_frame_time = 0.0f;
 static float s_average_frame_time = 0.0f;
 static float s_cpu_thread_usage = 0.0f;
 static float s_cpu_thread_time = 0.0f;
+static float s_cpu_idle_skip_percent = 0.0f;
 static float s_sw_thread_usage = 0.0f;
 static float s_sw_thread_time = 0.0f;
 static float s_average_gpu_time = 0.0f;
@@ -214,6 +216,7 @@ static u32 s_frame_time_history_pos = 0;
 static u32 s_last_frame_number = 0;
 static u32 s_last_internal_frame_number = 0;
 static u32 s_last_global_tick_counter = 0;
+static u64 s_last_idle_loop_skipped_ticks = 0;
 static u64 s_last_cpu_time = 0;
 static u64 s_last_sw_time = 0;
 static u32 s_presents_since_last_update = 0;
@@ -498,6 +501,10 @@ float System::GetCPUThreadAverageTime()
 {
   return s_cpu_thread_time;
 }
+float System::GetCPUIdleSkipPercent()
+{
+  return s_cpu_idle_skip_percent;
+}
 float System::GetSWThreadUsage()
 {
   return s_sw_thread_usage;
@@ -985,6 +992,7 @@ void System::SetDefaultSettings(SettingsInterface& si)
   temp.display_show_fps = g_settings.display_show_fps;
   temp.display_show_speed = g_settings.display_show_speed;
   temp.display_show_gpu_stats = g_settings.display_show_gpu_stats;
+  temp.display_show_audio_stats = g_settings.display_show_audio_stats;
   temp.display_show_resolution = g_settings.display_show_resolution;
   temp.display_show_cpu_usage = g_settings.display_show_cpu_usage;
   temp.display_show_gpu_usage = g_settings.display_show_gpu_usage;
@@ -1596,14 +1604,17 @@ bool System::Initialize(bool force_software_renderer)
   s_average_frame_time = 0.0f;
   s_cpu_thread_usage = 0.0f;
   s_cpu_thread_time = 0.0f;
+  s_cpu_idle_skip_percent = 0.0f;
   s_sw_thread_usage = 0.0f;
   s_sw_thread_time = 0.0f;
   s_average_gpu_time = 0.0f;
   s_accumulated_gpu_time = 0.0f;
   s_gpu_usage = 0.0f;
+  AudioPerfCounters::SetEnabled(g_settings.display_show_audio_stats);
   s_last_frame_number = 0;
   s_last_internal_frame_number = 0;
   s_last_global_tick_counter = 0;
+  s_last_idle_loop_skipped_ticks = CPU::CodeCache::GetIdleLoopSkippedTicks();
   s_presents_since_last_update = 0;
   s_last_cpu_time = 0;
   s_fps_timer.Reset();
@@ -2635,6 +2646,15 @@ void System::UpdatePerformanceCounters()
   s_speed = static_cast<float>(static_cast<double>(global_tick_counter - s_last_global_tick_counter) /
                                (static_cast<double>(g_ticks_per_second) * time)) *
             100.0f;
+
+  // Fraction of emulated time which was fast-forwarded through in idle loops.
+  const u64 idle_loop_skipped_ticks = CPU::CodeCache::GetIdleLoopSkippedTicks();
+  const u32 ticks_run = global_tick_counter - s_last_global_tick_counter;
+  s_cpu_idle_skip_percent =
+    (ticks_run > 0) ? static_cast<float>(static_cast<double>(idle_loop_skipped_ticks - s_last_idle_loop_skipped_ticks) /
+                                         static_cast<double>(ticks_run) * 100.0) :
+                      0.0f;
+  s_last_idle_loop_skipped_ticks = idle_loop_skipped_ticks;
   s_last_global_tick_counter = global_tick_counter;
 
   const Threading::Thread* sw_thread = g_gpu->GetSWThread();
@@ -2663,6 +2683,12 @@ void System::UpdatePerformanceCounters()
   if (g_settings.display_show_gpu_stats)
     g_gpu->UpdateStatistics(frames_run);
 
+  // Checked here rather than on settings changes, so the OSD toggle hotkey is picked up too.
+  if (AudioPerfCounters::IsEnabled() != g_settings.display_show_audio_stats)
+    AudioPerfCounters::SetEnabled(g_settings.display_show_audio_stats);
+  else if (AudioPerfCounters::IsEnabled())
+    AudioPerfCounters::UpdateInterval(time);
+
   if (s_pre_frame_sleep)
     UpdatePreFrameSleepTime();
 
@@ -2677,6 +2703,7 @@ void System::ResetPerformanceCounters()
   s_last_frame_number = s_frame_number;
   s_last_internal_frame_number = s_internal_frame_number;
   s_last_global_tick_counter = GetGlobalTickCounter();
+  s_last_idle_loop_skipped_ticks = CPU::CodeCache::GetIdleLoopSkippedTicks();
   s_last_cpu_time = s_cpu_thread_handle ? s_cpu_thread_handle.GetCPUTime() : 0;
   if (const Threading::Thread* sw_thread = g_gpu->GetSWThread(); sw_thread)
     s_last_sw_time = sw_thread->GetCPUTime();
@@ -3764,11 +3791,13 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
       CPU::ClearICache();
     }
 
-    if (CPU::CodeCache::IsUsingAnyRecompiler() &&
-        (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
-         g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
-         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
-         g_settings.bios_tty_logging != old_settings.bios_tty_logging))
+    if ((CPU::CodeCache::IsUsingAnyRecompiler() &&
+         (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
+          g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
+          g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
+          g_settings.bios_tty_logging != old_settings.bios_tty_logging)) ||
+        (g_settings.cpu_execution_mode != CPUExecutionMode::Interpreter &&
+         g_settings.cpu_idle_loop_skipping != old_settings.cpu_idle_loop_skipping))
     {
       Host::AddIconOSDMessage("CPUFlushAllBlocks", ICON_FA_MICROCHIP,
                               TRANSLATE_STR("OSDMessage", "Recompiler options changed, flushing all blocks."),
@@ -3888,6 +3917,8 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
 
     DMA::SetMaxSliceTicks(g_settings.dma_max_slice_ticks);
     DMA::SetHaltTicks(g_settings.dma_halt_ticks);
+    DMA::SetLinkedListFastPath(g_settings.dma_linked_list_fast_path);
+    MDEC::SetUseThread(g_settings.mdec_use_thread);
 
     if (g_settings.audio_backend != old_settings.audio_backend ||
         g_settings.increase_timer_resolution != old_settings.increase_timer_resolution ||
@@ -4488,6 +4519,64 @@ void System::StopDumpingAudio()
   Host::AddOSDMessage(TRANSLATE_STR("OSDMessage", "Stopped dumping audio."), 5.0f);
 }
 
+bool System::IsRecordingGPUDump()
+{
+  return (g_gpu && g_gpu->IsRecordingGPUDump());
+}
+
+bool System::StartRecordingGPUDump(const char* filename, u32 num_frames)
+{
+  if (System::IsShutdown())
+    return false;
+
+  std::string auto_filename;
+  if (!filename)
+  {
+    const auto& serial = System::GetGameSerial();
+    if (serial.empty())
+    {
+      auto_filename = Path::Combine(EmuFolders::Dumps, fmt::format("gpu" FS_OSPATH_SEPARATOR_STR "{}.{}",
+                                                                   GetTimestampStringForFileName(),
+                                                                   GPUDump::FILE_EXTENSION));
+    }
+    else
+    {
+      auto_filename = Path::Combine(EmuFolders::Dumps, fmt::format("gpu" FS_OSPATH_SEPARATOR_STR "{}_{}.{}", serial,
+                                                                   GetTimestampStringForFileName(),
+                                                                   GPUDump::FILE_EXTENSION));
+    }
+
+    const std::string dump_directory = Path::Combine(EmuFolders::Dumps, "gpu");
+    if (!FileSystem::DirectoryExists(dump_directory.c_str()))
+      FileSystem::CreateDirectory(dump_directory.c_str(), false);
+
+    filename = auto_filename.c_str();
+  }
+
+  Error error;
+  if (g_gpu->StartRecordingGPUDump(filename, num_frames, &error))
+  {
+    Host::AddFormattedOSDMessage(5.0f, TRANSLATE("OSDMessage", "Started recording GPU dump to '%s'."), filename);
+    return true;
+  }
+  else
+  {
+    Log_ErrorFmt("Failed to start GPU dump: {}", error.GetDescription());
+    Host::AddFormattedOSDMessage(10.0f, TRANSLATE("OSDMessage", "Failed to start recording GPU dump to '%s'."),
+                                 filename);
+    return false;
+  }
+}
+
+void System::StopRecordingGPUDump()
+{
+  if (!IsRecordingGPUDump())
+    return;
+
+  g_gpu->StopRecordingGPUDump();
+  Host::AddOSDMessage(TRANSLATE_STR("OSDMessage", "Stopped recording GPU dump."), 5.0f);
+}
+
 bool System::SaveScreenshot(const char* filename, DisplayScreenshotMode mode, DisplayScreenshotFormat format,
                             u8 quality, bool compress_on_thread)
 {
@@ -229,6 +229,7 @@ float GetMaximumFrameTime();
 float GetThrottleFrequency();
 float GetCPUThreadUsage();
 float GetCPUThreadAverageTime();
+float GetCPUIdleSkipPercent();
 float GetSWThreadUsage();
 float GetSWThreadAverageTime();
 float GetGPUUsage();
@@ -422,6 +423,16 @@ bool StartDumpingAudio(const char* filename = nullptr);
 /// Stops dumping audio to file if it has been started.
 void StopDumpingAudio();
 
+/// Returns true if currently recording a GPU dump.
+bool IsRecordingGPUDump();
+
+/// Starts recording GPU commands to a file. If no file name is provided, one will be generated automatically.
+/// A frame count of zero records until stopped.
+bool StartRecordingGPUDump(const char* filename = nullptr, u32 num_frames = 0);
+
+/// Stops recording GPU commands if it has been started.
+void StopRecordingGPUDump();
+
 /// Saves a screenshot to the specified file. If no file name is provided, one will be generated automatically.
 bool SaveScreenshot(const char* filename = nullptr, DisplayScreenshotMode mode = g_settings.display_screenshot_mode,
                     DisplayScreenshotFormat format = g_settings.display_screenshot_format,
@@ -238,11 +238,17 @@ void AdvancedSettingsWidget::addTweakOptions()
                          Settings::DEFAULT_GPU_FIFO_SIZE);
   addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("GPU Max Run-Ahead"), "Hacks", "GPUMaxRunAhead", 0, 1000,
                          Settings::DEFAULT_GPU_MAX_RUN_AHEAD);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable DMA Linked List Fast Path"), "Hacks",
+                        "DMALinkedListFastPath", true);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Threaded MDEC Decoding"), "Hacks",
+                        "MDECUseThread", true);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Memory Exceptions"), "CPU",
                         "RecompilerMemoryExceptions", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Linking"), "CPU",
                         "RecompilerBlockLinking", true);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Idle Loop Skipping"), "CPU", "IdleLoopSkipping",
+                        true);
   addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Fast Memory Access"), "CPU",
                        "FastmemMode", Settings::ParseCPUFastmemMode, Settings::GetCPUFastmemModeName,
                        Settings::GetCPUFastmemModeDisplayName, static_cast<u32>(CPUFastmemMode::Count),
@@ -279,8 +285,11 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
                            static_cast<int>(Settings::DEFAULT_GPU_FIFO_SIZE)); // GPU FIFO size
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
                            static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD)); // GPU max run-ahead
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // DMA linked list fast path
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // Threaded MDEC decoding
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler memory exceptions
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // Recompiler block linking
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // Idle loop skipping
     setChoiceTweakOption(m_ui.tweakOptionTable, i++,
                          Settings::DEFAULT_CPU_FASTMEM_MODE); // Recompiler fastmem mode
     setChoiceTweakOption(m_ui.tweakOptionTable, i++,
@@ -308,8 +317,11 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("Hacks", "DMAHaltTicks");
   sif->DeleteValue("Hacks", "GPUFIFOSize");
   sif->DeleteValue("Hacks", "GPUMaxRunAhead");
+  sif->DeleteValue("Hacks", "DMALinkedListFastPath");
+  sif->DeleteValue("Hacks", "MDECUseThread");
   sif->DeleteValue("CPU", "RecompilerMemoryExceptions");
   sif->DeleteValue("CPU", "RecompilerBlockLinking");
+  sif->DeleteValue("CPU", "IdleLoopSkipping");
   sif->DeleteValue("CPU", "FastmemMode");
   sif->DeleteValue("CDROM", "MechaconVersion");
   sif->DeleteValue("CDROM", "RegionCheck");
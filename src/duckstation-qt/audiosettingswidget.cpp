@@ -373,8 +373,6 @@ void AudioSettingsWidget::onStretchSettingsClicked()
   SettingWidgetBinder::BindWidgetToIntSetting(sif, dlgui.overlap, "Audio", "StretchOverlapMS",
                                               AudioStreamParameters::DEFAULT_STRETCH_OVERLAP, 0);
   QtUtils::BindLabelToSlider(dlgui.overlap, dlgui.overlapLabel);
-  SettingWidgetBinder::BindWidgetToBoolSetting(sif, dlgui.useQuickSeek, "Audio", "StretchUseQuickSeek",
-                                               AudioStreamParameters::DEFAULT_STRETCH_USE_QUICKSEEK);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, dlgui.useAAFilter, "Audio", "StretchUseAAFilter",
                                                AudioStreamParameters::DEFAULT_STRETCH_USE_AA_FILTER);
 
@@ -392,10 +390,6 @@ void AudioSettingsWidget::onStretchSettingsClicked()
                                  m_dialog->isPerGameSettings() ?
                                    std::nullopt :
                                    std::optional<int>(AudioStreamParameters::DEFAULT_STRETCH_OVERLAP));
-    m_dialog->setBoolSettingValue("Audio", "StretchUseQuickSeek",
-                                  m_dialog->isPerGameSettings() ?
-                                    std::nullopt :
-                                    std::optional<bool>(AudioStreamParameters::DEFAULT_STRETCH_USE_QUICKSEEK));
     m_dialog->setBoolSettingValue("Audio", "StretchUseAAFilter",
                                   m_dialog->isPerGameSettings() ?
                                     std::nullopt :
@@ -174,6 +174,7 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showGPU, "Display", "ShowGPU", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showInput, "Display", "ShowInputs", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showGPUStatistics, "Display", "ShowGPUStatistics", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showAudioStatistics, "Display", "ShowAudioStatistics", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showLatencyStatistics, "Display", "ShowLatencyStatistics",
                                                false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showStatusIndicators, "Display", "ShowStatusIndicators", true);
@@ -428,6 +429,9 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
                              tr("Shows the host's GPU usage in the top-right corner of the display."));
   dialog->registerWidgetHelp(m_ui.showGPUStatistics, tr("Show GPU Statistics"), tr("Unchecked"),
                              tr("Shows information about the emulated GPU in the top-right corner of the display."));
+  dialog->registerWidgetHelp(m_ui.showAudioStatistics, tr("Show Audio Statistics"), tr("Unchecked"),
+                             tr("Shows the time spent in each part of the audio pipeline and how full its buffers are "
+                                "in the top-right corner of the display."));
   dialog->registerWidgetHelp(
     m_ui.showLatencyStatistics, tr("Show Latency Statistics"), tr("Unchecked"),
     tr("Shows information about input and audio latency in the top-right corner of the display."));
@@ -2,14 +2,30 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "core/achievements.h"
+#include "core/bus.h"
+#include "core/cdrom.h"
+#include "core/cpu_code_cache.h"
+#include "core/cpu_core.h"
+#include "core/cpu_recompiler_thunks.h"
 #include "core/fullscreen_ui.h"
 #include "core/game_list.h"
 #include "core/gpu.h"
+#include "core/gpu_dump.h"
+#include "core/gpu_hw.h"
+#include "core/gte.h"
 #include "core/host.h"
+#include "core/settings.h"
+#include "core/mdec.h"
+#include "core/spu.h"
 #include "core/system.h"
 
 #include "scmversion/scmversion.h"
 
+#include "util/audio_perf_counters.h"
+#include "util/audio_stream.h"
+#include "util/audio_stretcher.h"
+#include "util/cd_image.h"
+#include "util/cd_xa.h"
 #include "util/gpu_device.h"
 #include "util/imgui_manager.h"
 #include "util/input_manager.h"
@@ -23,9 +39,19 @@
 #include "common/memory_settings_interface.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/timer.h"
 
+#include "SoundTouch.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <csignal>
 #include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
 
 Log_SetChannel(RegTestHost);
 
@@ -38,6 +64,21 @@ static void InitializeEarlyConsole();
 static void HookSignals();
 static bool SetFolders();
 static std::string GetFrameDumpFilename(u32 frame);
+static bool ReplayGPUDump(const char* path);
+static bool WriteMDECRecording(const char* path);
+static bool ReplayMDECRecording(const char* path);
+static bool WriteAudioStats(const char* path);
+static void RunAudioBenchmark(u32 seconds);
+static void RunAudioBenchmarkPass(AudioStretchMode stretch_mode, bool realtime, u32 volume, u32 seconds);
+static bool RunStretchBenchmark(const char* path);
+static void RunVertexBenchmark(u32 iterations);
+static void RandomizeGTERegisters(std::mt19937& rng);
+static bool RunGTETest(u32 iterations);
+static bool RunGTERecompilerTest(u32 iterations);
+static bool RunSPUTest(u32 iterations);
+static bool RunXATest(u32 iterations);
+static void RunMemoryBenchmark(u32 iterations);
+static bool RunCPUBenchmark(const SystemBootParameters& parameters);
 } // namespace RegTestHost
 
 static std::unique_ptr<MemorySettingsInterface> s_base_settings_interface;
@@ -46,6 +87,21 @@ static u32 s_frames_to_run = 60 * 60;
 static u32 s_frame_dump_interval = 0;
 static std::string s_dump_base_directory;
 static std::string s_dump_game_directory;
+static std::string s_gpu_dump_record_path;
+static std::string s_gpu_dump_replay_path;
+static std::string s_mdec_record_path;
+static std::string s_mdec_replay_path;
+static std::vector<u32> s_mdec_recording;
+static std::string s_audio_stats_path;
+static u32 s_audio_benchmark_seconds = 0;
+static std::string s_stretch_benchmark_path;
+static u32 s_vertex_benchmark_iterations = 0;
+static u32 s_gte_test_iterations = 0;
+static u32 s_gte_recompiler_test_iterations = 0;
+static u32 s_spu_test_iterations = 0;
+static u32 s_xa_test_iterations = 0;
+static u32 s_memory_benchmark_iterations = 0;
+static bool s_cpu_benchmark = false;
 
 bool RegTestHost::SetFolders()
 {
@@ -480,6 +536,23 @@ void RegTestHost::PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -frames: Sets the number of frames to execute.\n");
   std::fprintf(stderr, "  -log <level>: Sets the log level. Defaults to verbose.\n");
   std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Default to software.\n");
+  std::fprintf(stderr, "  -recordgpudump <file>: Records a GPU dump of the frames executed to the specified file.\n");
+  std::fprintf(stderr, "  -replaygpudump <file>: Replays a GPU dump for the number of frames, and reports timings.\n");
+  std::fprintf(stderr, "  -recordmdec <file>: Records the MDEC data of the frames executed to the specified file.\n");
+  std::fprintf(stderr, "  -replaymdec <file>: Decodes a MDEC recording as fast as possible, and reports timings.\n");
+  std::fprintf(stderr, "  -audiostats <file>: Writes the audio performance counters as JSON to the specified file.\n");
+  std::fprintf(stderr, "  -audiobench <seconds>: Benchmarks the audio stream for each stretch mode, and exits.\n");
+  std::fprintf(stderr, "  -stretchbench <file>: Compares time stretchers on a 16-bit stereo WAV file, and exits.\n");
+  std::fprintf(stderr, "  -vertexbench <iterations>: Times hardware renderer polygon vertex setup, and exits.\n");
+  std::fprintf(stderr, "  -cpubench: Runs the frames once with each CPU execution mode, and reports the timings.\n"
+                       "    The recompilers are also run with PGXP CPU mode, when using a hardware renderer.\n");
+  std::fprintf(stderr, "  -membench <iterations>: Times interpreter RAM accesses with each RAM size, and exits.\n");
+  std::fprintf(stderr, "  -gtetest <iterations>: Checks the vectorized GTE commands against the scalar versions.\n");
+  std::fprintf(stderr, "  -gterectest <iterations>: Checks the GTE commands generated by the recompiler against the\n"
+                       "    interpreter.\n");
+  std::fprintf(stderr, "  -sputest <iterations>: Checks the vectorized SPU voice mixing against the scalar version.\n");
+  std::fprintf(stderr, "  -xatest <iterations>: Checks the vectorized XA-ADPCM decoding and resampling against the\n"
+                       "    scalar versions.\n");
   std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
                        "    parameters make up the filename. Use when the filename contains\n"
                        "    spaces or starts with a dash.\n");
@@ -572,6 +645,119 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
         s_base_settings_interface->SetStringValue("GPU", "Renderer", Settings::GetRendererName(renderer.value()));
         continue;
       }
+      else if (CHECK_ARG_PARAM("-recordgpudump"))
+      {
+        s_gpu_dump_record_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-replaygpudump"))
+      {
+        s_gpu_dump_replay_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-recordmdec"))
+      {
+        s_mdec_record_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-replaymdec"))
+      {
+        s_mdec_replay_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-audiostats"))
+      {
+        s_audio_stats_path = argv[++i];
+        s_base_settings_interface->SetBoolValue("Display", "ShowAudioStatistics", true);
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-audiobench"))
+      {
+        s_audio_benchmark_seconds = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_audio_benchmark_seconds == 0)
+        {
+          Log_ErrorPrint("Invalid audio benchmark duration.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-stretchbench"))
+      {
+        s_stretch_benchmark_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-vertexbench"))
+      {
+        s_vertex_benchmark_iterations = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_vertex_benchmark_iterations == 0)
+        {
+          Log_ErrorPrint("Invalid vertex benchmark iteration count.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG("-cpubench"))
+      {
+        s_cpu_benchmark = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-membench"))
+      {
+        s_memory_benchmark_iterations = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_memory_benchmark_iterations == 0)
+        {
+          Log_ErrorPrint("Invalid memory benchmark iteration count.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-gtetest"))
+      {
+        s_gte_test_iterations = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_gte_test_iterations == 0)
+        {
+          Log_ErrorPrint("Invalid GTE test iteration count.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-gterectest"))
+      {
+        s_gte_recompiler_test_iterations = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_gte_recompiler_test_iterations == 0)
+        {
+          Log_ErrorPrint("Invalid GTE recompiler test iteration count.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-sputest"))
+      {
+        s_spu_test_iterations = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_spu_test_iterations == 0)
+        {
+          Log_ErrorPrint("Invalid SPU test iteration count.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-xatest"))
+      {
+        s_xa_test_iterations = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_xa_test_iterations == 0)
+        {
+          Log_ErrorPrint("Invalid XA test iteration count.");
+          return false;
+        }
+
+        continue;
+      }
       else if (CHECK_ARG_PARAM("-upscale"))
       {
         const u32 upscale = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
@@ -640,6 +826,918 @@ std::string RegTestHost::GetFrameDumpFilename(u32 frame)
   return Path::Combine(s_dump_game_directory, fmt::format("frame_{:05d}.png", frame));
 }
 
+bool RegTestHost::ReplayGPUDump(const char* path)
+{
+  Error error;
+  std::unique_ptr<GPUDump::Player> player = GPUDump::Player::Open(path, &error);
+  if (!player || !player->Reset(g_gpu.get(), &error))
+  {
+    Log_ErrorFmt("Failed to load GPU dump '{}': {}", path, error.GetDescription());
+    return false;
+  }
+
+  if (player->GetFrameCount() == 0)
+  {
+    Log_ErrorFmt("GPU dump '{}' contains no frames.", path);
+    return false;
+  }
+
+  Log_InfoFmt("Replaying {} frames from GPU dump '{}' ({} frames recorded)...", s_frames_to_run, path,
+              player->GetFrameCount());
+
+  // The dump is looped if more frames are requested than it contains.
+  const u32 start_primitives = g_gpu->GetPrimitiveCounter();
+  double min_frame_time = std::numeric_limits<double>::max();
+  double max_frame_time = 0.0;
+  Common::Timer total_timer;
+  Common::Timer frame_timer;
+  for (u32 frame = 0; frame < s_frames_to_run;)
+  {
+    const GPUDump::Player::FrameResult result = player->ProcessFrame(g_gpu.get(), &error);
+    if (result == GPUDump::Player::FrameResult::Error)
+    {
+      Log_ErrorFmt("Failed to replay GPU dump: {}", error.GetDescription());
+      return false;
+    }
+    else if (result == GPUDump::Player::FrameResult::EndOfDump)
+    {
+      if (!player->Reset(g_gpu.get(), &error))
+      {
+        Log_ErrorFmt("Failed to reset GPU dump: {}", error.GetDescription());
+        return false;
+      }
+
+      continue;
+    }
+
+    System::PresentDisplay(false, false);
+
+    const double frame_time = frame_timer.GetTimeMillisecondsAndReset();
+    min_frame_time = std::min(min_frame_time, frame_time);
+    max_frame_time = std::max(max_frame_time, frame_time);
+    frame++;
+  }
+
+  const double total_time = total_timer.GetTimeSeconds();
+  const u32 num_primitives = g_gpu->GetPrimitiveCounter() - start_primitives;
+  Log_InfoFmt("Replayed {} frames in {:.2f} seconds ({:.2f} FPS).", s_frames_to_run, total_time,
+              static_cast<double>(s_frames_to_run) / total_time);
+  Log_InfoFmt("Frame time: avg {:.3f}ms, min {:.3f}ms, max {:.3f}ms.",
+              (total_time * 1000.0) / static_cast<double>(s_frames_to_run), min_frame_time, max_frame_time);
+  Log_InfoFmt("Primitives: {} ({:.0f}/sec).", num_primitives, static_cast<double>(num_primitives) / total_time);
+  return true;
+}
+
+bool RegTestHost::WriteMDECRecording(const char* path)
+{
+  MDEC::SetDataRecording(nullptr);
+  if (!FileSystem::WriteBinaryFile(path, s_mdec_recording.data(), s_mdec_recording.size() * sizeof(u32)))
+  {
+    Log_ErrorFmt("Failed to write MDEC recording to '{}'.", path);
+    return false;
+  }
+
+  Log_InfoFmt("Wrote {} words of MDEC data to '{}'.", s_mdec_recording.size(), path);
+  return true;
+}
+
+bool RegTestHost::WriteAudioStats(const char* path)
+{
+  const std::string report = AudioPerfCounters::GetJSONReport();
+  if (!FileSystem::WriteStringToFile(path, report))
+  {
+    Log_ErrorFmt("Failed to write audio statistics to '{}'.", path);
+    return false;
+  }
+
+  Log_InfoFmt("Wrote audio statistics to '{}'.", path);
+  return true;
+}
+
+bool RegTestHost::ReplayMDECRecording(const char* path)
+{
+  static constexpr u32 NUM_PASSES = 10;
+
+  Error error;
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path, &error);
+  if (!data.has_value() || data->size() < sizeof(u32))
+  {
+    Log_ErrorFmt("Failed to load MDEC recording '{}': {}", path, error.GetDescription());
+    return false;
+  }
+
+  std::vector<u32> words(data->size() / sizeof(u32));
+  std::memcpy(words.data(), data->data(), words.size() * sizeof(u32));
+  Log_InfoFmt("Decoding {} words of MDEC data from '{}' {} times...", words.size(), path, NUM_PASSES);
+
+  u32 num_blocks = 0;
+  double min_pass_time = std::numeric_limits<double>::max();
+  Common::Timer total_timer;
+  for (u32 pass = 0; pass < NUM_PASSES; pass++)
+  {
+    Common::Timer pass_timer;
+    num_blocks += MDEC::DecodeDataStream(words.data(), static_cast<u32>(words.size()));
+    min_pass_time = std::min(min_pass_time, pass_timer.GetTimeMilliseconds());
+  }
+
+  const double total_time = total_timer.GetTimeSeconds();
+  Log_InfoFmt("Decoded {} blocks in {:.2f} seconds ({:.0f} blocks/sec).", num_blocks, total_time,
+              static_cast<double>(num_blocks) / total_time);
+  Log_InfoFmt("Pass time: avg {:.3f}ms, min {:.3f}ms.", (total_time * 1000.0) / static_cast<double>(NUM_PASSES),
+              min_pass_time);
+  return true;
+}
+
+namespace {
+/// Null stream with the output side driven by the benchmark, in place of a device callback.
+class BenchmarkAudioStream final : public AudioStream
+{
+public:
+  BenchmarkAudioStream(u32 sample_rate, const AudioStreamParameters& parameters) : AudioStream(sample_rate, parameters)
+  {
+    BaseInitialize(&StereoSampleReaderImpl);
+  }
+
+  /// Returns true if this read ran out of buffered frames.
+  bool Read(SampleType* samples, u32 num_frames)
+  {
+    const bool was_filling = m_filling;
+    ReadFrames(samples, num_frames);
+    ApplyVolume(samples, num_frames * m_output_channels);
+    return (!was_filling && m_filling);
+  }
+};
+} // namespace
+
+void RegTestHost::RunAudioBenchmark(u32 seconds)
+{
+  static constexpr std::array<AudioStretchMode, 3> stretch_modes = {
+    AudioStretchMode::Off, AudioStretchMode::Resample, AudioStretchMode::TimeStretch};
+
+  // Unpaced passes measure the cost of moving frames through the stream, realtime passes how it copes with jitter.
+  // Volume scaling is skipped at 100%, so the unpaced passes are also run at a lower volume to include its cost.
+  for (const AudioStretchMode stretch_mode : stretch_modes)
+  {
+    RunAudioBenchmarkPass(stretch_mode, false, 100, seconds);
+    RunAudioBenchmarkPass(stretch_mode, false, 50, seconds);
+    RunAudioBenchmarkPass(stretch_mode, true, 100, seconds);
+  }
+}
+
+void RegTestHost::RunAudioBenchmarkPass(AudioStretchMode stretch_mode, bool realtime, u32 volume, u32 seconds)
+{
+  static constexpr u32 SAMPLE_RATE = 44100;
+  static constexpr u32 FRAMES_PER_VSYNC = SAMPLE_RATE / 60;
+  static constexpr u32 CALLBACK_FRAMES = 512;
+
+  AudioStreamParameters params;
+  params.expansion_mode = AudioExpansionMode::Disabled;
+  params.stretch_mode = stretch_mode;
+
+  BenchmarkAudioStream stream(SAMPLE_RATE, params);
+  stream.SetOutputVolume(volume);
+
+  // Emulator side, writes a vsync worth of frames at a time.
+  std::atomic_bool done{false};
+  std::atomic<u64> frames_written{0};
+  std::thread producer([&stream, &done, &frames_written, realtime]() {
+    const Common::Timer::Value vsync_period = Common::Timer::ConvertSecondsToValue(1.0 / 60.0);
+    Common::Timer::Value next_vsync = Common::Timer::GetCurrentValue();
+    u32 phase = 0;
+    while (!done.load(std::memory_order_relaxed))
+    {
+      for (u32 remaining = FRAMES_PER_VSYNC; remaining > 0;)
+      {
+        AudioStream::SampleType* buffer;
+        u32 num_frames;
+        stream.BeginWrite(&buffer, &num_frames);
+        num_frames = std::min(num_frames, remaining);
+        for (u32 i = 0; i < num_frames; i++, phase++)
+        {
+          const s16 sample = static_cast<s16>(static_cast<u16>(phase * 128));
+          buffer[i * 2 + 0] = sample;
+          buffer[i * 2 + 1] = sample;
+        }
+
+        stream.EndWrite(num_frames);
+        remaining -= num_frames;
+      }
+
+      frames_written.fetch_add(FRAMES_PER_VSYNC, std::memory_order_relaxed);
+      if (realtime)
+      {
+        next_vsync += vsync_period;
+        Common::Timer::SleepUntil(next_vsync, false);
+      }
+    }
+  });
+
+  // Output side, pulls fixed size callbacks like a device would.
+  const Common::Timer::Value callback_period =
+    Common::Timer::ConvertSecondsToValue(static_cast<double>(CALLBACK_FRAMES) / static_cast<double>(SAMPLE_RATE));
+  std::array<AudioStream::SampleType, CALLBACK_FRAMES * AudioStream::NUM_INPUT_CHANNELS> output;
+  u64 frames_read = 0;
+  u32 underruns = 0;
+  Common::Timer::Value max_callback_time = 0;
+  Common::Timer::Value next_callback = Common::Timer::GetCurrentValue();
+  Common::Timer total_timer;
+  while (total_timer.GetTimeSeconds() < static_cast<double>(seconds))
+  {
+    const Common::Timer::Value callback_start = Common::Timer::GetCurrentValue();
+    underruns += static_cast<u32>(stream.Read(output.data(), CALLBACK_FRAMES));
+    max_callback_time = std::max(max_callback_time, Common::Timer::GetCurrentValue() - callback_start);
+    frames_read += CALLBACK_FRAMES;
+
+    if (realtime)
+    {
+      next_callback += callback_period;
+      Common::Timer::SleepUntil(next_callback, false);
+    }
+  }
+
+  done.store(true, std::memory_order_relaxed);
+  producer.join();
+
+  const double total_time = total_timer.GetTimeSeconds();
+  Log_InfoFmt("{} ({}, {}% volume): read {:.0f} frames/sec, wrote {:.0f} frames/sec, {} underruns, max callback "
+              "{:.1f}us.",
+              AudioStream::GetStretchModeName(stretch_mode), realtime ? "realtime" : "unpaced", volume,
+              static_cast<double>(frames_read) / total_time,
+              static_cast<double>(frames_written.load(std::memory_order_relaxed)) / total_time, underruns,
+              Common::Timer::ConvertValueToNanoseconds(max_callback_time) / 1000.0);
+}
+
+bool RegTestHost::RunStretchBenchmark(const char* path)
+{
+  static constexpr u32 SAMPLE_RATE = 44100;
+  static constexpr u32 CHANNELS = 2;
+  static constexpr u32 BLOCK_SIZE = AudioStream::CHUNK_SIZE;
+  static constexpr std::array<float, 3> tempos = {0.95f, 1.0f, 1.05f};
+
+  // Audio dumps are plain PCM, so only the fmt and data chunks are needed.
+  Error error;
+  const std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path, &error);
+  if (!data.has_value())
+  {
+    Log_ErrorFmt("Failed to read '{}': {}", path, error.GetDescription());
+    return false;
+  }
+
+  const auto read_u32 = [&data](size_t offset) {
+    u32 value;
+    std::memcpy(&value, data->data() + offset, sizeof(value));
+    return value;
+  };
+  const auto read_u16 = [&data](size_t offset) {
+    u16 value;
+    std::memcpy(&value, data->data() + offset, sizeof(value));
+    return value;
+  };
+
+  std::vector<float> input;
+  bool format_ok = false;
+  for (size_t pos = 12; data->size() >= 12 && (pos + 8) <= data->size();)
+  {
+    const u32 chunk_id = read_u32(pos);
+    const u32 chunk_size = std::min<u32>(read_u32(pos + 4), static_cast<u32>(data->size() - pos - 8));
+    if (chunk_id == 0x20746D66 && chunk_size >= 16) // fmt
+    {
+      format_ok = (read_u16(pos + 8) == 1 && read_u16(pos + 10) == CHANNELS && read_u32(pos + 12) == SAMPLE_RATE &&
+                   read_u16(pos + 22) == 16);
+    }
+    else if (chunk_id == 0x61746164) // data
+    {
+      input.resize(chunk_size / sizeof(s16));
+      for (u32 i = 0; i < static_cast<u32>(input.size()); i++)
+        input[i] = static_cast<float>(static_cast<s16>(read_u16(pos + 8 + i * sizeof(s16)))) / 32767.0f;
+    }
+
+    pos += 8 + chunk_size + (chunk_size & 1);
+  }
+
+  const u32 num_frames = static_cast<u32>(input.size() / CHANNELS) & ~(BLOCK_SIZE - 1);
+  if (!format_ok || num_frames == 0)
+  {
+    Log_ErrorFmt("'{}' is not a 16-bit stereo {}Hz WAV file.", path, SAMPLE_RATE);
+    return false;
+  }
+
+  Log_InfoFmt("Stretching {:.1f} seconds of audio from '{}'.", static_cast<double>(num_frames) / SAMPLE_RATE, path);
+
+  // Latency is how far the output lags the input, i.e. the frames held by the stretcher, measured after each block.
+  std::array<float, BLOCK_SIZE * CHANNELS> output;
+  const auto measure = [&input, &output, num_frames](const char* name, float tempo, const auto& put,
+                                                     const auto& receive) {
+    u64 total_output = 0;
+    double total_latency = 0.0;
+    u32 first_output_frame = 0;
+    Common::Timer timer;
+    for (u32 frame = 0; frame < num_frames; frame += BLOCK_SIZE)
+    {
+      put(&input[frame * CHANNELS], BLOCK_SIZE);
+
+      u32 received;
+      while ((received = receive(output.data(), BLOCK_SIZE)) != 0)
+        total_output += received;
+
+      if (first_output_frame == 0 && total_output > 0)
+        first_output_frame = frame + BLOCK_SIZE;
+
+      total_latency += static_cast<double>(frame + BLOCK_SIZE) - static_cast<double>(total_output) * tempo;
+    }
+
+    const double time = timer.GetTimeSeconds();
+    const double average_latency = total_latency / static_cast<double>(num_frames / BLOCK_SIZE);
+    Log_InfoFmt("{} @ {:.2f}: {:.0f}x realtime, first output after {:.1f}ms, average latency {:.1f}ms.", name, tempo,
+                (static_cast<double>(num_frames) / SAMPLE_RATE) / time, (first_output_frame * 1000.0) / SAMPLE_RATE,
+                (average_latency * 1000.0) / SAMPLE_RATE);
+  };
+
+  const AudioStreamParameters params;
+  for (const float tempo : tempos)
+  {
+    AudioStretcher stretcher(SAMPLE_RATE, CHANNELS, params.stretch_sequence_length_ms, params.stretch_seekwindow_ms,
+                             params.stretch_overlap_ms, BLOCK_SIZE);
+    stretcher.SetTempo(tempo);
+    measure(
+      "AudioStretcher", tempo, [&stretcher](const float* frames, u32 count) { stretcher.PutFrames(frames, count); },
+      [&stretcher](float* frames, u32 count) { return stretcher.ReceiveFrames(frames, count); });
+
+    // SoundTouch with the settings it used to run with.
+    soundtouch::SoundTouch st;
+    st.setSampleRate(SAMPLE_RATE);
+    st.setChannels(CHANNELS);
+    st.setSetting(SETTING_SEQUENCE_MS, 30);
+    st.setSetting(SETTING_SEEKWINDOW_MS, 20);
+    st.setSetting(SETTING_OVERLAP_MS, 10);
+    st.setTempo(tempo);
+    measure(
+      "SoundTouch", tempo, [&st](const float* frames, u32 count) { st.putSamples(frames, count); },
+      [&st](float* frames, u32 count) { return static_cast<u32>(st.receiveSamples(frames, count)); });
+  }
+
+  return true;
+}
+
+void RegTestHost::RunVertexBenchmark(u32 iterations)
+{
+  // A mix of random triangles and quads. The command words are generated up front, so only the conversion to batch
+  // vertices is timed. Doesn't touch the GPU device, so it runs without one.
+  static constexpr u32 NUM_POLYGONS = 4096;
+  struct Polygon
+  {
+    std::array<u32, 4> positions;
+    std::array<u32, 4> colors;
+    std::array<u32, 4> texcoords;
+    u32 num_vertices;
+  };
+
+  std::mt19937 rng;
+  std::vector<Polygon> polygons(NUM_POLYGONS);
+  for (Polygon& poly : polygons)
+  {
+    poly.num_vertices = (rng() & 1u) ? 4 : 3;
+    for (u32 i = 0; i < 4; i++)
+    {
+      const u32 index = std::min(i, poly.num_vertices - 1);
+      poly.positions[i] = (i == index) ? (static_cast<u32>(rng()) & 0x07FF07FFu) : poly.positions[index];
+      poly.colors[i] = (i == index) ? (static_cast<u32>(rng()) & 0x00FFFFFFu) : poly.colors[index];
+      poly.texcoords[i] = (i == index) ? (static_cast<u32>(rng()) & 0xFFFFu) : poly.texcoords[index];
+    }
+  }
+
+  std::vector<GPU_HW::BatchVertex> vertices(NUM_POLYGONS * 4);
+  std::array<std::array<s32, 2>, 4> native_positions;
+  u64 num_vertices = 0;
+  u32 checksum = 0;
+  Common::Timer timer;
+  for (u32 iteration = 0; iteration < iterations; iteration++)
+  {
+    GPU_HW::BatchVertex* vertex_ptr = vertices.data();
+    for (const Polygon& poly : polygons)
+    {
+      GPU_HW::UnpackPolygonVertices(vertex_ptr, native_positions, poly.positions, poly.colors, poly.texcoords, 16, 8,
+                                    0.5f, 0x1234u);
+      const auto [min_u, min_v, max_u, max_v] = GPU_HW::ComputePolygonUVLimits(vertex_ptr, poly.num_vertices);
+      checksum += min_u + min_v + max_u + max_v + static_cast<u32>(native_positions[0][0]);
+      num_vertices += poly.num_vertices;
+      vertex_ptr += 4;
+    }
+  }
+
+  const double total_time = timer.GetTimeSeconds();
+  Log_InfoFmt("Set up {} vertices in {:.3f} seconds ({:.2f} million vertices/sec, checksum {:08X}).", num_vertices,
+              total_time, static_cast<double>(num_vertices) / total_time / 1000000.0, checksum);
+}
+
+void RegTestHost::RandomizeGTERegisters(std::mt19937& rng)
+{
+  // Extremes show up often enough to exercise every overflow and saturation path.
+  static constexpr std::array<u32, 10> interesting_values = {
+    {0x00000000u, 0x00000001u, 0x00000FFFu, 0x00007FFFu, 0x00008000u, 0x0000FFFFu, 0x7FFFFFFFu, 0x80000000u,
+     0xFFFF8000u, 0xFFFFFFFFu}};
+
+  // Registers are written through the normal path so they hold values the hardware could.
+  for (u32 i = 0; i < GTE::NUM_REGS; i++)
+  {
+    const u32 r = static_cast<u32>(rng());
+    GTE::WriteRegister(i, ((r & 3u) == 0) ? interesting_values[(r >> 2) % interesting_values.size()] :
+                                            static_cast<u32>(rng()));
+  }
+}
+
+bool RegTestHost::RunGTETest(u32 iterations)
+{
+  if (!GTE::HasVectorizedTripleCommands())
+  {
+    Log_InfoPrint("GTE commands are not vectorized on this platform.");
+    return true;
+  }
+
+  static constexpr u32 MAX_REPORTED_MISMATCHES = 16;
+  static constexpr u32 NUM_COMMANDS = static_cast<u32>(GTE::TripleCommand::Count);
+  static constexpr u32 FLAG_REGISTER = 63;
+
+  static constexpr std::array<const char*, NUM_COMMANDS> command_names = {{"RTPT", "NCT", "NCCT", "NCDT"}};
+
+  u32* const regs = GTE::GetRegisterPtr(0);
+  std::mt19937 rng;
+  u32 mismatches = 0;
+  for (u32 iteration = 0; iteration < iterations; iteration++)
+  {
+    RandomizeGTERegisters(rng);
+
+    std::array<u32, GTE::NUM_REGS> input;
+    std::memcpy(input.data(), regs, sizeof(u32) * GTE::NUM_REGS);
+    for (u32 test = 0; test < NUM_COMMANDS * 4; test++)
+    {
+      const GTE::TripleCommand command = static_cast<GTE::TripleCommand>(test / 4);
+      const u8 shift = (test & 1u) ? 12 : 0;
+      const bool lm = (test & 2u) != 0;
+
+      std::memcpy(regs, input.data(), sizeof(u32) * GTE::NUM_REGS);
+      regs[FLAG_REGISTER] = 0;
+      GTE::ExecuteTripleCommandForTest(command, shift, lm, false);
+
+      std::array<u32, GTE::NUM_REGS> expected;
+      std::memcpy(expected.data(), regs, sizeof(u32) * GTE::NUM_REGS);
+
+      std::memcpy(regs, input.data(), sizeof(u32) * GTE::NUM_REGS);
+      regs[FLAG_REGISTER] = 0;
+      GTE::ExecuteTripleCommandForTest(command, shift, lm, true);
+
+      if (std::memcmp(expected.data(), regs, sizeof(u32) * GTE::NUM_REGS) == 0)
+        continue;
+
+      if (mismatches < MAX_REPORTED_MISMATCHES)
+      {
+        for (u32 i = 0; i < GTE::NUM_REGS; i++)
+        {
+          if (expected[i] != regs[i])
+          {
+            Log_ErrorFmt("{} (sf={}, lm={}) iteration {}: register {} is 0x{:08X}, expected 0x{:08X}",
+                         command_names[test / 4], shift / 12, lm, iteration, i, regs[i], expected[i]);
+          }
+        }
+      }
+
+      mismatches++;
+    }
+  }
+
+  GTE::Reset();
+
+  if (mismatches > 0)
+  {
+    Log_ErrorFmt("{} of {} vectorized GTE commands did not match.", mismatches, iterations * NUM_COMMANDS * 4);
+    return false;
+  }
+
+  Log_InfoFmt("{} vectorized GTE commands matched.", iterations * NUM_COMMANDS * 4);
+  return true;
+}
+
+bool RegTestHost::RunSPUTest(u32 iterations)
+{
+  if (!SPU::HasVectorizedVoiceMixing())
+  {
+    Log_InfoPrint("SPU voice mixing is not vectorized on this platform.");
+    return true;
+  }
+
+  static constexpr u32 MAX_REPORTED_MISMATCHES = 16;
+  static constexpr std::array<s16, 6> interesting_values = {{0, 1, -1, 0x7FFF, -0x8000, 0x4000}};
+
+  std::mt19937 rng;
+  const auto random_value = [&rng]() {
+    const u32 r = static_cast<u32>(rng());
+    return ((r & 3u) == 0) ? interesting_values[(r >> 2) % interesting_values.size()] : static_cast<s16>(rng());
+  };
+
+  u32 mismatches = 0;
+  u64 voices_tested = 0;
+  std::array<SPU::VoiceMixTestState, SPU::MAX_VOICE_MIX_TEST_COUNT> input;
+  std::array<SPU::VoiceMixTestState, SPU::MAX_VOICE_MIX_TEST_COUNT> expected;
+  std::array<SPU::VoiceMixTestState, SPU::MAX_VOICE_MIX_TEST_COUNT> actual;
+  for (u32 iteration = 0; iteration < iterations; iteration++)
+  {
+    // Odd counts leave a partial vector at the end, which has to be handled the same way.
+    const u32 count = 1 + static_cast<u32>(rng() % SPU::MAX_VOICE_MIX_TEST_COUNT);
+    for (u32 i = 0; i < count; i++)
+    {
+      SPU::VoiceMixTestState& voice = input[i];
+      for (s16& sample : voice.samples)
+        sample = random_value();
+
+      // Noise voices use two 0x4000 taps. Otherwise the gaussian taps are kept small enough that the sum of the four
+      // products fits in 32 bits, as it does with the real table.
+      if ((rng() & 7u) == 0)
+      {
+        voice.coefficients = {{0x4000, 0x4000, 0, 0}};
+      }
+      else
+      {
+        for (s16& coefficient : voice.coefficients)
+          coefficient = static_cast<s16>(static_cast<s32>(rng() % 0x2201u) - 0x200);
+      }
+
+      voice.adsr_volume = random_value();
+      voice.left_level = random_value();
+      voice.right_level = random_value();
+      voice.volume = 0;
+      voice.left = 0;
+      voice.right = 0;
+    }
+
+    expected = input;
+    SPU::MixVoicesForTest(expected.data(), count, false);
+    actual = input;
+    SPU::MixVoicesForTest(actual.data(), count, true);
+    voices_tested += count;
+
+    for (u32 i = 0; i < count; i++)
+    {
+      const SPU::VoiceMixTestState& e = expected[i];
+      const SPU::VoiceMixTestState& a = actual[i];
+      if (e.volume == a.volume && e.left == a.left && e.right == a.right)
+        continue;
+
+      if (mismatches < MAX_REPORTED_MISMATCHES)
+      {
+        Log_ErrorFmt("Iteration {} voice {}: volume/left/right are {}/{}/{}, expected {}/{}/{}", iteration, i,
+                     a.volume, a.left, a.right, e.volume, e.left, e.right);
+      }
+
+      mismatches++;
+    }
+  }
+
+  if (mismatches > 0)
+  {
+    Log_ErrorFmt("{} of {} vectorized SPU voices did not match.", mismatches, voices_tested);
+    return false;
+  }
+
+  Log_InfoFmt("{} vectorized SPU voices matched.", voices_tested);
+  return true;
+}
+
+bool RegTestHost::RunXATest(u32 iterations)
+{
+  static constexpr u32 MAX_REPORTED_MISMATCHES = 16;
+  static constexpr u32 CODING_INFO_OFFSET = CDImage::SECTOR_SYNC_SIZE + sizeof(CDImage::SectorHeader) + 3;
+  static constexpr u32 RING_BUFFER_SIZE = 32;
+  static constexpr u32 OUTPUTS_PER_POSITION = 7;
+  static constexpr std::array<const char*, 4> sector_types = {
+    {"4-bit mono", "4-bit stereo", "8-bit mono", "8-bit stereo"}};
+
+  std::mt19937 rng;
+  u32 mismatches = 0;
+
+  // Sectors are random data with each combination of sample size and channel count, so the block headers cover the
+  // reserved shift values too. The filter history is random, but in range of what the filter can produce.
+  const bool test_decoding = CDXA::HasVectorizedADPCMDecoding();
+  if (test_decoding)
+  {
+    std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
+    std::array<s16, CDXA::XA_ADPCM_SAMPLES_PER_SECTOR_4BIT> expected_samples;
+    std::array<s16, CDXA::XA_ADPCM_SAMPLES_PER_SECTOR_4BIT> actual_samples;
+    for (u32 iteration = 0; iteration < iterations; iteration++)
+    {
+      for (u8& value : sector)
+        value = static_cast<u8>(rng());
+
+      std::array<s32, 4> input_last_samples;
+      for (s32& value : input_last_samples)
+        value = static_cast<s32>(rng() % 0x20000u) - 0x10000;
+
+      for (u32 type = 0; type < sector_types.size(); type++)
+      {
+        CDXA::XASubHeader::Codinginfo codinginfo{};
+        codinginfo.mono_stereo = static_cast<u8>(type & 1u);
+        codinginfo.bits_per_sample = static_cast<u8>(type >> 1);
+        sector[CODING_INFO_OFFSET] = codinginfo.bits;
+
+        std::array<s32, 4> expected_last_samples = input_last_samples;
+        std::array<s32, 4> actual_last_samples = input_last_samples;
+        CDXA::DecodeADPCMSectorForTest(sector.data(), expected_samples.data(), expected_last_samples.data(), false);
+        CDXA::DecodeADPCMSectorForTest(sector.data(), actual_samples.data(), actual_last_samples.data(), true);
+
+        const u32 num_samples = codinginfo.GetSamplesPerSector();
+        if (std::memcmp(expected_samples.data(), actual_samples.data(), sizeof(s16) * num_samples) == 0 &&
+            expected_last_samples == actual_last_samples)
+        {
+          continue;
+        }
+
+        if (mismatches < MAX_REPORTED_MISMATCHES)
+        {
+          for (u32 i = 0; i < num_samples; i++)
+          {
+            if (expected_samples[i] != actual_samples[i])
+            {
+              Log_ErrorFmt("{} sector iteration {}: sample {} is {}, expected {}", sector_types[type], iteration, i,
+                           actual_samples[i], expected_samples[i]);
+              break;
+            }
+          }
+        }
+
+        mismatches++;
+      }
+    }
+  }
+  else
+  {
+    Log_InfoPrint("XA-ADPCM decoding is not vectorized on this platform.");
+  }
+
+  // The ring buffers are random, with a chance of being saturated in either direction to catch overflow in the sums.
+  std::array<s16, RING_BUFFER_SIZE> left_ringbuf;
+  std::array<s16, RING_BUFFER_SIZE> right_ringbuf;
+  for (u32 iteration = 0; iteration < iterations; iteration++)
+  {
+    const u32 fill = static_cast<u32>(rng() % 4u);
+    for (u32 i = 0; i < RING_BUFFER_SIZE; i++)
+    {
+      const s16 random_value = static_cast<s16>(rng());
+      left_ringbuf[i] = (fill == 1) ? s16(0x7FFF) : (fill == 2) ? s16(-0x8000) : random_value;
+      right_ringbuf[i] = (fill == 3) ? ((i & 1u) ? s16(0x7FFF) : s16(-0x8000)) : static_cast<s16>(rng());
+    }
+
+    const u8 p = static_cast<u8>(rng() % RING_BUFFER_SIZE);
+    std::array<s16, OUTPUTS_PER_POSITION> expected_left, expected_right;
+    std::array<s16, OUTPUTS_PER_POSITION> actual_left, actual_right;
+    CDROM::ZigZagInterpolateForTest(left_ringbuf.data(), right_ringbuf.data(), p, expected_left.data(),
+                                    expected_right.data(), false);
+    CDROM::ZigZagInterpolateForTest(left_ringbuf.data(), right_ringbuf.data(), p, actual_left.data(),
+                                    actual_right.data(), true);
+
+    for (u32 i = 0; i < OUTPUTS_PER_POSITION; i++)
+    {
+      if (expected_left[i] == actual_left[i] && expected_right[i] == actual_right[i])
+        continue;
+
+      if (mismatches < MAX_REPORTED_MISMATCHES)
+      {
+        Log_ErrorFmt("Zigzag iteration {} (p={}): output {} is {}/{}, expected {}/{}", iteration, p, i,
+                     actual_left[i], actual_right[i], expected_left[i], expected_right[i]);
+      }
+
+      mismatches++;
+    }
+  }
+
+  const u32 num_tests = (test_decoding ? (iterations * static_cast<u32>(sector_types.size())) : 0u) +
+                        (iterations * OUTPUTS_PER_POSITION);
+  if (mismatches > 0)
+  {
+    Log_ErrorFmt("{} of {} XA-ADPCM sectors and resampled frames did not match.", mismatches, num_tests);
+    return false;
+  }
+
+  Log_InfoFmt("{} XA-ADPCM sectors and resampled frames matched.", num_tests);
+  return true;
+}
+
+bool RegTestHost::RunGTERecompilerTest(u32 iterations)
+{
+#ifdef ENABLE_NEWREC
+  static constexpr u32 MAX_REPORTED_MISMATCHES = 16;
+  static constexpr u32 FLAG_REGISTER = 63;
+
+  struct TestCommand
+  {
+    const char* name;
+    u32 bits;
+    CPU::CodeCache::GTETestFunction func;
+  };
+
+  // Every shift/lm combination of the commands with inline versions, and every MVMVA operand selection.
+  std::vector<TestCommand> commands;
+  for (u32 sf_lm = 0; sf_lm < 4; sf_lm++)
+  {
+    const u32 sf_lm_bits = ((sf_lm & 1u) << 19) | ((sf_lm >> 1) << 10);
+    for (const auto& [name, command] : {std::make_pair("RTPS", 0x01u), std::make_pair("NCLIP", 0x06u),
+                                        std::make_pair("NCDS", 0x13u), std::make_pair("AVSZ3", 0x2Du),
+                                        std::make_pair("AVSZ4", 0x2Eu), std::make_pair("RTPT", 0x30u)})
+    {
+      commands.push_back({name, sf_lm_bits | command, nullptr});
+    }
+
+    for (u32 mvmva = 0; mvmva < 64; mvmva++)
+      commands.push_back({"MVMVA", sf_lm_bits | (mvmva << 13) | 0x12u, nullptr});
+  }
+
+  for (TestCommand& command : commands)
+  {
+    command.func = CPU::CodeCache::CompileGTECommandForTest(command.bits);
+    if (!command.func)
+    {
+      Log_InfoPrint("GTE commands can't be compiled on this platform.");
+      return true;
+    }
+  }
+
+  // The projection scale is read when the code runs, so the widescreen hack is checked with the same code.
+  const bool old_widescreen_hack = g_settings.gpu_widescreen_hack;
+  const DisplayAspectRatio old_aspect_ratio = g_settings.display_aspect_ratio;
+
+  u32* const regs = GTE::GetRegisterPtr(0);
+  std::mt19937 rng;
+  u32 mismatches = 0;
+  for (const bool widescreen : {false, true})
+  {
+    g_settings.gpu_widescreen_hack = widescreen;
+    g_settings.display_aspect_ratio = DisplayAspectRatio::R16_9;
+    GTE::UpdateAspectRatio();
+
+    for (u32 iteration = 0; iteration < iterations; iteration++)
+    {
+      RandomizeGTERegisters(rng);
+
+      std::array<u32, GTE::NUM_REGS> input;
+      std::memcpy(input.data(), regs, sizeof(u32) * GTE::NUM_REGS);
+      for (const TestCommand& command : commands)
+      {
+        std::memcpy(regs, input.data(), sizeof(u32) * GTE::NUM_REGS);
+        regs[FLAG_REGISTER] = 0;
+        GTE::ExecuteInstruction(command.bits);
+
+        std::array<u32, GTE::NUM_REGS> expected;
+        std::memcpy(expected.data(), regs, sizeof(u32) * GTE::NUM_REGS);
+
+        std::memcpy(regs, input.data(), sizeof(u32) * GTE::NUM_REGS);
+        regs[FLAG_REGISTER] = 0;
+        command.func();
+
+        if (std::memcmp(expected.data(), regs, sizeof(u32) * GTE::NUM_REGS) == 0)
+          continue;
+
+        if (mismatches < MAX_REPORTED_MISMATCHES)
+        {
+          for (u32 i = 0; i < GTE::NUM_REGS; i++)
+          {
+            if (expected[i] != regs[i])
+            {
+              Log_ErrorFmt("{} (0x{:05X}, widescreen={}) iteration {}: register {} is 0x{:08X}, expected 0x{:08X}",
+                           command.name, command.bits, widescreen, iteration, i, regs[i], expected[i]);
+            }
+          }
+        }
+
+        mismatches++;
+      }
+    }
+  }
+
+  g_settings.gpu_widescreen_hack = old_widescreen_hack;
+  g_settings.display_aspect_ratio = old_aspect_ratio;
+  GTE::UpdateAspectRatio();
+  GTE::Reset();
+
+  const u32 total = iterations * static_cast<u32>(commands.size()) * 2;
+  if (mismatches > 0)
+  {
+    Log_ErrorFmt("{} of {} recompiled GTE commands did not match.", mismatches, total);
+    return false;
+  }
+
+  Log_InfoFmt("{} recompiled GTE commands matched.", total);
+  return true;
+#else
+  Log_InfoPrint("The new recompiler is not available in this build.");
+  return true;
+#endif
+}
+
+void RegTestHost::RunMemoryBenchmark(u32 iterations)
+{
+  // Random addresses over every RAM mirror and segment, so the handler lookups can't all be predicted.
+  static constexpr u32 NUM_ADDRESSES = 4096;
+  static constexpr std::array<u32, 3> segments = {{0x00000000u, 0x80000000u, 0xA0000000u}};
+  std::mt19937 rng;
+  std::array<u32, NUM_ADDRESSES> addresses;
+  for (u32& address : addresses)
+    address = segments[rng() % segments.size()] | (static_cast<u32>(rng()) & (Bus::RAM_MIRROR_SIZE - 1) & ~3u);
+
+  const bool was_using_8mb_ram = (Bus::g_ram_size == Bus::RAM_8MB_SIZE);
+  const double num_accesses = static_cast<double>(iterations) * static_cast<double>(NUM_ADDRESSES);
+  for (const bool enable_8mb_ram : {false, true})
+  {
+    Bus::SetRAMSize(enable_8mb_ram);
+    CPU::g_state.memory_handlers = Bus::GetMemoryHandlers(false, false);
+
+    // Handler reads are what the interpreter and recompiler slow paths use, safe reads are the debugger's path.
+    Common::Timer timer;
+    u32 checksum = 0;
+    for (u32 i = 0; i < iterations; i++)
+    {
+      for (const u32 address : addresses)
+        checksum += CPU::Recompiler::Thunks::UncheckedReadMemoryWord(address);
+    }
+    const double read_time = timer.GetTimeNanosecondsAndReset();
+
+    for (u32 i = 0; i < iterations; i++)
+    {
+      for (const u32 address : addresses)
+      {
+        u32 value;
+        if (CPU::SafeReadMemoryWord(address, &value))
+          checksum += value;
+      }
+    }
+    const double safe_read_time = timer.GetTimeNanosecondsAndReset();
+
+    for (u32 i = 0; i < iterations; i++)
+    {
+      for (const u32 address : addresses)
+        CPU::Recompiler::Thunks::UncheckedWriteMemoryByte(address, i);
+    }
+    const double write_time = timer.GetTimeNanoseconds();
+
+    Log_InfoFmt("{}MB RAM: {:.2f} ns per word read, {:.2f} ns per safe word read, {:.2f} ns per byte write "
+                "(checksum {:08X})",
+                enable_8mb_ram ? 8 : 2, read_time / num_accesses, safe_read_time / num_accesses,
+                write_time / num_accesses, checksum);
+  }
+
+  Bus::SetRAMSize(was_using_8mb_ram);
+  CPU::UpdateMemoryPointers();
+}
+
+bool RegTestHost::RunCPUBenchmark(const SystemBootParameters& parameters)
+{
+  static constexpr std::array cpu_modes = {
+    std::make_pair(CPUExecutionMode::Interpreter, false),
+    std::make_pair(CPUExecutionMode::CachedInterpreter, false),
+#ifdef ENABLE_RECOMPILER
+    std::make_pair(CPUExecutionMode::Recompiler, false),
+    std::make_pair(CPUExecutionMode::Recompiler, true),
+#endif
+#ifdef ENABLE_NEWREC
+    std::make_pair(CPUExecutionMode::NewRec, false),
+    std::make_pair(CPUExecutionMode::NewRec, true),
+#endif
+  };
+
+  // PGXP gets switched off with the software renderer, so those passes would only repeat the plain ones.
+  const bool pgxp_supported =
+    (Settings::ParseRendererName(s_base_settings_interface->GetStringValue("GPU", "Renderer").c_str())
+       .value_or(GPURenderer::Software) != GPURenderer::Software);
+  if (!pgxp_supported)
+    Log_WarningPrint("Skipping PGXP CPU mode passes, a hardware renderer is required.");
+
+  // Each mode boots from scratch, so every pass runs the same frames.
+  const u32 frames = s_frames_to_run;
+  for (const auto& [mode, pgxp_cpu] : cpu_modes)
+  {
+    if (pgxp_cpu && !pgxp_supported)
+      continue;
+
+    s_base_settings_interface->SetStringValue("CPU", "ExecutionMode", Settings::GetCPUExecutionModeName(mode));
+    s_base_settings_interface->SetBoolValue("GPU", "PGXPEnable", pgxp_cpu);
+    s_base_settings_interface->SetBoolValue("GPU", "PGXPCPU", pgxp_cpu);
+    s_frames_to_run = frames;
+
+    Error error;
+    if (!System::BootSystem(SystemBootParameters(parameters), &error))
+    {
+      Log_ErrorFmt("Failed to boot system: {}", error.GetDescription());
+      return false;
+    }
+
+    Common::Timer timer;
+    System::Execute();
+
+    const double total_time = timer.GetTimeSeconds();
+    Log_InfoFmt("{}{}: {} frames in {:.2f} seconds ({:.2f} FPS).", Settings::GetCPUExecutionModeDisplayName(mode),
+                pgxp_cpu ? " (PGXP CPU)" : "", frames, total_time, static_cast<double>(frames) / total_time);
+  }
+
+  return true;
+}
+
 int main(int argc, char* argv[])
 {
   RegTestHost::InitializeEarlyConsole();
@@ -651,7 +1749,59 @@ int main(int argc, char* argv[])
   if (!RegTestHost::ParseCommandLineParameters(argc, argv, autoboot))
     return EXIT_FAILURE;
 
-  if (!autoboot || autoboot->filename.empty())
+  if (s_audio_benchmark_seconds > 0)
+  {
+    RegTestHost::RunAudioBenchmark(s_audio_benchmark_seconds);
+    return EXIT_SUCCESS;
+  }
+
+  if (!s_stretch_benchmark_path.empty())
+    return RegTestHost::RunStretchBenchmark(s_stretch_benchmark_path.c_str()) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  if (s_vertex_benchmark_iterations > 0)
+  {
+    RegTestHost::RunVertexBenchmark(s_vertex_benchmark_iterations);
+    return EXIT_SUCCESS;
+  }
+
+  if (s_gte_test_iterations > 0)
+    return RegTestHost::RunGTETest(s_gte_test_iterations) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  if (s_gte_recompiler_test_iterations > 0)
+  {
+    // Only the code buffer is needed, not a running system.
+    if (!System::Internal::ProcessStartup())
+      return EXIT_FAILURE;
+
+    const bool result = RegTestHost::RunGTERecompilerTest(s_gte_recompiler_test_iterations);
+    System::Internal::ProcessShutdown();
+    return result ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  if (s_spu_test_iterations > 0)
+    return RegTestHost::RunSPUTest(s_spu_test_iterations) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  if (s_xa_test_iterations > 0)
+    return RegTestHost::RunXATest(s_xa_test_iterations) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  if (s_memory_benchmark_iterations > 0)
+  {
+    // Only the memory mappings are needed, not a running system.
+    if (!System::Internal::ProcessStartup())
+      return EXIT_FAILURE;
+
+    RegTestHost::RunMemoryBenchmark(s_memory_benchmark_iterations);
+    System::Internal::ProcessShutdown();
+    return EXIT_SUCCESS;
+  }
+
+  if (!s_gpu_dump_replay_path.empty() || !s_mdec_replay_path.empty())
+  {
+    // GPU dumps and MDEC recordings carry their own state, only the BIOS is needed to bring the system up.
+    if (!autoboot)
+      autoboot.emplace();
+  }
+  else if (!autoboot || autoboot->filename.empty())
   {
     Log_ErrorPrint("No boot path specified.");
     return EXIT_FAILURE;
@@ -664,6 +1814,18 @@ int main(int argc, char* argv[])
 
   Error error;
   int result = -1;
+
+  if (s_cpu_benchmark)
+  {
+    if (RegTestHost::RunCPUBenchmark(autoboot.value()))
+    {
+      Log_InfoPrintf("Exiting with success.");
+      result = 0;
+    }
+
+    goto cleanup;
+  }
+
   Log_InfoPrintf("Trying to boot '%s'...", autoboot->filename.c_str());
   if (!System::BootSystem(std::move(autoboot.value()), &error))
   {
@@ -682,9 +1844,43 @@ int main(int argc, char* argv[])
     Log_InfoPrintf("Dumping every %dth frame to '%s'.", s_frame_dump_interval, s_dump_base_directory.c_str());
   }
 
+  if (!s_gpu_dump_replay_path.empty())
+  {
+    if (!RegTestHost::ReplayGPUDump(s_gpu_dump_replay_path.c_str()))
+      goto cleanup;
+
+    System::ShutdownSystem(false);
+    Log_InfoPrintf("Exiting with success.");
+    result = 0;
+    goto cleanup;
+  }
+
+  if (!s_mdec_replay_path.empty())
+  {
+    if (!RegTestHost::ReplayMDECRecording(s_mdec_replay_path.c_str()))
+      goto cleanup;
+
+    System::ShutdownSystem(false);
+    Log_InfoPrintf("Exiting with success.");
+    result = 0;
+    goto cleanup;
+  }
+
+  if (!s_gpu_dump_record_path.empty() && !System::StartRecordingGPUDump(s_gpu_dump_record_path.c_str()))
+    goto cleanup;
+
+  if (!s_mdec_record_path.empty())
+    MDEC::SetDataRecording(&s_mdec_recording);
+
   Log_InfoPrintf("Running for %d frames...", s_frames_to_run);
   System::Execute();
 
+  if (!s_mdec_record_path.empty() && !RegTestHost::WriteMDECRecording(s_mdec_record_path.c_str()))
+    goto cleanup;
+
+  if (!s_audio_stats_path.empty() && !RegTestHost::WriteAudioStats(s_audio_stats_path.c_str()))
+    goto cleanup;
+
   Log_InfoPrintf("Exiting with success.");
   result = 0;
 
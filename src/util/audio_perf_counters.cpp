@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "audio_perf_counters.h"
+
+#include "common/assert.h"
+#include "common/small_string.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+namespace AudioPerfCounters {
+namespace {
+struct SectionStats
+{
+  u64 calls;
+  Common::Timer::Value time;
+  Common::Timer::Value max_time;
+};
+
+struct BufferStats
+{
+  std::array<u64, NUM_HISTOGRAM_BUCKETS> histogram;
+  u64 samples;
+  u64 percent_sum;
+};
+} // namespace
+
+static constexpr std::array<const char*, static_cast<size_t>(Section::Count)> s_section_names = {
+  {"SPUExecute", "SPUSampleVoices", "SPUReverb", "XAADPCMDecode", "XAADPCMResample", "StreamStretch",
+   "StreamConvert"}};
+static constexpr std::array<const char*, static_cast<size_t>(Section::Count)> s_section_short_names = {
+  {"SPU", "Voices", "Reverb", "XA", "XA Resample", "Stretch", "Convert"}};
+static constexpr std::array<const char*, static_cast<size_t>(Buffer::Count)> s_buffer_names = {
+  {"OutputStream", "CDAudioFIFO"}};
+static constexpr std::array<const char*, static_cast<size_t>(Buffer::Count)> s_buffer_short_names = {
+  {"Output", "CD FIFO"}};
+
+static void AddStats(SectionStats& dst, const SectionStats& src);
+
+// Sections are accumulated into the current interval, and folded into the totals on each update.
+static std::array<SectionStats, static_cast<size_t>(Section::Count)> s_current_sections = {};
+static std::array<SectionStats, static_cast<size_t>(Section::Count)> s_last_interval_sections = {};
+static std::array<SectionStats, static_cast<size_t>(Section::Count)> s_total_sections = {};
+static double s_last_interval_seconds = 0.0;
+
+static std::array<u64, NUM_VOICES> s_voice_frames = {};
+
+static std::array<BufferStats, static_cast<size_t>(Buffer::Count)> s_buffers = {};
+static std::array<BufferStats, static_cast<size_t>(Buffer::Count)> s_current_buffers = {};
+static std::array<BufferStats, static_cast<size_t>(Buffer::Count)> s_last_interval_buffers = {};
+
+static Common::Timer s_total_timer;
+
+} // namespace AudioPerfCounters
+
+bool AudioPerfCounters::Internal::g_enabled = false;
+
+void AudioPerfCounters::SetEnabled(bool enabled)
+{
+  Internal::g_enabled = enabled;
+  Reset();
+}
+
+void AudioPerfCounters::Reset()
+{
+  s_current_sections = {};
+  s_last_interval_sections = {};
+  s_total_sections = {};
+  s_last_interval_seconds = 0.0;
+  s_voice_frames = {};
+  s_buffers = {};
+  s_current_buffers = {};
+  s_last_interval_buffers = {};
+  s_total_timer.Reset();
+}
+
+void AudioPerfCounters::AddStats(SectionStats& dst, const SectionStats& src)
+{
+  dst.calls += src.calls;
+  dst.time += src.time;
+  dst.max_time = std::max(dst.max_time, src.max_time);
+}
+
+void AudioPerfCounters::Internal::AddSectionTime(Section section, Common::Timer::Value time)
+{
+  SectionStats& stats = s_current_sections[static_cast<size_t>(section)];
+  stats.calls++;
+  stats.time += time;
+  stats.max_time = std::max(stats.max_time, time);
+}
+
+void AudioPerfCounters::Internal::AddVoiceFrames(u32 voice_index, u32 frames)
+{
+  DebugAssert(voice_index < NUM_VOICES);
+  s_voice_frames[voice_index] += frames;
+}
+
+void AudioPerfCounters::Internal::AddBufferLevel(Buffer buffer, u32 level, u32 capacity)
+{
+  const u32 percent = (capacity > 0) ? std::min((level * 100u) / capacity, 100u) : 0u;
+  const u32 bucket = std::min((percent * NUM_HISTOGRAM_BUCKETS) / 100u, NUM_HISTOGRAM_BUCKETS - 1);
+
+  BufferStats& stats = s_current_buffers[static_cast<size_t>(buffer)];
+  stats.histogram[bucket]++;
+  stats.samples++;
+  stats.percent_sum += percent;
+}
+
+void AudioPerfCounters::UpdateInterval(double interval_seconds)
+{
+  for (size_t i = 0; i < s_current_sections.size(); i++)
+  {
+    AddStats(s_total_sections[i], s_current_sections[i]);
+    s_last_interval_sections[i] = s_current_sections[i];
+    s_current_sections[i] = {};
+  }
+
+  for (size_t i = 0; i < s_current_buffers.size(); i++)
+  {
+    BufferStats& total = s_buffers[i];
+    const BufferStats& current = s_current_buffers[i];
+    for (u32 j = 0; j < NUM_HISTOGRAM_BUCKETS; j++)
+      total.histogram[j] += current.histogram[j];
+    total.samples += current.samples;
+    total.percent_sum += current.percent_sum;
+    s_last_interval_buffers[i] = current;
+    s_current_buffers[i] = {};
+  }
+
+  s_last_interval_seconds = interval_seconds;
+}
+
+void AudioPerfCounters::FormatSectionStats(SmallStringBase& text)
+{
+  text.clear();
+  if (s_last_interval_seconds <= 0.0)
+    return;
+
+  const double pct_scale = 100.0 / s_last_interval_seconds;
+  for (size_t i = 0; i < s_last_interval_sections.size(); i++)
+  {
+    const double seconds = Common::Timer::ConvertValueToSeconds(s_last_interval_sections[i].time);
+    text.append_format("{}{}: {:.2f}%", text.empty() ? "" : " | ", s_section_short_names[i], seconds * pct_scale);
+  }
+}
+
+void AudioPerfCounters::FormatBufferStats(SmallStringBase& text)
+{
+  text.clear();
+  if (s_last_interval_seconds <= 0.0)
+    return;
+
+  for (size_t i = 0; i < s_last_interval_buffers.size(); i++)
+  {
+    const BufferStats& stats = s_last_interval_buffers[i];
+    text.append_format("{}{} Fill: ", text.empty() ? "" : " | ", s_buffer_short_names[i]);
+    if (stats.samples == 0)
+      text.append("-");
+    else
+      text.append_format("{}%", stats.percent_sum / stats.samples);
+  }
+}
+
+std::string AudioPerfCounters::GetJSONReport()
+{
+  const double total_seconds = s_total_timer.GetTimeSeconds();
+  const double pct_scale = (total_seconds > 0.0) ? (100.0 / total_seconds) : 0.0;
+
+  std::string ret;
+  auto out = std::back_inserter(ret);
+  fmt::format_to(out, "{{\n  \"seconds\": {:.3f},\n  \"sections\": {{", total_seconds);
+  for (size_t i = 0; i < s_total_sections.size(); i++)
+  {
+    // The current interval hasn't been folded in yet.
+    SectionStats stats = s_total_sections[i];
+    AddStats(stats, s_current_sections[i]);
+
+    const double time_ms = Common::Timer::ConvertValueToMilliseconds(stats.time);
+    const double avg_us = (stats.calls > 0) ? ((time_ms * 1000.0) / static_cast<double>(stats.calls)) : 0.0;
+    fmt::format_to(out,
+                   "{}\n    \"{}\": {{\"calls\": {}, \"total_ms\": {:.3f}, \"avg_us\": {:.3f}, \"max_us\": {:.3f}, "
+                   "\"percent\": {:.3f}}}",
+                   (i == 0) ? "" : ",", s_section_names[i], stats.calls, time_ms, avg_us,
+                   Common::Timer::ConvertValueToNanoseconds(stats.max_time) / 1000.0,
+                   (time_ms / 1000.0) * pct_scale);
+  }
+
+  fmt::format_to(out, "\n  }},\n  \"voice_frames\": [");
+  for (u32 i = 0; i < NUM_VOICES; i++)
+    fmt::format_to(out, "{}{}", (i == 0) ? "" : ", ", s_voice_frames[i]);
+
+  fmt::format_to(out, "],\n  \"buffers\": {{");
+  for (size_t i = 0; i < s_buffers.size(); i++)
+  {
+    const BufferStats& total = s_buffers[i];
+    const BufferStats& current = s_current_buffers[i];
+    const u64 samples = total.samples + current.samples;
+    const u64 percent_sum = total.percent_sum + current.percent_sum;
+    fmt::format_to(out, "{}\n    \"{}\": {{\"samples\": {}, \"average_percent\": {}, \"histogram\": [",
+                   (i == 0) ? "" : ",", s_buffer_names[i], samples, (samples > 0) ? (percent_sum / samples) : 0);
+    for (u32 j = 0; j < NUM_HISTOGRAM_BUCKETS; j++)
+      fmt::format_to(out, "{}{}", (j == 0) ? "" : ", ", total.histogram[j] + current.histogram[j]);
+    fmt::format_to(out, "]}}");
+  }
+
+  fmt::format_to(out, "\n  }}\n}}\n");
+  return ret;
+}
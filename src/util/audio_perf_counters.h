@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "common/timer.h"
+#include "common/types.h"
+
+#include <string>
+
+class SmallStringBase;
+
+// Lightweight timing of the audio pipeline, so stutter can be pinned on the SPU, CD audio or the output stream. The
+// counters are always compiled in, but cost a single branch per section while they're disabled. Everything here is
+// only touched on the CPU thread.
+namespace AudioPerfCounters {
+
+enum class Section : u8
+{
+  SPUExecute,
+  SPUSampleVoices,
+  SPUReverb,
+  XAADPCMDecode,
+  XAADPCMResample,
+  StreamStretch,
+  StreamConvert,
+  Count
+};
+
+enum class Buffer : u8
+{
+  OutputStream,
+  CDAudioFIFO,
+  Count
+};
+
+static constexpr u32 NUM_VOICES = 24;
+static constexpr u32 NUM_HISTOGRAM_BUCKETS = 10;
+
+namespace Internal {
+extern bool g_enabled;
+void AddSectionTime(Section section, Common::Timer::Value time);
+void AddVoiceFrames(u32 voice_index, u32 frames);
+void AddBufferLevel(Buffer buffer, u32 level, u32 capacity);
+} // namespace Internal
+
+ALWAYS_INLINE bool IsEnabled()
+{
+  return Internal::g_enabled;
+}
+
+/// Enabling or disabling the counters also resets them.
+void SetEnabled(bool enabled);
+void Reset();
+
+/// Moves the counters for the current interval into the totals, and keeps them for the overlay.
+/// Called once per performance counter update.
+void UpdateInterval(double interval_seconds);
+
+/// Formats the time spent in each section over the last interval, as a percentage of wall time.
+void FormatSectionStats(SmallStringBase& text);
+
+/// Formats the average fill level of each buffer over the last interval.
+void FormatBufferStats(SmallStringBase& text);
+
+/// Returns everything collected since the counters were enabled as a JSON object.
+std::string GetJSONReport();
+
+/// Times the enclosing scope when the counters are enabled. Sections can nest, the outer section includes the inner.
+class ScopedSection
+{
+public:
+  ALWAYS_INLINE ScopedSection(Section section)
+    : m_start(IsEnabled() ? Common::Timer::GetCurrentValue() : 0), m_section(section)
+  {
+  }
+
+  ALWAYS_INLINE ~ScopedSection()
+  {
+    if (m_start != 0) [[unlikely]]
+      Internal::AddSectionTime(m_section, Common::Timer::GetCurrentValue() - m_start);
+  }
+
+  ScopedSection(const ScopedSection&) = delete;
+  ScopedSection& operator=(const ScopedSection&) = delete;
+
+private:
+  Common::Timer::Value m_start;
+  Section m_section;
+};
+
+ALWAYS_INLINE void AddVoiceFrames(u32 voice_index, u32 frames)
+{
+  if (IsEnabled()) [[unlikely]]
+    Internal::AddVoiceFrames(voice_index, frames);
+}
+
+/// Records how full a buffer is, in whatever units it's measured in.
+ALWAYS_INLINE void AddBufferLevel(Buffer buffer, u32 level, u32 capacity)
+{
+  if (IsEnabled()) [[unlikely]]
+    Internal::AddBufferLevel(buffer, level, capacity);
+}
+
+} // namespace AudioPerfCounters
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "audio_stream.h"
+#include "audio_perf_counters.h"
+#include "audio_stretcher.h"
 #include "host.h"
 
 #include "common/align.h"
@@ -238,7 +240,10 @@ u32 AudioStream::GetBufferedFramesRelaxed() const
 
 void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
 {
-  const u32 available_frames = GetBufferedFramesRelaxed();
+  // Acquire on the write position, so that the frames before it are visible to this thread.
+  u32 rpos = m_rpos.load(std::memory_order_relaxed);
+  const u32 wpos = m_wpos.load(std::memory_order_acquire);
+  const u32 available_frames = (wpos + m_buffer_size - rpos) % m_buffer_size;
   u32 frames_to_read = num_frames;
   u32 silence_frames = 0;
 
@@ -271,7 +276,7 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
 
   if (frames_to_read > 0)
   {
-    u32 rpos = m_rpos.load(std::memory_order_acquire);
+    const u32 start_rpos = rpos;
 
     u32 end = m_buffer_size - rpos;
     if (end > frames_to_read)
@@ -293,7 +298,18 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
       rpos = start;
     }
 
-    m_rpos.store(rpos, std::memory_order_release);
+    // The writer only moves the read position when it overruns, by discarding frames from wherever the read position
+    // was at the time. Both moves are forward from start_rpos, so the correct result is whichever went further: if
+    // the discard skipped at least as many frames as were read, its position already excludes everything consumed
+    // here. Otherwise, the discard only covered frames which were read anyway, so the reader's position still holds,
+    // and has to be stored over the writer's to avoid playing those frames a second time.
+    u32 current_rpos = start_rpos;
+    while (!m_rpos.compare_exchange_weak(current_rpos, rpos, std::memory_order_release, std::memory_order_relaxed))
+    {
+      const u32 discarded_frames = (current_rpos + m_buffer_size - start_rpos) % m_buffer_size;
+      if (discarded_frames >= frames_to_read)
+        break;
+    }
   }
 
   if (silence_frames > 0)
@@ -305,21 +321,14 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
       const u32 increment =
         static_cast<u32>(65536.0f * (static_cast<float>(frames_to_read) / static_cast<float>(num_frames)));
 
-      SampleType* resample_ptr =
-        static_cast<SampleType*>(alloca(frames_to_read * m_output_channels * sizeof(SampleType)));
-      std::memcpy(resample_ptr, samples, frames_to_read * m_output_channels * sizeof(SampleType));
-
-      SampleType* out_ptr = samples;
+      // Output frame i comes from input frame (i * increment) >> 16, which is never past i. Walking backwards means
+      // every source frame is read before it gets overwritten, so it can be done in place without a copy.
       const u32 copy_stride = sizeof(SampleType) * m_output_channels;
-      u32 resample_subpos = 0;
-      for (u32 i = 0; i < num_frames; i++)
+      for (u32 i = num_frames - 1; i > 0; i--)
       {
-        std::memcpy(out_ptr, resample_ptr, copy_stride);
-        out_ptr += m_output_channels;
-
-        resample_subpos += increment;
-        resample_ptr += (resample_subpos >> 16) * m_output_channels;
-        resample_subpos %= 65536u;
+        const u32 src = static_cast<u32>((static_cast<u64>(i) * increment) >> 16);
+        if (src != i)
+          std::memcpy(&samples[i * m_output_channels], &samples[src * m_output_channels], copy_stride);
       }
 
       Log_VerboseFmt("Audio buffer underflow, resampled {} frames to {}", frames_to_read, num_frames);
@@ -339,11 +348,34 @@ void AudioStream::StereoSampleReaderImpl(SampleType* dest, const SampleType* src
 
 void AudioStream::ApplyVolume(s16* samples, u32 num_samples)
 {
+  // 100% is a passthrough, the multiplier would be 32768, and (sample * 32768) >> 15 is the sample itself.
   if (m_volume == 100)
     return;
 
   const s32 volume_mult = static_cast<s32>((static_cast<float>(m_volume) / 100.0f) * 32768.0f);
 
+  // Attenuation keeps the multiplier within s16, which the vector paths need. Amplification is rare enough to not care.
+  if (volume_mult < 32768)
+  {
+#if defined(CPU_ARCH_NEON)
+    // (2 * a * b) >> 16 is the same as (a * b) >> 15, and can't saturate with a non-negative multiplier.
+    const int16x8_t mult = vdupq_n_s16(static_cast<s16>(volume_mult));
+    for (; num_samples >= 8; num_samples -= 8, samples += 8)
+      vst1q_s16(samples, vqdmulhq_s16(vld1q_s16(samples), mult));
+#elif defined(CPU_ARCH_SSE)
+    // The result fits in 16 bits, so it's bits 15..30 of the 32-bit product.
+    const __m128i mult = _mm_set1_epi16(static_cast<s16>(volume_mult));
+    for (; num_samples >= 8; num_samples -= 8, samples += 8)
+    {
+      const __m128i sv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples));
+      const __m128i lo = _mm_mullo_epi16(sv, mult);
+      const __m128i hi = _mm_mulhi_epi16(sv, mult);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(samples),
+                       _mm_or_si128(_mm_slli_epi16(hi, 1), _mm_srli_epi16(lo, 15)));
+    }
+#endif
+  }
+
   while (num_samples > 0)
   {
     *samples = static_cast<s16>((static_cast<s32>(*samples) * volume_mult) >> 15);
@@ -354,7 +386,10 @@ void AudioStream::ApplyVolume(s16* samples, u32 num_samples)
 
 void AudioStream::InternalWriteFrames(s16* data, u32 num_frames)
 {
-  const u32 free = m_buffer_size - GetBufferedFramesRelaxed();
+  // Acquire on the read position, so that the reader is done with any frames that are about to be overwritten.
+  u32 wpos = m_wpos.load(std::memory_order_relaxed);
+  const u32 rpos = m_rpos.load(std::memory_order_acquire);
+  const u32 free = m_buffer_size - ((wpos + m_buffer_size - rpos) % m_buffer_size);
   if (free <= num_frames)
   {
     if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
@@ -368,8 +403,6 @@ void AudioStream::InternalWriteFrames(s16* data, u32 num_frames)
     }
   }
 
-  u32 wpos = m_wpos.load(std::memory_order_acquire);
-
   // wrapping around the end of the buffer?
   if ((m_buffer_size - wpos) <= num_frames)
   {
@@ -448,11 +481,14 @@ void AudioStream::EmptyBuffer()
   }
 #endif
 
-  if (IsStretchEnabled())
+  if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
+  {
+    m_stretcher->Clear();
+    m_stretcher->SetTempo(m_nominal_rate);
+  }
+  else if (m_parameters.stretch_mode == AudioStretchMode::Resample)
   {
     m_soundtouch->clear();
-    if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
-      m_soundtouch->setTempo(m_nominal_rate);
   }
 
   m_wpos.store(m_rpos.load(std::memory_order_acquire), std::memory_order_release);
@@ -477,7 +513,7 @@ void AudioStream::UpdateTargetTempo(float tempo)
   m_average_position = AVERAGING_WINDOW;
   m_average_available = AVERAGING_WINDOW;
   std::fill_n(m_average_fullness.data(), AVERAGING_WINDOW, tempo);
-  m_soundtouch->setTempo(tempo);
+  m_stretcher->SetTempo(tempo);
   m_stretch_reset = 0;
   m_stretch_inactive = false;
   m_stretch_ok_count = 0;
@@ -634,16 +670,30 @@ static void FloatChunkToS16(s16* dst, const float* src, u32 num_samples)
 static void S16ChunkToFloat(const s16* src, float* dst, u32 num_samples)
 {
   for (u32 i = 0; i < num_samples; ++i)
-    *(dst++) = static_cast<float>(*(src++)) / 32767.0f;
+    *(dst++) = static_cast<float>(*(src++)) * S16_TO_FLOAT;
 }
 
 static void FloatChunkToS16(s16* dst, const float* src, u32 num_samples)
 {
+  // Saturate like the vector paths, out-of-range samples from the stretcher would otherwise wrap around.
   for (u32 i = 0; i < num_samples; ++i)
-    *(dst++) = static_cast<s16>((*(src++) * 32767.0f));
+    *(dst++) = static_cast<s16>(std::clamp(*(src++) * FLOAT_TO_S16, -32768.0f, 32767.0f));
 }
 #endif
 
+// Conversions are counted separately from the stretching, since they run whether it's enabled or not.
+static void TimedS16ChunkToFloat(const s16* src, float* dst, u32 num_samples)
+{
+  AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::StreamConvert);
+  S16ChunkToFloat(src, dst, num_samples);
+}
+
+static void TimedFloatChunkToS16(s16* dst, const float* src, u32 num_samples)
+{
+  AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::StreamConvert);
+  FloatChunkToS16(dst, src, num_samples);
+}
+
 void AudioStream::ExpandAllocate()
 {
   DebugAssert(!m_expander);
@@ -692,6 +742,7 @@ void AudioStream::EndWrite(u32 num_frames)
     return;
 
   m_staging_buffer_pos = 0;
+  AudioPerfCounters::AddBufferLevel(AudioPerfCounters::Buffer::OutputStream, GetBufferedFramesRelaxed(), m_buffer_size);
 
   if (!IsExpansionEnabled() && !IsStretchEnabled())
   {
@@ -703,8 +754,8 @@ void AudioStream::EndWrite(u32 num_frames)
   if (IsExpansionEnabled())
   {
     // StretchWriteBlock() overwrites the staging buffer on output, so we need to copy into the expand buffer first.
-    S16ChunkToFloat(m_staging_buffer.get(), m_expand_buffer.get() + m_expand_buffer_pos * NUM_INPUT_CHANNELS,
-                    CHUNK_SIZE * NUM_INPUT_CHANNELS);
+    TimedS16ChunkToFloat(m_staging_buffer.get(), m_expand_buffer.get() + m_expand_buffer_pos * NUM_INPUT_CHANNELS,
+                         CHUNK_SIZE * NUM_INPUT_CHANNELS);
 
     // Output the corresponding block.
     if (m_expand_output_buffer)
@@ -721,7 +772,7 @@ void AudioStream::EndWrite(u32 num_frames)
   else
 #endif
   {
-    S16ChunkToFloat(m_staging_buffer.get(), m_float_buffer.get(), CHUNK_SIZE * NUM_INPUT_CHANNELS);
+    TimedS16ChunkToFloat(m_staging_buffer.get(), m_float_buffer.get(), CHUNK_SIZE * NUM_INPUT_CHANNELS);
     StretchWriteBlock(m_float_buffer.get());
   }
 }
@@ -739,21 +790,22 @@ void AudioStream::StretchAllocate()
   if (m_parameters.stretch_mode == AudioStretchMode::Off)
     return;
 
-  m_soundtouch = std::make_unique<soundtouch::SoundTouch>();
-  m_soundtouch->setSampleRate(m_sample_rate);
-  m_soundtouch->setChannels(m_internal_channels);
-
-  m_soundtouch->setSetting(SETTING_USE_QUICKSEEK, m_parameters.stretch_use_quickseek);
-  m_soundtouch->setSetting(SETTING_USE_AA_FILTER, m_parameters.stretch_use_aa_filter);
-
-  m_soundtouch->setSetting(SETTING_SEQUENCE_MS, m_parameters.stretch_sequence_length_ms);
-  m_soundtouch->setSetting(SETTING_SEEKWINDOW_MS, m_parameters.stretch_seekwindow_ms);
-  m_soundtouch->setSetting(SETTING_OVERLAP_MS, m_parameters.stretch_overlap_ms);
-
-  if (m_parameters.stretch_mode == AudioStretchMode::Resample)
-    m_soundtouch->setRate(m_nominal_rate);
+  if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
+  {
+    m_stretcher = std::make_unique<AudioStretcher>(m_sample_rate, m_internal_channels,
+                                                   m_parameters.stretch_sequence_length_ms,
+                                                   m_parameters.stretch_seekwindow_ms, m_parameters.stretch_overlap_ms,
+                                                   CHUNK_SIZE);
+    m_stretcher->SetTempo(m_nominal_rate);
+  }
   else
-    m_soundtouch->setTempo(m_nominal_rate);
+  {
+    m_soundtouch = std::make_unique<soundtouch::SoundTouch>();
+    m_soundtouch->setSampleRate(m_sample_rate);
+    m_soundtouch->setChannels(m_internal_channels);
+    m_soundtouch->setSetting(SETTING_USE_AA_FILTER, m_parameters.stretch_use_aa_filter);
+    m_soundtouch->setRate(m_nominal_rate);
+  }
 
   m_stretch_reset = STRETCH_RESET_THRESHOLD;
   m_stretch_inactive = false;
@@ -767,28 +819,46 @@ void AudioStream::StretchAllocate()
 
 void AudioStream::StretchDestroy()
 {
+  m_stretcher.reset();
   m_soundtouch.reset();
 }
 
 void AudioStream::StretchWriteBlock(const float* block)
 {
-  if (IsStretchEnabled())
+  // Both stretchers do all of their work when the input is put, receiving is just a copy.
+  if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
   {
-    m_soundtouch->putSamples(block, CHUNK_SIZE);
+    {
+      AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::StreamStretch);
+      m_stretcher->PutFrames(block, CHUNK_SIZE);
+    }
+
+    u32 frames;
+    while ((frames = m_stretcher->ReceiveFrames(m_float_buffer.get(), CHUNK_SIZE)) != 0)
+    {
+      TimedFloatChunkToS16(m_staging_buffer.get(), m_float_buffer.get(), frames * m_internal_channels);
+      InternalWriteFrames(m_staging_buffer.get(), frames);
+    }
+
+    UpdateStretchTempo();
+  }
+  else if (m_parameters.stretch_mode == AudioStretchMode::Resample)
+  {
+    {
+      AudioPerfCounters::ScopedSection perf_section(AudioPerfCounters::Section::StreamStretch);
+      m_soundtouch->putSamples(block, CHUNK_SIZE);
+    }
 
     u32 tempProgress;
     while (tempProgress = m_soundtouch->receiveSamples(m_float_buffer.get(), CHUNK_SIZE), tempProgress != 0)
     {
-      FloatChunkToS16(m_staging_buffer.get(), m_float_buffer.get(), tempProgress * m_internal_channels);
+      TimedFloatChunkToS16(m_staging_buffer.get(), m_float_buffer.get(), tempProgress * m_internal_channels);
       InternalWriteFrames(m_staging_buffer.get(), tempProgress);
     }
-
-    if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
-      UpdateStretchTempo();
   }
   else
   {
-    FloatChunkToS16(m_staging_buffer.get(), block, CHUNK_SIZE * m_internal_channels);
+    TimedFloatChunkToS16(m_staging_buffer.get(), block, CHUNK_SIZE * m_internal_channels);
     InternalWriteFrames(m_staging_buffer.get(), CHUNK_SIZE);
   }
 }
@@ -816,8 +886,8 @@ float AudioStream::AddAndGetAverageTempo(float val)
 
 void AudioStream::UpdateStretchTempo()
 {
-  static constexpr float MIN_TEMPO = 0.05f;
-  static constexpr float MAX_TEMPO = 50.0f;
+  static constexpr float MIN_TEMPO = AudioStretcher::MIN_TEMPO;
+  static constexpr float MAX_TEMPO = AudioStretcher::MAX_TEMPO;
 
   // Which range we will run in 1:1 mode for.
   static constexpr float INACTIVE_GOOD_FACTOR = 1.04f;
@@ -901,7 +971,7 @@ void AudioStream::UpdateStretchTempo()
     iterations++;
   }
 
-  m_soundtouch->setTempo(tempo);
+  m_stretcher->SetTempo(tempo);
 
   if (m_stretch_reset >= STRETCH_RESET_THRESHOLD)
     m_stretch_reset = 0;
@@ -919,8 +989,13 @@ void AudioStream::StretchOverrun()
   m_stretch_reset++;
 
   // Drop two packets to give the time stretcher a bit more time to slow things down.
+  // This is the only place the writer touches the read position, so it has to race with the reader.
   const u32 discard = CHUNK_SIZE * 2;
-  m_rpos.store((m_rpos.load(std::memory_order_acquire) + discard) % m_buffer_size, std::memory_order_release);
+  u32 rpos = m_rpos.load(std::memory_order_acquire);
+  while (!m_rpos.compare_exchange_weak(rpos, (rpos + discard) % m_buffer_size, std::memory_order_acq_rel,
+                                       std::memory_order_acquire))
+  {
+  }
 }
 
 void AudioStreamParameters::Load(SettingsInterface& si, const char* section)
@@ -949,7 +1024,6 @@ void AudioStreamParameters::Load(SettingsInterface& si, const char* section)
     si.GetUIntValue(section, "StretchSeekWindowMS", DEFAULT_STRETCH_SEEKWINDOW), std::numeric_limits<u16>::max()));
   stretch_overlap_ms = static_cast<u16>(std::min<u32>(
     si.GetUIntValue(section, "StretchOverlapMS", DEFAULT_STRETCH_OVERLAP), std::numeric_limits<u16>::max()));
-  stretch_use_quickseek = si.GetBoolValue(section, "StretchUseQuickSeek", DEFAULT_STRETCH_USE_QUICKSEEK);
   stretch_use_aa_filter = si.GetBoolValue(section, "StretchUseAAFilter", DEFAULT_STRETCH_USE_AA_FILTER);
 
   expand_block_size = static_cast<u16>(std::min<u32>(
@@ -983,7 +1057,6 @@ void AudioStreamParameters::Save(SettingsInterface& si, const char* section) con
   si.SetUIntValue(section, "StretchSequenceLengthMS", stretch_sequence_length_ms);
   si.SetUIntValue(section, "StretchSeekWindowMS", stretch_seekwindow_ms);
   si.SetUIntValue(section, "StretchOverlapMS", stretch_overlap_ms);
-  si.SetBoolValue(section, "StretchUseQuickSeek", stretch_use_quickseek);
   si.SetBoolValue(section, "StretchUseAAFilter", stretch_use_aa_filter);
 
   si.SetUIntValue(section, "ExpandBlockSize", expand_block_size);
@@ -1008,7 +1081,6 @@ void AudioStreamParameters::Clear(SettingsInterface& si, const char* section)
   si.DeleteValue(section, "StretchSequenceLengthMS");
   si.DeleteValue(section, "StretchSeekWindowMS");
   si.DeleteValue(section, "StretchOverlapMS");
-  si.DeleteValue(section, "StretchUseQuickSeek");
   si.DeleteValue(section, "StretchUseAAFilter");
 
   si.DeleteValue(section, "ExpandBlockSize");
@@ -20,6 +20,7 @@
 class Error;
 class SettingsInterface;
 
+class AudioStretcher;
 class FreeSurroundDecoder;
 namespace soundtouch {
 class SoundTouch;
@@ -71,7 +72,6 @@ struct AudioStreamParameters
   u16 stretch_sequence_length_ms = DEFAULT_STRETCH_SEQUENCE_LENGTH;
   u16 stretch_seekwindow_ms = DEFAULT_STRETCH_SEEKWINDOW;
   u16 stretch_overlap_ms = DEFAULT_STRETCH_OVERLAP;
-  bool stretch_use_quickseek = DEFAULT_STRETCH_USE_QUICKSEEK;
   bool stretch_use_aa_filter = DEFAULT_STRETCH_USE_AA_FILTER;
 
   float expand_circular_wrap = DEFAULT_EXPAND_CIRCULAR_WRAP;
@@ -105,11 +105,10 @@ struct AudioStreamParameters
   static constexpr u8 DEFAULT_EXPAND_LOW_CUTOFF = 40;
   static constexpr u8 DEFAULT_EXPAND_HIGH_CUTOFF = 90;
 
-  static constexpr u16 DEFAULT_STRETCH_SEQUENCE_LENGTH = 30;
-  static constexpr u16 DEFAULT_STRETCH_SEEKWINDOW = 20;
-  static constexpr u16 DEFAULT_STRETCH_OVERLAP = 10;
+  static constexpr u16 DEFAULT_STRETCH_SEQUENCE_LENGTH = 10;
+  static constexpr u16 DEFAULT_STRETCH_SEEKWINDOW = 6;
+  static constexpr u16 DEFAULT_STRETCH_OVERLAP = 3;
 
-  static constexpr bool DEFAULT_STRETCH_USE_QUICKSEEK = false;
   static constexpr bool DEFAULT_STRETCH_USE_AA_FILTER = false;
 
   void Load(SettingsInterface& si, const char* section);
@@ -265,10 +264,14 @@ private:
   std::unique_ptr<s16[]> m_buffer;
   SampleReader m_sample_reader = nullptr;
 
-  std::atomic<u32> m_rpos{0};
-  std::atomic<u32> m_wpos{0};
+  // Single producer/single consumer ring. The positions live on their own cache lines, so the emulator thread writing
+  // and the output thread reading don't keep stealing each other's line.
+  alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> m_rpos{0};
+  alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> m_wpos{0};
 
-  std::unique_ptr<soundtouch::SoundTouch> m_soundtouch;
+  // SoundTouch is only used for resampling, time stretching goes through our own lower latency stretcher.
+  alignas(HOST_CACHE_LINE_SIZE) std::unique_ptr<soundtouch::SoundTouch> m_soundtouch;
+  std::unique_ptr<AudioStretcher> m_stretcher;
 
   u32 m_target_buffer_size = 0;
   u32 m_stretch_reset = STRETCH_RESET_THRESHOLD;
@@ -286,7 +289,7 @@ private:
   // temporary staging buffer, used for timestretching
   std::unique_ptr<s16[]> m_staging_buffer;
 
-  // float buffer, soundtouch only accepts float samples as input
+  // float buffer, the stretchers only accept float samples as input
   std::unique_ptr<float[]> m_float_buffer;
 
 #ifndef __ANDROID__
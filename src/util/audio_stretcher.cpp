@@ -0,0 +1,255 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "audio_stretcher.h"
+
+#include "common/assert.h"
+#include "common/intrin.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+static constexpr u32 MIN_OVERLAP_FRAMES = 8;
+static constexpr u32 MIN_SEQUENCE_FRAMES = MIN_OVERLAP_FRAMES * 2;
+
+static float DotProduct(const float* a, const float* b, u32 count)
+{
+  u32 i = 0;
+  float result;
+
+#if defined(CPU_ARCH_SSE)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (; (i + 8) <= count; i += 8)
+  {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  acc0 = _mm_add_ps(acc0, acc1);
+  acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+  acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(1, 1, 1, 1)));
+  result = _mm_cvtss_f32(acc0);
+#elif defined(CPU_ARCH_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (; (i + 8) <= count; i += 8)
+  {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  result = vaddvq_f32(vaddq_f32(acc0, acc1));
+#else
+  result = 0.0f;
+#endif
+
+  for (; i < count; i++)
+    result += a[i] * b[i];
+
+  return result;
+}
+
+AudioStretcher::AudioStretcher(u32 sample_rate, u32 channels, u32 sequence_ms, u32 seekwindow_ms, u32 overlap_ms,
+                               u32 max_put_frames)
+  : m_channels(channels)
+{
+  m_sequence_frames = std::max((sample_rate * sequence_ms) / 1000u, MIN_SEQUENCE_FRAMES);
+  m_overlap_frames = std::clamp((sample_rate * overlap_ms) / 1000u, MIN_OVERLAP_FRAMES, m_sequence_frames / 2);
+  m_seek_frames = std::max((sample_rate * seekwindow_ms) / 1000u, 1u);
+
+  m_overlap.resize(m_overlap_frames * m_channels);
+  m_reference.resize(m_overlap_frames * m_channels);
+  AllocateBuffers(max_put_frames);
+
+  SetTempo(1.0f);
+}
+
+AudioStretcher::~AudioStretcher() = default;
+
+u32 AudioStretcher::GetRequiredInputFrames(float tempo) const
+{
+  const double nominal_skip = static_cast<double>(tempo) * static_cast<double>(m_sequence_frames - m_overlap_frames);
+  const u32 int_skip = static_cast<u32>(nominal_skip + 0.5);
+  return std::max(int_skip + m_overlap_frames, m_sequence_frames) + m_seek_frames;
+}
+
+void AudioStretcher::AllocateBuffers(u32 max_put_frames)
+{
+  // After processing, less than the required input is left over, which is largest at the fastest tempo. The most
+  // sequences are produced from one put at the slowest tempo, where each one consumes the fewest frames. Process()
+  // stops when the output is full, which only happens when a drop in tempo leaves a large backlog of input, and that
+  // backlog is worked through over the next few puts instead.
+  const u32 output_frames_per_sequence = m_sequence_frames - m_overlap_frames;
+  const double min_skip = static_cast<double>(MIN_TEMPO) * static_cast<double>(output_frames_per_sequence);
+  const u32 max_sequences_per_put = static_cast<u32>(std::ceil(static_cast<double>(max_put_frames) / min_skip)) + 2;
+  m_input.resize((GetRequiredInputFrames(MAX_TEMPO) + max_put_frames) * m_channels);
+  m_output.resize(max_sequences_per_put * output_frames_per_sequence * m_channels);
+  m_max_put_frames = max_put_frames;
+}
+
+void AudioStretcher::SetTempo(float tempo)
+{
+  m_tempo = std::clamp(tempo, MIN_TEMPO, MAX_TEMPO);
+
+  // Each sequence produces (sequence - overlap) frames, and consumes that many scaled by the tempo.
+  m_nominal_skip = static_cast<double>(m_tempo) * static_cast<double>(m_sequence_frames - m_overlap_frames);
+  m_required_input_frames = GetRequiredInputFrames(m_tempo);
+}
+
+void AudioStretcher::Clear()
+{
+  m_input_start = 0;
+  m_input_end = 0;
+  m_output_start = 0;
+  m_output_end = 0;
+  m_skip_fract = 0.0;
+  m_first_sequence = true;
+}
+
+float* AudioStretcher::AppendFrames(std::vector<float>& buffer, u32 channels, u32& start, u32& end, u32 num_frames)
+{
+  if (((end + num_frames) * channels) > buffer.size())
+  {
+    // Move the live frames to the front first, so the buffer only grows when it's actually full.
+    if (start > 0)
+    {
+      std::memmove(buffer.data(), &buffer[start * channels], (end - start) * channels * sizeof(float));
+      end -= start;
+      start = 0;
+    }
+
+    if (((end + num_frames) * channels) > buffer.size())
+      buffer.resize((end + num_frames) * channels);
+  }
+
+  float* ptr = &buffer[end * channels];
+  end += num_frames;
+  return ptr;
+}
+
+void AudioStretcher::PutFrames(const float* frames, u32 num_frames)
+{
+  if (num_frames > m_max_put_frames) [[unlikely]]
+    AllocateBuffers(num_frames);
+
+  float* ptr = AppendFrames(m_input, m_channels, m_input_start, m_input_end, num_frames);
+  std::memcpy(ptr, frames, num_frames * m_channels * sizeof(float));
+  Process();
+}
+
+u32 AudioStretcher::ReceiveFrames(float* frames, u32 max_frames)
+{
+  const u32 num_frames = std::min(max_frames, m_output_end - m_output_start);
+  if (num_frames == 0)
+    return 0;
+
+  std::memcpy(frames, &m_output[m_output_start * m_channels], num_frames * m_channels * sizeof(float));
+  m_output_start += num_frames;
+  if (m_output_start == m_output_end)
+  {
+    m_output_start = 0;
+    m_output_end = 0;
+  }
+
+  return num_frames;
+}
+
+void AudioStretcher::UpdateReferenceOverlap(const float* input)
+{
+  const u32 channels = m_channels;
+  std::memcpy(m_overlap.data(), input, m_overlap_frames * channels * sizeof(float));
+
+  for (u32 i = 0; i < m_overlap_frames; i++)
+  {
+    const float weight = static_cast<float>(i * (m_overlap_frames - i));
+    for (u32 c = 0; c < channels; c++)
+      m_reference[i * channels + c] = input[i * channels + c] * weight;
+  }
+}
+
+u32 AudioStretcher::FindBestOverlapOffset(const float* input) const
+{
+  const u32 channels = m_channels;
+  const u32 count = m_overlap_frames * channels;
+
+  // Energy of the candidate window, slid along one frame at a time instead of being recomputed.
+  float energy = DotProduct(input, input, count);
+
+  u32 best_offset = 0;
+  float best_score = -std::numeric_limits<float>::max();
+  for (u32 offset = 0; offset < m_seek_frames; offset++)
+  {
+    const float* candidate = input + offset * channels;
+    const float score =
+      DotProduct(m_reference.data(), candidate, count) / std::sqrt(std::max(energy, std::numeric_limits<float>::min()));
+    if (score > best_score)
+    {
+      best_score = score;
+      best_offset = offset;
+    }
+
+    for (u32 c = 0; c < channels; c++)
+      energy += (candidate[count + c] * candidate[count + c]) - (candidate[c] * candidate[c]);
+  }
+
+  return best_offset;
+}
+
+void AudioStretcher::Process()
+{
+  const u32 channels = m_channels;
+  const u32 overlap_samples = m_overlap_frames * channels;
+  const u32 body_frames = m_sequence_frames - (m_overlap_frames * 2);
+  const u32 output_frames_per_sequence = m_sequence_frames - m_overlap_frames;
+  const u32 max_output_frames = static_cast<u32>(m_output.size()) / channels;
+
+  while ((m_input_end - m_input_start) >= m_required_input_frames &&
+         ((m_output_end - m_output_start) + output_frames_per_sequence) <= max_output_frames)
+  {
+    const float* input = &m_input[m_input_start * channels];
+    float* out = AppendFrames(m_output, channels, m_output_start, m_output_end, output_frames_per_sequence);
+
+    u32 offset = 0;
+    if (m_first_sequence) [[unlikely]]
+    {
+      // Nothing to blend with yet.
+      std::memcpy(out, input, overlap_samples * sizeof(float));
+      m_first_sequence = false;
+    }
+    else
+    {
+      offset = FindBestOverlapOffset(input);
+
+      const float* in = input + offset * channels;
+      const float step = 1.0f / static_cast<float>(m_overlap_frames);
+      for (u32 i = 0; i < m_overlap_frames; i++)
+      {
+        const float fade_in = static_cast<float>(i) * step;
+        const float fade_out = 1.0f - fade_in;
+        for (u32 c = 0; c < channels; c++)
+        {
+          const u32 idx = i * channels + c;
+          out[idx] = (m_overlap[idx] * fade_out) + (in[idx] * fade_in);
+        }
+      }
+    }
+
+    // The middle of the sequence goes straight through, the tail is kept to cross-fade with the next sequence.
+    std::memcpy(out + overlap_samples, input + (offset + m_overlap_frames) * channels,
+                body_frames * channels * sizeof(float));
+    UpdateReferenceOverlap(input + (offset + m_sequence_frames - m_overlap_frames) * channels);
+
+    m_skip_fract += m_nominal_skip;
+    const u32 skip = static_cast<u32>(m_skip_fract);
+    m_skip_fract -= static_cast<double>(skip);
+    DebugAssert(skip <= (m_input_end - m_input_start));
+    m_input_start += skip;
+  }
+
+  if (m_input_start == m_input_end)
+  {
+    m_input_start = 0;
+    m_input_end = 0;
+  }
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "common/types.h"
+
+#include <vector>
+
+/// Time stretcher based on WSOLA (waveform similarity overlap-add). Input is cut into sequences which are cross-faded
+/// at the point where the waveforms line up best. It's the same idea as SoundTouch's TDStretch, but with the windows
+/// sized for a few milliseconds, so very little audio is held back.
+class AudioStretcher
+{
+public:
+  /// Tempo range which the buffers are sized for, SetTempo() clamps to it.
+  static constexpr float MIN_TEMPO = 0.05f;
+  static constexpr float MAX_TEMPO = 50.0f;
+
+  /// The buffers are allocated up front for PutFrames() calls of up to max_put_frames frames, with the output received
+  /// after each put, so that neither allocates. Larger puts grow the buffers to match.
+  AudioStretcher(u32 sample_rate, u32 channels, u32 sequence_ms, u32 seekwindow_ms, u32 overlap_ms,
+                 u32 max_put_frames);
+  ~AudioStretcher();
+
+  ALWAYS_INLINE u32 GetChannels() const { return m_channels; }
+  ALWAYS_INLINE float GetTempo() const { return m_tempo; }
+
+  /// Returns the number of input frames which have to be buffered before any output is produced.
+  ALWAYS_INLINE u32 GetInputLatencyFrames() const { return m_required_input_frames; }
+
+  /// Returns the number of frames waiting to be received.
+  ALWAYS_INLINE u32 GetAvailableFrames() const { return m_output_end - m_output_start; }
+
+  void SetTempo(float tempo);
+
+  /// Drops all buffered audio, the next frames put are treated as the start of the stream.
+  void Clear();
+
+  void PutFrames(const float* frames, u32 num_frames);
+  u32 ReceiveFrames(float* frames, u32 max_frames);
+
+private:
+  u32 GetRequiredInputFrames(float tempo) const;
+  void AllocateBuffers(u32 max_put_frames);
+  void Process();
+  u32 FindBestOverlapOffset(const float* input) const;
+  void UpdateReferenceOverlap(const float* input);
+
+  static float* AppendFrames(std::vector<float>& buffer, u32 channels, u32& start, u32& end, u32 num_frames);
+
+  u32 m_channels;
+  u32 m_sequence_frames;
+  u32 m_seek_frames;
+  u32 m_overlap_frames;
+  u32 m_required_input_frames = 0;
+  u32 m_max_put_frames = 0;
+
+  float m_tempo = 1.0f;
+  double m_nominal_skip = 0.0;
+  double m_skip_fract = 0.0;
+  bool m_first_sequence = true;
+
+  // Frames are stored interleaved, [start, end) is the live part of each buffer.
+  std::vector<float> m_input;
+  u32 m_input_start = 0;
+  u32 m_input_end = 0;
+
+  std::vector<float> m_output;
+  u32 m_output_start = 0;
+  u32 m_output_end = 0;
+
+  // Tail of the last sequence, which gets cross-faded with the next one. The reference copy is weighted towards the
+  // middle for correlation, so the edges of the overlap matter less when seeking.
+  std::vector<float> m_overlap;
+  std::vector<float> m_reference;
+};
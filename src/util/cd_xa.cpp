@@ -4,6 +4,8 @@
 #include "cd_xa.h"
 #include "cd_image.h"
 
+#include "common/intrin.h"
+
 #include <algorithm>
 #include <array>
 
@@ -11,30 +13,79 @@ namespace CDXA {
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_pos = {{0, 60, 115, 98}};
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_neg = {{0, 0, -52, -55}};
 
-template<bool IS_STEREO, bool IS_8BIT>
+ALWAYS_INLINE static s16 FilterXA_ADPCMSample(s32 sample, s32 filter_pos, s32 filter_neg, s32& prev0, s32& prev1)
+{
+  // mix in previous values
+  const s32 interp_sample = sample + ((prev0 * filter_pos) + (prev1 * filter_neg) + 32) / 64;
+
+  // update previous values
+  prev1 = prev0;
+  prev0 = interp_sample;
+
+  return static_cast<s16>(std::clamp<s32>(interp_sample, -0x8000, 0x7FFF));
+}
+
+template<bool IS_STEREO, bool IS_8BIT, bool VECTORIZED>
 ALWAYS_INLINE_RELEASE static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16* samples, s32* last_samples)
 {
-  // The data layout is annoying here. Each word of data is interleaved with the other blocks, requiring multiple
-  // passes to decode the whole chunk.
+  // The data layout is annoying here. Each word of data is interleaved with the other blocks, so the nibbles for all
+  // of the blocks are extracted up front, and then the filter is run over each block.
   constexpr u32 NUM_BLOCKS = IS_8BIT ? 4 : 8;
   constexpr u32 WORDS_PER_BLOCK = 28;
+  constexpr u32 BITS_PER_BLOCK = IS_8BIT ? 8 : 4;
 
   const u8* headers_ptr = chunk_ptr + 4;
   const u8* words_ptr = chunk_ptr + 16;
 
+  std::array<u8, NUM_BLOCKS> shifts;
+  std::array<u8, NUM_BLOCKS> filters;
   for (u32 block = 0; block < NUM_BLOCKS; block++)
   {
     const XA_ADPCMBlockHeader block_header{headers_ptr[block]};
-    const u8 shift = block_header.GetShift();
-    const u8 filter = block_header.GetFilter();
-    const s32 filter_pos = s_xa_adpcm_filter_table_pos[filter];
-    const s32 filter_neg = s_xa_adpcm_filter_table_neg[filter];
+    shifts[block] = block_header.GetShift();
+    filters[block] = block_header.GetFilter();
+  }
 
-    s16* out_samples_ptr =
-      IS_STEREO ? &samples[(block / 2) * (WORDS_PER_BLOCK * 2) + (block % 2)] : &samples[block * WORDS_PER_BLOCK];
-    constexpr u32 out_samples_increment = IS_STEREO ? 2 : 1;
+  alignas(VECTOR_ALIGNMENT) std::array<std::array<s32, WORDS_PER_BLOCK>, NUM_BLOCKS> block_samples;
+  for (u32 block = 0; block < NUM_BLOCKS; block++)
+  {
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+    if constexpr (VECTORIZED)
+    {
+      // Only the low nibble of each block is used, even for 8-bit data. Moving the nibble to the top of the word,
+      // masking off the rest and arithmetic shifting it back down by (16 + shift) gives the same result as shifting a
+      // halfword, which is what the scalar version below does.
+      static constexpr u32 NIBBLE_MASK = 0xF0000000u;
+      const u32 left_shift = 28 - (block * BITS_PER_BLOCK);
+      const u32 right_shift = 16 + shifts[block];
+
+#if defined(CPU_ARCH_SSE)
+      const __m128i left_shift_vec = _mm_cvtsi32_si128(left_shift);
+      const __m128i right_shift_vec = _mm_cvtsi32_si128(right_shift);
+      const __m128i mask = _mm_set1_epi32(static_cast<s32>(NIBBLE_MASK));
+      for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+      {
+        const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&words_ptr[word * sizeof(u32)]));
+        const __m128i nibbles = _mm_and_si128(_mm_sll_epi32(words, left_shift_vec), mask);
+        _mm_store_si128(reinterpret_cast<__m128i*>(&block_samples[block][word]),
+                        _mm_sra_epi32(nibbles, right_shift_vec));
+      }
+#elif defined(CPU_ARCH_NEON)
+      const int32x4_t left_shift_vec = vdupq_n_s32(static_cast<s32>(left_shift));
+      const int32x4_t right_shift_vec = vdupq_n_s32(-static_cast<s32>(right_shift));
+      const int32x4_t mask = vdupq_n_s32(static_cast<s32>(NIBBLE_MASK));
+      for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+      {
+        const int32x4_t words = vreinterpretq_s32_u8(vld1q_u8(&words_ptr[word * sizeof(u32)]));
+        const int32x4_t nibbles = vandq_s32(vshlq_s32(words, left_shift_vec), mask);
+        vst1q_s32(&block_samples[block][word], vshlq_s32(nibbles, right_shift_vec));
+      }
+#endif
+      continue;
+    }
+#endif
 
-    for (u32 word = 0; word < 28; word++)
+    for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
     {
       // NOTE: assumes LE
       u32 word_data;
@@ -42,23 +93,58 @@ ALWAYS_INLINE_RELEASE static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16*
 
       // extract nibble from block
       const u32 nibble = IS_8BIT ? ((word_data >> (block * 8)) & 0xFF) : ((word_data >> (block * 4)) & 0x0F);
-      const s16 sample = static_cast<s16>(Truncate16(nibble << 12)) >> shift;
-
-      // mix in previous values
-      s32* prev = IS_STEREO ? &last_samples[(block & 1) * 2] : last_samples;
-      const s32 interp_sample = s32(sample) + ((prev[0] * filter_pos) + (prev[1] * filter_neg) + 32) / 64;
+      block_samples[block][word] = static_cast<s16>(Truncate16(nibble << 12)) >> shifts[block];
+    }
+  }
 
-      // update previous values
-      prev[1] = prev[0];
-      prev[0] = interp_sample;
+  if constexpr (IS_STEREO)
+  {
+    // Even blocks are left and odd blocks are right. Filtering both channels in the same loop lets the two
+    // dependency chains overlap.
+    s32 left_prev0 = last_samples[0];
+    s32 left_prev1 = last_samples[1];
+    s32 right_prev0 = last_samples[2];
+    s32 right_prev1 = last_samples[3];
+    for (u32 block = 0; block < NUM_BLOCKS; block += 2)
+    {
+      const s32 left_filter_pos = s_xa_adpcm_filter_table_pos[filters[block]];
+      const s32 left_filter_neg = s_xa_adpcm_filter_table_neg[filters[block]];
+      const s32 right_filter_pos = s_xa_adpcm_filter_table_pos[filters[block + 1]];
+      const s32 right_filter_neg = s_xa_adpcm_filter_table_neg[filters[block + 1]];
+      s16* out_samples_ptr = &samples[(block / 2) * (WORDS_PER_BLOCK * 2)];
+      for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+      {
+        out_samples_ptr[word * 2 + 0] = FilterXA_ADPCMSample(block_samples[block][word], left_filter_pos,
+                                                             left_filter_neg, left_prev0, left_prev1);
+        out_samples_ptr[word * 2 + 1] = FilterXA_ADPCMSample(block_samples[block + 1][word], right_filter_pos,
+                                                             right_filter_neg, right_prev0, right_prev1);
+      }
+    }
 
-      *out_samples_ptr = static_cast<s16>(std::clamp<s32>(interp_sample, -0x8000, 0x7FFF));
-      out_samples_ptr += out_samples_increment;
+    last_samples[0] = left_prev0;
+    last_samples[1] = left_prev1;
+    last_samples[2] = right_prev0;
+    last_samples[3] = right_prev1;
+  }
+  else
+  {
+    s32 prev0 = last_samples[0];
+    s32 prev1 = last_samples[1];
+    for (u32 block = 0; block < NUM_BLOCKS; block++)
+    {
+      const s32 filter_pos = s_xa_adpcm_filter_table_pos[filters[block]];
+      const s32 filter_neg = s_xa_adpcm_filter_table_neg[filters[block]];
+      s16* out_samples_ptr = &samples[block * WORDS_PER_BLOCK];
+      for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+        out_samples_ptr[word] = FilterXA_ADPCMSample(block_samples[block][word], filter_pos, filter_neg, prev0, prev1);
     }
+
+    last_samples[0] = prev0;
+    last_samples[1] = prev1;
   }
 }
 
-template<bool IS_STEREO, bool IS_8BIT>
+template<bool IS_STEREO, bool IS_8BIT, bool VECTORIZED>
 ALWAYS_INLINE_RELEASE static void DecodeXA_ADPCMChunks(const u8* chunk_ptr, s16* samples, s32* last_samples)
 {
   constexpr u32 NUM_CHUNKS = 18;
@@ -68,15 +154,14 @@ ALWAYS_INLINE_RELEASE static void DecodeXA_ADPCMChunks(const u8* chunk_ptr, s16*
 
   for (u32 i = 0; i < NUM_CHUNKS; i++)
   {
-    DecodeXA_ADPCMChunk<IS_STEREO, IS_8BIT>(chunk_ptr, samples, last_samples);
+    DecodeXA_ADPCMChunk<IS_STEREO, IS_8BIT, VECTORIZED>(chunk_ptr, samples, last_samples);
     samples += SAMPLES_PER_CHUNK;
     chunk_ptr += CHUNK_SIZE_IN_BYTES;
   }
 }
 
-} // namespace CDXA
-
-void CDXA::DecodeADPCMSector(const void* data, s16* samples, s32* last_samples)
+template<bool VECTORIZED>
+static void DecodeADPCMSectorImpl(const void* data, s16* samples, s32* last_samples)
 {
   const XASubHeader* subheader = reinterpret_cast<const XASubHeader*>(
     reinterpret_cast<const u8*>(data) + CDImage::SECTOR_SYNC_SIZE + sizeof(CDImage::SectorHeader));
@@ -88,15 +173,39 @@ void CDXA::DecodeADPCMSector(const void* data, s16* samples, s32* last_samples)
   if (subheader->codinginfo.bits_per_sample != 1)
   {
     if (subheader->codinginfo.mono_stereo != 1)
-      DecodeXA_ADPCMChunks<false, false>(chunk_ptr, samples, last_samples);
+      DecodeXA_ADPCMChunks<false, false, VECTORIZED>(chunk_ptr, samples, last_samples);
     else
-      DecodeXA_ADPCMChunks<true, false>(chunk_ptr, samples, last_samples);
+      DecodeXA_ADPCMChunks<true, false, VECTORIZED>(chunk_ptr, samples, last_samples);
   }
   else
   {
     if (subheader->codinginfo.mono_stereo != 1)
-      DecodeXA_ADPCMChunks<false, true>(chunk_ptr, samples, last_samples);
+      DecodeXA_ADPCMChunks<false, true, VECTORIZED>(chunk_ptr, samples, last_samples);
     else
-      DecodeXA_ADPCMChunks<true, true>(chunk_ptr, samples, last_samples);
+      DecodeXA_ADPCMChunks<true, true, VECTORIZED>(chunk_ptr, samples, last_samples);
   }
 }
+
+} // namespace CDXA
+
+void CDXA::DecodeADPCMSector(const void* data, s16* samples, s32* last_samples)
+{
+  DecodeADPCMSectorImpl<true>(data, samples, last_samples);
+}
+
+bool CDXA::HasVectorizedADPCMDecoding()
+{
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CDXA::DecodeADPCMSectorForTest(const void* data, s16* samples, s32* last_samples, bool vectorized)
+{
+  if (vectorized)
+    DecodeADPCMSectorImpl<true>(data, samples, last_samples);
+  else
+    DecodeADPCMSectorImpl<false>(data, samples, last_samples);
+}
@@ -70,4 +70,10 @@ static_assert(sizeof(XA_ADPCMBlockHeader) == 1, "XA-ADPCM block header is one by
 // Decodes XA-ADPCM samples in an audio sector. Stereo samples are interleaved with left first.
 void DecodeADPCMSector(const void* data, s16* samples, s32* last_samples);
 
+/// Returns true if the sample extraction in DecodeADPCMSector() is vectorized on this platform.
+bool HasVectorizedADPCMDecoding();
+
+/// Decodes a sector with either the vectorized or the scalar sample extraction.
+void DecodeADPCMSectorForTest(const void* data, s16* samples, s32* last_samples, bool vectorized);
+
 } // namespace CDXA
\ No newline at end of file
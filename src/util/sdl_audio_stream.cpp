@@ -148,7 +148,7 @@ void SDLAudioStream::AudioCallback(void* userdata, uint8_t* stream, int len)
   const u32 num_frames = len / sizeof(SampleType) / this_ptr->m_output_channels;
 
   this_ptr->ReadFrames(reinterpret_cast<SampleType*>(stream), num_frames);
-  this_ptr->ApplyVolume(reinterpret_cast<SampleType*>(stream), num_frames);
+  this_ptr->ApplyVolume(reinterpret_cast<SampleType*>(stream), num_frames * this_ptr->m_output_channels);
 }
 
 void SDLAudioStream::SetOutputVolume(u32 volume)